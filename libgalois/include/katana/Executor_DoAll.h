@@ -29,6 +29,7 @@
 #include "katana/Statistics.h"
 #include "katana/TerminationDetection.h"
 #include "katana/ThreadPool.h"
+#include "katana/Threads.h"
 #include "katana/Timer.h"
 #include "katana/config.h"
 #include "katana/gIO.h"
@@ -374,7 +375,7 @@ public:
         func(_func),
         loopname(katana::internal::getLoopName(argsTuple)),
         chunk_size(get_trait_value<chunk_size_tag>(argsTuple).value),
-        term(GetTerminationDetection(activeThreads)),
+        term(GetTerminationDetection(getActiveThreads())),
         totalTime(loopname, "Total"),
         initTime(loopname, "Init"),
         execTime(loopname, "Execute"),
@@ -468,10 +469,10 @@ struct ChooseDoAllImpl {
         R, OperatorReferenceType<decltype(std::forward<F>(func))>, ArgsT>
         exec(range, std::forward<F>(func), argsTuple);
 
-    Barrier& barrier = GetBarrier(activeThreads);
+    Barrier& barrier = GetBarrier(getActiveThreads());
 
     GetThreadPool().run(
-        activeThreads, [&exec]() { exec.initThread(); },
+        getActiveThreads(), [&exec]() { exec.initThread(); },
         [&barrier]() { barrier.Wait(); }, std::ref(exec));
   }
 };
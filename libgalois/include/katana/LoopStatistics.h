@@ -43,6 +43,18 @@ public:
     ReportStatSum(loopname, "Commits", (m_iterations - m_conflicts));
     ReportStatSum(loopname, "Pushes", m_pushes);
     ReportStatSum(loopname, "Conflicts", m_conflicts);
+
+    if (auto* sm = internal::sysStatManager(); sm && sm->IsTracing()) {
+      int64_t iterations = m_iterations;
+      int64_t conflicts = m_conflicts;
+      int64_t pushes = m_pushes;
+      sm->AddTraceInstant(
+          loopname, "LoopStatistics",
+          {{"Iterations", iterations},
+           {"Commits", iterations - conflicts},
+           {"Pushes", pushes},
+           {"Conflicts", conflicts}});
+    }
   }
 
   size_t iterations() const { return m_iterations; }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 #include "katana/Manager.h"
@@ -8,7 +10,7 @@
 #include "katana/config.h"
 
 namespace katana {
-/// The memory supervisor singleton (MS).  Not thread safe.
+/// The memory supervisor singleton (MS).
 ///
 /// The MS controls policy and does bookkeeping.  All memory allocation
 /// is done by the system, mostly the C++ standard library.
@@ -20,9 +22,28 @@ namespace katana {
 /// The MS does not manage per-allocation tokens, it only manages sizes
 /// Clients are trusted to call the proper functions or the MS will make
 /// bad decisions.
+///
+/// The MS keeps total memory use under a budget.  When active memory grows
+/// past the budget it asks managers to free standby memory, managers holding
+/// the most standby memory first.  Managers free their standby memory least
+/// recently used first.  The budget defaults to most of physical memory and
+/// can be set with the KATANA_MEMORY_BUDGET environment variable, a number of
+/// bytes optionally followed by K, M, G or T, or with SetMemoryBudget.
 
 class KATANA_EXPORT MemorySupervisor {
 public:
+  /// Cumulative record of the memory the MS has reclaimed from managers
+  struct ReclaimStats {
+    /// Number of times the MS asked managers to free standby memory
+    uint64_t num_reclaims{};
+    /// Bytes of standby memory the MS asked for
+    count_t bytes_requested{};
+    /// Bytes of standby memory managers freed
+    count_t bytes_reclaimed{};
+    /// Number of times use stayed over budget after reclaiming
+    uint64_t num_oversubscribed{};
+  };
+
   MemorySupervisor(const MemorySupervisor&) = delete;
   MemorySupervisor(MemorySupervisor&&) = delete;
   MemorySupervisor& operator=(const MemorySupervisor&) = delete;
@@ -38,7 +59,9 @@ public:
   void Register(Manager* manager);
 
   /// This manager is defunct.
-  /// \p manager must have zero active and standby memory.
+  /// \p manager must have zero active memory; standby memory it still holds
+  /// is released. Waits for reclaims in progress, so once this returns the
+  /// supervisor no longer calls \p manager.
   void Unregister(Manager* manager);
 
   /// Inform MS of allocation of \p bytes for active memory
@@ -60,14 +83,29 @@ public:
   /// Managers are always allowed to transition from standby to active
   void StandbyToActive(Manager* manager, count_t bytes);
 
+  /// Limit the memory the MS plans to use, active plus standby, to \p bytes.
+  /// Standby memory is reclaimed immediately if the new budget is exceeded.
+  void SetMemoryBudget(count_t bytes);
+  count_t GetMemoryBudget();
+
+  /// Sum of all active memory across all managers
+  count_t GetActive();
+  /// Sum of all standby memory across all managers
+  count_t GetStandby();
+
+  ReclaimStats GetReclaimStats();
+
 private:
   MemorySupervisor();
   /// Make sure our state is sane, log if not
   void Sanity();
   void LogState(const std::string& str);
 
-  /// Get managers to free \p goal bytes of standby memory
-  void ReclaimMemory(count_t goal);
+  /// Get managers to free \p goal bytes of standby memory. \p lock holds
+  /// mutex_, and is released while the managers are called.
+  void ReclaimMemory(count_t goal, std::unique_lock<std::mutex>* lock);
+  /// Reclaim standby memory until we are within budget, if possible
+  void ReclaimOversubscribed(std::unique_lock<std::mutex>* lock);
   bool CheckRegistered(Manager* manager);
 
   struct ManagerInfo {
@@ -77,6 +115,17 @@ private:
   };
   std::unordered_map<Manager*, ManagerInfo> managers_;
 
+  /// Protects all of the state below. Managers may be used from several
+  /// threads, e.g., when properties are loaded on first access.
+  std::mutex mutex_;
+
+  ReclaimStats reclaim_stats_{};
+
+  /// Reclaims calling managers with mutex_ released; Unregister waits on
+  /// reclaim_done_ until there are none
+  int num_reclaiming_{0};
+  std::condition_variable reclaim_done_;
+
   /// Sum of all active memory across all managers
   count_t active_{};
   void ActiveMinus(ManagerInfo& info, count_t bytes);
@@ -90,7 +139,8 @@ private:
 
   /// The maximum amount of physical memory the MS plans to use, which should be less
   /// than or equal to the total physical memory in the machine.  There are users of
-  /// memory outside our control, like the operating system.
+  /// memory outside our control, like the operating system.  This is the memory
+  /// budget.
   count_t physical_{};
   count_t Available() { return physical_ - Used(); }
   bool MemoryOversubscribed() { return Used() >= physical_; }
@@ -29,6 +29,7 @@
 #include "katana/FlatMap.h"
 #include "katana/PerThreadStorage.h"
 #include "katana/TerminationDetection.h"
+#include "katana/Threads.h"
 #include "katana/WorkListHelpers.h"
 
 namespace katana {
@@ -53,7 +54,7 @@ protected:
 
   Barrier& barrier;
 
-  OrderedByIntegerMetricData() : barrier(GetBarrier(activeThreads)) {}
+  OrderedByIntegerMetricData() : barrier(GetBarrier(getActiveThreads())) {}
 
   bool hasStored(ThreadData& p, Index idx) {
     for (auto& e : p.stored) {
@@ -258,6 +259,8 @@ private:
 
   std::atomic<unsigned int> masterVersion;
   Indexer indexer;
+  //! number of threads of the loops this worklist is used in
+  unsigned numThreads;
 
   bool updateLocal(ThreadData& p) {
     if (p.lastMasterVersion != masterVersion.load(std::memory_order_relaxed)) {
@@ -283,7 +286,7 @@ private:
     if (BSP && !UseMonotonic) {
       msS = p.scanStart;
       if (localLeader) {
-        for (unsigned i = 0; i < activeThreads; ++i) {
+        for (unsigned i = 0; i < numThreads; ++i) {
           Index o = data.getRemote(i)->scanStart;
           if (this->compare(o, msS))
             msS = o;
@@ -345,7 +348,10 @@ private:
 
 public:
   OrderedByIntegerMetric(const Indexer& x = Indexer())
-      : data(this->earliest), masterVersion(0), indexer(x) {}
+      : data(this->earliest),
+        masterVersion(0),
+        indexer(x),
+        numThreads(getActiveThreads()) {}
 
   ~OrderedByIntegerMetric() {
     // Deallocate in LIFO order to give opportunity for simple garbage
@@ -443,7 +449,7 @@ public:
     Index curIndex = (hasWork) ? p.curIndex : this->identity;
     CTy* C = (hasWork) ? p.current : nullptr;
 
-    for (unsigned i = 0; i < activeThreads; ++i) {
+    for (unsigned i = 0; i < numThreads; ++i) {
       ThreadData& o = *data.getRemote(i);
       if (o.hasWork && this->compare(o.curIndex, curIndex)) {
         curIndex = o.curIndex;
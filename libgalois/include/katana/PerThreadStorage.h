@@ -86,18 +86,31 @@ KATANA_EXPORT PerBackend& getPPSBackend();
 
 KATANA_EXPORT void initPTS(unsigned maxT);
 
+/**
+ * One T per thread of the thread pool current when it is constructed (see
+ * GetThreadPool()). getLocal() works from any thread of the system pool.
+ *
+ * Thread ids passed to getLocal(unsigned) and getRemote, and size(), are
+ * relative to the creation pool. ThreadPool::getTID() is relative to the
+ * pool the caller is lent to, so it names the caller's own element only
+ * when that pool is the creation pool. Code that may run in another pool
+ * must translate through ThreadPool::getSystemTID(), or keep pointers to
+ * elements rather than thread ids.
+ */
 template <typename T>
 class PerThreadStorage {
   PerBackend* b;
   unsigned offset;
+  unsigned first_thread_;
+  unsigned num_threads_;
 
   void destruct() {
     if (offset == ~0U) {
       return;
     }
 
-    for (unsigned n = 0; n < GetThreadPool().getMaxThreads(); ++n) {
-      reinterpret_cast<T*>(b->getRemote(n, offset))->~T();
+    for (unsigned n = 0; n < num_threads_; ++n) {
+      reinterpret_cast<T*>(b->getRemote(first_thread_ + n, offset))->~T();
     }
     b->deallocOffset(offset, sizeof(T));
     offset = ~0U;
@@ -143,15 +156,21 @@ public:
     // In case we make one of these before initializing the thread pool, this
     // will call initPTS for each thread if it hasn't already
     auto& tp = GetThreadPool();
+    first_thread_ = tp.getSystemTIDBase();
+    num_threads_ = tp.getMaxThreads();
 
     offset = b->allocOffset(sizeof(T));
-    for (unsigned n = 0; n < tp.getMaxThreads(); ++n) {
-      new (b->getRemote(n, offset)) T(std::forward<Args>(args)...);
+    for (unsigned n = 0; n < num_threads_; ++n) {
+      new (b->getRemote(first_thread_ + n, offset))
+          T(std::forward<Args>(args)...);
     }
   }
 
   PerThreadStorage(PerThreadStorage&& rhs) noexcept
-      : b(rhs.b), offset(rhs.offset) {
+      : b(rhs.b),
+        offset(rhs.offset),
+        first_thread_(rhs.first_thread_),
+        num_threads_(rhs.num_threads_) {
     rhs.offset = ~0;
   }
 
@@ -164,6 +183,8 @@ public:
     auto tmp = std::move(rhs);
     std::swap(b, tmp.b);
     std::swap(offset, tmp.offset);
+    std::swap(first_thread_, tmp.first_thread_);
+    std::swap(num_threads_, tmp.num_threads_);
     return *this;
   }
 
@@ -177,28 +198,35 @@ public:
     return reinterpret_cast<T*>(ditem);
   }
 
-  //! Like getLocal() but optimized for when you already know the thread id
+  //! Like getLocal() but optimized for when you already know the thread id,
+  //! which is relative to the creation pool
   T* getLocal(unsigned int thread) {
-    void* ditem = b->getLocal(offset, thread);
+    KATANA_LOG_DEBUG_ASSERT(
+        first_thread_ + thread == ThreadPool::getSystemTID());
+    void* ditem = b->getLocal(offset, first_thread_ + thread);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getLocal(unsigned int thread) const {
-    void* ditem = b->getLocal(offset, thread);
+    KATANA_LOG_DEBUG_ASSERT(
+        first_thread_ + thread == ThreadPool::getSystemTID());
+    void* ditem = b->getLocal(offset, first_thread_ + thread);
     return reinterpret_cast<T*>(ditem);
   }
 
   T* getRemote(unsigned int thread) {
-    void* ditem = b->getRemote(thread, offset);
+    KATANA_LOG_DEBUG_ASSERT(thread < num_threads_);
+    void* ditem = b->getRemote(first_thread_ + thread, offset);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getRemote(unsigned int thread) const {
-    void* ditem = b->getRemote(thread, offset);
+    KATANA_LOG_DEBUG_ASSERT(thread < num_threads_);
+    void* ditem = b->getRemote(first_thread_ + thread, offset);
     return reinterpret_cast<T*>(ditem);
   }
 
-  unsigned size() const { return GetThreadPool().getMaxThreads(); }
+  unsigned size() const { return num_threads_; }
 
   iterator begin() { return iterator(*this, 0); }
 
@@ -209,16 +237,23 @@ public:
   local_iterator local_end() { return local_begin() + 1; }
 };
 
+/**
+ * One T per socket of the thread pool current when it is constructed. As with
+ * PerThreadStorage, thread ids are relative to that pool, not to the pool
+ * the caller is lent to.
+ */
 template <typename T>
 class PerSocketStorage {
   unsigned offset;
   PerBackend* b;
+  unsigned first_thread_;
+  unsigned num_threads_;
+  //! system id of the leader of each socket
+  std::vector<unsigned> leaders_;
 
   void destruct() {
-    auto& tp = GetThreadPool();
-    for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      reinterpret_cast<T*>(b->getRemote(tp.getLeaderForSocket(n), offset))
-          ->~T();
+    for (unsigned leader : leaders_) {
+      reinterpret_cast<T*>(b->getRemote(leader, offset))->~T();
     }
     b->deallocOffset(offset, sizeof(T));
   }
@@ -234,19 +269,32 @@ public:
 
     offset = b->allocOffset(sizeof(T));
     auto& tp = GetThreadPool();
+    first_thread_ = tp.getSystemTIDBase();
+    num_threads_ = tp.getMaxThreads();
+    // Threads of a socket share storage, so the first thread of a socket in a
+    // partition of the thread pool finds the same storage as the leader of
+    // the socket in the system pool
     for (unsigned n = 0; n < tp.getMaxSockets(); ++n) {
-      new (b->getRemote(tp.getLeaderForSocket(n), offset))
+      leaders_.emplace_back(first_thread_ + tp.getLeaderForSocket(n));
+      new (b->getRemote(leaders_.back(), offset))
           T(std::forward<Args>(args)...);
     }
   }
 
   PerSocketStorage(PerSocketStorage&& rhs) noexcept
-      : offset(std::move(rhs.offset)), b(&getPPSBackend()) {}
+      : offset(std::move(rhs.offset)),
+        b(&getPPSBackend()),
+        first_thread_(rhs.first_thread_),
+        num_threads_(rhs.num_threads_),
+        leaders_(std::move(rhs.leaders_)) {}
 
   PerSocketStorage& operator=(PerSocketStorage&& rhs) {
     auto tmp = std::move(rhs);
     std::swap(b, tmp.b);
     std::swap(offset, tmp.offset);
+    std::swap(first_thread_, tmp.first_thread_);
+    std::swap(num_threads_, tmp.num_threads_);
+    std::swap(leaders_, tmp.leaders_);
     return *this;
   }
 
@@ -265,38 +313,45 @@ public:
     return reinterpret_cast<T*>(ditem);
   }
 
-  //! Like getLocal() but optimized for when you already know the thread id
+  //! Like getLocal() but optimized for when you already know the thread id,
+  //! which is relative to the creation pool
   T* getLocal(unsigned int thread) {
-    void* ditem = b->getLocal(offset, thread);
+    KATANA_LOG_DEBUG_ASSERT(
+        first_thread_ + thread == ThreadPool::getSystemTID());
+    void* ditem = b->getLocal(offset, first_thread_ + thread);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getLocal(unsigned int thread) const {
-    void* ditem = b->getLocal(offset, thread);
+    KATANA_LOG_DEBUG_ASSERT(
+        first_thread_ + thread == ThreadPool::getSystemTID());
+    void* ditem = b->getLocal(offset, first_thread_ + thread);
     return reinterpret_cast<T*>(ditem);
   }
 
   T* getRemote(unsigned int thread) {
-    void* ditem = b->getRemote(thread, offset);
+    KATANA_LOG_DEBUG_ASSERT(thread < num_threads_);
+    void* ditem = b->getRemote(first_thread_ + thread, offset);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getRemote(unsigned int thread) const {
-    void* ditem = b->getRemote(thread, offset);
+    KATANA_LOG_DEBUG_ASSERT(thread < num_threads_);
+    void* ditem = b->getRemote(first_thread_ + thread, offset);
     return reinterpret_cast<T*>(ditem);
   }
 
   T* getRemoteByPkg(unsigned int pkg) {
-    void* ditem = b->getRemote(GetThreadPool().getLeaderForSocket(pkg), offset);
+    void* ditem = b->getRemote(leaders_[pkg], offset);
     return reinterpret_cast<T*>(ditem);
   }
 
   const T* getRemoteByPkg(unsigned int pkg) const {
-    void* ditem = b->getRemote(GetThreadPool().getLeaderForSocket(pkg), offset);
+    void* ditem = b->getRemote(leaders_[pkg], offset);
     return reinterpret_cast<T*>(ditem);
   }
 
-  unsigned size() const { return GetThreadPool().getMaxThreads(); }
+  unsigned size() const { return num_threads_; }
 };
 
 }  // end namespace katana
@@ -0,0 +1,98 @@
+#ifndef KATANA_LIBGALOIS_KATANA_PERFCOUNTERS_H_
+#define KATANA_LIBGALOIS_KATANA_PERFCOUNTERS_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "katana/Result.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// Hardware events counted by PerfCounters
+enum class PerfEvent {
+  kCycles,
+  kInstructions,
+  kLLCMisses,
+  kBranchMisses,
+  kDTLBMisses,
+};
+
+constexpr size_t kNumPerfEvents = 5;
+
+/// PerfCounters counts hardware events on every thread of the system thread
+/// pool with the Linux perf_event_open interface, without PAPI or VTune.
+///
+/// The counters of each thread are opened by that thread when the
+/// PerfCounters object is made and count user-space events until it is
+/// destroyed. They can be read from any thread, so a region timed on one
+/// thread, like a StatTimer around a parallel loop, can still add up the
+/// events of all of the threads that ran the loop.
+///
+/// GaloisRuntime makes a PerfCounters object when the environment variable
+/// KATANA_PERF_COUNTERS is set. Every StatTimer, including the one each
+/// named loop starts, then reports the events counted between its start and
+/// stop calls (see StatTimer).
+class KATANA_EXPORT PerfCounters {
+public:
+  /// Event counts, indexed by PerfEvent
+  using Sample = std::array<uint64_t, kNumPerfEvents>;
+
+  /// Open counters on all threads of the system thread pool. Must be called
+  /// outside of parallel loops and before threads are lent to partitions.
+  /// Events the processor or the kernel does not support are skipped, but
+  /// it is an error if no event can be counted (e.g., because
+  /// /proc/sys/kernel/perf_event_paranoid forbids it).
+  static Result<std::unique_ptr<PerfCounters>> Make();
+
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+  PerfCounters(PerfCounters&&) = delete;
+  PerfCounters& operator=(PerfCounters&&) = delete;
+
+  /// The events counted by the threads of the current thread pool (see
+  /// GetThreadPool) so far, summed over the threads. Counts of events that
+  /// are not available are zero.
+  Sample Read() const;
+
+  /// Whether event e is counted
+  bool IsAvailable(PerfEvent e) const {
+    return available_[static_cast<size_t>(e)];
+  }
+
+  /// The name statistics of event e are reported under
+  static const char* Name(PerfEvent e);
+
+private:
+  /// The counters of one thread, a group led by the first available event
+  struct ThreadCounters {
+    int leader_fd{-1};
+    std::vector<int> fds;
+  };
+
+  PerfCounters() = default;
+
+  /// Open the counters of the calling thread
+  Result<void> OpenLocal(ThreadCounters* counters);
+
+  /// Add the counts of one thread to sample
+  void ReadThread(const ThreadCounters& counters, Sample* sample) const;
+
+  std::vector<ThreadCounters> threads_;
+  std::array<bool, kNumPerfEvents> available_{};
+};
+
+namespace internal {
+
+KATANA_EXPORT void SetPerfCounters(PerfCounters* counters);
+KATANA_EXPORT PerfCounters* GetPerfCounters();
+
+}  // namespace internal
+
+}  // namespace katana
+
+#endif
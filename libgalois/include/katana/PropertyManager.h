@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
 #include <string>
 
 #include "katana/Cache.h"
@@ -19,10 +20,21 @@ public:
   const std::string& MemoryCategory() const override { return memory_category; }
   count_t FreeStandbyMemory(count_t goal) override;
 
-  void AddProperty(const katana::Uri& property_path);
+  /// Take the property stored at \p property_path out of standby memory.
+  /// \returns the property, or nullopt if it is not in standby memory, e.g.,
+  /// because it was reclaimed
+  std::optional<std::shared_ptr<arrow::Table>> AddProperty(
+      const katana::Uri& property_path);
 
   void PropertyLoadedCallback(const std::shared_ptr<arrow::Table>& property);
 
+  /// A property previously reported by PropertyLoadedCallback was dropped
+  /// from memory without passing through the cache
+  void PropertyUnloadedCallback(const std::shared_ptr<arrow::Table>& property);
+
+  /// Move a property reported by PropertyLoadedCallback from active to
+  /// standby memory, keeping it in memory if the supervisor allows so that a
+  /// later AddProperty can return it without reading storage
   void UnloadProperty(
       const katana::Uri& property_path,
       const std::shared_ptr<arrow::Table>& property);
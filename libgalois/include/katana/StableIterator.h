@@ -22,6 +22,7 @@
 
 #include "katana/Chunk.h"
 #include "katana/Range.h"
+#include "katana/Threads.h"
 #include "katana/config.h"
 #include "katana/gstl.h"
 
@@ -96,6 +97,8 @@ private:
 
   PerThreadStorage<state> TLDS;
   Container inner;
+  //! number of threads of the loops this worklist is used in
+  unsigned numThreads = getActiveThreads();
 
   bool doSteal(state& dst, state& src, bool wait) {
     shared_state& s = src.stealState.data;
@@ -130,7 +133,7 @@ private:
     }
     ++data.nextVictim;
     ++data.numStealFailures;
-    data.nextVictim %= activeThreads;
+    data.nextVictim %= numThreads;
     return std::nullopt;
   }
 
@@ -154,7 +157,7 @@ public:
       return *data.localBegin++;
 
     std::optional<value_type> item;
-    if (Steal && 2 * data.numStealFailures > activeThreads)
+    if (Steal && 2 * data.numStealFailures > numThreads)
       if ((item = pop_steal(data)))
         return item;
     if ((item = inner.pop()))
@@ -23,7 +23,10 @@
 #include <limits>
 #include <string>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "katana/Time.h"
 #include "katana/config.h"
 #include "katana/gIO.h"
 #include "katana/gstl.h"
@@ -290,6 +293,7 @@ class KATANA_EXPORT StatManager {
   class Impl;
 
   std::unique_ptr<Impl> impl_;
+  bool tracing_{false};
 
 public:
   using Str = katana::gstl::Str;
@@ -313,6 +317,16 @@ protected:
   /// ReadParam and ReadFP and print their own results here.
   virtual void PrintStats(std::ostream& out);
 
+  /// PrintJSON prints the statistics added so far, with the values of every
+  /// thread, as a JSON document of the form
+  ///
+  ///     {"stats": [{"kind": "STAT", "region": "BFS", "category": "Time",
+  ///                 "total_type": "TMAX", "total": 12,
+  ///                 "thread_values": [12]}, ...]}
+  ///
+  /// Unlike PrintStats, it may be called any number of times.
+  virtual void PrintJSON(std::ostream& out);
+
   void MergeStats();
 
   bool IsPrintingThreadVals() const;
@@ -348,6 +362,36 @@ public:
 
   void SetStatFile(const std::string& outfile);
 
+  /// Also write the statistics as JSON (see PrintJSON) to outfile on Print
+  /// and Flush. Defaults to the value of the environment variable
+  /// KATANA_STAT_JSON_FILE.
+  void SetJSONFile(const std::string& outfile);
+
+  /// Record StatTimer intervals, per-thread LoopStatistics, page allocation
+  /// counts and ProgressTracer spans as trace events, and write them to
+  /// outfile in the JSON array flavor of the Chrome trace event format, which
+  /// chrome://tracing and Perfetto load. Defaults to the value of the
+  /// environment variable KATANA_TRACE_FILE.
+  void SetTraceFile(const std::string& outfile);
+
+  bool IsTracing() const { return tracing_; }
+
+  /// Record a complete event on the calling thread
+  void AddTraceSpan(
+      const std::string& name, const std::string& category,
+      const TimePoint& start, const TimePoint& finish);
+
+  /// Record an instant event on the calling thread
+  void AddTraceInstant(
+      const std::string& name, const std::string& category,
+      std::vector<std::pair<std::string, int64_t>> args);
+
+  /// Record a counter event; each element of series is plotted as its own
+  /// line
+  void AddTraceCounter(
+      const std::string& name,
+      std::vector<std::pair<std::string, int64_t>> series);
+
   void AddInt(
       const std::string& region, const std::string& category, int64_t val,
       const StatTotal::Type& type);
@@ -360,6 +404,13 @@ public:
       const std::string& region, const std::string& category, const Str& val);
 
   void Print();
+
+  /// Write the statistics added so far to the JSON file and append the trace
+  /// events recorded since the last flush to the trace file, so that long
+  /// runs can be monitored before Print. Trace files are valid at any point
+  /// because the trace event format allows the closing bracket to be
+  /// missing. Must not be called while a parallel loop is running.
+  void Flush();
 };
 
 namespace internal {
@@ -483,6 +534,15 @@ KATANA_EXPORT void PrintStats();
 
 KATANA_EXPORT void SetStatFile(const std::string& f);
 
+/// See StatManager::SetJSONFile
+KATANA_EXPORT void SetStatJSONFile(const std::string& f);
+
+/// See StatManager::SetTraceFile
+KATANA_EXPORT void SetTraceFile(const std::string& f);
+
+/// See StatManager::Flush
+KATANA_EXPORT void FlushStats();
+
 }  // end namespace katana
 
 #endif
@@ -21,6 +21,7 @@
 #define KATANA_LIBGALOIS_KATANA_TERMINATIONDETECTION_H_
 
 #include <atomic>
+#include <memory>
 
 #include "katana/CacheLineStorage.h"
 #include "katana/PerThreadStorage.h"
@@ -110,6 +111,10 @@ public:
 
 namespace internal {
 void SetTerminationDetection(TerminationDetection* term);
+
+/// Create an instance of the termination detection returned by
+/// GetTerminationDetection for the current thread pool
+std::unique_ptr<TerminationDetection> CreateTerminationDetection();
 }  // end namespace internal
 
 }  // end namespace katana
@@ -51,9 +51,12 @@ struct ExecuteTupleImpl<tpl, s, 0> {
 
 namespace katana {
 
+class ThreadPoolPartition;
+
 class KATANA_EXPORT ThreadPool {
 private:
   friend class GaloisRuntime;
+  friend class ThreadPoolPartition;
 
   struct shutdown_ty {};  //! type for shutting down thread
   struct fastmode_ty {
@@ -71,6 +74,13 @@ private:
     std::atomic<int> done;
     std::atomic<int> fastRelease;
     ThreadTopoInfo topo;
+    //! id of this thread in the system pool; topo.tid is relative to pool
+    unsigned systemTID;
+    //! partition this thread is lent to, or null if it belongs to the
+    //! system pool
+    ThreadPool* pool{nullptr};
+    //! top-level task to run instead of pool work (see runTask)
+    std::function<void(void)>* task{nullptr};
 
     void wakeup(bool fastmode) {
       if (fastmode) {
@@ -101,6 +111,8 @@ private:
   thread_local static per_signal my_box;
 
   MachineTopoInfo mi;
+  //! topology of the threads of this pool, numbered relative to it
+  std::vector<ThreadTopoInfo> threadTopo;
   std::vector<per_signal*> signals;
   std::vector<std::thread> threads;
   unsigned reserved;
@@ -108,6 +120,18 @@ private:
   bool running;
   std::function<void(void)> work;
 
+  //! number of reserved threads running dedicated functions
+  unsigned dedicated{0};
+  //! the partition each thread is lent to, if any
+  std::vector<ThreadPool*> lentTo;
+  //! for a partition, the system pool and the system id of its thread 0
+  ThreadPool* systemPool{nullptr};
+  unsigned systemTIDBase{0};
+  ThreadPoolPartition* partition{nullptr};
+  //! for a partition, the number of threads its loops use; the system pool
+  //! uses katana::activeThreads
+  unsigned partitionActiveThreads{1};
+
   //! destroy all threads
   void destroyCommon();
 
@@ -126,8 +150,17 @@ private:
   //! execute work on num threads
   void runInternal(unsigned num);
 
+  //! run a task that was handed to this thread by runTask
+  void runTaskOnThisThread(per_signal& me);
+
+  //! recompute reserved from dedicated threads and lent threads
+  void updateReserved();
+
   ThreadPool();
 
+  //! create a partition over threads [begin, begin + num) of system_pool
+  ThreadPool(ThreadPool* system_pool, unsigned begin, unsigned num);
+
 public:
   ~ThreadPool();
 
@@ -165,6 +198,11 @@ public:
   //! run function in a dedicated thread until the threadpool exits
   void runDedicated(std::function<void(void)>& f);
 
+  //! run f on thread 0 of a partition and wait for it to finish; f may
+  //! start parallel loops on the partition. Only partitions have a thread 0
+  //! other than the calling thread.
+  void runTask(std::function<void(void)>& f);
+
   // experimental: busy wait for work
   void burnPower(unsigned num);
   // experimental: leave busy wait
@@ -187,20 +225,33 @@ public:
   }
 
   bool isLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader == tid;
+    return threadTopo[tid].socketLeader == tid;
   }
-  unsigned getSocket(unsigned tid) const { return signals[tid]->topo.socket; }
+  unsigned getSocket(unsigned tid) const { return threadTopo[tid].socket; }
   unsigned getLeader(unsigned tid) const {
-    return signals[tid]->topo.socketLeader;
+    return threadTopo[tid].socketLeader;
   }
   unsigned getCumulativeMaxSocket(unsigned tid) const {
-    return signals[tid]->topo.cumulativeMaxSocket;
-  }
-  unsigned getNumaNode(unsigned tid) const {
-    return signals[tid]->topo.numaNode;
+    return threadTopo[tid].cumulativeMaxSocket;
   }
+  unsigned getNumaNode(unsigned tid) const { return threadTopo[tid].numaNode; }
+
+  //! return the system thread id of thread 0 of this pool; thread ids of a
+  //! partition are relative to it
+  unsigned getSystemTIDBase() const { return systemTIDBase; }
+  //! return the partition this pool implements, or null for the system pool
+  ThreadPoolPartition* getPartition() const { return partition; }
+
+  //! return the number of threads loops on this partition use (see
+  //! katana::getActiveThreads)
+  unsigned getActiveThreads() const { return partitionActiveThreads; }
+  void setActiveThreads(unsigned num) { partitionActiveThreads = num; }
+
+  //! return the partition the calling thread is lent to, or null
+  static ThreadPool* getCurrent() { return my_box.pool; }
 
   static unsigned getTID() { return my_box.topo.tid; }
+  static unsigned getSystemTID() { return my_box.systemTID; }
   static bool isLeader() { return my_box.topo.tid == my_box.topo.socketLeader; }
   static unsigned getLeader() { return my_box.topo.socketLeader; }
   static unsigned getSocket() { return my_box.topo.socket; }
@@ -211,7 +262,8 @@ public:
 };
 
 /**
- * return a reference to system thread pool
+ * return a reference to the thread pool of the calling thread: the partition
+ * it is lent to, if any, otherwise the system thread pool
  */
 KATANA_EXPORT ThreadPool& GetThreadPool();
 
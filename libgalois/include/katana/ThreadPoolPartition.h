@@ -0,0 +1,102 @@
+#ifndef KATANA_LIBGALOIS_KATANA_THREADPOOLPARTITION_H_
+#define KATANA_LIBGALOIS_KATANA_THREADPOOLPARTITION_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "katana/Barrier.h"
+#include "katana/Result.h"
+#include "katana/TerminationDetection.h"
+#include "katana/ThreadPool.h"
+#include "katana/config.h"
+
+namespace katana {
+
+/// A ThreadPoolPartition borrows threads from the system thread pool and runs
+/// parallel loops on them independently of the system pool and of other
+/// partitions. A service hosting several graphs can give each concurrent
+/// query its own partition so that queries do not serialize on the system
+/// pool.
+///
+/// Work is submitted with Run, which calls a function on the first thread of
+/// the partition. Within that function GetThreadPool() returns the
+/// partition, so katana::do_all, katana::for_each, etc. run only on the
+/// threads of the partition, using a barrier and termination detection of
+/// their own. Thread ids (ThreadPool::getTID()) and socket ids are relative
+/// to the partition, and PerThreadStorage objects created within Run hold one
+/// element per thread of the partition. Objects created outside of Run, such
+/// as reducers, can still be updated from the partition through getLocal().
+///
+/// Partitions take the highest numbered threads of the system pool that are
+/// not lent yet. System pool threads are bound to cores in socket order (see
+/// HWTopo.h), so partitions occupy disjoint sets of cores, and MakeForSockets
+/// gives a partition whole sockets and their NUMA nodes. Loops started
+/// outside of any partition use at most the threads not lent. Partitions may
+/// only be created and destroyed while no loop runs on the system pool, and
+/// must be destroyed before the system pool is.
+class KATANA_EXPORT ThreadPoolPartition {
+public:
+  /// Borrow num_threads threads. Thread 0 of the system pool is never lent.
+  static Result<std::unique_ptr<ThreadPoolPartition>> Make(
+      unsigned num_threads);
+
+  /// Borrow the threads of the num_sockets highest numbered sockets with
+  /// threads that are not lent yet.
+  static Result<std::unique_ptr<ThreadPoolPartition>> MakeForSockets(
+      unsigned num_sockets);
+
+  ~ThreadPoolPartition();
+
+  ThreadPoolPartition(const ThreadPoolPartition&) = delete;
+  ThreadPoolPartition& operator=(const ThreadPoolPartition&) = delete;
+  ThreadPoolPartition(ThreadPoolPartition&&) = delete;
+  ThreadPoolPartition& operator=(ThreadPoolPartition&&) = delete;
+
+  /// Call fn on the partition and return its result. Loops started by fn use
+  /// all threads of the partition unless fn calls setActiveThreads. Calls
+  /// from different threads run one after the other. Exceptions thrown by fn
+  /// are rethrown to the caller.
+  template <typename Fn>
+  std::invoke_result_t<Fn> Run(Fn&& fn) {
+    using R = std::invoke_result_t<Fn>;
+    if constexpr (std::is_void_v<R>) {
+      RunImpl([&fn]() { fn(); });
+    } else {
+      std::optional<R> result;
+      RunImpl([&fn, &result]() { result.emplace(fn()); });
+      return std::move(*result);
+    }
+  }
+
+  /// The number of threads in the partition
+  unsigned NumThreads() const { return pool_->getMaxThreads(); }
+
+  /// The system thread id of the first thread in the partition
+  unsigned FirstThread() const { return pool_->getSystemTIDBase(); }
+
+  /// The number of sockets the threads of the partition are on
+  unsigned NumSockets() const { return pool_->getMaxSockets(); }
+
+private:
+  friend Barrier& GetBarrier(unsigned);
+  friend TerminationDetection& GetTerminationDetection(unsigned);
+
+  ThreadPoolPartition(unsigned begin, unsigned num);
+
+  void RunImpl(const std::function<void(void)>& fn);
+
+  std::unique_ptr<ThreadPool> pool_;
+  std::mutex run_mutex_;
+
+  std::unique_ptr<Barrier> barrier_;
+  unsigned barrier_threads_{0};
+  std::unique_ptr<TerminationDetection> term_;
+};
+
+}  // namespace katana
+
+#endif
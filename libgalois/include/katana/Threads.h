@@ -34,6 +34,10 @@ KATANA_EXPORT unsigned int setActiveThreads(unsigned int num) noexcept;
 
 /**
  * Returns the number of threads in use.
+ *
+ * Within a thread pool partition (see ThreadPoolPartition.h), this is the
+ * number of the partition, which starts as all of its threads. Elsewhere,
+ * it is the number last set outside of any partition.
  */
 KATANA_EXPORT unsigned int getActiveThreads() noexcept;
 
@@ -22,6 +22,8 @@
 
 #include <chrono>
 
+#include "katana/PerfCounters.h"
+#include "katana/Time.h"
 #include "katana/config.h"
 #include "katana/gstl.h"
 
@@ -59,11 +61,24 @@ public:
 };
 
 //! Galois Timer that automatically reports stats upon destruction
-//! Provides statistic interface around timer
+//! Provides statistic interface around timer. When the StatManager is tracing
+//! (StatManager::SetTraceFile), every start/stop interval is also recorded
+//! as a trace event. When hardware counters are enabled (see PerfCounters),
+//! the events counted by the threads of the current thread pool between
+//! start and stop are reported as well, in the same region under the
+//! categories "Cycles", "Instructions", etc., prefixed by the name of the
+//! timer unless it is the default "Time".
 class KATANA_EXPORT StatTimer : public TimeAccumulator {
   gstl::Str name_;
   gstl::Str region_;
   bool valid_;
+  //! Start of the current interval if it is traced
+  TimePoint trace_start_;
+  //! Hardware events at the start of the current interval and in total
+  PerfCounters::Sample perf_start_{};
+  PerfCounters::Sample perf_total_{};
+  bool perf_started_{false};
+  bool perf_counted_{false};
 
 public:
   StatTimer(const char* name, const char* region);
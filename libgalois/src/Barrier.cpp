@@ -21,6 +21,7 @@
 
 #include "katana/Logging.h"
 #include "katana/ThreadPool.h"
+#include "katana/ThreadPoolPartition.h"
 
 // anchor vtable
 katana::Barrier::~Barrier() = default;
@@ -43,11 +44,20 @@ katana::internal::SetBarrier(katana::Barrier* barrier) {
 
 katana::Barrier&
 katana::GetBarrier(unsigned active_threads) {
-  KATANA_LOG_VASSERT(kBarrier, "Barrier not initialized");
-  active_threads =
-      std::min(active_threads, GetThreadPool().getMaxUsableThreads());
+  auto& tp = GetThreadPool();
+  active_threads = std::min(active_threads, tp.getMaxUsableThreads());
   active_threads = std::max(active_threads, 1U);
 
+  if (ThreadPoolPartition* partition = tp.getPartition()) {
+    if (active_threads != partition->barrier_threads_) {
+      partition->barrier_threads_ = active_threads;
+      partition->barrier_->Reinit(active_threads);
+    }
+    return *partition->barrier_;
+  }
+
+  KATANA_LOG_VASSERT(kBarrier, "Barrier not initialized");
+
   if (active_threads != kBarrierThreads) {
     kBarrierThreads = active_threads;
     kBarrier->Reinit(kBarrierThreads);
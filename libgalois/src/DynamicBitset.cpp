@@ -124,24 +124,37 @@ katana::DynamicBitset::SerialCount() const {
 }
 
 namespace {
+/// The word of bitset at index w, without any bits past the end of the
+/// bitset (which bitwise_not sets)
+uint64_t
+WordAt(const katana::DynamicBitset& bitset, size_t w) {
+  constexpr size_t kBits = katana::DynamicBitset::kNumBitsInUint64;
+  uint64_t word = bitset.get_vec()[w];
+  size_t end = bitset.size() - w * kBits;
+  if (end < kBits) {
+    word &= (uint64_t{1} << end) - 1;
+  }
+  return word;
+}
+
 template <typename Integer>
 void
 ComputeOffsets(
     const katana::DynamicBitset& bitset, std::vector<Integer>* offsets) {
+  constexpr size_t kBits = katana::DynamicBitset::kNumBitsInUint64;
   // TODO uint32_t is somewhat dangerous; change in the future
   uint32_t activeThreads = katana::getActiveThreads();
   std::vector<Integer> tPrefixBitCounts(activeThreads);
+  size_t num_words = bitset.get_vec().size();
 
-  // count how many bits are set on each thread
+  // count how many bits are set on each thread, a word at a time
   katana::on_each([&](unsigned tid, unsigned nthreads) {
     auto [start, end] =
-        katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
+        katana::block_range(size_t{0}, num_words, tid, nthreads);
 
     Integer count = 0;
-    for (Integer i = start; i < end; ++i) {
-      if (bitset.test(i)) {
-        ++count;
-      }
+    for (size_t w = start; w < end; ++w) {
+      count += __builtin_popcountll(WordAt(bitset, w));
     }
 
     tPrefixBitCounts[tid] = count;
@@ -162,15 +175,16 @@ ComputeOffsets(
     offsets->resize(cur_size + bitsetCount);
     katana::on_each([&](unsigned tid, unsigned nthreads) {
       auto [start, end] =
-          katana::block_range(size_t{0}, bitset.size(), tid, nthreads);
+          katana::block_range(size_t{0}, num_words, tid, nthreads);
       Integer index = cur_size;
       if (tid != 0) {
         index += tPrefixBitCounts[tid - 1];
       }
 
-      for (Integer i = start; i < end; ++i) {
-        if (bitset.test(i)) {
-          offsets->at(index) = i;
+      for (size_t w = start; w < end; ++w) {
+        // visit the set bits of the word from lowest to highest
+        for (uint64_t word = WordAt(bitset, w); word != 0; word &= word - 1) {
+          (*offsets)[index] = w * kBits + __builtin_ctzll(word);
           ++index;
         }
       }
@@ -22,7 +22,10 @@
 #include <memory>
 
 #include "katana/Barrier.h"
+#include "katana/Env.h"
+#include "katana/Logging.h"
 #include "katana/PagePool.h"
+#include "katana/PerfCounters.h"
 #include "katana/Statistics.h"
 #include "katana/TerminationDetection.h"
 #include "katana/ThreadPool.h"
@@ -205,12 +208,18 @@ public:
 
 }  // namespace
 
+std::unique_ptr<katana::TerminationDetection>
+katana::internal::CreateTerminationDetection() {
+  return std::make_unique<LocalTerminationDetection>();
+}
+
 struct katana::GaloisRuntime::Impl {
   struct Dependents {
     LocalTerminationDetection term;
     std::unique_ptr<Barrier> barrier;
     internal::PageAllocState<> page_pool;
     katana::StatManager stat_manager;
+    std::unique_ptr<PerfCounters> perf_counters;
   };
 
   ThreadPool thread_pool;
@@ -230,9 +239,19 @@ katana::GaloisRuntime::GaloisRuntime() : impl_(std::make_unique<Impl>()) {
   internal::SetTerminationDetection(&impl_->deps->term);
   internal::setPagePoolState(&impl_->deps->page_pool);
   katana::internal::setSysStatManager(&impl_->deps->stat_manager);
+
+  if (GetEnv("KATANA_PERF_COUNTERS")) {
+    if (auto res = PerfCounters::Make(); !res) {
+      KATANA_LOG_WARN("hardware counters disabled: {}", res.error());
+    } else {
+      impl_->deps->perf_counters = std::move(res.value());
+      internal::SetPerfCounters(impl_->deps->perf_counters.get());
+    }
+  }
 }
 
 katana::GaloisRuntime::~GaloisRuntime() {
+  internal::SetPerfCounters(nullptr);
   katana::PrintStats();
   katana::internal::setSysStatManager(nullptr);
   internal::setPagePoolState(nullptr);
@@ -1,5 +1,13 @@
 #include "katana/MemorySupervisor.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <iomanip>
+#include <optional>
+#include <vector>
+
+#include "katana/Env.h"
 #include "katana/ProgressTracer.h"
 #include "katana/Time.h"
 
@@ -13,9 +21,48 @@ getTotalSystemMemory() {
   return pages * page_size;
 }
 
+/// Parse a byte count such as 4096, 512M or 2G
+std::optional<count_t>
+ParseBytes(const std::string& str) {
+  char* end = nullptr;
+  errno = 0;
+  long long val = std::strtoll(str.c_str(), &end, 10);
+  if (errno != 0 || end == str.c_str() || val <= 0) {
+    return std::nullopt;
+  }
+  int shift = 0;
+  switch (*end) {
+  case '\0':
+    break;
+  case 'k':
+  case 'K':
+    shift = 10;
+    break;
+  case 'm':
+  case 'M':
+    shift = 20;
+    break;
+  case 'g':
+  case 'G':
+    shift = 30;
+    break;
+  case 't':
+  case 'T':
+    shift = 40;
+    break;
+  default:
+    return std::nullopt;
+  }
+  if (*end != '\0' && *(end + 1) != '\0') {
+    return std::nullopt;
+  }
+  return static_cast<count_t>(val) << shift;
+}
+
 const std::string sanity_str = "memory manager sanity";
 const std::string oversubscribed_str = "memory manager oversubscribed";
 const std::string unregister_str = "memory manager unregister";
+const std::string reclaim_str = "memory manager reclaim";
 }  // anonymous namespace
 
 void
@@ -60,6 +107,15 @@ katana::MemorySupervisor::MemorySupervisor() {
       (uint64_t)(0.9 * physical_),
       (uint64_t)2 * ((uint64_t)1024 * (uint64_t)1024 * (uint64_t)1024));
   physical_ -= os_and_overhead;
+  if (std::string budget_str; GetEnv("KATANA_MEMORY_BUDGET", &budget_str)) {
+    if (auto budget = ParseBytes(budget_str); budget) {
+      physical_ = budget.value();
+    } else {
+      KATANA_LOG_WARN(
+          "ignoring malformed KATANA_MEMORY_BUDGET {}",
+          std::quoted(budget_str));
+    }
+  }
   auto& tracer = katana::GetTracer();
   tracer.GetActiveSpan().Log(
       "memory manager",
@@ -109,16 +165,20 @@ katana::MemorySupervisor::CheckRegistered(Manager* manager) {
 
 void
 katana::MemorySupervisor::Register(Manager* manager) {
+  std::lock_guard<std::mutex> lock(mutex_);
   managers_[manager] = ManagerInfo();
 }
 
 void
 katana::MemorySupervisor::Unregister(Manager* manager) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  // A reclaim in progress may still call the manager
+  reclaim_done_.wait(lock, [this]() { return num_reclaiming_ == 0; });
   if (!CheckRegistered(manager)) {
     return;
   }
   auto& info = managers_.at(manager);
-  if (info.active > 0 || info.standby > 0) {
+  if (info.active > 0) {
     KATANA_LOG_WARN(
         "Unregister for manager {} with active {} standby {}\n",
         std::quoted(manager->MemoryCategory()), info.active, info.standby);
@@ -130,36 +190,79 @@ katana::MemorySupervisor::Unregister(Manager* manager) {
 }
 
 void
-katana::MemorySupervisor::ReclaimMemory(count_t goal) {
+katana::MemorySupervisor::ReclaimMemory(
+    count_t goal, std::unique_lock<std::mutex>* lock) {
+  // Managers holding the most standby memory give it up first. Each manager
+  // frees its own least recently used memory first.
+  std::vector<std::pair<Manager*, count_t>> order;
+  for (const auto& [manager, info] : managers_) {
+    if (info.standby > 0) {
+      order.emplace_back(manager, info.standby);
+    }
+  }
+  std::sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+    return a.second > b.second;
+  });
+
+  // Managers free memory without the lock held, since they take locks of
+  // their own that may be held while calling into the supervisor.
+  // Unregister waits for this reclaim, so the managers outlive the calls.
+  ++num_reclaiming_;
+  lock->unlock();
+  std::vector<count_t> freed(order.size());
   count_t reclaimed = 0;
-  // TODO(witchel) reclaim in proportion to current use
-  for (auto& [manager, info] : managers_) {
-    auto got = manager->FreeStandbyMemory(goal - reclaimed);
-    StandbyMinus(info, got);
-    reclaimed += got;
-    if (reclaimed >= goal)
-      break;
+  for (size_t i = 0; i < order.size() && reclaimed < goal; ++i) {
+    freed[i] = order[i].first->FreeStandbyMemory(goal - reclaimed);
+    reclaimed += freed[i];
+  }
+  lock->lock();
+  for (size_t i = 0; i < order.size(); ++i) {
+    StandbyMinus(managers_.at(order[i].first), freed[i]);
+  }
+  if (--num_reclaiming_ == 0) {
+    reclaim_done_.notify_all();
+  }
+
+  reclaim_stats_.num_reclaims++;
+  reclaim_stats_.bytes_requested += goal;
+  reclaim_stats_.bytes_reclaimed += reclaimed;
+  katana::GetTracer().GetActiveSpan().Log(
+      reclaim_str, {
+                       {"goal", goal},
+                       {"reclaimed", reclaimed},
+                       {"active", active_},
+                       {"standby", standby_},
+                   });
+}
+
+void
+katana::MemorySupervisor::ReclaimOversubscribed(
+    std::unique_lock<std::mutex>* lock) {
+  if (!MemoryOversubscribed()) {
+    return;
+  }
+  ReclaimMemory(Used() - physical_, lock);
+  if (MemoryOversubscribed()) {
+    // TODO (witchel) explore policies where we kill ourselves before OOM
+    reclaim_stats_.num_oversubscribed++;
+    LogState(oversubscribed_str);
   }
 }
 
 void
 katana::MemorySupervisor::BorrowActive(Manager* manager, count_t bytes) {
+  std::unique_lock<std::mutex> lock(mutex_);
   if (!CheckRegistered(manager)) {
     return;
   }
   auto& info = managers_.at(manager);
   ActivePlus(info, bytes);
-  if (MemoryOversubscribed()) {
-    ReclaimMemory(bytes);
-    if (MemoryOversubscribed()) {
-      // TODO (witchel) explore policies where we kill ourselves before OOM
-      LogState(oversubscribed_str);
-    }
-  }
+  ReclaimOversubscribed(&lock);
 }
 
 count_t
 katana::MemorySupervisor::BorrowStandby(Manager* manager, count_t goal) {
+  std::lock_guard<std::mutex> lock(mutex_);
   if (!CheckRegistered(manager)) {
     return 0;
   }
@@ -176,6 +279,7 @@ katana::MemorySupervisor::BorrowStandby(Manager* manager, count_t goal) {
 
 void
 katana::MemorySupervisor::ReturnActive(Manager* manager, count_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
   if (!CheckRegistered(manager)) {
     return;
   }
@@ -185,6 +289,7 @@ katana::MemorySupervisor::ReturnActive(Manager* manager, count_t bytes) {
 
 void
 katana::MemorySupervisor::ReturnStandby(Manager* manager, count_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
   if (!CheckRegistered(manager)) {
     return;
   }
@@ -194,21 +299,20 @@ katana::MemorySupervisor::ReturnStandby(Manager* manager, count_t bytes) {
 
 count_t
 katana::MemorySupervisor::ActiveToStandby(Manager* manager, count_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
   if (!CheckRegistered(manager)) {
     return 0;
   }
   auto& info = managers_.at(manager);
   ActiveMinus(info, bytes);
-  if (MemoryOversubscribed()) {
-    auto grant = std::min(bytes, Available());
-    StandbyPlus(info, grant);
-    return grant;
-  }
-  return bytes;
+  auto grant = std::clamp<count_t>(Available(), 0, bytes);
+  StandbyPlus(info, grant);
+  return grant;
 }
 
 void
 katana::MemorySupervisor::StandbyToActive(Manager* manager, count_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
   if (!CheckRegistered(manager)) {
     return;
   }
@@ -216,3 +320,38 @@ katana::MemorySupervisor::StandbyToActive(Manager* manager, count_t bytes) {
   ActivePlus(info, bytes);
   StandbyMinus(info, bytes);
 }
+
+void
+katana::MemorySupervisor::SetMemoryBudget(count_t bytes) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  physical_ = bytes;
+  katana::GetTracer().GetActiveSpan().Log(
+      "memory manager budget",
+      {{"physical", physical_},
+       {"physical_human", katana::BytesToStr("{:.2f}{}", physical_)}});
+  ReclaimOversubscribed(&lock);
+}
+
+count_t
+katana::MemorySupervisor::GetMemoryBudget() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return physical_;
+}
+
+count_t
+katana::MemorySupervisor::GetActive() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return active_;
+}
+
+count_t
+katana::MemorySupervisor::GetStandby() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return standby_;
+}
+
+katana::MemorySupervisor::ReclaimStats
+katana::MemorySupervisor::GetReclaimStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return reclaim_stats_;
+}
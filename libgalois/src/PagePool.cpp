@@ -53,7 +53,7 @@ katana::pagePoolPreAlloc(unsigned num) {
 
 void
 katana::pagePoolEnsurePreallocated(unsigned num) {
-  auto tid = katana::ThreadPool::getTID();
+  auto tid = katana::ThreadPool::getSystemTID();
   while (PA->freeCount(tid) < num) {
     PA->pagePreAlloc();
   }
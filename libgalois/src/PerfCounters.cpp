@@ -0,0 +1,221 @@
+#include "katana/PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <mutex>
+
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/ThreadPool.h"
+
+namespace {
+
+katana::PerfCounters* perf_counters;
+
+constexpr const char* kEventNames[katana::kNumPerfEvents] = {
+    "Cycles", "Instructions", "LLCMisses", "BranchMisses", "DTLBMisses",
+};
+
+#ifdef __linux__
+
+perf_event_attr
+EventAttr(size_t event) {
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  switch (static_cast<katana::PerfEvent>(event)) {
+  case katana::PerfEvent::kCycles:
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    break;
+  case katana::PerfEvent::kInstructions:
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    break;
+  case katana::PerfEvent::kLLCMisses:
+    // The generic cache miss event counts last level cache misses on most
+    // processors
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    break;
+  case katana::PerfEvent::kBranchMisses:
+    attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+    break;
+  case katana::PerfEvent::kDTLBMisses:
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    break;
+  }
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                     PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return attr;
+}
+
+int
+OpenEvent(size_t event, int group_fd) {
+  perf_event_attr attr = EventAttr(event);
+  // pid 0 and cpu -1 count the calling thread on any CPU
+  return syscall(
+      SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+}
+
+#endif
+
+}  // namespace
+
+katana::Result<void>
+katana::PerfCounters::OpenLocal(ThreadCounters* counters) {
+#ifdef __linux__
+  for (size_t i = 0; i < kNumPerfEvents; ++i) {
+    if (!available_[i]) {
+      continue;
+    }
+    int fd = OpenEvent(i, counters->leader_fd);
+    if (fd < 0) {
+      return KATANA_ERROR(
+          ResultErrno(), "opening counter for {} on thread {}", kEventNames[i],
+          ThreadPool::getSystemTID());
+    }
+    if (counters->leader_fd < 0) {
+      counters->leader_fd = fd;
+    }
+    counters->fds.emplace_back(fd);
+  }
+  return ResultSuccess();
+#else
+  (void)counters;
+  return KATANA_ERROR(
+      ErrorCode::NotImplemented, "hardware counters require Linux");
+#endif
+}
+
+katana::Result<std::unique_ptr<katana::PerfCounters>>
+katana::PerfCounters::Make() {
+#ifdef __linux__
+  std::unique_ptr<PerfCounters> counters(new PerfCounters());
+  ThreadPool& pool = GetThreadPool();
+  KATANA_LOG_VASSERT(
+      pool.getPartition() == nullptr && ThreadPool::getSystemTID() == 0,
+      "PerfCounters must be made on thread 0 of the system pool");
+  counters->threads_.resize(pool.getMaxThreads());
+
+  // Find the events this machine can count by opening them on this thread
+  ThreadCounters& local = counters->threads_[0];
+  for (size_t i = 0; i < kNumPerfEvents; ++i) {
+    int fd = OpenEvent(i, local.leader_fd);
+    counters->available_[i] = fd >= 0;
+    if (fd < 0) {
+      KATANA_LOG_VERBOSE(
+          "hardware event {} is not available: {}", kEventNames[i],
+          ResultErrno().message());
+      continue;
+    }
+    if (local.leader_fd < 0) {
+      local.leader_fd = fd;
+    }
+    local.fds.emplace_back(fd);
+  }
+  if (local.leader_fd < 0) {
+    return KATANA_ERROR(
+        ErrorCode::FeatureNotEnabled,
+        "no hardware event can be counted; check "
+        "/proc/sys/kernel/perf_event_paranoid");
+  }
+
+  std::mutex error_mutex;
+  Result<void> error = ResultSuccess();
+  pool.run(pool.getMaxUsableThreads(), [&]() {
+    unsigned tid = ThreadPool::getSystemTID();
+    if (tid == 0) {
+      return;
+    }
+    if (auto res = counters->OpenLocal(&counters->threads_[tid]); !res) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      error = res.error();
+    }
+  });
+  if (!error) {
+    return error.error();
+  }
+
+  return std::unique_ptr<PerfCounters>(std::move(counters));
+#else
+  return KATANA_ERROR(
+      ErrorCode::NotImplemented, "hardware counters require Linux");
+#endif
+}
+
+katana::PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  for (const ThreadCounters& counters : threads_) {
+    for (int fd : counters.fds) {
+      close(fd);
+    }
+  }
+#endif
+}
+
+void
+katana::PerfCounters::ReadThread(
+    const ThreadCounters& counters, Sample* sample) const {
+#ifdef __linux__
+  if (counters.leader_fd < 0) {
+    return;
+  }
+  // nr, time enabled, time running, then one value per event of the group
+  uint64_t buf[3 + kNumPerfEvents];
+  if (read(counters.leader_fd, buf, sizeof(buf)) < 0) {
+    KATANA_WARN_ONCE("reading hardware counters: {}", ResultErrno().message());
+    return;
+  }
+  uint64_t enabled = buf[1];
+  uint64_t running = buf[2];
+  const uint64_t* value = &buf[3];
+  for (size_t i = 0; i < kNumPerfEvents; ++i) {
+    if (!available_[i]) {
+      continue;
+    }
+    uint64_t v = *value++;
+    // Scale counts up if the kernel multiplexed the counters
+    if (running > 0 && running < enabled) {
+      v = static_cast<uint64_t>(static_cast<double>(v) * enabled / running);
+    }
+    (*sample)[i] += v;
+  }
+#else
+  (void)counters;
+  (void)sample;
+#endif
+}
+
+katana::PerfCounters::Sample
+katana::PerfCounters::Read() const {
+  Sample sample{};
+  const ThreadPool& pool = GetThreadPool();
+  unsigned begin = pool.getSystemTIDBase();
+  unsigned end = begin + pool.getMaxUsableThreads();
+  for (unsigned t = begin; t < end && t < threads_.size(); ++t) {
+    ReadThread(threads_[t], &sample);
+  }
+  return sample;
+}
+
+const char*
+katana::PerfCounters::Name(PerfEvent e) {
+  return kEventNames[static_cast<size_t>(e)];
+}
+
+void
+katana::internal::SetPerfCounters(PerfCounters* counters) {
+  perf_counters = counters;
+}
+
+katana::PerfCounters*
+katana::internal::GetPerfCounters() {
+  return perf_counters;
+}
@@ -21,17 +21,26 @@ katana::PropertyManager::MakePropertyCache() {
       });
 }
 
-katana::PropertyManager::PropertyManager() { MakePropertyCache(); }
-katana::PropertyManager::~PropertyManager() { cache_.reset(); }
+katana::PropertyManager::PropertyManager() {
+  MakePropertyCache();
+  MemorySupervisor::Get().Register(this);
+}
 
-// TODO(witchel) should return a bool or the property table to caller
-void
+katana::PropertyManager::~PropertyManager() {
+  // Unregistering releases what the cache holds and waits for reclaims that
+  // may be freeing from it, so the cache is destroyed after
+  MemorySupervisor::Get().Unregister(this);
+  cache_.reset();
+}
+
+std::optional<std::shared_ptr<arrow::Table>>
 katana::PropertyManager::AddProperty(const katana::Uri& property_path) {
   auto property = cache_->GetAndEvict(property_path);
   if (property.has_value()) {
     auto bytes = katana::ApproxTableMemUse(property.value());
     MemorySupervisor::Get().StandbyToActive(this, bytes);
   }
+  return property;
 }
 
 void
@@ -42,29 +51,37 @@ katana::PropertyManager::PropertyLoadedCallback(
   MemorySupervisor::Get().BorrowActive(this, bytes);
 }
 
+void
+katana::PropertyManager::PropertyUnloadedCallback(
+    const std::shared_ptr<arrow::Table>& property) {
+  KATANA_LOG_DEBUG_ASSERT(property);
+  auto bytes = katana::ApproxTableMemUse(property);
+  MemorySupervisor::Get().ReturnActive(this, bytes);
+}
+
 void
 katana::PropertyManager::UnloadProperty(
     const katana::Uri& property_path,
     const std::shared_ptr<arrow::Table>& property) {
-  auto bytes = katana::ApproxTableMemUse(property);
+  auto bytes = static_cast<count_t>(katana::ApproxTableMemUse(property));
+  // Insert before accounting, so that standby memory the supervisor knows
+  // about is always in the cache for a reclaim to free
+  cache_->Insert(property_path, property);
   auto granted = MemorySupervisor::Get().ActiveToStandby(this, bytes);
-  if (granted >= static_cast<count_t>(bytes)) {
-    cache_->Insert(property_path, property);
-  } else {
-    MemorySupervisor::Get().ReturnActive(this, bytes);
+  if (granted < bytes) {
+    // Not enough room to keep the whole property; drop it. If a reclaim
+    // dropped it first, the reclaim already took all of its bytes out of
+    // standby, including the ones that were not granted.
+    auto dropped = cache_->GetAndEvict(property_path);
+    MemorySupervisor::Get().ReturnStandby(
+        this, dropped.has_value() ? granted : granted - bytes);
   }
 }
 
+// Called by the MemorySupervisor, which does the accounting for what we free
 katana::count_t
 katana::PropertyManager::FreeStandbyMemory(count_t goal) {
-  count_t total = 0;
-  if (goal >= static_cast<count_t>(cache_->size())) {
-    total = static_cast<count_t>(cache_->size());
-    MemorySupervisor::Get().ReturnStandby(this, total);
-    cache_->clear();
-  } else {
-    total = cache_->Reclaim(goal);
-    MemorySupervisor::Get().ReturnStandby(this, total);
-  }
-  return total;
+  // Reclaim rather than clear, even when asked for everything, so the count
+  // is exact when other threads are using the cache
+  return static_cast<count_t>(cache_->Reclaim(goal));
 }
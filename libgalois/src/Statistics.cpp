@@ -21,15 +21,21 @@
 
 #include <sys/resource.h>
 #include <sys/time.h>
+#include <unistd.h>
 
+#include <atomic>
+#include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 
+#include <nlohmann/json.hpp>
+
 #include "katana/Env.h"
 #include "katana/Executor_OnEach.h"
 #include "katana/Logging.h"
 #include "katana/PerThreadStorage.h"
+#include "katana/ProgressTracer.h"
 
 namespace {
 
@@ -45,6 +51,50 @@ PrintHeader(std::ostream& out, const char* sep) {
   out << "\n";
 }
 
+std::string
+ToString(const katana::gstl::Str& s) {
+  return std::string(s.begin(), s.end());
+}
+
+nlohmann::ordered_json
+ToJSON(const katana::gstl::Str& s) {
+  return ToString(s);
+}
+
+template <typename T>
+nlohmann::ordered_json
+ToJSON(const T& v) {
+  return v;
+}
+
+/// Write contents to path through a temporary file, so that readers never
+/// see a partially written file
+void
+ReplaceFile(const std::string& path, const std::string& contents) {
+  std::string tmp_path = path + ".tmp";
+  std::ofstream ofs(tmp_path);
+  if (!ofs.is_open()) {
+    KATANA_LOG_ERROR("opening {}", tmp_path);
+    return;
+  }
+  ofs << contents;
+  ofs.close();
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    KATANA_LOG_ERROR("renaming {} to {}", tmp_path, path);
+  }
+}
+
+struct TraceEvent {
+  /// "X" (complete), "i" (instant) or "C" (counter)
+  char phase;
+  std::string name;
+  std::string category;
+  int64_t timestamp_us;
+  int64_t duration_us;
+  unsigned tid;
+  std::vector<std::pair<std::string, int64_t>> args;
+};
+
 template <typename T>
 struct StatImpl {
   using MergedStats = katana::internal::VecStatManager<T>;
@@ -66,25 +116,50 @@ struct StatImpl {
     perThreadManagers_.getLocal()->addToStat(region, category, val, type);
   }
 
-  void Merge() {
-    if (merged_) {
-      return;
-    }
-
+  void MergeInto(MergedStats* result) const {
     for (unsigned t = 0; t < perThreadManagers_.size(); ++t) {
       const auto* manager = perThreadManagers_.getRemote(t);
 
       for (auto i = manager->cbegin(), end_i = manager->cend(); i != end_i;
            ++i) {
-        result_.addToStat(
+        result->addToStat(
             manager->region(i), manager->category(i), T(manager->stat(i)),
             manager->stat(i).totalTy());
       }
     }
+  }
 
+  void Merge() {
+    if (merged_) {
+      return;
+    }
+    MergeInto(&result_);
     merged_ = true;
   }
 
+  /// Append the stats to the JSON array out. Works on a fresh merge so that
+  /// it can be called repeatedly while stats are still being added.
+  void PrintJSON(nlohmann::ordered_json* out) const {
+    MergedStats merged;
+    MergeInto(&merged);
+
+    for (auto i = merged.cbegin(), end_i = merged.cend(); i != end_i; ++i) {
+      const auto& s = merged.stat(i);
+      nlohmann::ordered_json values = nlohmann::ordered_json::array();
+      for (const auto& v : s.values()) {
+        values.push_back(ToJSON(v));
+      }
+      out->push_back({
+          {"kind", StatKind()},
+          {"region", ToString(merged.region(i))},
+          {"category", ToString(merged.category(i))},
+          {"total_type", katana::StatTotal::str(s.totalTy())},
+          {"total", ToJSON(s.total())},
+          {"thread_values", std::move(values)},
+      });
+    }
+  }
+
   void Read(
       const_iterator i, katana::gstl::Str& region, katana::gstl::Str& category,
       T& total, katana::StatTotal::Type& type,
@@ -134,17 +209,154 @@ public:
   StatImpl<double> fp_stats_;
   StatImpl<Str> str_stats_;
   std::string outfile_;
+  std::string json_file_;
+
+  std::string trace_file_;
+  katana::PerThreadStorage<std::vector<TraceEvent>> trace_events_;
+  katana::TimePoint trace_begin_{katana::Now()};
+  /// Number of events written to trace_file_ so far
+  uint64_t trace_events_written_{};
+
+  void AddTraceEvent(TraceEvent&& event) {
+    event.tid = katana::ThreadPool::getSystemTID();
+    trace_events_.getLocal()->emplace_back(std::move(event));
+  }
+
+  int64_t SinceBegin(const katana::TimePoint& t) const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               t - trace_begin_)
+        .count();
+  }
+
+  void FlushTrace(bool close);
 };
 
-katana::StatManager::StatManager() { impl_ = std::make_unique<Impl>(); }
+void
+katana::StatManager::Impl::FlushTrace(bool close) {
+  std::ofstream ofs(
+      trace_file_, trace_events_written_ == 0 ? std::ios::trunc
+                                              : std::ios::app);
+  if (!ofs.is_open()) {
+    KATANA_LOG_ERROR("opening trace file {}", trace_file_);
+    return;
+  }
+  if (trace_events_written_ == 0) {
+    ofs << "[\n";
+  }
+
+  int64_t pid = getpid();
+  for (unsigned t = 0; t < trace_events_.size(); ++t) {
+    auto* events = trace_events_.getRemote(t);
+    for (const TraceEvent& e : *events) {
+      nlohmann::ordered_json args = nlohmann::ordered_json::object();
+      for (const auto& [key, value] : e.args) {
+        args[key] = value;
+      }
+      nlohmann::ordered_json j{
+          {"name", e.name},
+          {"cat", e.category},
+          {"ph", std::string(1, e.phase)},
+          {"ts", e.timestamp_us},
+          {"pid", pid},
+          {"tid", e.tid},
+      };
+      if (e.phase == 'X') {
+        j["dur"] = e.duration_us;
+      } else if (e.phase == 'i') {
+        j["s"] = "t";
+      }
+      j["args"] = std::move(args);
+
+      // Separators precede events so that the file is a valid (unterminated)
+      // trace after every flush
+      if (trace_events_written_++ > 0) {
+        ofs << ",\n";
+      }
+      ofs << j.dump();
+    }
+    events->clear();
+  }
+
+  if (close) {
+    ofs << "\n]\n";
+  }
+}
+
+katana::StatManager::StatManager() {
+  impl_ = std::make_unique<Impl>();
 
-katana::StatManager::~StatManager() = default;
+  if (std::string f; GetEnv("KATANA_STAT_JSON_FILE", &f)) {
+    SetJSONFile(f);
+  }
+  if (std::string f; GetEnv("KATANA_TRACE_FILE", &f)) {
+    SetTraceFile(f);
+  }
+}
+
+katana::StatManager::~StatManager() {
+  if (tracing_) {
+    ProgressTracer::SetSpanListener(nullptr);
+  }
+}
 
 void
 katana::StatManager::SetStatFile(const std::string& outfile) {
   impl_->outfile_ = outfile;
 }
 
+void
+katana::StatManager::SetJSONFile(const std::string& outfile) {
+  impl_->json_file_ = outfile;
+}
+
+void
+katana::StatManager::SetTraceFile(const std::string& outfile) {
+  KATANA_LOG_VASSERT(
+      impl_->trace_events_written_ == 0,
+      "trace file set after trace events were written");
+  impl_->trace_file_ = outfile;
+  tracing_ = !outfile.empty();
+
+  if (tracing_) {
+    ProgressTracer::SetSpanListener(
+        [this](
+            const std::string& span_name, const TimePoint& start,
+            const TimePoint& finish) {
+          AddTraceSpan(span_name, "ProgressTracer", start, finish);
+        });
+  } else {
+    ProgressTracer::SetSpanListener(nullptr);
+  }
+}
+
+void
+katana::StatManager::AddTraceSpan(
+    const std::string& name, const std::string& category,
+    const TimePoint& start, const TimePoint& finish) {
+  impl_->AddTraceEvent(TraceEvent{
+      'X', name, category, impl_->SinceBegin(start),
+      std::chrono::duration_cast<std::chrono::microseconds>(finish - start)
+          .count(),
+      0, {}});
+}
+
+void
+katana::StatManager::AddTraceInstant(
+    const std::string& name, const std::string& category,
+    std::vector<std::pair<std::string, int64_t>> args) {
+  impl_->AddTraceEvent(TraceEvent{
+      'i', name, category, impl_->SinceBegin(Now()), 0, 0, std::move(args)});
+}
+
+void
+katana::StatManager::AddTraceCounter(
+    const std::string& name,
+    std::vector<std::pair<std::string, int64_t>> series) {
+  impl_->AddTraceEvent(TraceEvent{
+      'C', name, "Counter", impl_->SinceBegin(Now()), 0, 0,
+      std::move(series)});
+}
+
 bool
 katana::StatManager::IsPrintingThreadVals() const {
   return CheckPrintingThreadVals();
@@ -165,6 +377,16 @@ katana::StatManager::PrintStats(std::ostream& out) {
   impl_->str_stats_.Print(out, kSep, kThreadSep, kThreadNameSep);
 }
 
+void
+katana::StatManager::PrintJSON(std::ostream& out) {
+  nlohmann::ordered_json stats = nlohmann::ordered_json::array();
+  impl_->int_stats_.PrintJSON(&stats);
+  impl_->fp_stats_.PrintJSON(&stats);
+  impl_->str_stats_.PrintJSON(&stats);
+
+  out << nlohmann::ordered_json{{"stats", std::move(stats)}}.dump(2) << "\n";
+}
+
 auto
 katana::StatManager::int_cbegin() const -> int_const_iterator {
   return impl_->int_stats_.result_.cbegin();
@@ -246,8 +468,32 @@ katana::StatManager::AddParam(
       gstl::makeStr(region), gstl::makeStr(category), val, StatTotal::SINGLE);
 }
 
+void
+katana::StatManager::Flush() {
+  if (!impl_->json_file_.empty()) {
+    std::ostringstream out;
+    PrintJSON(out);
+    ReplaceFile(impl_->json_file_, out.str());
+  }
+  if (tracing_) {
+    impl_->FlushTrace(false);
+  }
+}
+
 void
 katana::StatManager::Print() {
+  if (!impl_->json_file_.empty()) {
+    std::ostringstream out;
+    PrintJSON(out);
+    ReplaceFile(impl_->json_file_, out.str());
+  }
+  if (tracing_) {
+    impl_->FlushTrace(true);
+    // Events recorded from now on would follow the closing bracket
+    tracing_ = false;
+    ProgressTracer::SetSpanListener(nullptr);
+  }
+
   if (impl_->outfile_.empty()) {
     return PrintStats(std::cout);
   }
@@ -288,18 +534,41 @@ katana::SetStatFile(const std::string& f) {
   internal::sysStatManager()->SetStatFile(f);
 }
 
+void
+katana::SetStatJSONFile(const std::string& f) {
+  internal::sysStatManager()->SetJSONFile(f);
+}
+
+void
+katana::SetTraceFile(const std::string& f) {
+  internal::sysStatManager()->SetTraceFile(f);
+}
+
 void
 katana::PrintStats() {
   internal::sysStatManager()->Print();
 }
 
+void
+katana::FlushStats() {
+  internal::sysStatManager()->Flush();
+}
+
 void
 katana::reportPageAlloc(const char* category) {
+  std::atomic<int64_t> total{0};
   katana::on_each_gen(
-      [category](unsigned int tid, unsigned int) {
-        ReportStatSum("PageAlloc", category, numPagePoolAllocForThread(tid));
+      [category, &total](unsigned int, unsigned int) {
+        int64_t num_pages =
+            numPagePoolAllocForThread(ThreadPool::getSystemTID());
+        ReportStatSum("PageAlloc", category, num_pages);
+        total += num_pages;
       },
       std::make_tuple());
+
+  if (auto* sm = internal::sysStatManager(); sm && sm->IsTracing()) {
+    sm->AddTraceCounter("PageAlloc", {{category, total}});
+  }
 }
 
 void
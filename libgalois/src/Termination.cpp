@@ -19,6 +19,7 @@
 
 #include "katana/Logging.h"
 #include "katana/TerminationDetection.h"
+#include "katana/ThreadPoolPartition.h"
 
 // vtable anchoring
 katana::TerminationDetection::~TerminationDetection() = default;
@@ -35,6 +36,10 @@ katana::internal::SetTerminationDetection(katana::TerminationDetection* t) {
 
 katana::TerminationDetection&
 katana::GetTerminationDetection(unsigned active_threads) {
+  if (ThreadPoolPartition* partition = GetThreadPool().getPartition()) {
+    partition->term_->Init(active_threads);
+    return *partition->term_;
+  }
   kTerminationDetection->Init(active_threads);
   return *kTerminationDetection;
 }
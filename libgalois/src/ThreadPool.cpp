@@ -39,11 +39,14 @@ using katana::ThreadPool;
 thread_local ThreadPool::per_signal ThreadPool::my_box;
 
 ThreadPool::ThreadPool()
-    : mi(getHWTopo().machineTopoInfo),
-      reserved(0),
+    : reserved(0),
       masterFastmode(0),
       running(false) {
+  HWTopoInfo topo = getHWTopo();
+  mi = topo.machineTopoInfo;
+  threadTopo = std::move(topo.threadTopoInfo);
   signals.resize(mi.maxThreads);
+  lentTo.resize(mi.maxThreads);
   initThread(0);
 
   for (unsigned i = 1; i < mi.maxThreads; ++i) {
@@ -59,7 +62,84 @@ ThreadPool::ThreadPool()
   }
 }
 
+ThreadPool::ThreadPool(ThreadPool* system_pool, unsigned begin, unsigned num)
+    : reserved(0),
+      masterFastmode(0),
+      running(false),
+      systemPool(system_pool),
+      systemTIDBase(begin) {
+  KATANA_LOG_VASSERT(
+      !systemPool->running && !systemPool->masterFastmode,
+      "Can't partition the thread pool during a parallel section");
+  KATANA_LOG_DEBUG_ASSERT(
+      begin > 0 && begin + num <= systemPool->getMaxThreads());
+
+  auto first = systemPool->signals.begin() + begin;
+  signals.assign(first, first + num);
+
+  // Renumber sockets and numa nodes from zero in the order they appear
+  std::vector<unsigned> sockets;
+  std::vector<unsigned> leaders;
+  std::vector<unsigned> numa_nodes;
+  auto renumber = [](std::vector<unsigned>* ids, unsigned id) -> unsigned {
+    auto it = std::find(ids->begin(), ids->end(), id);
+    if (it == ids->end()) {
+      ids->emplace_back(id);
+      return ids->size() - 1;
+    }
+    return it - ids->begin();
+  };
+  unsigned max_socket = 0;
+  for (unsigned i = 0; i < num; ++i) {
+    KATANA_LOG_DEBUG_ASSERT(!systemPool->lentTo[begin + i]);
+    systemPool->lentTo[begin + i] = this;
+
+    const ThreadTopoInfo& system_topo = systemPool->threadTopo[begin + i];
+    ThreadTopoInfo topo = system_topo;
+    topo.tid = i;
+    topo.socket = renumber(&sockets, system_topo.socket);
+    if (topo.socket == leaders.size()) {
+      leaders.emplace_back(i);
+    }
+    topo.socketLeader = leaders[topo.socket];
+    topo.numaNode = renumber(&numa_nodes, system_topo.numaNode);
+    max_socket = std::max(max_socket, topo.socket);
+    topo.cumulativeMaxSocket = max_socket;
+    threadTopo.emplace_back(topo);
+
+    // Threads are idle, their next wakeup publishes these writes
+    signals[i]->topo = topo;
+    signals[i]->pool = this;
+  }
+
+  mi.maxThreads = num;
+  mi.maxCores = std::max(
+      1U, num * systemPool->mi.maxCores / systemPool->mi.maxThreads);
+  mi.maxSockets = sockets.size();
+  mi.maxNumaNodes = numa_nodes.size();
+
+  systemPool->updateReserved();
+}
+
 ThreadPool::~ThreadPool() {
+  if (systemPool) {
+    // Return the threads to the system pool
+    KATANA_LOG_VASSERT(
+        !systemPool->running, "Can't return threads during a parallel section");
+    for (unsigned i = 0; i < mi.maxThreads; ++i) {
+      per_signal* s = signals[i];
+      s->topo = systemPool->threadTopo[s->systemTID];
+      s->pool = nullptr;
+      systemPool->lentTo[s->systemTID] = nullptr;
+    }
+    systemPool->updateReserved();
+    return;
+  }
+
+  KATANA_LOG_VASSERT(
+      std::none_of(
+          lentTo.begin(), lentTo.end(), [](ThreadPool* p) { return p; }),
+      "Thread pool partitions must be destroyed before the thread pool");
   destroyCommon();
   for (auto& t : threads) {
     t.join();
@@ -129,7 +209,8 @@ getNth(std::atomic<T*>& headptr, unsigned off) {
 void
 ThreadPool::initThread(unsigned tid) {
   signals[tid] = &my_box;
-  my_box.topo = getHWTopo().threadTopoInfo[tid];
+  my_box.topo = threadTopo[tid];
+  my_box.systemTID = tid;
   // Initialize
   initPTS(mi.maxThreads);
 
@@ -159,9 +240,15 @@ ThreadPool::threadLoop(unsigned tid) {
   auto& me = my_box;
   do {
     me.wait(fastmode);
-    cascade(fastmode);
+    // Threads lent to a partition run the work of the partition
+    ThreadPool* pool = me.pool ? me.pool : this;
+    if (me.task) {
+      pool->runTaskOnThisThread(me);
+      continue;
+    }
+    pool->cascade(fastmode);
     try {
-      work();
+      pool->work();
     } catch (const shutdown_ty&) {
       return;
     } catch (const fastmode_ty& fm) {
@@ -177,10 +264,30 @@ ThreadPool::threadLoop(unsigned tid) {
     } catch (...) {
       abort();
     }
-    decascade();
+    pool->decascade();
   } while (true);
 }
 
+void
+ThreadPool::runTaskOnThisThread(per_signal& me) {
+  // Each task starts with the whole partition
+  partitionActiveThreads = getMaxUsableThreads();
+  try {
+    (*me.task)();
+  } catch (const std::exception& exc) {
+    std::cerr << exc.what();
+    abort();
+  } catch (...) {
+    abort();
+  }
+  {
+    std::lock_guard<std::mutex> lg(me.m);
+    me.task = nullptr;
+    me.done = 1;
+  }
+  me.cv.notify_all();
+}
+
 void
 ThreadPool::decascade() {
   auto& me = my_box;
@@ -235,6 +342,7 @@ ThreadPool::runInternal(unsigned num) {
   num = std::min(std::max(1U, num), getMaxUsableThreads());
   // my_box is tid 0
   auto& me = my_box;
+  KATANA_LOG_DEBUG_ASSERT(&me == signals[0]);
   me.wbegin = 1;
   me.wend = num;
 
@@ -264,6 +372,10 @@ ThreadPool::runDedicated(std::function<void(void)>& f) {
   // clients access katana::activeThreads directly.
   KATANA_LOG_VASSERT(
       !running, "Can't start dedicated thread during parallel section");
+  KATANA_LOG_VASSERT(
+      reserved == dedicated,
+      "Can't start dedicated thread while threads are lent to partitions");
+  ++dedicated;
   ++reserved;
 
   KATANA_LOG_VASSERT(reserved < mi.maxThreads, "Too many dedicated threads");
@@ -279,6 +391,31 @@ ThreadPool::runDedicated(std::function<void(void)>& f) {
   work = nullptr;
 }
 
+void
+ThreadPool::runTask(std::function<void(void)>& f) {
+  KATANA_LOG_VASSERT(systemPool, "Only thread pool partitions run tasks");
+  KATANA_LOG_VASSERT(
+      my_box.pool != this, "Recursive thread pool execution not supported");
+
+  auto* root = signals[0];
+  root->task = &f;
+  root->wbegin = 0;
+  root->wend = 0;
+  root->wakeup(false);
+
+  std::unique_lock<std::mutex> lg(root->m);
+  root->cv.wait(lg, [root] { return root->done.load(); });
+}
+
+void
+ThreadPool::updateReserved() {
+  // Partitions take threads from the top, so everything from the lowest lent
+  // thread up is unusable by the system pool
+  auto first_lent = std::find_if(
+      lentTo.begin(), lentTo.end(), [](ThreadPool* p) { return p; });
+  reserved = std::max<unsigned>(dedicated, lentTo.end() - first_lent);
+}
+
 static katana::ThreadPool* TPOOL = nullptr;
 
 void
@@ -289,6 +426,9 @@ katana::internal::SetThreadPool(ThreadPool* tp) {
 
 katana::ThreadPool&
 katana::GetThreadPool() {
+  if (ThreadPool* partition = ThreadPool::getCurrent()) {
+    return *partition;
+  }
   KATANA_LOG_VASSERT(TPOOL, "ThreadPool not initialized");
   return *TPOOL;
 }
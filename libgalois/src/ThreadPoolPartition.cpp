@@ -0,0 +1,109 @@
+#include "katana/ThreadPoolPartition.h"
+
+#include <exception>
+
+#include "katana/ErrorCode.h"
+#include "katana/Threads.h"
+
+namespace {
+// Serializes changes to the threads lent by the system pool
+std::mutex kLendMutex;
+}  // namespace
+
+katana::Result<std::unique_ptr<katana::ThreadPoolPartition>>
+katana::ThreadPoolPartition::Make(unsigned num_threads) {
+  if (ThreadPool::getCurrent()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "partitions can only be made outside of partitions");
+  }
+  std::lock_guard<std::mutex> lock(kLendMutex);
+  unsigned free_threads = GetThreadPool().getMaxUsableThreads();
+  if (num_threads == 0 || num_threads >= free_threads) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "cannot lend {} threads, only 1 to {} threads are available",
+        num_threads, free_threads - 1);
+  }
+  return std::unique_ptr<ThreadPoolPartition>(
+      new ThreadPoolPartition(free_threads - num_threads, num_threads));
+}
+
+katana::Result<std::unique_ptr<katana::ThreadPoolPartition>>
+katana::ThreadPoolPartition::MakeForSockets(unsigned num_sockets) {
+  if (ThreadPool::getCurrent()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "partitions can only be made outside of partitions");
+  }
+  if (num_sockets == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "number of sockets must be positive");
+  }
+  std::lock_guard<std::mutex> lock(kLendMutex);
+  auto& tp = GetThreadPool();
+  unsigned end = tp.getMaxUsableThreads();
+
+  // Walk down from the highest free thread until num_sockets sockets are
+  // covered
+  unsigned begin = end;
+  unsigned taken = 0;
+  while (begin > 0) {
+    if (begin == end || tp.getSocket(begin - 1) != tp.getSocket(begin)) {
+      if (taken == num_sockets) {
+        break;
+      }
+      ++taken;
+    }
+    --begin;
+  }
+  if (begin == 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "cannot lend {} sockets, thread 0 and its socket are never lent",
+        num_sockets);
+  }
+  return std::unique_ptr<ThreadPoolPartition>(
+      new ThreadPoolPartition(begin, end - begin));
+}
+
+katana::ThreadPoolPartition::ThreadPoolPartition(unsigned begin, unsigned num)
+    : pool_(new ThreadPool(&GetThreadPool(), begin, num)) {
+  pool_->partition = this;
+  // Loops started by the calling thread can no longer use the lent threads
+  setActiveThreads(getActiveThreads());
+
+  // Make these on the partition so that their per-thread storage is indexed
+  // by the threads of the partition
+  RunImpl([this]() {
+    barrier_threads_ = NumThreads();
+    barrier_ = CreateTopoBarrier(barrier_threads_);
+    term_ = internal::CreateTerminationDetection();
+  });
+}
+
+katana::ThreadPoolPartition::~ThreadPoolPartition() {
+  RunImpl([this]() {
+    term_.reset();
+    barrier_.reset();
+  });
+  std::lock_guard<std::mutex> lock(kLendMutex);
+  pool_.reset();
+}
+
+void
+katana::ThreadPoolPartition::RunImpl(const std::function<void(void)>& fn) {
+  std::lock_guard<std::mutex> lock(run_mutex_);
+  std::exception_ptr error;
+  std::function<void(void)> task = [&fn, &error]() {
+    try {
+      fn();
+    } catch (...) {
+      error = std::current_exception();
+    }
+  };
+  pool_->runTask(task);
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
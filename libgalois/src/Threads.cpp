@@ -22,7 +22,10 @@
 #include <algorithm>
 
 #include "katana/ThreadPool.h"
+
 namespace katana {
+// The number of threads of loops started outside of any thread pool
+// partition. Partitions keep their own number (see ThreadPool).
 KATANA_EXPORT unsigned int activeThreads = 1;
 }  // namespace katana
 
@@ -30,11 +33,18 @@ unsigned int
 katana::setActiveThreads(unsigned int num) noexcept {
   num = std::min(num, katana::GetThreadPool().getMaxUsableThreads());
   num = std::max(num, 1U);
-  katana::activeThreads = num;
+  if (ThreadPool* partition = ThreadPool::getCurrent()) {
+    partition->setActiveThreads(num);
+  } else {
+    katana::activeThreads = num;
+  }
   return num;
 }
 
 unsigned int
 katana::getActiveThreads() noexcept {
+  if (ThreadPool* partition = ThreadPool::getCurrent()) {
+    return partition->getActiveThreads();
+  }
   return katana::activeThreads;
 }
@@ -19,6 +19,8 @@
 
 #include "katana/Timer.h"
 
+#include <string>
+
 #include "katana/Statistics.h"
 
 using namespace katana;
@@ -99,10 +101,30 @@ StatTimer::~StatTimer() {
     katana::ReportStatMax(
         region_.c_str(), name_.c_str(), TimeAccumulator::get());
   }
+
+  PerfCounters* perf_counters = internal::GetPerfCounters();
+  if (!perf_counted_ || !perf_counters) {
+    return;
+  }
+  std::string prefix = name_ == "Time" ? "" : name_.c_str();
+  for (size_t i = 0; i < kNumPerfEvents; ++i) {
+    auto event = static_cast<PerfEvent>(i);
+    if (perf_counters->IsAvailable(event)) {
+      katana::ReportStatSum(
+          region_.c_str(), prefix + PerfCounters::Name(event), perf_total_[i]);
+    }
+  }
 }
 
 void
 StatTimer::start() {
+  if (auto* sm = internal::sysStatManager(); sm && sm->IsTracing()) {
+    trace_start_ = Now();
+  }
+  if (PerfCounters* perf_counters = internal::GetPerfCounters()) {
+    perf_start_ = perf_counters->Read();
+    perf_started_ = true;
+  }
   TimeAccumulator::start();
   valid_ = true;
 }
@@ -111,6 +133,22 @@ void
 StatTimer::stop() {
   valid_ = false;
   TimeAccumulator::stop();
+  if (PerfCounters* perf_counters = internal::GetPerfCounters();
+      perf_counters && perf_started_) {
+    PerfCounters::Sample sample = perf_counters->Read();
+    for (size_t i = 0; i < kNumPerfEvents; ++i) {
+      perf_total_[i] += sample[i] - perf_start_[i];
+    }
+    perf_started_ = false;
+    perf_counted_ = true;
+  }
+  if (trace_start_ == TimePoint()) {
+    return;
+  }
+  if (auto* sm = internal::sysStatManager(); sm && sm->IsTracing()) {
+    sm->AddTraceSpan(region_.c_str(), name_.c_str(), trace_start_, Now());
+  }
+  trace_start_ = TimePoint();
 }
 
 uint64_t
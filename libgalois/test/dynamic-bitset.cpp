@@ -0,0 +1,89 @@
+#include <random>
+#include <vector>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+
+namespace {
+
+/// The set bits of bitset, found by testing each one
+std::vector<uint64_t>
+Expected(const katana::DynamicBitset& bitset) {
+  std::vector<uint64_t> offsets;
+  for (size_t i = 0; i < bitset.size(); ++i) {
+    if (bitset.test(i)) {
+      offsets.emplace_back(i);
+    }
+  }
+  return offsets;
+}
+
+template <typename Integer>
+void
+CheckOffsets(const katana::DynamicBitset& bitset) {
+  std::vector<uint64_t> expected = Expected(bitset);
+
+  std::vector<Integer> offsets = bitset.GetOffsets<Integer>();
+  KATANA_LOG_VASSERT(
+      offsets.size() == expected.size(), "size {}: found {} offsets, want {}",
+      bitset.size(), offsets.size(), expected.size());
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    KATANA_LOG_VASSERT(
+        offsets[i] == expected[i], "size {}: offset {} is {}, want {}",
+        bitset.size(), i, offsets[i], expected[i]);
+  }
+
+  // Appending keeps what was in the vector
+  std::vector<Integer> appended{7, 3};
+  bitset.AppendOffsets(&appended);
+  KATANA_LOG_ASSERT(appended.size() == expected.size() + 2);
+  KATANA_LOG_ASSERT(appended[0] == 7 && appended[1] == 3);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    KATANA_LOG_ASSERT(appended[i + 2] == expected[i]);
+  }
+}
+
+void
+TestSize(size_t size, std::mt19937* gen) {
+  katana::DynamicBitset bitset;
+  bitset.resize(size);
+  CheckOffsets<uint32_t>(bitset);
+
+  std::bernoulli_distribution coin(0.3);
+  for (size_t i = 0; i < size; ++i) {
+    if (coin(*gen)) {
+      bitset.set(i);
+    }
+  }
+  CheckOffsets<uint32_t>(bitset);
+  CheckOffsets<uint64_t>(bitset);
+
+  // bitwise_not also sets the bits of the last word past the end of the
+  // bitset; they are not offsets
+  bitset.bitwise_not();
+  CheckOffsets<uint32_t>(bitset);
+  CheckOffsets<uint64_t>(bitset);
+  std::vector<uint32_t> offsets = bitset.GetOffsets<uint32_t>();
+  KATANA_LOG_ASSERT(offsets.empty() || offsets.back() < size);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime Katana_runtime;
+
+  std::mt19937 gen(0);
+  for (unsigned num_threads :
+       {1U, 3U, katana::GetThreadPool().getMaxThreads()}) {
+    katana::setActiveThreads(num_threads);
+    // Word boundaries and sizes that are not a multiple of 64, with fewer
+    // words than threads and more
+    for (size_t size : {0, 1, 63, 64, 65, 127, 128, 130, 1000, 4097}) {
+      TestSize(size, &gen);
+    }
+  }
+
+  return 0;
+}
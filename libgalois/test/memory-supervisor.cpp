@@ -0,0 +1,117 @@
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <arrow/api.h>
+
+#include "katana/ArrowInterchange.h"
+#include "katana/Logging.h"
+#include "katana/MemorySupervisor.h"
+#include "katana/PropertyManager.h"
+#include "katana/URI.h"
+
+namespace {
+
+using katana::count_t;
+
+std::shared_ptr<arrow::Table>
+MakeColumn(const std::string& name, int64_t length) {
+  arrow::Int64Builder builder;
+  for (int64_t i = 0; i < length; ++i) {
+    KATANA_LOG_ASSERT(builder.Append(i).ok());
+  }
+  std::shared_ptr<arrow::Array> array;
+  KATANA_LOG_ASSERT(builder.Finish(&array).ok());
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, arrow::int64())}), {array});
+}
+
+katana::Uri
+MakeUri(const std::string& name) {
+  auto uri_res = katana::Uri::Make("/tmp/memory-supervisor/" + name);
+  KATANA_LOG_ASSERT(uri_res);
+  return uri_res.value();
+}
+
+void
+TestBudgetFromEnv() {
+  // The supervisor reads the environment when it is first used
+  KATANA_LOG_VASSERT(
+      katana::MemorySupervisor::Get().GetMemoryBudget() == (count_t{64} << 20),
+      "budget {}", katana::MemorySupervisor::Get().GetMemoryBudget());
+}
+
+void
+TestReclaimLRU() {
+  auto& ms = katana::MemorySupervisor::Get();
+  katana::PropertyManager pm;
+
+  auto a = MakeColumn("a", 1024);
+  auto b = MakeColumn("b", 1024);
+  auto c = MakeColumn("c", 1024);
+  auto d = MakeColumn("d", 2048);
+  count_t col_bytes = katana::ApproxTableMemUse(a);
+  count_t d_bytes = katana::ApproxTableMemUse(d);
+
+  ms.SetMemoryBudget(64 * col_bytes);
+  auto start_stats = ms.GetReclaimStats();
+
+  std::vector<std::pair<std::string, std::shared_ptr<arrow::Table>>> props{
+      {"a", a}, {"b", b}, {"c", c}};
+  for (const auto& [name, table] : props) {
+    pm.PropertyLoadedCallback(table);
+    pm.UnloadProperty(MakeUri(name), table);
+  }
+  KATANA_LOG_ASSERT(ms.GetActive() == 0);
+  KATANA_LOG_ASSERT(ms.GetStandby() == 3 * col_bytes);
+
+  // Reactivate a, leaving b as the least recently used
+  auto got_a = pm.AddProperty(MakeUri("a"));
+  KATANA_LOG_ASSERT(got_a && got_a.value() == a);
+  KATANA_LOG_ASSERT(ms.GetActive() == col_bytes);
+  pm.UnloadProperty(MakeUri("a"), a);
+  KATANA_LOG_ASSERT(ms.GetStandby() == 3 * col_bytes);
+
+  // Shrinking the budget reclaims only what is needed, oldest first
+  ms.SetMemoryBudget(3 * col_bytes - col_bytes / 2);
+  KATANA_LOG_ASSERT(ms.GetStandby() == 2 * col_bytes);
+  auto stats = ms.GetReclaimStats();
+  KATANA_LOG_ASSERT(stats.num_reclaims == start_stats.num_reclaims + 1);
+  KATANA_LOG_ASSERT(
+      stats.bytes_reclaimed == start_stats.bytes_reclaimed + col_bytes);
+  KATANA_LOG_ASSERT(!pm.AddProperty(MakeUri("b")));
+
+  // Loading more active memory pushes the rest out of standby
+  pm.PropertyLoadedCallback(d);
+  KATANA_LOG_ASSERT(ms.GetActive() == d_bytes);
+  KATANA_LOG_ASSERT(ms.GetStandby() == 0);
+  KATANA_LOG_ASSERT(!pm.AddProperty(MakeUri("a")));
+  KATANA_LOG_ASSERT(!pm.AddProperty(MakeUri("c")));
+  stats = ms.GetReclaimStats();
+  KATANA_LOG_ASSERT(stats.num_reclaims == start_stats.num_reclaims + 2);
+  KATANA_LOG_ASSERT(
+      stats.bytes_reclaimed == start_stats.bytes_reclaimed + 3 * col_bytes);
+
+  // Without room for standby memory, unloaded properties are dropped
+  ms.SetMemoryBudget(col_bytes);
+  KATANA_LOG_ASSERT(
+      ms.GetReclaimStats().num_oversubscribed ==
+      start_stats.num_oversubscribed + 1);
+  pm.UnloadProperty(MakeUri("d"), d);
+  KATANA_LOG_ASSERT(ms.GetActive() == 0);
+  KATANA_LOG_ASSERT(ms.GetStandby() == 0);
+  KATANA_LOG_ASSERT(!pm.AddProperty(MakeUri("d")));
+}
+
+}  // namespace
+
+int
+main() {
+  setenv("KATANA_MEMORY_BUDGET", "64M", 1);
+
+  TestBudgetFromEnv();
+  TestReclaimLRU();
+
+  return 0;
+}
@@ -0,0 +1,66 @@
+#include <cstdint>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/PerfCounters.h"
+#include "katana/Timer.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 1 << 20;
+
+void
+RunLoop(std::vector<uint64_t>* data) {
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNumItems),
+      [&](uint64_t i) { (*data)[i] = i * i; }, katana::loopname("Squares"));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime katana_runtime;
+  katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+
+  auto res = katana::PerfCounters::Make();
+  if (!res) {
+    // Containers and virtual machines often do not expose hardware counters
+    KATANA_LOG_WARN("skipping test: {}", res.error());
+    return 0;
+  }
+  std::unique_ptr<katana::PerfCounters> counters = std::move(res.value());
+  katana::internal::SetPerfCounters(counters.get());
+
+  std::vector<uint64_t> data(kNumItems);
+  katana::PerfCounters::Sample before = counters->Read();
+  {
+    katana::StatTimer timer("Timed", "PerfCounters");
+    katana::TimerGuard guard(timer);
+    RunLoop(&data);
+  }
+  katana::PerfCounters::Sample after = counters->Read();
+
+  for (size_t i = 0; i < katana::kNumPerfEvents; ++i) {
+    auto event = static_cast<katana::PerfEvent>(i);
+    if (!counters->IsAvailable(event)) {
+      KATANA_LOG_ASSERT(after[i] == 0);
+      continue;
+    }
+    KATANA_LOG_VASSERT(
+        after[i] >= before[i], "{} decreased",
+        katana::PerfCounters::Name(event));
+  }
+
+  if (counters->IsAvailable(katana::PerfEvent::kInstructions)) {
+    // Each item takes at least a multiply and a store
+    auto i = static_cast<size_t>(katana::PerfEvent::kInstructions);
+    uint64_t instructions = after[i] - before[i];
+    KATANA_LOG_VASSERT(
+        instructions >= 2 * kNumItems, "{} instructions", instructions);
+  }
+
+  katana::internal::SetPerfCounters(nullptr);
+  return 0;
+}
@@ -0,0 +1,151 @@
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/NoopTracer.h"
+#include "katana/Statistics.h"
+#include "katana/Timer.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 1000;
+
+std::string
+ReadFile(const std::string& path) {
+  std::ifstream in(path);
+  KATANA_LOG_VASSERT(in.is_open(), "cannot open {}", path);
+  std::stringstream buf;
+  buf << in.rdbuf();
+  return buf.str();
+}
+
+/// Parse a trace file, which is unterminated until the StatManager prints
+nlohmann::json
+ReadTrace(const std::string& path, bool closed) {
+  std::string contents = ReadFile(path);
+  return nlohmann::json::parse(closed ? contents : contents + "]");
+}
+
+const nlohmann::json*
+FindEvent(
+    const nlohmann::json& trace, const std::string& phase,
+    const std::string& name) {
+  for (const auto& event : trace) {
+    if (event["ph"] == phase && event["name"] == name) {
+      return &event;
+    }
+  }
+  return nullptr;
+}
+
+void
+RunLoops() {
+  katana::StatTimer timer("Outer", "StatExport");
+  timer.start();
+
+  katana::GAccumulator<uint64_t> sum;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNumItems), [&](uint64_t i) { sum += i; },
+      katana::loopname("SumLoop"));
+  KATANA_LOG_ASSERT(sum.reduce() == kNumItems * (kNumItems - 1) / 2);
+
+  std::vector<uint64_t> initial{0};
+  katana::for_each(
+      katana::iterate(initial),
+      [&](uint64_t i, katana::UserContext<uint64_t>& ctx) {
+        if (i + 1 < kNumItems) {
+          ctx.push(i + 1);
+        }
+      },
+      katana::loopname("PushLoop"));
+
+  timer.stop();
+}
+
+void
+TestExport(const std::string& dir) {
+  std::string json_file = dir + "/stats.json";
+  std::string trace_file = dir + "/trace.json";
+
+  {
+    katana::GaloisRuntime katana_runtime;
+    katana::setActiveThreads(katana::GetThreadPool().getMaxUsableThreads());
+    katana::SetStatJSONFile(json_file);
+    katana::SetTraceFile(trace_file);
+    katana::ProgressTracer::Set(katana::NoopTracer::Make());
+
+    {
+      auto scope = katana::GetTracer().StartActiveSpan("export span");
+      RunLoops();
+      katana::reportPageAlloc("MeminfoPre");
+    }
+    katana::FlushStats();
+
+    auto trace = ReadTrace(trace_file, false);
+    KATANA_LOG_ASSERT(FindEvent(trace, "X", "StatExport"));
+    KATANA_LOG_ASSERT(FindEvent(trace, "X", "SumLoop"));
+    KATANA_LOG_ASSERT(FindEvent(trace, "C", "PageAlloc"));
+    const auto* span = FindEvent(trace, "X", "export span");
+    KATANA_LOG_ASSERT(span && (*span)["cat"] == "ProgressTracer");
+
+    // Each thread of the for_each reports its own loop statistics
+    int64_t iterations = 0;
+    for (const auto& event : trace) {
+      if (event["ph"] == "i" && event["name"] == "PushLoop") {
+        iterations += event["args"]["Iterations"].get<int64_t>();
+      }
+    }
+    KATANA_LOG_VASSERT(
+        iterations == kNumItems, "{} iterations in trace", iterations);
+
+    auto stats = nlohmann::json::parse(ReadFile(json_file))["stats"];
+    bool found = false;
+    for (const auto& stat : stats) {
+      if (stat["region"] == "PushLoop" && stat["category"] == "Iterations") {
+        KATANA_LOG_ASSERT(stat["total"] == kNumItems);
+        KATANA_LOG_ASSERT(stat["total_type"] == "TSUM");
+        KATANA_LOG_ASSERT(!stat["thread_values"].empty());
+        found = true;
+      }
+    }
+    KATANA_LOG_ASSERT(found);
+
+    // Later flushes append to the trace
+    size_t num_events = trace.size();
+    RunLoops();
+    katana::FlushStats();
+    KATANA_LOG_ASSERT(ReadTrace(trace_file, false).size() > num_events);
+
+    katana::GetTracer().Finish();
+  }
+
+  // The runtime closes the trace when it prints the stats
+  auto trace = ReadTrace(trace_file, true);
+  KATANA_LOG_ASSERT(FindEvent(trace, "C", "PageAlloc"));
+}
+
+}  // namespace
+
+int
+main() {
+  char dir_template[] = "/tmp/stat-export-XXXXXX";
+  char* dir = mkdtemp(dir_template);
+  KATANA_LOG_ASSERT(dir);
+
+  TestExport(dir);
+
+  unlink((std::string(dir) + "/stats.json").c_str());
+  unlink((std::string(dir) + "/trace.json").c_str());
+  rmdir(dir);
+
+  return 0;
+}
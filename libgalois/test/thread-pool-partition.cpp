@@ -0,0 +1,204 @@
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "katana/Galois.h"
+#include "katana/Logging.h"
+#include "katana/ThreadPoolPartition.h"
+
+namespace {
+
+constexpr uint64_t kNumItems = 100000;
+
+uint64_t
+Expected() {
+  return kNumItems * (kNumItems - 1) / 2;
+}
+
+/// Run a do_all, a for_each (which uses the barrier and termination
+/// detection) and an on_each, returning the number of mismatches
+uint64_t
+RunLoops(unsigned num_threads) {
+  uint64_t errors = 0;
+
+  katana::GAccumulator<uint64_t> sum;
+  katana::do_all(
+      katana::iterate(uint64_t{0}, kNumItems), [&](uint64_t i) { sum += i; },
+      katana::steal(), katana::no_stats());
+  errors += sum.reduce() != Expected();
+
+  // Each item pushes its successor until kNumItems items were processed
+  katana::GAccumulator<uint64_t> count;
+  std::vector<uint64_t> initial{0, 1, 2, 3};
+  katana::for_each(
+      katana::iterate(initial),
+      [&](uint64_t i, katana::UserContext<uint64_t>& ctx) {
+        count += 1;
+        if (i + initial.size() < kNumItems) {
+          ctx.push(i + initial.size());
+        }
+      },
+      katana::no_stats());
+  errors += count.reduce() != kNumItems;
+
+  std::atomic<uint64_t> bad_threads{0};
+  katana::on_each([&](unsigned tid, unsigned total) {
+    if (tid >= total || total > num_threads ||
+        katana::GetThreadPool().getMaxUsableThreads() != num_threads) {
+      ++bad_threads;
+    }
+  });
+  errors += bad_threads;
+
+  return errors;
+}
+
+void
+TestConcurrentPartitions() {
+  auto& system = katana::GetThreadPool();
+  unsigned max_threads = system.getMaxThreads();
+  unsigned num_threads = (max_threads - 1) / 2;
+
+  // Thread 0 is never lent
+  KATANA_LOG_ASSERT(!katana::ThreadPoolPartition::Make(max_threads));
+  if (num_threads == 0) {
+    return;
+  }
+
+  auto a_res = katana::ThreadPoolPartition::Make(num_threads);
+  KATANA_LOG_ASSERT(a_res);
+  auto b_res = katana::ThreadPoolPartition::Make(num_threads);
+  KATANA_LOG_ASSERT(b_res);
+  std::unique_ptr<katana::ThreadPoolPartition> a = std::move(a_res.value());
+  std::unique_ptr<katana::ThreadPoolPartition> b = std::move(b_res.value());
+
+  KATANA_LOG_ASSERT(a->NumThreads() == num_threads);
+  KATANA_LOG_ASSERT(a->FirstThread() == max_threads - num_threads);
+  KATANA_LOG_ASSERT(b->FirstThread() == max_threads - 2 * num_threads);
+  KATANA_LOG_ASSERT(
+      system.getMaxUsableThreads() == max_threads - 2 * num_threads);
+  KATANA_LOG_ASSERT(
+      !katana::ThreadPoolPartition::Make(system.getMaxUsableThreads()));
+
+  katana::setActiveThreads(max_threads);
+  unsigned system_threads = system.getMaxUsableThreads();
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == system_threads);
+
+  // Both partitions and the system pool run loops at the same time
+  uint64_t a_errors = 0;
+  uint64_t b_errors = 0;
+  std::thread a_thread([&]() {
+    for (int i = 0; i < 20; ++i) {
+      a_errors += a->Run([&]() { return RunLoops(num_threads); });
+    }
+  });
+  std::thread b_thread([&]() {
+    for (int i = 0; i < 20; ++i) {
+      b_errors += b->Run([&]() { return RunLoops(num_threads); });
+    }
+  });
+  uint64_t system_errors = 0;
+  for (int i = 0; i < 20; ++i) {
+    system_errors += RunLoops(system_threads);
+  }
+  a_thread.join();
+  b_thread.join();
+  KATANA_LOG_VASSERT(a_errors == 0, "{} errors", a_errors);
+  KATANA_LOG_VASSERT(b_errors == 0, "{} errors", b_errors);
+  KATANA_LOG_VASSERT(system_errors == 0, "{} errors", system_errors);
+
+  // Fewer threads within a partition
+  uint64_t errors = a->Run([&]() {
+    katana::setActiveThreads(1);
+    return RunLoops(num_threads);
+  });
+  KATANA_LOG_ASSERT(errors == 0);
+  KATANA_LOG_ASSERT(katana::getActiveThreads() == system_threads);
+
+  bool caught = false;
+  try {
+    b->Run([]() { throw std::runtime_error("expected"); });
+  } catch (const std::runtime_error&) {
+    caught = true;
+  }
+  KATANA_LOG_ASSERT(caught);
+
+  // Threads are returned in any order
+  a.reset();
+  KATANA_LOG_ASSERT(
+      system.getMaxUsableThreads() == max_threads - 2 * num_threads);
+  b.reset();
+  KATANA_LOG_ASSERT(system.getMaxUsableThreads() == max_threads);
+
+  katana::setActiveThreads(max_threads);
+  KATANA_LOG_ASSERT(RunLoops(max_threads) == 0);
+}
+
+/// Storage made in the system pool is indexed by system thread id, also
+/// from inside a partition whose getTID() counts from the partition
+void
+TestStorageAcrossPools() {
+  auto& system = katana::GetThreadPool();
+  unsigned num_threads = (system.getMaxThreads() - 1) / 2;
+  if (num_threads == 0) {
+    return;
+  }
+  auto res = katana::ThreadPoolPartition::Make(num_threads);
+  KATANA_LOG_ASSERT(res);
+  auto& partition = res.value();
+
+  katana::PerThreadStorage<unsigned> system_tids(0U);
+  uint64_t errors = partition->Run([&]() {
+    std::atomic<uint64_t> bad_threads{0};
+    katana::on_each([&](unsigned tid, unsigned) {
+      unsigned system_tid = katana::ThreadPool::getSystemTID();
+      if (system_tid != partition->FirstThread() + tid) {
+        ++bad_threads;
+      }
+      *system_tids.getLocal() = system_tid;
+    });
+    return bad_threads.load();
+  });
+  KATANA_LOG_ASSERT(errors == 0);
+  KATANA_LOG_ASSERT(system_tids.size() == system.getMaxThreads());
+  for (unsigned tid = 0; tid < num_threads; ++tid) {
+    unsigned system_tid = partition->FirstThread() + tid;
+    KATANA_LOG_ASSERT(*system_tids.getRemote(system_tid) == system_tid);
+  }
+}
+
+void
+TestSockets() {
+  auto& system = katana::GetThreadPool();
+  auto res = katana::ThreadPoolPartition::MakeForSockets(1);
+  if (system.getMaxSockets() == 1) {
+    // The only socket holds thread 0
+    KATANA_LOG_ASSERT(!res);
+    return;
+  }
+  KATANA_LOG_ASSERT(res);
+  auto& partition = res.value();
+  KATANA_LOG_ASSERT(partition->NumSockets() == 1);
+  KATANA_LOG_ASSERT(
+      system.getSocket(partition->FirstThread()) ==
+      system.getSocket(system.getMaxThreads() - 1));
+  KATANA_LOG_ASSERT(partition->Run([&]() {
+    return RunLoops(partition->NumThreads());
+  }) == 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::GaloisRuntime katana_runtime;
+
+  TestConcurrentPartitions();
+  TestStorageAcrossPools();
+  TestSockets();
+
+  return 0;
+}
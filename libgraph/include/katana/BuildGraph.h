@@ -7,6 +7,8 @@
 
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <variant>
@@ -18,6 +20,18 @@
 
 #include "katana/PropertyGraph.h"
 
+namespace arrow::io {
+
+class OutputStream;
+
+}  // namespace arrow::io
+
+namespace parquet::arrow {
+
+class FileWriter;
+
+}  // namespace parquet::arrow
+
 namespace katana {
 
 using ArrayBuilders = std::vector<std::shared_ptr<arrow::ArrayBuilder>>;
@@ -130,6 +144,26 @@ struct TopologyState {
   std::unordered_map<size_t, std::string> destinations_intermediate;
 };
 
+/// Property columns whose finished chunks are written to local Parquet files,
+/// one file per column with a row group per chunk
+struct SpilledColumns {
+  std::vector<std::string> files;
+  std::vector<std::shared_ptr<arrow::io::OutputStream>> sinks;
+  std::vector<std::shared_ptr<parquet::arrow::FileWriter>> writers;
+  // the leading chunks of each column that have been written; their entries
+  // in PropertiesState::chunks are left null so that the number of chunks
+  // still tracks the number of rows
+  std::vector<size_t> num_spilled;
+};
+
+struct SpillState {
+  std::string dir;
+  SpilledColumns nodes;
+  SpilledColumns edges;
+  // the first error seen while spilling from FinishNode or FinishEdge
+  std::optional<CopyableErrorInfo> error;
+};
+
 struct WriterProperties {
   NullMaps null_arrays;
   std::shared_ptr<arrow::Array> false_array;
@@ -183,6 +217,7 @@ class KATANA_EXPORT PropertyGraphBuilder {
   LabelsState node_labels_;
   LabelsState edge_types_;
   TopologyState topology_builder_;
+  SpillState spill_;
   size_t nodes_;
   size_t edges_;
   bool building_node_;
@@ -222,13 +257,33 @@ public:
 
   Result<GraphComponents> Finish(bool verbose = true);
 
+  /// Write property chunks to Parquet files in the local directory dir as
+  /// soon as they are complete instead of keeping them in memory. Must be
+  /// called before any values are added. Spilled properties are only
+  /// available through FinishAndWrite.
+  Result<void> SpillPropertiesTo(const std::string& dir);
+
+  /// Like Finish followed by WritePropertyGraph, but adds, writes and
+  /// unloads one property column at a time so that at most one column is
+  /// in memory. Removes any spilled files once they have been written.
+  Result<void> FinishAndWrite(
+      const std::string& dir, katana::TxnContext* txn_ctx,
+      bool verbose = true);
+
   size_t GetNodeIndex();
   size_t GetNodes();
   size_t GetEdges();
 
 private:
   void ResolveIntermediateIDs();
+  void EvenOutColumns();
+  std::vector<size_t> BuildFinalTopology();
   GraphComponent BuildFinalEdges(bool verbose);
+  void MaybeSpillChunks(bool for_node, size_t num_rows);
+  Result<void> SpillChunks(bool for_node);
+  Result<void> CloseSpilledColumns();
+  Result<std::shared_ptr<arrow::ChunkedArray>> TakeColumn(
+      bool for_node, size_t i);
 };
 
 KATANA_EXPORT Result<std::unique_ptr<katana::PropertyGraph>>
@@ -1,9 +1,11 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ENTITYINDEX_H_
 #define KATANA_LIBGRAPH_KATANA_ENTITYINDEX_H_
 
-#include <set>
+#include <algorithm>
+#include <cstddef>
 #include <string>
-#include <variant>
+#include <string_view>
+#include <utility>
 
 #include <arrow/api.h>
 #include <arrow/array.h>
@@ -11,36 +13,53 @@
 #include <boost/iterator/iterator_categories.hpp>
 #include <boost/iterator/iterator_facade.hpp>
 
+#include "katana/FileView.h"
+#include "katana/NUMAArray.h"
 #include "katana/Result.h"
+#include "katana/URI.h"
 #include "katana/config.h"
 
 namespace katana {
 
+// The kinds of EntityIndex that can be built over a property.
+enum class EntityIndexKind {
+  // Ordered lookups through Find, LowerBound and UpperBound.
+  kSorted,
+  // Exact-match lookups only, in expected constant time.
+  kHash,
+};
+
 // EntityIndex provides an interface similar to an ordered container
 // over a single property.
+//
+// The index is a flat array of node or edge ids sorted by the value of the
+// indexed property (ties are broken by id). The array is either built in
+// memory by BuildFromProperty or mapped from a file previously written by
+// WriteToFile.
 template <typename node_or_edge>
 class KATANA_EXPORT EntityIndex {
 public:
-  // Type-safe container for node and edge ids to avoid overlap with the
-  // primitive types we are indexing.
-  struct IndexID {
-    node_or_edge id;
-  };
-
-  // The set key type is either a node/edge id (all the keys in the actual set)
-  // or a value representing the search key.
-  using set_key_type = typename std::variant<
-      IndexID, bool, uint8_t, int64_t, uint64_t, double_t, std::string_view*>;
-
   // EntityIndex::iterator returns a sequence of node or edge ids.
-  using base_iterator = typename std::multiset<set_key_type>::iterator;
-  class iterator : public base_iterator {
+  class iterator
+      : public boost::iterator_facade<
+            iterator, const node_or_edge, boost::random_access_traversal_tag> {
   public:
-    explicit iterator(const base_iterator& base) : base_iterator(base) {}
-    iterator() : base_iterator(0) {}
-    const node_or_edge& operator*() const {
-      return std::get<IndexID>(base_iterator::operator*()).id;
+    iterator() = default;
+    explicit iterator(const node_or_edge* pos) : pos_(pos) {}
+
+  private:
+    friend class boost::iterator_core_access;
+
+    const node_or_edge& dereference() const { return *pos_; }
+    bool equal(const iterator& other) const { return pos_ == other.pos_; }
+    void increment() { ++pos_; }
+    void decrement() { --pos_; }
+    void advance(std::ptrdiff_t n) { pos_ += n; }
+    std::ptrdiff_t distance_to(const iterator& other) const {
+      return other.pos_ - pos_;
     }
+
+    const node_or_edge* pos_{nullptr};
   };
 
   EntityIndex(std::string column_name) : column_name_(std::move(column_name)) {}
@@ -55,180 +74,232 @@ public:
   // The name of the indexed property.
   std::string column_name() { return column_name_; }
 
-  virtual iterator begin() = 0;
-  virtual iterator end() = 0;
+  virtual EntityIndexKind kind() const { return EntityIndexKind::kSorted; }
+
+  iterator begin() const { return iterator(ids_); }
+  iterator end() const { return iterator(ids_ + num_ids_); }
+
+  // The number of indexed entities; entities with a null value are not
+  // indexed.
+  size_t size() const { return num_ids_; }
 
   virtual Result<void> BuildFromProperty() = 0;
-  // virtual Result<void> BuildFromFile() = 0;
+
+  // Map an index written by WriteToFile rather than building it. The file
+  // must have been written for a property with the same values.
+  virtual Result<void> BuildFromFile(const Uri& uri) = 0;
+
+  virtual Result<void> WriteToFile(const Uri& uri) const = 0;
+
+protected:
+  // Point ids_ at the in-memory id_storage_.
+  void UseIdStorage() {
+    ids_ = id_storage_.data();
+    num_ids_ = id_storage_.size();
+  }
+
+  const node_or_edge* ids_{nullptr};
+  size_t num_ids_{0};
+  NUMAArray<node_or_edge> id_storage_;
+  FileView file_;
 
 private:
   std::string column_name_;
 };
 
 // PrimitiveEntityIndex provides a EntityIndex for primitive types.
+//
+// Alongside the ids the index keeps a copy of their keys in the same order so
+// that searches do not touch the property.
 template <typename node_or_edge, typename c_type>
 class KATANA_EXPORT PrimitiveEntityIndex : public EntityIndex<node_or_edge> {
 public:
   using ArrowArrayType = typename arrow::CTypeTraits<c_type>::ArrayType;
-  using IndexID = typename EntityIndex<node_or_edge>::IndexID;
   using iterator = typename EntityIndex<node_or_edge>::iterator;
-  using set_key_type = typename EntityIndex<node_or_edge>::set_key_type;
 
   PrimitiveEntityIndex(
       const std::string& column, size_t num_entities,
       std::shared_ptr<arrow::Array> property)
       : EntityIndex<node_or_edge>(column),
         num_entities_(num_entities),
-        property_(std::static_pointer_cast<ArrowArrayType>(property)),
-        set_(PropertyCompare(property_)) {}
-
-  iterator begin() override { return iterator(set_.begin()); }
-  iterator end() override { return iterator(set_.end()); }
-
-  // Returns an iterator to the first element in the set with its property
-  // value equal to `key`. The STL does not seem to specify that
-  // multiset::find returns the first value, though it appears so in practice.
-  iterator Find(c_type key) {
-    auto it = set_.lower_bound(key);
-    if (it == set_.end() ||
-        property_->Value(std::get<IndexID>(*it).id) != key) {
-      return end();
+        property_(std::static_pointer_cast<ArrowArrayType>(property)) {}
+
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
+  iterator Find(c_type key) const {
+    iterator it = LowerBound(key);
+    if (it == this->end() || keys_[it - this->begin()] != key) {
+      return this->end();
     }
-    return iterator(it);
+    return it;
   }
 
-  // Returns an iterator to the first element in the set that is greater than or
-  // equal to `key`.
-  iterator LowerBound(c_type key) { return iterator(set_.lower_bound(key)); }
+  // Returns an iterator to the first element in the index that is greater
+  // than or equal to `key`.
+  iterator LowerBound(c_type key) const {
+    return this->begin() +
+           (std::lower_bound(keys_, keys_ + this->num_ids_, key) - keys_);
+  }
 
-  // Returns an iterator to the first element in the set that is greater than
-  // `key`.
-  iterator UpperBound(c_type key) { return iterator(set_.upper_bound(key)); }
+  // Returns an iterator to the first element in the index that is greater
+  // than `key`.
+  iterator UpperBound(c_type key) const {
+    return this->begin() +
+           (std::upper_bound(keys_, keys_ + this->num_ids_, key) - keys_);
+  }
 
 private:
-  class PropertyCompare {
-  public:
-    PropertyCompare(std::shared_ptr<ArrowArrayType> property)
-        : property_(std::move(property)) {}
-
-    bool operator()(const set_key_type& a, const set_key_type& b) const {
-      // Each operand is either a literal key_type or a node/edge.
-      c_type val_a = GetValue(a);
-      c_type val_b = GetValue(b);
-      // Compare the value of the indexed property for a and b using std::less.
-      return std::less<c_type>{}(val_a, val_b);
-    }
-
-  private:
-    c_type GetValue(const set_key_type& a) const {
-      if (std::holds_alternative<IndexID>(a)) {
-        node_or_edge id = std::get<IndexID>(a).id;
-        c_type val = property_->Value(id);
-        return val;
-      }
-      return std::get<c_type>(a);
-    }
-
-    std::shared_ptr<ArrowArrayType> property_;
-  };
-
   Result<void> BuildFromProperty() override;
-  // Result<void> BuildFromFile(...) override;
+  Result<void> BuildFromFile(const Uri& uri) override;
+  Result<void> WriteToFile(const Uri& uri) const override;
 
   size_t num_entities_;
   std::shared_ptr<ArrowArrayType> property_;
-  std::multiset<set_key_type, PropertyCompare> set_;
+  const c_type* keys_{nullptr};
+  NUMAArray<c_type> key_storage_;
 };
 
 // StringEntityIndex provides a EntityIndex for strings.
+//
+// Only the ids are stored; searches compare against the property itself.
 template <typename node_or_edge>
 class KATANA_EXPORT StringEntityIndex : public EntityIndex<node_or_edge> {
 public:
   using ArrowArrayType =
       typename arrow::TypeTraits<arrow::LargeStringType>::ArrayType;
-  using IndexID = typename EntityIndex<node_or_edge>::IndexID;
   using iterator = typename EntityIndex<node_or_edge>::iterator;
-  using set_key_type = typename EntityIndex<node_or_edge>::set_key_type;
 
   StringEntityIndex(
       const std::string& column_name, size_t num_entities,
       const std::shared_ptr<arrow::Array>& property)
       : EntityIndex<node_or_edge>(column_name),
         num_entities_(num_entities),
-        property_(std::static_pointer_cast<arrow::LargeStringArray>(property)),
-        set_(StringCompare(property_)) {}
-
-  iterator begin() override { return iterator(set_.begin()); }
-  iterator end() override { return iterator(set_.end()); }
-
-  // Returns an iterator to the first element in the set with its property
-  // value equal to `key`. The STL does not appear to specify that
-  // multiset::find returns the first value, though it appears so in practice.
-  iterator Find(std::string_view key) {
-    auto it = set_.lower_bound(&key);
-    if (it != set_.end()) {
-      arrow::util::string_view arrow_view =
-          property_->GetView(std::get<IndexID>(*it).id);
-      if (std::string_view(arrow_view.data(), arrow_view.length()) != key) {
-        return end();
-      }
+        property_(
+            std::static_pointer_cast<arrow::LargeStringArray>(property)) {}
+
+  // Returns an iterator to the first element in the index with its property
+  // value equal to `key`.
+  iterator Find(std::string_view key) const {
+    iterator it = LowerBound(key);
+    if (it == this->end() || GetValue(*it) != key) {
+      return this->end();
     }
-    return iterator(it);
+    return it;
   }
 
-  // Returns an iterator to the first element in the set that is greater than or
-  // equal to `key`.
-  iterator LowerBound(std::string_view key) {
-    return iterator(set_.lower_bound(&key));
+  // Returns an iterator to the first element in the index that is greater
+  // than or equal to `key`.
+  iterator LowerBound(std::string_view key) const {
+    return iterator(std::lower_bound(
+        this->ids_, this->ids_ + this->num_ids_, key,
+        [this](node_or_edge id, std::string_view k) {
+          return GetValue(id) < k;
+        }));
   }
 
-  // Returns an iterator to the first element in the set that is greater than
-  // `key`.
-  iterator UpperBound(std::string_view key) {
-    return iterator(set_.upper_bound(&key));
+  // Returns an iterator to the first element in the index that is greater
+  // than `key`.
+  iterator UpperBound(std::string_view key) const {
+    return iterator(std::upper_bound(
+        this->ids_, this->ids_ + this->num_ids_, key,
+        [this](std::string_view k, node_or_edge id) {
+          return k < GetValue(id);
+        }));
   }
 
 private:
-  class StringCompare {
-  public:
-    StringCompare(std::shared_ptr<arrow::LargeStringArray> property)
-        : property_(std::move(property)) {}
-
-    bool operator()(const set_key_type& a, const set_key_type& b) const {
-      // Each operand is either a pointer to a string_view or a node/edge.
-      std::string_view val_a = GetValue(a);
-      std::string_view val_b = GetValue(b);
-      // Compare the value of the indexed property for a and b using std::less.
-      return std::less<std::string_view>{}(val_a, val_b);
-    }
+  std::string_view GetValue(node_or_edge id) const {
+    arrow::util::string_view arrow_view = property_->GetView(id);
+    return std::string_view(arrow_view.data(), arrow_view.length());
+  }
 
-  private:
-    std::string_view GetValue(const set_key_type& a) const {
-      if (std::holds_alternative<IndexID>(a)) {
-        arrow::util::string_view arrow_view =
-            property_->GetView(std::get<IndexID>(a).id);
-        return std::string_view(arrow_view.data(), arrow_view.length());
-      }
-      return *std::get<std::string_view*>(a);
-    }
+  Result<void> BuildFromProperty() override;
+  Result<void> BuildFromFile(const Uri& uri) override;
+  Result<void> WriteToFile(const Uri& uri) const override;
 
-    std::shared_ptr<arrow::LargeStringArray> property_;
-  };
+  size_t num_entities_;
+  std::shared_ptr<arrow::LargeStringArray> property_;
+};
+
+namespace internal {
+
+template <typename key_type>
+struct HashIndexArray {
+  using type = typename arrow::CTypeTraits<key_type>::ArrayType;
+};
+
+template <>
+struct HashIndexArray<std::string_view> {
+  using type = arrow::LargeStringArray;
+};
+
+}  // namespace internal
+
+// HashEntityIndex provides a EntityIndex for exact-match lookups on integer
+// (key_type is a C integer type) and string (key_type is std::string_view)
+// properties.
+//
+// The ids are grouped into runs of entities with equal keys. An open
+// addressing table maps the hash of each distinct key to its run. As in
+// SwissTable, every slot has a control byte holding 7 bits of the hash of its
+// key, and a probe compares a group of 16 control bytes at once so that the
+// property is only read for slots whose control byte matches.
+template <typename node_or_edge, typename key_type>
+class KATANA_EXPORT HashEntityIndex : public EntityIndex<node_or_edge> {
+public:
+  using ArrowArrayType = typename internal::HashIndexArray<key_type>::type;
+  using iterator = typename EntityIndex<node_or_edge>::iterator;
+
+  HashEntityIndex(
+      const std::string& column_name, size_t num_entities,
+      const std::shared_ptr<arrow::Array>& property)
+      : EntityIndex<node_or_edge>(column_name),
+        num_entities_(num_entities),
+        property_(std::static_pointer_cast<ArrowArrayType>(property)) {}
+
+  EntityIndexKind kind() const override { return EntityIndexKind::kHash; }
+
+  // Returns the range of elements with their property value equal to `key`.
+  std::pair<iterator, iterator> EqualRange(key_type key) const;
+
+  // Returns an iterator to the first element with its property value equal to
+  // `key`, or end() if there is none. Unlike the sorted indexes, the elements
+  // following those equal to `key` are in no particular order.
+  iterator Find(key_type key) const {
+    auto [first, last] = EqualRange(key);
+    return first == last ? this->end() : first;
+  }
+
+  // The number of distinct keys in the index.
+  size_t num_keys() const {
+    return run_starts_.size() == 0 ? 0 : run_starts_.size() - 1;
+  }
+
+private:
+  key_type GetValue(node_or_edge id) const;
 
   Result<void> BuildFromProperty() override;
-  // virtual Result<void> BuildFromFile(...) override;
+  Result<void> BuildFromFile(const Uri& uri) override;
+  Result<void> WriteToFile(const Uri& uri) const override;
 
   size_t num_entities_;
-  std::shared_ptr<arrow::LargeStringArray> property_;
-  std::multiset<set_key_type, StringCompare> set_;
-};  // namespace katana
+  std::shared_ptr<ArrowArrayType> property_;
+  // run_starts_[r] is the offset of the first id of run r; the last entry is
+  // the total number of ids.
+  NUMAArray<uint64_t> run_starts_;
+  // Control bytes and run numbers of the table slots. The table capacity is a
+  // power of two and a multiple of the probe group size.
+  NUMAArray<uint8_t> ctrl_;
+  NUMAArray<uint64_t> slots_;
+};
 
-// Create a EntityIndex with the appropriate type for 'property'. Does not
-// build the index.
+// Create a EntityIndex of the given kind with the appropriate type for
+// 'property'. Does not build the index.
 template <typename node_or_edge>
 Result<std::unique_ptr<EntityIndex<node_or_edge>>> MakeTypedEntityIndex(
     const std::string& column_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property,
+    EntityIndexKind kind = EntityIndexKind::kSorted);
 
 }  // namespace katana
 
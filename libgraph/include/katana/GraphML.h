@@ -34,6 +34,24 @@ KATANA_EXPORT katana::Result<katana::GraphComponents> ConvertGraphML(
 KATANA_EXPORT katana::Result<katana::GraphComponents> ConvertGraphML(
     xmlTextReaderPtr reader, size_t chunk_size = 25000, bool verbose = false);
 
+/// ConvertGraphMLStreaming converts a GraphML file into an RDG without holding
+/// its properties in memory. Property chunks are written to Parquet files in
+/// spill_dir as they are parsed and only the ID maps, topology and labels
+/// stay resident. Properties are then added to the RDG one column at a time.
+/// The result is the same as ConvertGraphML followed by WritePropertyGraph.
+///
+/// \param infilename Path to source graphml file
+/// \param dir Output location of the RDG
+/// \param spill_dir Local directory for temporary property files
+/// \param chunk_size Number of rows per property chunk; this also bounds the
+///     number of rows per column held in memory while parsing
+/// \param verbose If true, print progress to the standard out while
+///     converting.
+KATANA_EXPORT katana::Result<void> ConvertGraphMLStreaming(
+    const std::string& infilename, const std::string& dir,
+    const std::string& spill_dir, katana::TxnContext* txn_ctx,
+    size_t chunk_size = 25000, bool verbose = false);
+
 }  // end namespace katana
 
 #endif
@@ -1087,6 +1087,14 @@ public:
     return topo().OutEdgeDst(eid);
   }
 
+  /// The destinations of the out-edges of node are stored contiguously;
+  /// this returns a pointer to the first of OutDegree(node) of them, in
+  /// OutEdges(node) order. Useful for kernels (e.g., set intersection) that
+  /// want to operate on the raw array.
+  const Node* OutEdgeDsts(const Node& node) const noexcept {
+    return topo().DestData() + *OutEdges(node).begin();
+  }
+
   auto GetEdgeSrc(const Edge& eid) const noexcept {
     return topo().GetEdgeSrc(eid);
   }
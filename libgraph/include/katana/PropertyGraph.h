@@ -2,6 +2,8 @@
 #define KATANA_LIBGRAPH_KATANA_PROPERTYGRAPH_H_
 
 #include <memory>
+#include <mutex>
+#include <unordered_set>
 #include <utility>
 
 #include <arrow/api.h>
@@ -24,6 +26,8 @@
 
 namespace katana {
 
+class PropertyManager;
+
 // TODO(amber): find a better place to put this
 template <
     typename T,
@@ -99,6 +103,50 @@ private:
 
   PGViewCache pg_view_cache_;
 
+  /// Load absent properties the first time they are requested by name. See
+  /// RDGLoadOptions::lazy_properties.
+  bool lazy_properties_{false};
+  /// Serializes loading and unloading properties, and readers of the
+  /// property tables when properties are loaded on access. Held by pointer so
+  /// that PropertyGraph remains movable.
+  std::unique_ptr<std::mutex> property_mutex_{std::make_unique<std::mutex>()};
+  /// Accounts for properties loaded while it is set and keeps unloaded ones
+  /// in standby memory
+  katana::PropertyManager* property_manager_{nullptr};
+  /// Properties loaded while property_manager_ was set
+  std::unordered_set<std::string> managed_node_properties_;
+  std::unordered_set<std::string> managed_edge_properties_;
+
+  /// The loaded property tables. Loading and unloading replace these tables,
+  /// so readers take a reference under property_mutex_ and work from that;
+  /// the tables themselves are immutable.
+  std::shared_ptr<arrow::Table> node_properties() const {
+    std::lock_guard<std::mutex> lock(*property_mutex_);
+    return rdg_.node_properties();
+  }
+  std::shared_ptr<arrow::Table> edge_properties() const {
+    std::lock_guard<std::mutex> lock(*property_mutex_);
+    return rdg_.edge_properties();
+  }
+
+  // The Do*Property* functions expect property_mutex_ to be held
+  Result<void> DoNodePropertyLoad(const std::string& name, int i);
+  Result<void> DoEdgePropertyLoad(const std::string& name, int i);
+  Result<void> DoNodePropertyUnload(const std::string& name);
+  Result<void> DoEdgePropertyUnload(const std::string& name);
+  Result<void> DoNodePropertyRemove(int i, katana::TxnContext* txn_ctx);
+  Result<void> DoEdgePropertyRemove(int i, katana::TxnContext* txn_ctx);
+
+  Result<std::shared_ptr<arrow::ChunkedArray>> LoadNodePropertyOnAccess(
+      const std::string& name);
+  Result<std::shared_ptr<arrow::ChunkedArray>> LoadEdgePropertyOnAccess(
+      const std::string& name);
+  /// If name is accounted for by property_manager_, tell it the property is
+  /// gone
+  void ReleaseManagedProperty(
+      std::unordered_set<std::string>* managed, const std::string& name,
+      const std::shared_ptr<arrow::ChunkedArray>& column);
+
   katana::Result<katana::RDGTopology*> LoadTopology(
       const katana::RDGTopology& shadow) {
     katana::RDGTopology* topo = KATANA_CHECKED(rdg_.GetTopology(shadow));
@@ -377,7 +425,7 @@ public:
 
   /// get the schema for loaded node properties
   std::shared_ptr<arrow::Schema> loaded_node_schema() const {
-    return rdg_.node_properties()->schema();
+    return node_properties()->schema();
   }
 
   /// get the schema for all node properties (includes unloaded properties)
@@ -387,7 +435,7 @@ public:
 
   /// get the schema for loaded edge properties
   std::shared_ptr<arrow::Schema> loaded_edge_schema() const {
-    return rdg_.edge_properties()->schema();
+    return edge_properties()->schema();
   }
 
   /// get the schema for all edge properties (includes unloaded properties)
@@ -584,18 +632,20 @@ public:
 
   // num_rows() == NumNodes() (all local nodes)
   std::shared_ptr<arrow::ChunkedArray> GetNodeProperty(int i) const {
-    if (i >= rdg_.node_properties()->num_columns()) {
+    auto props = node_properties();
+    if (i >= props->num_columns()) {
       return nullptr;
     }
-    return rdg_.node_properties()->column(i);
+    return props->column(i);
   }
 
   // num_rows() == num_edges() (all local edges)
   std::shared_ptr<arrow::ChunkedArray> GetEdgeProperty(int i) const {
-    if (i >= rdg_.edge_properties()->num_columns()) {
+    auto props = edge_properties();
+    if (i >= props->num_columns()) {
       return nullptr;
     }
-    return rdg_.edge_properties()->column(i);
+    return props->column(i);
   }
 
   /// \returns true if a node property/type with @param name exists
@@ -610,6 +660,10 @@ public:
 
   /// Get a node property by name.
   ///
+  /// If the graph was loaded with RDGLoadOptions::lazy_properties and the
+  /// property exists in storage but is not loaded, it is loaded first.
+  /// Concurrent requests for the same property load it once.
+  ///
   /// \param name The name of the property to get.
   /// \return The property data or NULL if the property is not found.
   Result<std::shared_ptr<arrow::ChunkedArray>> GetNodeProperty(
@@ -619,6 +673,8 @@ public:
     return loaded_node_schema()->field(i)->name();
   }
 
+  /// Get an edge property by name, loading it first if needed as with
+  /// GetNodeProperty.
   Result<std::shared_ptr<arrow::ChunkedArray>> GetEdgeProperty(
       const std::string& name) const;
 
@@ -752,23 +808,45 @@ public:
   /// the table do nothing otherwise
   Result<void> EnsureEdgePropertyLoaded(const std::string& name);
 
+  /// \returns true if absent properties are loaded when first requested by
+  /// name
+  bool lazy_properties() const { return lazy_properties_; }
+
+  /// Account for properties loaded from now on with \p manager so they count
+  /// against the process memory budget. Unloading such a property moves it
+  /// to standby memory, where the MemorySupervisor may reclaim it, and loading
+  /// it again takes it from standby memory if it is still there.
+  void set_property_manager(katana::PropertyManager* manager) {
+    property_manager_ = manager;
+  }
+
   std::vector<std::string> ListFullNodeProperties() const {
+    std::lock_guard<std::mutex> lock(*property_mutex_);
     return rdg_.ListFullNodeProperties();
   }
   std::vector<std::string> ListLoadedNodeProperties() const {
+    std::lock_guard<std::mutex> lock(*property_mutex_);
     return rdg_.ListLoadedNodeProperties();
   }
   std::vector<std::string> ListFullEdgeProperties() const {
+    std::lock_guard<std::mutex> lock(*property_mutex_);
     return rdg_.ListFullEdgeProperties();
   }
   std::vector<std::string> ListLoadedEdgeProperties() const {
+    std::lock_guard<std::mutex> lock(*property_mutex_);
     return rdg_.ListLoadedEdgeProperties();
   }
 
   /// Remove all node properties
-  void DropNodeProperties() { rdg_.DropNodeProperties(); }
+  void DropNodeProperties() {
+    std::lock_guard<std::mutex> lock(*property_mutex_);
+    rdg_.DropNodeProperties();
+  }
   /// Remove all edge properties
-  void DropEdgeProperties() { rdg_.DropEdgeProperties(); }
+  void DropEdgeProperties() {
+    std::lock_guard<std::mutex> lock(*property_mutex_);
+    rdg_.DropEdgeProperties();
+  }
 
   MutablePropertyView NodeMutablePropertyView() {
     return MutablePropertyView{
@@ -870,16 +948,38 @@ public:
     return node_iterator(node_id);
   }
 
-  // Creates an index over a node property.
-  Result<void> MakeNodeIndex(const std::string& column_name);
+  // Creates an index of the given kind over a node property. If a sorted
+  // index was persisted alongside the stored property it is mapped rather
+  // than rebuilt.
+  Result<void> MakeNodeIndex(
+      const std::string& column_name,
+      EntityIndexKind kind = EntityIndexKind::kSorted);
 
-  // Delete an existing index over a node property.
-  Result<void> DeleteNodeIndex(const std::string& column_name);
+  // Writes the sorted index over a node property next to the stored
+  // property so that later calls to MakeNodeIndex can map it. Fails if the
+  // property has been modified since it was last stored. Writing the graph
+  // persists every sorted index, so this is only needed for indexes made
+  // after the last write.
+  Result<void> PersistNodeIndex(const std::string& column_name);
 
-  // Creates an index over an edge property.
-  Result<void> MakeEdgeIndex(const std::string& column_name);
+  // Delete the existing indexes over a node property.
+  Result<void> DeleteNodeIndex(const std::string& column_name);
 
-  // Delete an existing index over an edge property.
+  // Creates an index of the given kind over an edge property. If a sorted
+  // index was persisted alongside the stored property it is mapped rather
+  // than rebuilt.
+  Result<void> MakeEdgeIndex(
+      const std::string& column_name,
+      EntityIndexKind kind = EntityIndexKind::kSorted);
+
+  // Writes the sorted index over an edge property next to the stored
+  // property so that later calls to MakeEdgeIndex can map it. Fails if the
+  // property has been modified since it was last stored. Writing the graph
+  // persists every sorted index, so this is only needed for indexes made
+  // after the last write.
+  Result<void> PersistEdgeIndex(const std::string& column_name);
+
+  // Delete the existing indexes over an edge property.
   Result<void> DeleteEdgeIndex(const std::string& column_name);
 
   // Returns the list of node indexes.
@@ -904,9 +1004,27 @@ public:
     return false;
   }
 
-  // Returns the property index associated with the named property
+  // Returns the sorted property index associated with the named property
+  katana::Result<katana::EntityIndex<GraphTopology::Node>*> GetNodeIndex(
+      const std::string& property_name) const {
+    return GetNodeIndex(property_name, EntityIndexKind::kSorted);
+  }
+
+  // Returns the property index of the given kind associated with the named
+  // property
   katana::Result<katana::EntityIndex<GraphTopology::Node>*> GetNodeIndex(
-      const std::string& property_name) const;
+      const std::string& property_name, EntityIndexKind kind) const;
+
+  // Returns the sorted edge property index associated with the named property
+  katana::Result<katana::EntityIndex<GraphTopology::Edge>*> GetEdgeIndex(
+      const std::string& property_name) const {
+    return GetEdgeIndex(property_name, EntityIndexKind::kSorted);
+  }
+
+  // Returns the edge property index of the given kind associated with the
+  // named property
+  katana::Result<katana::EntityIndex<GraphTopology::Edge>*> GetEdgeIndex(
+      const std::string& property_name, EntityIndexKind kind) const;
 };
 
 /// SortAllEdgesByDest sorts edges for each node by destination
@@ -1,6 +1,11 @@
 #ifndef KATANA_LIBGRAPH_KATANA_TOPOLOGYGENERATION_H_
 #define KATANA_LIBGRAPH_KATANA_TOPOLOGYGENERATION_H_
 
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
 #include <arrow/type_traits.h>
 
 #include "katana/PropertyGraph.h"
@@ -35,6 +40,50 @@ KATANA_EXPORT std::unique_ptr<katana::PropertyGraph> MakeClique(
 KATANA_EXPORT std::unique_ptr<katana::PropertyGraph> MakeTriangle(
     size_t num_rows) noexcept;
 
+/// A (source, destination) pair, as drawn by MakeRandomEdges
+using GeneratedEdge = std::pair<uint32_t, uint32_t>;
+
+/// Parameters of MakeRandomEdges and MakeRandomGraph
+struct RandomGraphOptions {
+  size_t num_nodes{0};
+  /// Number of edges; they may repeat unless distinct is set
+  size_t num_edges{0};
+  /// Seed of the std::mt19937 that draws the edges and their weights
+  uint64_t seed{0};
+  /// Edges only join the first num_nodes - num_isolated nodes
+  size_t num_isolated{0};
+  /// Redraw self loops and edges drawn before. There must be at least
+  /// num_edges such edges that pass edge_filter.
+  bool distinct{false};
+  /// If set, redraw edges for which it returns false
+  std::function<bool(uint32_t src, uint32_t dst)> edge_filter;
+  /// Store each edge in both directions, as SymmetricGraphTopologyBuilder
+  bool symmetric{false};
+  /// If set, called once per edge, right after it is drawn, to draw its
+  /// weight from the same generator. MakeRandomGraph stores the weights in
+  /// the uint32 edge property "weight".
+  std::function<uint32_t(std::mt19937*)> weight_generator;
+};
+
+/// Draws edges whose endpoints are chosen uniformly at random, in the order
+/// drawn. If weights is not null, it receives the weight of each edge.
+KATANA_EXPORT std::vector<GeneratedEdge> MakeRandomEdges(
+    const RandomGraphOptions& options,
+    std::vector<uint32_t>* weights = nullptr) noexcept;
+
+/// Generates a graph with the edges of MakeRandomEdges(options)
+KATANA_EXPORT std::unique_ptr<katana::PropertyGraph> MakeRandomGraph(
+    const RandomGraphOptions& options) noexcept;
+
+/// Generates a graph with the given edges, which may repeat. If weights is
+/// not empty it holds the weight of each edge, stored in the uint32 edge
+/// property "weight"; with symmetric, both directions of an edge get its
+/// weight.
+KATANA_EXPORT std::unique_ptr<katana::PropertyGraph> MakeGraphFromEdges(
+    size_t num_nodes, const std::vector<GeneratedEdge>& edges,
+    bool symmetric = false,
+    const std::vector<uint32_t>& weights = {}) noexcept;
+
 /***********************************************************/
 /* Functions for adding node and edge properties to graphs */
 /***********************************************************/
@@ -0,0 +1,90 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_CLUSTERWEIGHTACCUMULATOR_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_CLUSTERWEIGHTACCUMULATOR_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace katana::analytics {
+
+/// Sums edge weights by cluster, for the neighbors of one node or the
+/// members of one cluster at a time. Clusters are kept in the order they were
+/// first added, and an open-addressing hash table maps each cluster to its
+/// position. An accumulator is meant to be reused, one per thread: its table
+/// only grows, and Clear only resets the slots in use.
+template <typename EdgeWeightType>
+class ClusterWeightAccumulator {
+public:
+  /// Forget all clusters
+  void Clear() {
+    for (uint32_t slot : used_slots_) {
+      slots_[slot] = kEmpty;
+    }
+    used_slots_.clear();
+    clusters_.clear();
+    weights_.clear();
+  }
+
+  /// Add weight to the weight of cluster, adding the cluster if it is new
+  void Add(uint64_t cluster, EdgeWeightType weight) {
+    if (2 * (clusters_.size() + 1) > slots_.size()) {
+      Grow();
+    }
+    size_t slot = Hash(cluster);
+    while (slots_[slot] != kEmpty) {
+      uint32_t index = slots_[slot];
+      if (clusters_[index] == cluster) {
+        weights_[index] += weight;
+        return;
+      }
+      slot = (slot + 1) & (slots_.size() - 1);
+    }
+    slots_[slot] = clusters_.size();
+    used_slots_.emplace_back(slot);
+    clusters_.emplace_back(cluster);
+    weights_.emplace_back(weight);
+  }
+
+  /// Number of clusters
+  size_t size() const { return clusters_.size(); }
+
+  /// The i-th cluster added
+  uint64_t cluster(size_t i) const { return clusters_[i]; }
+
+  /// The weight of the i-th cluster added
+  EdgeWeightType weight(size_t i) const { return weights_[i]; }
+
+private:
+  static constexpr uint32_t kEmpty = std::numeric_limits<uint32_t>::max();
+
+  /// Fibonacci hashing; the top bits of the product are the best mixed
+  size_t Hash(uint64_t cluster) const {
+    return (cluster * UINT64_C(0x9e3779b97f4a7c15)) >> (64 - log_size_);
+  }
+
+  void Grow() {
+    log_size_ = std::max(log_size_ + 1, 4U);
+    slots_.assign(size_t{1} << log_size_, kEmpty);
+    used_slots_.clear();
+    for (size_t i = 0; i < clusters_.size(); ++i) {
+      size_t slot = Hash(clusters_[i]);
+      while (slots_[slot] != kEmpty) {
+        slot = (slot + 1) & (slots_.size() - 1);
+      }
+      slots_[slot] = i;
+      used_slots_.emplace_back(slot);
+    }
+  }
+
+  unsigned log_size_{0};
+  std::vector<uint32_t> slots_;
+  std::vector<uint32_t> used_slots_;
+  std::vector<uint64_t> clusters_;
+  std::vector<EdgeWeightType> weights_;
+};
+
+}  // namespace katana::analytics
+
+#endif
@@ -20,15 +20,25 @@
 #ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_CLUSTERINGIMPLEMENTATIONBASE_H_
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <random>
 #include <set>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/Galois.h"
+#include "katana/GraphTopology.h"
 #include "katana/NUMAArray.h"
+#include "katana/Properties.h"
+#include "katana/Traits.h"
+#include "katana/analytics/ClusterWeightAccumulator.h"
 #include "katana/analytics/Utils.h"
 
 namespace katana::analytics {
@@ -64,6 +74,91 @@ using EdgeWeight = katana::PODProperty<EdgeWeightType>;
 struct CurrentSubCommunityID : public katana::PODProperty<uint64_t> {};
 struct NodeWeight : public katana::PODProperty<uint64_t> {};
 
+/// A weighted graph for the coarsened levels of hierarchical clustering. The
+/// topology, the edge weights and the node properties in NodeProps are plain
+/// arrays, so making a level does not build a PropertyGraph or any Arrow
+/// table. It has the part of the TypedPropertyGraph interface the clustering
+/// algorithms use. Edges are stored in both directions, so the out-edges of
+/// a node are all its edges.
+template <typename NodeProps, typename EdgeWeightType>
+class ClusteringCoarseGraph;
+
+template <typename... NodeProps, typename EdgeWeightType>
+class ClusteringCoarseGraph<std::tuple<NodeProps...>, EdgeWeightType> {
+public:
+  using node_properties = std::tuple<NodeProps...>;
+  using node_iterator = GraphTopology::node_iterator;
+  using edge_iterator = GraphTopology::edge_iterator;
+  using edges_range = GraphTopology::edges_range;
+  using iterator = GraphTopology::iterator;
+  using Node = GraphTopology::Node;
+  using Edge = GraphTopology::Edge;
+
+  ClusteringCoarseGraph(
+      GraphTopology&& topology, katana::NUMAArray<EdgeWeightType>&& weights)
+      : topology_(std::move(topology)), edge_weights_(std::move(weights)) {
+    KATANA_LOG_DEBUG_ASSERT(edge_weights_.size() == topology_.NumEdges());
+    std::apply(
+        [&](auto&... arrays) {
+          (arrays.allocateBlocked(topology_.NumNodes()), ...);
+          (katana::ParallelSTL::fill(arrays.begin(), arrays.end(), 0), ...);
+        },
+        node_data_);
+  }
+
+  node_iterator begin() const { return node_iterator(0); }
+
+  node_iterator end() const { return node_iterator(NumNodes()); }
+
+  size_t size() const { return topology_.NumNodes(); }
+
+  bool empty() const { return size() == 0; }
+
+  uint64_t NumNodes() const { return topology_.NumNodes(); }
+
+  uint64_t NumEdges() const { return topology_.NumEdges(); }
+
+  template <typename NodeProp>
+  PropertyReferenceType<NodeProp> GetData(Node node) {
+    constexpr size_t index = find_trait<NodeProp, node_properties>();
+    return std::get<index>(node_data_)[node];
+  }
+
+  template <typename NodeProp>
+  PropertyConstReferenceType<NodeProp> GetData(Node node) const {
+    constexpr size_t index = find_trait<NodeProp, node_properties>();
+    return std::get<index>(node_data_)[node];
+  }
+
+  /// The only edge property is the edge weight
+  template <typename EdgeProp>
+  EdgeWeightType& GetEdgeData(Edge edge) {
+    static_assert(std::is_same_v<
+                  PropertyValueType<EdgeProp>, EdgeWeightType>);
+    return edge_weights_[edge];
+  }
+
+  template <typename EdgeProp>
+  const EdgeWeightType& GetEdgeData(Edge edge) const {
+    static_assert(std::is_same_v<
+                  PropertyValueType<EdgeProp>, EdgeWeightType>);
+    return edge_weights_[edge];
+  }
+
+  edges_range OutEdges() const { return topology_.OutEdges(); }
+
+  edges_range OutEdges(Node node) const { return topology_.OutEdges(node); }
+
+  Node OutEdgeDst(Edge edge) const { return topology_.OutEdgeDst(edge); }
+
+  size_t OutDegree(Node node) const { return topology_.OutDegree(node); }
+
+private:
+  GraphTopology topology_;
+  katana::NUMAArray<EdgeWeightType> edge_weights_;
+  std::tuple<katana::NUMAArray<PropertyValueType<NodeProps>>...> node_data_;
+};
+
 template <typename _Graph, typename _EdgeType, typename _CommunityType>
 struct ClusteringImplementationBase {
   using Graph = _Graph;
@@ -77,29 +172,25 @@ struct ClusteringImplementationBase {
       std::numeric_limits<double>::max() / 4;
 
   using CommunityArray = katana::NUMAArray<CommunityType>;
+  using ClusterWeights = ClusterWeightAccumulator<EdgeTy>;
 
   /**
    * Algorithm to find the best cluster for the node
    * to move to among its neighbors in the graph and moves.
    *
-   * It updates the mapping of neighboring nodes clusters
-   * in cluster_local_map, total unique cluster edge weights
-   * in counter as well as total weight of self edges in self_loop_wt.
+   * It sums up the edge weights from n to each neighboring cluster
+   * in cluster_weights, starting with the current cluster of n, and
+   * the total weight of self edges in self_loop_wt.
    */
   template <typename EdgeWeightType>
   static void FindNeighboringClusters(
-      const Graph& graph, const GNode& n,
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeTy>& counter, EdgeTy& self_loop_wt) {
-    uint64_t num_unique_clusters = 0;
+      const Graph& graph, const GNode& n, ClusterWeights* cluster_weights,
+      EdgeTy& self_loop_wt) {
+    cluster_weights->Clear();
 
     // Add the node's current cluster to be considered
     // for movement as well
-    cluster_local_map[graph.template GetData<CurrentCommunityID>(n)] =
-        0;                 // Add n's current cluster
-    counter.push_back(0);  // Initialize the counter to zero (no edges incident
-                           // yet)
-    num_unique_clusters++;
+    cluster_weights->Add(graph.template GetData<CurrentCommunityID>(n), 0);
 
     // Assuming we have grabbed lock on all the neighbors
     for (auto e : Edges(graph, n)) {
@@ -109,17 +200,8 @@ struct ClusteringImplementationBase {
       if (dst == n) {
         self_loop_wt += edge_wt;  // Self loop weights is recorded
       }
-      auto stored_already =
-          cluster_local_map.find(graph.template GetData<CurrentCommunityID>(
-              dst));  // Check if it already exists
-      if (stored_already != cluster_local_map.end()) {
-        counter[stored_already->second] += edge_wt;
-      } else {
-        cluster_local_map[graph.template GetData<CurrentCommunityID>(dst)] =
-            num_unique_clusters;
-        counter.push_back(edge_wt);
-        num_unique_clusters++;
-      }
+      cluster_weights->Add(
+          graph.template GetData<CurrentCommunityID>(dst), edge_wt);
     }  // End edge loop
   }
 
@@ -276,44 +358,41 @@ struct ClusteringImplementationBase {
    * without swapping the cluster assignment.
    */
   static uint64_t MaxModularityWithoutSwaps(
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeTy>& counter, uint64_t self_loop_wt,
+      const ClusterWeights& cluster_weights, EdgeTy self_loop_wt,
       CommunityArray& c_info, EdgeTy degree_wt, uint64_t sc, double constant) {
     uint64_t max_index = sc;  // Assign the intial value as self community
     double cur_gain = 0;
     double max_gain = 0;
-    double eix = counter[0] - self_loop_wt;
+    double eix = cluster_weights.weight(0) - self_loop_wt;
     double ax = c_info[sc].degree_wt - degree_wt;
     double eiy = 0;
     double ay = 0;
 
-    auto stored_already = cluster_local_map.begin();
-    do {
-      if (sc != stored_already->first) {
-        ay = c_info[stored_already->first].degree_wt;  // Degree wt of cluster y
+    // The choice does not depend on the order clusters are visited in, as
+    // ties are broken by cluster ID
+    for (size_t i = 0; i < cluster_weights.size(); ++i) {
+      uint64_t cluster = cluster_weights.cluster(i);
+      if (sc == cluster) {
+        continue;
+      }
+      ay = c_info[cluster].degree_wt;  // Degree wt of cluster y
 
-        if (ay < (ax + degree_wt)) {
-          stored_already++;
-          continue;
-        } else if (ay == (ax + degree_wt) && stored_already->first > sc) {
-          stored_already++;
-          continue;
-        }
+      if (ay < (ax + degree_wt)) {
+        continue;
+      } else if (ay == (ax + degree_wt) && cluster > sc) {
+        continue;
+      }
 
-        eiy = counter[stored_already
-                          ->second];  // Total edges incident on cluster y
-        cur_gain = 2 * constant * (eiy - eix) +
-                   2 * degree_wt * ((ax - ay) * constant * constant);
+      eiy = cluster_weights.weight(i);  // Total edges incident on cluster y
+      cur_gain = 2 * constant * (eiy - eix) +
+                 2 * degree_wt * ((ax - ay) * constant * constant);
 
-        if ((cur_gain > max_gain) ||
-            ((cur_gain == max_gain) && (cur_gain != 0) &&
-             (stored_already->first < max_index))) {
-          max_gain = cur_gain;
-          max_index = stored_already->first;
-        }
+      if ((cur_gain > max_gain) || ((cur_gain == max_gain) && (cur_gain != 0) &&
+                                    (cluster < max_index))) {
+        max_gain = cur_gain;
+        max_index = cluster;
       }
-      stored_already++;  // Explore next cluster
-    } while (stored_already != cluster_local_map.end());
+    }
 
     if ((c_info[max_index].size == 1 && c_info[sc].size == 1 &&
          max_index > sc)) {
@@ -436,31 +515,28 @@ struct ClusteringImplementationBase {
  */
   template <typename CommunityIDType>
   static uint64_t RenumberClustersContiguously(Graph* graph) {
-    std::map<uint64_t, uint64_t> cluster_local_map;
-    uint64_t num_unique_clusters = 0;
+    // Clusters keep their relative order: the new ID of a cluster is the
+    // number of clusters in use with smaller IDs
+    katana::NUMAArray<uint64_t> new_comm_ids;
+    new_comm_ids.allocateInterleaved(graph->NumNodes());
+    katana::ParallelSTL::fill(new_comm_ids.begin(), new_comm_ids.end(), 0);
 
-    // TODO(amber): parallelize
-    for (GNode n : graph->Nodes()) {
-      auto& n_data_curr_comm_id = graph->template GetData<CommunityIDType>(n);
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      auto n_data_curr_comm_id = graph->template GetData<CommunityIDType>(n);
       if (n_data_curr_comm_id != UNASSIGNED) {
-        auto stored_already = cluster_local_map.find(n_data_curr_comm_id);
-        if (stored_already == cluster_local_map.end()) {
-          cluster_local_map[n_data_curr_comm_id] = num_unique_clusters;
-          num_unique_clusters++;
-        }
+        new_comm_ids[n_data_curr_comm_id] = 1;
       }
-    }
+    });
 
-    uint64_t new_comm_id = 0;
-    for (std::pair<uint64_t, uint64_t> old_comm_id : cluster_local_map) {
-      cluster_local_map[old_comm_id.first] = new_comm_id;
-      new_comm_id++;
-    }
+    katana::ParallelSTL::partial_sum(
+        new_comm_ids.begin(), new_comm_ids.end(), new_comm_ids.begin());
+    uint64_t num_unique_clusters =
+        graph->NumNodes() == 0 ? 0 : new_comm_ids[graph->NumNodes() - 1];
 
     katana::do_all(katana::iterate(*graph), [&](GNode n) {
       auto& n_data_curr_comm_id = graph->template GetData<CommunityIDType>(n);
       if (n_data_curr_comm_id != UNASSIGNED) {
-        n_data_curr_comm_id = cluster_local_map[n_data_curr_comm_id];
+        n_data_curr_comm_id = new_comm_ids[n_data_curr_comm_id] - 1;
       }
     });
 
@@ -481,59 +557,145 @@ struct ClusteringImplementationBase {
   }
 
   /**
- * Creates a duplicate of the graph by copying the
- * graph (pfg_from) topology
- * (read from the underlying RDG) to the in-memory
- * temporary graph (pfg_to).
- * TODO(gill) replace with ephemeral graph
- */
-  static katana::Result<std::unique_ptr<katana::PropertyGraph>>
-  DuplicateGraphWithSameTopo(const katana::PropertyGraph& pfg_from) {
-    const katana::GraphTopology& topology_from = pfg_from.topology();
+   * Copies the graph and its edge weights into a CoarseGraph, the graph type
+   * of the coarsened levels. The edges of a node in the copy are the edges
+   * the algorithms see through Edges, so for an undirected view both the
+   * out-edges and the in-edges.
+   */
+  template <typename EdgeWeightType, typename CoarseGraph>
+  static CoarseGraph CopyGraph(const Graph& graph) {
+    katana::NUMAArray<uint64_t> adj_indices;
+    adj_indices.allocateInterleaved(graph.NumNodes());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) { adj_indices[n] = Degree(graph, n); },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        adj_indices.begin(), adj_indices.end(), adj_indices.begin());
+    const uint64_t num_edges =
+        graph.NumNodes() == 0 ? 0 : adj_indices[graph.NumNodes() - 1];
 
-    katana::GraphTopology topo_copy = GraphTopology::Copy(topology_from);
+    katana::NUMAArray<GraphTopology::Node> dests;
+    dests.allocateInterleaved(num_edges);
+    katana::NUMAArray<EdgeWeightType> weights;
+    weights.allocateInterleaved(num_edges);
 
-    auto pfg_to_res = katana::PropertyGraph::Make(std::move(topo_copy));
-    if (!pfg_to_res) {
-      return pfg_to_res.error();
-    }
-    return std::unique_ptr<katana::PropertyGraph>(
-        std::move(pfg_to_res.value()));
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          uint64_t pos = (n == 0) ? 0 : adj_indices[n - 1];
+          for (auto e : Edges(graph, n)) {
+            dests[pos] = EdgeDst(graph, e);
+            weights[pos] =
+                graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
+            ++pos;
+          }
+        },
+        katana::steal(), katana::loopname("CopyGraph"));
+
+    return CoarseGraph(
+        GraphTopology{std::move(adj_indices), std::move(dests)},
+        std::move(weights));
   }
 
   /**
- * Copy edge property from
- * property graph, pg_from to pg_to.
- */
-  static katana::Result<void> CopyEdgeProperty(
-      katana::PropertyGraph* pfg_from, katana::PropertyGraph* pfg_to,
-      const std::string& edge_property_name,
-      const std::string& new_edge_property_name, katana::TxnContext* txn_ctx) {
-    // Remove the existing edge property
-    if (pfg_to->HasEdgeProperty(new_edge_property_name)) {
-      if (auto r = pfg_to->RemoveEdgeProperty(new_edge_property_name, txn_ctx);
-          !r) {
-        return r.error();
-      }
-    }
-    // Copy edge properties
-    using ArrowType = typename arrow::CTypeTraits<EdgeTy>::ArrowType;
-    auto edge_property_result =
-        pfg_from->GetEdgePropertyTyped<EdgeTy>(edge_property_name);
-    if (!edge_property_result) {
-      return edge_property_result.error();
-    }
-    auto edge_property = edge_property_result.value();
-    std::vector<std::shared_ptr<arrow::Field>> fields;
-    std::vector<std::shared_ptr<arrow::Array>> columns;
-    fields.emplace_back(
-        arrow::field((new_edge_property_name), std::make_shared<ArrowType>()));
-    columns.emplace_back(edge_property);
-    auto edge_data_table = arrow::Table::Make(arrow::schema(fields), columns);
-    if (auto r = pfg_to->AddEdgeProperties(edge_data_table, txn_ctx); !r) {
-      return r.error();
+   * Builds the first level of the hierarchy from the input graph and
+   * initializes clusters_orig, the cluster of each input node.
+   *
+   * With vertex following, isolated nodes are left out and nodes of degree
+   * one are merged into their neighbor, and clusters_orig maps each node to
+   * its node in the first level. Otherwise, the first level is a copy of the
+   * graph and clusters_orig is UNASSIGNED.
+   */
+  template <typename EdgeWeightType, typename CoarseGraph>
+  static CoarseGraph MakeFirstLevel(
+      Graph* graph, bool enable_vf,
+      katana::NUMAArray<uint64_t>* clusters_orig) {
+    if (!enable_vf) {
+      katana::do_all(katana::iterate(*graph), [&](GNode n) {
+        (*clusters_orig)[n] = UNASSIGNED;
+      });
+      return CopyGraph<EdgeWeightType, CoarseGraph>(*graph);
     }
-    return katana::ResultSuccess();
+
+    VertexFollowing(graph);  // Find nodes that follow other nodes
+
+    uint64_t num_unique_clusters =
+        RenumberClustersContiguously<CurrentCommunityID>(graph);
+
+    katana::do_all(katana::iterate(*graph), [&](GNode n) {
+      (*clusters_orig)[n] = graph->template GetData<CurrentCommunityID>(n);
+    });
+
+    // Build new graph to remove the isolated nodes
+    return GraphCoarsening<EdgeWeightType, CurrentCommunityID, CoarseGraph>(
+        *graph, num_unique_clusters);
+  }
+
+  /**
+   * Sorts the nodes by cluster with a parallel counting sort. The nodes of
+   * cluster c end up in (*cluster_nodes)[(*cluster_offsets)[c]] to
+   * (*cluster_nodes)[(*cluster_offsets)[c + 1] - 1], in increasing order.
+   * Unassigned nodes are left out.
+   */
+  template <typename CommunityIDType>
+  static void SortNodesByCluster(
+      const Graph& graph, uint64_t num_clusters,
+      katana::NUMAArray<uint64_t>* cluster_offsets,
+      katana::NUMAArray<GNode>* cluster_nodes) {
+    katana::NUMAArray<std::atomic<uint64_t>> cursors;
+    cursors.allocateInterleaved(num_clusters + 1);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_clusters + 1),
+        [&](uint64_t c) { cursors[c] = 0; }, katana::no_stats());
+
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto n_data_curr_comm_id = graph.template GetData<CommunityIDType>(n);
+          if (n_data_curr_comm_id != UNASSIGNED) {
+            cursors[n_data_curr_comm_id + 1].fetch_add(
+                1, std::memory_order_relaxed);
+          }
+        },
+        katana::no_stats());
+
+    cluster_offsets->allocateInterleaved(num_clusters + 1);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_clusters + 1),
+        [&](uint64_t c) { (*cluster_offsets)[c] = cursors[c]; },
+        katana::no_stats());
+    katana::ParallelSTL::partial_sum(
+        cluster_offsets->begin(), cluster_offsets->end(),
+        cluster_offsets->begin());
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_clusters),
+        [&](uint64_t c) { cursors[c] = (*cluster_offsets)[c]; },
+        katana::no_stats());
+
+    cluster_nodes->allocateInterleaved((*cluster_offsets)[num_clusters]);
+    katana::do_all(
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto n_data_curr_comm_id = graph.template GetData<CommunityIDType>(n);
+          if (n_data_curr_comm_id != UNASSIGNED) {
+            uint64_t pos = cursors[n_data_curr_comm_id].fetch_add(
+                1, std::memory_order_relaxed);
+            (*cluster_nodes)[pos] = n;
+          }
+        },
+        katana::no_stats());
+
+    // Threads placed the nodes of a cluster in any order; sorting them makes
+    // the coarsened graph independent of scheduling
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_clusters),
+        [&](uint64_t c) {
+          std::sort(
+              cluster_nodes->begin() + (*cluster_offsets)[c],
+              cluster_nodes->begin() + (*cluster_offsets)[c + 1]);
+        },
+        katana::steal(), katana::no_stats());
   }
 
   /**
@@ -544,16 +706,13 @@ struct ClusteringImplementationBase {
  * the number of unique clusters in the previous level of the graph.
  * All the edges inside a cluster are merged (edge weights are summed
  * up) to form the edges within super nodes.
+ * The coarsened graph is a CoarseGraph, such as a ClusteringCoarseGraph,
+ * and its node properties start at zero.
  */
   template <
-      typename NodeData, typename EdgeData, typename EdgeWeightType,
-      typename CommunityIDType>
-  static katana::Result<std::unique_ptr<katana::PropertyGraph>> GraphCoarsening(
-      const Graph& graph, katana::PropertyGraph* pfg_mutable,
-      uint64_t num_unique_clusters,
-      const std::vector<std::string>& temp_node_property_names,
-      const std::vector<std::string>& temp_edge_property_names,
-      katana::TxnContext* txn_ctx) {
+      typename EdgeWeightType, typename CommunityIDType, typename CoarseGraph>
+  static CoarseGraph GraphCoarsening(
+      const Graph& graph, uint64_t num_unique_clusters) {
     using GNode = typename Graph::Node;
 
     katana::StatTimer TimerGraphBuild("Timer_Graph_build");
@@ -561,63 +720,67 @@ struct ClusteringImplementationBase {
 
     const uint64_t num_nodes_next = num_unique_clusters;
 
-    std::vector<std::vector<GNode>> cluster_bags(num_unique_clusters);
-    // TODO(amber): This loop can be parallelized when using a concurrent container
-    // for cluster_bags, but something like katana::InsertBag exhausts the
-    // per-thread-storage memory
-    for (GNode n = 0; n < graph.NumNodes(); ++n) {
-      auto n_data_curr_comm_id = graph.template GetData<CommunityIDType>(n);
-      if (n_data_curr_comm_id != UNASSIGNED) {
-        cluster_bags[n_data_curr_comm_id].push_back(n);
+    katana::NUMAArray<uint64_t> cluster_offsets;
+    katana::NUMAArray<GNode> cluster_nodes;
+    SortNodesByCluster<CommunityIDType>(
+        graph, num_unique_clusters, &cluster_offsets, &cluster_nodes);
+
+    // Sums up the weights of the edges from the nodes of cluster c to each
+    // cluster, in the order the clusters are first reached
+    katana::PerThreadStorage<ClusterWeights> cluster_weights;
+    auto sum_cluster_edges = [&](uint64_t c) -> const ClusterWeights& {
+      ClusterWeights& local = *cluster_weights.getLocal();
+      local.Clear();
+      for (uint64_t i = cluster_offsets[c]; i < cluster_offsets[c + 1]; ++i) {
+        GNode node = cluster_nodes[i];
+        for (auto e : Edges(graph, node)) {
+          auto dst_data_curr_comm_id =
+              graph.template GetData<CommunityIDType>(EdgeDst(graph, e));
+          KATANA_LOG_DEBUG_ASSERT(dst_data_curr_comm_id != UNASSIGNED);
+          local.Add(
+              dst_data_curr_comm_id,
+              graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e));
+        }
       }
-    }
+      return local;
+    };
 
-    std::vector<katana::gstl::Vector<uint32_t>> edges_id(num_unique_clusters);
-    std::vector<katana::gstl::Vector<EdgeTy>> edges_data(num_unique_clusters);
+    using Node = katana::GraphTopology::Node;
 
-    /* First pass to find the number of edges */
-    katana::do_all(
-        katana::iterate(uint64_t{0}, num_unique_clusters),
-        [&](uint64_t c) {
-          katana::gstl::Map<uint64_t, uint64_t> cluster_local_map;
-          uint64_t num_unique_clusters = 0;
-          for (auto node : cluster_bags[c]) {
-            KATANA_LOG_DEBUG_ASSERT(
-                graph.template GetData<CommunityIDType>(node) ==
-                c);  // All nodes in this bag must have same cluster id
-
-            for (auto e : Edges(graph, node)) {
-              auto dst = EdgeDst(graph, e);
-              auto dst_data_curr_comm_id =
-                  graph.template GetData<CommunityIDType>(dst);
-              KATANA_LOG_DEBUG_ASSERT(dst_data_curr_comm_id != UNASSIGNED);
-              auto stored_already = cluster_local_map.find(
-                  dst_data_curr_comm_id);  // Check if it already exists
-              if (stored_already != cluster_local_map.end()) {
-                edges_data[c][stored_already->second] +=
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e);
-              } else {
-                cluster_local_map[dst_data_curr_comm_id] = num_unique_clusters;
-                edges_id[c].push_back(dst_data_curr_comm_id);
-                edges_data[c].push_back(
-                    graph.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e));
-                num_unique_clusters++;
-              }
-            }  // End edge loop
-          }
-        },
-        katana::steal(), katana::loopname("BuildGraph: Find edges"));
+    // Coarse edges of the clusters a thread summed, in the order it summed
+    // them; cluster c starts at spill_offsets[c] in spill_owners[c]. Owners
+    // are kept as pointers because getTID() is relative to the pool the loop
+    // runs in, which need not be the pool spills was made in.
+    struct EdgeSpill {
+      std::vector<Node> dests;
+      std::vector<EdgeWeightType> weights;
+    };
+    katana::PerThreadStorage<EdgeSpill> spills;
+    katana::NUMAArray<const EdgeSpill*> spill_owners;
+    spill_owners.allocateInterleaved(num_unique_clusters);
+    katana::NUMAArray<uint64_t> spill_offsets;
+    spill_offsets.allocateInterleaved(num_unique_clusters);
 
-    /* Serial loop to reduce all the edge counts */
+    /* First pass to sum up and count the edges of each cluster */
     katana::NUMAArray<uint64_t> prefix_edges_count;
     prefix_edges_count.allocateInterleaved(num_unique_clusters);
 
     katana::GAccumulator<uint64_t> num_edges_acc;
     katana::do_all(
-        katana::iterate(uint64_t{0}, num_nodes_next), [&](uint64_t c) {
-          prefix_edges_count[c] = edges_id[c].size();
-          num_edges_acc += prefix_edges_count[c];
-        });
+        katana::iterate(uint64_t{0}, num_nodes_next),
+        [&](uint64_t c) {
+          const ClusterWeights& edges = sum_cluster_edges(c);
+          EdgeSpill& spill = *spills.getLocal();
+          spill_owners[c] = &spill;
+          spill_offsets[c] = spill.dests.size();
+          for (size_t k = 0; k < edges.size(); ++k) {
+            spill.dests.emplace_back(edges.cluster(k));
+            spill.weights.emplace_back(edges.weight(k));
+          }
+          prefix_edges_count[c] = edges.size();
+          num_edges_acc += edges.size();
+        },
+        katana::steal(), katana::loopname("BuildGraph: Find edges"));
 
     const uint64_t num_edges_next = num_edges_acc.reduce();
 
@@ -630,93 +793,36 @@ struct ClusteringImplementationBase {
     katana::StatTimer TimerConstructFrom("Timer_Construct_From");
     TimerConstructFrom.start();
 
-    // Remove all the existing node/edge properties
-    for (auto property : temp_node_property_names) {
-      if (pfg_mutable->HasNodeProperty(property)) {
-        if (auto r = pfg_mutable->RemoveNodeProperty(property, txn_ctx); !r) {
-          return r.error();
-        }
-      }
-    }
-    for (auto property : temp_edge_property_names) {
-      if (pfg_mutable->HasEdgeProperty(property)) {
-        if (auto r = pfg_mutable->RemoveEdgeProperty(property, txn_ctx); !r) {
-          return r.error();
-        }
-      }
-    }
-
-    using Node = katana::GraphTopology::Node;
-    using Edge = katana::GraphTopology::Edge;
-
     katana::NUMAArray<Node> out_dests_next;
     out_dests_next.allocateInterleaved(num_edges_next);
 
     katana::NUMAArray<EdgeWeightType> edge_data_next;
     edge_data_next.allocateInterleaved(num_edges_next);
 
+    /* Second pass to copy the spilled edges in place */
     katana::do_all(
-        katana::iterate(uint64_t{0}, num_nodes_next), [&](uint64_t n) {
-          uint64_t number_of_edges =
-              (n == 0) ? prefix_edges_count[0]
-                       : (prefix_edges_count[n] - prefix_edges_count[n - 1]);
-          uint64_t start_index = (n == 0) ? 0 : prefix_edges_count[n - 1];
-          for (uint64_t k = 0; k < number_of_edges; ++k) {
-            out_dests_next[start_index + k] = edges_id[n][k];
-            edge_data_next[start_index + k] = edges_data[n][k];
-          }
-        });
+        katana::iterate(uint64_t{0}, num_nodes_next),
+        [&](uint64_t c) {
+          uint64_t start_index = (c == 0) ? 0 : prefix_edges_count[c - 1];
+          uint64_t num_edges = prefix_edges_count[c] - start_index;
+          const EdgeSpill& spill = *spill_owners[c];
+          std::copy_n(
+              spill.dests.begin() + spill_offsets[c], num_edges,
+              out_dests_next.begin() + start_index);
+          std::copy_n(
+              spill.weights.begin() + spill_offsets[c], num_edges,
+              edge_data_next.begin() + start_index);
+        },
+        katana::steal(), katana::loopname("BuildGraph: Write edges"));
 
     TimerConstructFrom.stop();
 
-    // TODO(amber): This is a lame attempt at freeing the memory back to each
-    // thread's pool of free pages and blocks. Due to stealing, the execution of
-    // do_all above that populates these containers may be different from the
-    // do_all below that frees them.
-    katana::do_all(
-        katana::iterate(uint64_t{0}, num_unique_clusters), [&](uint64_t c) {
-          edges_id[c] = gstl::Vector<uint32_t>();
-          edges_data[c] = gstl::Vector<EdgeTy>();
-        });
-
     GraphTopology topo_next{
         std::move(prefix_edges_count), std::move(out_dests_next)};
-    auto pfg_next_res = katana::PropertyGraph::Make(std::move(topo_next));
-
-    if (!pfg_next_res) {
-      return pfg_next_res.error();
-    }
-    std::unique_ptr<katana::PropertyGraph> pfg_next =
-        std::move(pfg_next_res.value());
-
-    if (auto result = katana::analytics::ConstructNodeProperties<NodeData>(
-            pfg_next.get(), txn_ctx, temp_node_property_names);
-        !result) {
-      return result.error();
-    }
-
-    if (auto result = katana::analytics::ConstructEdgeProperties<EdgeData>(
-            pfg_next.get(), txn_ctx, temp_edge_property_names);
-        !result) {
-      return result.error();
-    }
-
-    auto graph_result = Graph::Make(pfg_next.get());
-    if (!graph_result) {
-      return graph_result.error();
-    }
-    Graph graph_next = graph_result.value();
-    // TODO(amber): figure out a better way to add/update the edge property
-    katana::do_all(
-        katana::iterate(graph_next.OutEdges()),
-        [&](Edge e) {
-          graph_next.template GetEdgeData<EdgeWeight<EdgeWeightType>>(e) =
-              edge_data_next[e];
-        },
-        katana::no_stats());
+    CoarseGraph graph_next(std::move(topo_next), std::move(edge_data_next));
 
     TimerGraphBuild.stop();
-    return std::unique_ptr<katana::PropertyGraph>(std::move(pfg_next));
+    return graph_next;
   }
 
   /**
@@ -1073,37 +1179,34 @@ struct ClusteringImplementationBase {
 
   template <typename EdgeWeightType>
   uint64_t MaxCPMQualityWithoutSwaps(
-      std::map<uint64_t, uint64_t>& cluster_local_map,
-      std::vector<EdgeWeightType>& counter, EdgeWeightType self_loop_wt,
+      const ClusterWeights& cluster_weights, EdgeWeightType self_loop_wt,
       CommunityArray& c_info, uint64_t node_wt, uint64_t sc,
       double resolution) {
     uint64_t max_index = sc;  // Assign the initial value as self community
     double cur_gain = 0;
     double max_gain = 0;
-    double eix = counter[0] - self_loop_wt;
+    double eix = cluster_weights.weight(0) - self_loop_wt;
     double eiy = 0;
     auto size_x = static_cast<double>(c_info[sc].node_wt - node_wt);
     double size_y = 0;
 
-    auto stored_already = cluster_local_map.begin();
-    do {
-      if (sc != stored_already->first) {
-        eiy = counter[stored_already
-                          ->second];  // Total edges incident on cluster y
-        size_y = c_info[stored_already->first].node_wt;
-
-        cur_gain = 2.0 * (eiy - eix) - resolution *
-                                           static_cast<double>(node_wt) *
-                                           (size_y - size_x);
-        if ((cur_gain > max_gain) ||
-            ((cur_gain == max_gain) && (cur_gain != 0) &&
-             (stored_already->first < max_index))) {
-          max_gain = cur_gain;
-          max_index = stored_already->first;
-        }
+    for (size_t i = 0; i < cluster_weights.size(); ++i) {
+      uint64_t cluster = cluster_weights.cluster(i);
+      if (sc == cluster) {
+        continue;
       }
-      stored_already++;  // Explore next cluster
-    } while (stored_already != cluster_local_map.end());
+      eiy = cluster_weights.weight(i);  // Total edges incident on cluster y
+      size_y = c_info[cluster].node_wt;
+
+      cur_gain = 2.0 * (eiy - eix) - resolution *
+                                         static_cast<double>(node_wt) *
+                                         (size_y - size_x);
+      if ((cur_gain > max_gain) || ((cur_gain == max_gain) && (cur_gain != 0) &&
+                                    (cluster < max_index))) {
+        max_gain = cur_gain;
+        max_index = cluster;
+      }
+    }
 
     if ((c_info[max_index].size == 1 && c_info[sc].size == 1 &&
          max_index > sc)) {
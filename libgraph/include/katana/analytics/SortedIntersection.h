@@ -0,0 +1,276 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_SORTEDINTERSECTION_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_SORTEDINTERSECTION_H_
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Intersection of sorted neighbor lists, the inner loop of triangle
+/// counting, Jaccard similarity, k-truss and local clustering coefficient.
+///
+/// All functions here take lists of strictly increasing uint32_t values
+/// (e.g., the destinations of a node whose edges are sorted by destination,
+/// see BasicTopologyWrapper::OutEdgeDsts). Lists of similar length are merged
+/// a block at a time with SIMD all-pairs comparisons (16 lanes with AVX-512,
+/// 8 with AVX2, 4 with SSE2; the widest the build enables); when one list is
+/// much longer than the other the elements of the short list are instead
+/// searched for in the long one by galloping. NeighborBitmap covers the case
+/// where one list is intersected with many others.
+namespace katana::analytics {
+
+namespace internal {
+
+/// When one list is more than this many times longer than the other, gallop
+/// instead of merging
+constexpr size_t kGallopRatio = 32;
+
+#if defined(__AVX512F__)
+constexpr size_t kIntersectBlock = 16;
+#elif defined(__AVX2__)
+constexpr size_t kIntersectBlock = 8;
+#elif defined(__SSE2__)
+constexpr size_t kIntersectBlock = 4;
+#else
+constexpr size_t kIntersectBlock = 0;
+#endif
+
+/// Returns a mask with bit i set if a[i] is equal to any of
+/// b[0, kIntersectBlock)
+inline uint32_t
+MatchBlock(
+    [[maybe_unused]] const uint32_t* a, [[maybe_unused]] const uint32_t* b) {
+#if defined(__AVX512F__)
+  __m512i va = _mm512_loadu_si512(a);
+  __m512i vb = _mm512_loadu_si512(b);
+  const __m512i rotate = _mm512_set_epi32(
+      0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+  __mmask16 mask = _mm512_cmpeq_epi32_mask(va, vb);
+  for (size_t r = 1; r < kIntersectBlock; ++r) {
+    vb = _mm512_permutexvar_epi32(rotate, vb);
+    mask |= _mm512_cmpeq_epi32_mask(va, vb);
+  }
+  return mask;
+#elif defined(__AVX2__)
+  __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+  __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+  const __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+  __m256i eq = _mm256_cmpeq_epi32(va, vb);
+  for (size_t r = 1; r < kIntersectBlock; ++r) {
+    vb = _mm256_permutevar8x32_epi32(vb, rotate);
+    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+  }
+  return _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+#elif defined(__SSE2__)
+  __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+  __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+  __m128i eq = _mm_cmpeq_epi32(va, vb);
+  for (size_t r = 1; r < kIntersectBlock; ++r) {
+    vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, vb));
+  }
+  return _mm_movemask_ps(_mm_castsi128_ps(eq));
+#else
+  return 0;
+#endif
+}
+
+/// Returns the index of key in block b, which must contain it
+inline size_t
+FindInBlock(const uint32_t* b, uint32_t key) {
+  size_t j = 0;
+  while (b[j] != key) {
+    ++j;
+  }
+  return j;
+}
+
+/// Returns the first index in [lo, size) whose element is not less than key,
+/// probing lo, lo + 1, lo + 3, lo + 7, ... before binary searching
+inline size_t
+Gallop(const uint32_t* list, size_t lo, size_t size, uint32_t key) {
+  size_t hi = lo;
+  size_t step = 1;
+  while (hi < size && list[hi] < key) {
+    lo = hi + 1;
+    hi += step;
+    step *= 2;
+  }
+  hi = std::min(hi, size);
+  return std::lower_bound(list + lo, list + hi, key) - list;
+}
+
+inline bool
+IsSkewed(size_t a_size, size_t b_size) {
+  return a_size > b_size * kGallopRatio || b_size > a_size * kGallopRatio;
+}
+
+}  // namespace internal
+
+/// Calls fn(i, j) for every i, j such that a[i] == b[j], in increasing order,
+/// stopping early if fn returns false.
+template <typename Fn>
+void
+ForEachIntersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size,
+    Fn fn) {
+  using namespace internal;
+
+  if (a_size == 0 || b_size == 0) {
+    return;
+  }
+
+  if (IsSkewed(a_size, b_size)) {
+    if (a_size < b_size) {
+      for (size_t i = 0, j = 0; i < a_size; ++i) {
+        j = Gallop(b, j, b_size, a[i]);
+        if (j == b_size) {
+          return;
+        }
+        if (b[j] == a[i] && !fn(i, j)) {
+          return;
+        }
+      }
+    } else {
+      for (size_t i = 0, j = 0; j < b_size; ++j) {
+        i = Gallop(a, i, a_size, b[j]);
+        if (i == a_size) {
+          return;
+        }
+        if (a[i] == b[j] && !fn(i, j)) {
+          return;
+        }
+      }
+    }
+    return;
+  }
+
+  size_t i = 0;
+  size_t j = 0;
+  if constexpr (kIntersectBlock > 0) {
+    while (i + kIntersectBlock <= a_size && j + kIntersectBlock <= b_size) {
+      uint32_t mask = MatchBlock(a + i, b + j);
+      while (mask != 0) {
+        size_t k = __builtin_ctz(mask);
+        mask &= mask - 1;
+        if (!fn(i + k, j + FindInBlock(b + j, a[i + k]))) {
+          return;
+        }
+      }
+      uint32_t a_max = a[i + kIntersectBlock - 1];
+      uint32_t b_max = b[j + kIntersectBlock - 1];
+      i += a_max <= b_max ? kIntersectBlock : 0;
+      j += b_max <= a_max ? kIntersectBlock : 0;
+    }
+  }
+
+  while (i < a_size && j < b_size) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      if (!fn(i, j)) {
+        return;
+      }
+      ++i;
+      ++j;
+    }
+  }
+}
+
+/// Returns the number of elements common to a and b
+inline size_t
+CountIntersection(
+    const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size) {
+  using namespace internal;
+
+  if (a_size == 0 || b_size == 0) {
+    return 0;
+  }
+
+  size_t count = 0;
+  if (IsSkewed(a_size, b_size)) {
+    ForEachIntersection(a, a_size, b, b_size, [&count](size_t, size_t) {
+      ++count;
+      return true;
+    });
+    return count;
+  }
+
+  size_t i = 0;
+  size_t j = 0;
+  if constexpr (kIntersectBlock > 0) {
+    while (i + kIntersectBlock <= a_size && j + kIntersectBlock <= b_size) {
+      count += __builtin_popcount(MatchBlock(a + i, b + j));
+      uint32_t a_max = a[i + kIntersectBlock - 1];
+      uint32_t b_max = b[j + kIntersectBlock - 1];
+      i += a_max <= b_max ? kIntersectBlock : 0;
+      j += b_max <= a_max ? kIntersectBlock : 0;
+    }
+  }
+
+  while (i < a_size && j < b_size) {
+    uint32_t x = a[i];
+    uint32_t y = b[j];
+    count += x == y;
+    i += x <= y;
+    j += y <= x;
+  }
+  return count;
+}
+
+/// A bitmap over node IDs for intersecting one (typically high degree) list
+/// with many others. Loading the list once makes each later intersection
+/// cost O(size of the other list), independent of the degree of the hub,
+/// and does not require the other lists to be sorted.
+class NeighborBitmap {
+public:
+  explicit NeighborBitmap(size_t num_nodes)
+      : words_((num_nodes + kBitsPerWord - 1) / kBitsPerWord) {}
+
+  /// Sets the bits of list; the bitmap must be cleared before loading
+  /// another list
+  void Load(const uint32_t* list, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      words_[list[i] / kBitsPerWord] |= uint64_t{1}
+                                        << (list[i] % kBitsPerWord);
+    }
+  }
+
+  /// Clears the bits of a list previously loaded; cheaper than clearing the
+  /// whole bitmap when the list is short relative to the number of nodes
+  void Clear(const uint32_t* list, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      words_[list[i] / kBitsPerWord] = 0;
+    }
+  }
+
+  bool Test(uint32_t node) const {
+    return (words_[node / kBitsPerWord] >> (node % kBitsPerWord)) & 1;
+  }
+
+  /// Returns the number of elements of list that are in the loaded list
+  size_t Count(const uint32_t* list, size_t size) const {
+    size_t count = 0;
+    for (size_t i = 0; i < size; ++i) {
+      count += Test(list[i]);
+    }
+    return count;
+  }
+
+private:
+  static constexpr size_t kBitsPerWord = 64;
+
+  std::vector<uint64_t> words_;
+};
+
+}  // namespace katana::analytics
+
+#endif
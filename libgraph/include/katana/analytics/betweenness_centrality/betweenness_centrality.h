@@ -18,16 +18,39 @@ public:
   enum Algorithm {
     kLevel,
     kOuter,
+    kApproximate,
     // TODO(gill): Reinstate async and auto once we have bidirectional graphs.
     // kAsynchronous,
     // kAutomatic,
   };
 
+  static constexpr double kDefaultEpsilon = 1.0e-3;
+  static constexpr double kDefaultDelta = 0.1;
+  static const uint32_t kDefaultSourcesPerBatch = 16;
+  static const uint32_t kMaxSourcesPerBatch = 64;
+  static const uint64_t kDefaultSeed = 0;
+
 private:
   Algorithm algorithm_;
+  double epsilon_;
+  double delta_;
+  uint32_t sources_per_batch_;
+  uint64_t seed_;
+
+  BetweennessCentralityPlan(
+      Architecture architecture, Algorithm algorithm, double epsilon,
+      double delta, uint32_t sources_per_batch, uint64_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        epsilon_(epsilon),
+        delta_(delta),
+        sources_per_batch_(sources_per_batch),
+        seed_(seed) {}
 
   BetweennessCentralityPlan(Architecture architecture, Algorithm algorithm)
-      : Plan(architecture), algorithm_(algorithm) {}
+      : BetweennessCentralityPlan{
+            architecture, algorithm, kDefaultEpsilon, kDefaultDelta,
+            kDefaultSourcesPerBatch, kDefaultSeed} {}
 
 public:
   BetweennessCentralityPlan() : BetweennessCentralityPlan{kCPU, kLevel} {}
@@ -51,10 +74,54 @@ public:
 
   Algorithm algorithm() const { return algorithm_; }
 
+  /// Maximum error of the normalized centrality of the approximate algorithm
+  double epsilon() const { return epsilon_; }
+
+  /// Probability that the approximate algorithm exceeds epsilon anywhere
+  double delta() const { return delta_; }
+
+  /// Number of sources the approximate algorithm explores in one pass; at
+  /// most kMaxSourcesPerBatch
+  uint32_t sources_per_batch() const { return sources_per_batch_; }
+
+  /// Seed of the random number generator of the approximate algorithm
+  uint64_t seed() const { return seed_; }
+
   static BetweennessCentralityPlan Level() { return {kCPU, kLevel}; }
 
   static BetweennessCentralityPlan Outer() { return {kCPU, kOuter}; }
 
+  /// Approximate algorithm
+  ///
+  /// Sources are sampled uniformly at random and their dependencies are
+  /// summed as in the level algorithm, sources_per_batch sources at a time:
+  /// one level-synchronous pass explores every source of a batch, with the
+  /// sources that reach a node at a level packed into a bit mask. Sampling
+  /// stops once an empirical Bernstein bound shows that, with probability
+  /// at least 1 - delta, the centrality of every node divided by
+  /// n * (n - 2) is within epsilon of the exact value. Without a limit on
+  /// the number of sources, this takes at most ln(4 * n / delta) /
+  /// (2 * epsilon^2) sources, and usually far fewer.
+  ///
+  /// Each source of a batch keeps a shortest path count and a dependency per
+  /// node, so the algorithm takes 12 * sources_per_batch + 40 bytes per
+  /// node, about 800 bytes per node with 64 sources per batch. Only the
+  /// nodes a batch reaches are reset before the next one.
+  ///
+  /// BRANDES, Ulrik; PICH, Christian. Centrality estimation in large
+  /// networks. International Journal of Bifurcation and Chaos, 2007, 17.07:
+  /// 2303-2318.
+  ///
+  /// MAURER, Andreas; PONTIL, Massimiliano. Empirical Bernstein bounds and
+  /// sample variance penalization. In: Proceedings of the 22nd Annual
+  /// Conference on Learning Theory (COLT). 2009.
+  static BetweennessCentralityPlan Approximate(
+      double epsilon = kDefaultEpsilon, double delta = kDefaultDelta,
+      uint32_t sources_per_batch = kDefaultSourcesPerBatch,
+      uint64_t seed = kDefaultSeed) {
+    return {kCPU, kApproximate, epsilon, delta, sources_per_batch, seed};
+  }
+
   static BetweennessCentralityPlan FromAlgorithm(Algorithm algo) {
     return BetweennessCentralityPlan(kCPU, algo);
   }
@@ -78,6 +145,9 @@ KATANA_EXPORT extern const BetweennessCentralitySources
 /// @param sources Only process some sources, producing an approximate
 ///          betweenness centrality. If this is a vector process those source
 ///          nodes; if this is an int process that number of source nodes.
+///          With the approximate algorithm, this must be an int, and it
+///          limits the number of sampled sources; if the limit is reached
+///          before the bound holds, the (epsilon, delta) guarantee is lost.
 /// @param plan
 KATANA_EXPORT Result<void> BetweennessCentrality(
     PropertyGraph* pg, const std::string& output_property_name,
@@ -2,6 +2,8 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_BFS_BFS_H_
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "katana/analytics/Plan.h"
 #include "katana/analytics/Utils.h"
@@ -87,6 +89,36 @@ KATANA_EXPORT Result<void> Bfs(
 KATANA_EXPORT Result<void> BfsAssertValid(
     PropertyGraph* pg, uint32_t source, const std::string& property_name);
 
+/// The number of sources MultiSourceBfs searches from together, one bit of a
+/// 64-bit mask per source.
+constexpr size_t kMultiSourceBfsBatchSize = 64;
+
+/// Compute the BFS distances of nodes in the graph pg from each node in
+/// sources. Sources are searched in batches of kMultiSourceBfsBatchSize that
+/// share one traversal of the graph, so a batch costs about as much as a
+/// single BFS. Each step of a batch is top-down or bottom-up, chosen with
+/// the alpha parameter of the plan as in BfsPlan::SynchronousDirectOpt,
+/// which is the only supported algorithm.
+///
+/// The result is stored in a large_list<uint32> property named by
+/// output_property_name. Element i of the list of a node is its distance
+/// from sources[i], or the maximum uint32_t value if it is unreachable.
+/// The property is created by this function and may not exist before the
+/// call.
+KATANA_EXPORT Result<void> MultiSourceBfs(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    BfsPlan algo = {});
+
+/// Check that the distances computed by MultiSourceBfs and stored in
+/// property_name are BFS levels from each source. This check is exhaustive
+/// and costs one pass over the edges per source.
+/// @return a failure if the results do not pass validation or if there is a
+///     failure during checking.
+KATANA_EXPORT Result<void> MultiSourceBfsAssertValid(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& property_name);
+
 /// Statistics about a graph that can be extracted from the results of BFS.
 struct KATANA_EXPORT BfsStatistics {
   /// The number of nodes reachable from the source node.
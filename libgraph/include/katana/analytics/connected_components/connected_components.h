@@ -2,6 +2,9 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_CONNECTEDCOMPONENTS_CONNECTEDCOMPONENTS_H_
 
 #include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/analytics/Plan.h"
@@ -162,6 +165,26 @@ KATANA_EXPORT Result<void> ConnectedComponents(
     katana::TxnContext* txn_ctx, const bool& is_symmetric = false,
     ConnectedComponentsPlan plan = ConnectedComponentsPlan());
 
+/// Update the connected components of pg after the edges in inserted_edges
+/// were added to it, starting from the labels stored in the property named
+/// previous_property_name.
+///
+/// Labels are the smallest node ID in the component of each node, so they do
+/// not depend on the order in which edges arrive, and the label property is
+/// itself a union-find forest in which every node points to its root. Each
+/// batch merges the inserted edges into that forest in parallel with the
+/// lock-free union-find merge and does not revisit the rest of the graph.
+/// Edges are treated as undirected, and edge deletions are not supported.
+///
+/// If previous_property_name is empty, the labels are computed from scratch
+/// from the edges of pg, in addition to inserted_edges. The property named
+/// output_property_name is created by this function and may not exist before
+/// the call; it can seed the next batch.
+KATANA_EXPORT Result<void> ConnectedComponentsIncremental(
+    PropertyGraph* pg, const std::string& previous_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx);
+
 KATANA_EXPORT Result<void> ConnectedComponentsAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
@@ -52,6 +52,23 @@ KATANA_EXPORT Result<void> KCore(
     const std::string& output_property_name, katana::TxnContext* txn_ctx,
     const bool& is_symmetric = false, KCorePlan plan = KCorePlan());
 
+/// Compute the core number of every node of pg, the largest k such that the
+/// node is in the k-core, in a single pass. Nodes are peeled in parallel from
+/// buckets of equal current degree, lowest bucket first.
+///
+/// The core numbers are stored in the property named output_property_name.
+/// If degeneracy_rank_property_name is not empty, the position of each node
+/// in the peeling order is stored in that property. This is a degeneracy
+/// ordering: each node has at most as many neighbors ranked after it as the
+/// largest core number, so orienting edges from lower to higher rank bounds
+/// the out-degree of every node, e.g., for triangle counting.
+/// The properties are created by this function and may not exist before the
+/// call.
+KATANA_EXPORT Result<void> KCoreness(
+    PropertyGraph* pg, const std::string& output_property_name,
+    const std::string& degeneracy_rank_property_name,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric = false);
+
 KATANA_EXPORT Result<void> KCoreAssertValid(
     PropertyGraph* pg, uint32_t k_core_number,
     const std::string& property_name);
@@ -2,6 +2,9 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_PAGERANK_PAGERANK_H_
 
 #include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "katana/Properties.h"
 #include "katana/PropertyGraph.h"
@@ -105,6 +108,107 @@ public:
   }
 };
 
+/// A computational plan for personalized Page Rank, specifying the algorithm
+/// and any parameters associated with it.
+class PersonalizedPagerankPlan : public Plan {
+public:
+  enum Algorithm {
+    kForwardPush,
+    kMonteCarlo,
+  };
+
+  static constexpr double kDefaultAlpha = 0.85;
+  static constexpr double kDefaultEpsilon = 1.0e-6;
+  static const uint32_t kDefaultNumberOfWalks = 100000;
+  static const uint64_t kDefaultSeed = 0;
+
+private:
+  Algorithm algorithm_;
+  float alpha_;
+  float epsilon_;
+  uint32_t number_of_walks_;
+  uint64_t seed_;
+
+  PersonalizedPagerankPlan(
+      Architecture architecture, Algorithm algorithm, float alpha,
+      float epsilon, uint32_t number_of_walks, uint64_t seed)
+      : Plan(architecture),
+        algorithm_(algorithm),
+        alpha_(alpha),
+        epsilon_(epsilon),
+        number_of_walks_(number_of_walks),
+        seed_(seed) {}
+
+public:
+  PersonalizedPagerankPlan() : PersonalizedPagerankPlan(ForwardPush()) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  /// Probability of following an out-edge instead of returning to the seeds
+  float alpha() const { return alpha_; }
+
+  /// Residual per out-edge below which forward push stops pushing a node
+  float epsilon() const { return epsilon_; }
+
+  /// Number of walks from each seed set of the Monte-Carlo algorithm
+  uint32_t number_of_walks() const { return number_of_walks_; }
+
+  /// Seed of the random number generator of the Monte-Carlo algorithm. The
+  /// ranks are a function of the graph, the plan and the seed only.
+  uint64_t seed() const { return seed_; }
+
+  /// Forward push algorithm
+  ///
+  /// Each node keeps an estimate and a residual per seed set. Pushing a node
+  /// moves (1 - alpha) of its residual into its estimate and spreads the
+  /// rest over its out-neighbors, until every residual is below epsilon
+  /// times the out-degree. The seed sets are processed
+  /// kPersonalizedPagerankBatchSize at a time with the residuals of a node
+  /// stored together, so one push serves the whole batch.
+  ///
+  /// ANDERSEN, Reid; CHUNG, Fan; LANG, Kevin. Local graph partitioning using
+  /// PageRank vectors. In: 47th Annual IEEE Symposium on Foundations of
+  /// Computer Science (FOCS'06). IEEE, 2006. p. 475-486.
+  static PersonalizedPagerankPlan ForwardPush(
+      float epsilon = kDefaultEpsilon, float alpha = kDefaultAlpha) {
+    return {kCPU, kForwardPush, alpha, epsilon, 0, kDefaultSeed};
+  }
+
+  /// Monte-Carlo algorithm
+  ///
+  /// Walks start at a random seed and stop with probability (1 - alpha) at
+  /// every step; the rank of a node is the fraction of walks that stop
+  /// there.
+  static PersonalizedPagerankPlan MonteCarlo(
+      uint32_t number_of_walks = kDefaultNumberOfWalks,
+      float alpha = kDefaultAlpha, uint64_t seed = kDefaultSeed) {
+    return {kCPU, kMonteCarlo, alpha, 0, number_of_walks, seed};
+  }
+};
+
+/// Number of seed sets forward push processes together. The residuals of a
+/// batch at one node fill a cache line.
+constexpr size_t kPersonalizedPagerankBatchSize = 16;
+
+/// The nodes with the highest personalized Page Rank of one seed set and
+/// their ranks, in decreasing order of rank
+using PersonalizedPagerankTopK = std::vector<std::pair<uint32_t, float>>;
+
+/// Compute the personalized Page Rank of each seed set in seed_sets and
+/// return, for each seed set, the k nodes with the highest rank.
+///
+/// The personalized Page Rank of seed set S is the stationary distribution
+/// of a walk that follows a random out-edge with probability alpha and
+/// otherwise jumps back to a random node of S. Walks that reach a node
+/// without out-edges and do not jump back are lost, so the ranks sum to less
+/// than 1 when such nodes are reachable. Nodes with a rank of 0 are never
+/// returned, so fewer than k nodes may be returned. Ties are broken by node
+/// ID.
+KATANA_EXPORT Result<std::vector<PersonalizedPagerankTopK>>
+PersonalizedPagerank(
+    PropertyGraph* pg, const std::vector<std::vector<uint32_t>>& seed_sets,
+    uint32_t k, PersonalizedPagerankPlan plan = {});
+
 /// Compute the Page Rank of each node in the graph.
 /// The property named output_property_name is created by this function and may
 /// not exist before the call.
@@ -112,6 +216,29 @@ KATANA_EXPORT Result<void> Pagerank(
     PropertyGraph* pg, const std::string& output_property_name,
     katana::TxnContext* txn_ctx, PagerankPlan plan = {});
 
+/// Update the Page Rank of each node after edges were inserted into or
+/// deleted from the graph, starting from the ranks stored in the property
+/// named previous_property_name. The previous ranks must have been computed
+/// by a push algorithm (PushAsynchronous or PushSynchronous) with the same
+/// alpha and tolerance, or by an earlier PagerankIncremental.
+///
+/// changed_nodes lists the sources and destinations of the inserted and
+/// deleted edges, and any inserted nodes (whose previous rank may be 0).
+/// Residuals are recomputed only at these nodes and the out-neighbors of
+/// these nodes, and the asynchronous push algorithm runs from there until
+/// every residual is within the tolerance. When a small part of the graph
+/// changed, the push touches a small part of the graph; copying the previous
+/// ranks in and the output property out still takes time linear in the
+/// number of nodes.
+///
+/// The plan must be a push plan. The property named output_property_name is
+/// created by this function and may not exist before the call.
+KATANA_EXPORT Result<void> PagerankIncremental(
+    PropertyGraph* pg, const std::string& previous_property_name,
+    const std::vector<uint32_t>& changed_nodes,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    PagerankPlan plan = {});
+
 KATANA_EXPORT Result<void> PagerankAssertValid(
     PropertyGraph* pg, const std::string& property_name);
 
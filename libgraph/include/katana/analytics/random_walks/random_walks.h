@@ -2,7 +2,9 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_RANDOMWALKS_RANDOMWALKS_H_
 
 #include <iostream>
+#include <string>
 
+#include <arrow/array.h>
 #include <katana/analytics/Plan.h>
 
 #include "katana/AtomicHelpers.h"
@@ -12,6 +14,33 @@
 
 namespace katana::analytics {
 
+/// A counter-based random number generator (SplitMix64). Each walk gets its
+/// own stream derived from the seed and the index of the walk, so walks do
+/// not depend on which thread generated them or in what order.
+class WalkRandom {
+public:
+  WalkRandom(uint64_t seed, uint64_t walk) : state_(Mix(seed ^ Mix(walk))) {}
+
+  uint64_t Next() { return Mix(state_ += kGamma); }
+
+  /// Uniform in [0, 1)
+  double NextDouble() { return (Next() >> 11) * 0x1.0p-53; }
+
+  /// Uniform in [0, n)
+  uint64_t NextIndex(uint64_t n) { return NextDouble() * n; }
+
+private:
+  static constexpr uint64_t kGamma = 0x9e3779b97f4a7c15;
+
+  static uint64_t Mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+
+  uint64_t state_;
+};
+
 /// A computational plan to for random walks, specifying the algorithm and any
 /// parameters associated with it.
 class RandomWalksPlan : public Plan {
@@ -26,6 +55,7 @@ public:
   constexpr static const double kDefaultForwardProbability = 1.0;
   static const uint32_t kDefaultMaxIterations = 10;
   static const uint32_t kDefaultNumberOfEdgeTypes = 1;
+  static const uint64_t kDefaultSeed = 0;
 
   // Don't allow people to directly construct these, so as to have only one
   // consistent way to configure.
@@ -40,12 +70,17 @@ private:
   // Only need for edge2vec
   // TODO(gill) Find number of edge types automatically
   uint32_t number_of_edge_types_;
+  // Only used by node2vec
+  std::string edge_weight_property_name_;
+  // Only used by node2vec
+  uint64_t seed_;
 
   RandomWalksPlan(
       Architecture architecture, Algorithm algorithm, uint32_t walk_length,
       uint32_t number_of_walks, double backward_probability,
       double forward_probability, uint32_t max_iterations,
-      uint32_t number_of_edge_types)
+      uint32_t number_of_edge_types,
+      std::string edge_weight_property_name = "", uint64_t seed = kDefaultSeed)
       : Plan(architecture),
         algorithm_(algorithm),
         walk_length_(walk_length),
@@ -53,7 +88,9 @@ private:
         backward_probability_(backward_probability),
         forward_probability_(forward_probability),
         max_iterations_(max_iterations),
-        number_of_edge_types_(number_of_edge_types) {}
+        number_of_edge_types_(number_of_edge_types),
+        edge_weight_property_name_(std::move(edge_weight_property_name)),
+        seed_(seed) {}
 
 public:
   // kChunkSize is fixed at 1
@@ -79,7 +116,8 @@ public:
   //  which do not change the expected output (though they may cause selecting a
   //  different correct output).
 
-  /// Length of random walks.
+  /// Number of steps of each random walk; a walk that is not cut short
+  /// visits walk_length + 1 nodes.
   uint32_t walk_length() const { return walk_length_; }
 
   /// Number of walks per node.
@@ -95,12 +133,26 @@ public:
 
   uint32_t number_of_edge_types() const { return number_of_edge_types_; }
 
+  /// Edge property holding the (non-negative, numeric) weight of each edge;
+  /// neighbors are sampled in proportion to it. Empty if all edges have
+  /// weight 1.
+  const std::string& edge_weight_property_name() const {
+    return edge_weight_property_name_;
+  }
+
+  /// Seed of the random number generator. The walks are a function of the
+  /// graph, the plan and the seed only, not of the number of threads or how
+  /// work was scheduled among them.
+  uint64_t seed() const { return seed_; }
+
   /// Node2Vec algorithm to generate random walks on the graph
   static RandomWalksPlan Node2Vec(
       uint32_t walk_length = kDefaultWalkLength,
       uint32_t number_of_walks = kDefaultNumberOfWalks,
       double backward_probability = kDefaultBackwardProbability,
-      double forward_probability = kDefaultBackwardProbability) {
+      double forward_probability = kDefaultBackwardProbability,
+      const std::string& edge_weight_property_name = "",
+      uint64_t seed = kDefaultSeed) {
     return {
         kCPU,
         kNode2Vec,
@@ -109,7 +161,9 @@ public:
         backward_probability,
         forward_probability,
         0,
-        1};
+        1,
+        edge_weight_property_name,
+        seed};
   }
 
   /// Edge2Vec algorithm to generate random walks on the graph.
@@ -140,6 +194,21 @@ public:
 KATANA_EXPORT Result<std::vector<std::vector<uint32_t>>> RandomWalks(
     PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan());
 
+/// Like RandomWalks but returns the walks in a single contiguous buffer, as
+/// a FixedSizeListArray of uint32 node IDs with one element per walk. Walks
+/// that end early, at a node without out-edges, are padded with nulls.
+///
+/// For node2vec the walks starting at the nodes with out-edges come in
+/// order of their first node, repeated number_of_walks times, and every walk
+/// has max(walk_length, 1) + 1 slots. Walks are generated directly into the
+/// result.
+///
+/// Edge2vec drops walks that end early, so each of its walks has
+/// max(walk_length, 1) + 1 nodes. Its walks are generated as in RandomWalks
+/// and then copied into the result.
+KATANA_EXPORT Result<std::shared_ptr<arrow::FixedSizeListArray>>
+RandomWalksFlat(PropertyGraph* pg, RandomWalksPlan plan = RandomWalksPlan());
+
 KATANA_EXPORT Result<void> RandomWalksAssertValid(PropertyGraph* pg);
 
 }  // namespace katana::analytics
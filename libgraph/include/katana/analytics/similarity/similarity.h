@@ -0,0 +1,90 @@
+#ifndef KATANA_LIBGRAPH_KATANA_ANALYTICS_SIMILARITY_SIMILARITY_H_
+#define KATANA_LIBGRAPH_KATANA_ANALYTICS_SIMILARITY_SIMILARITY_H_
+
+#include <iostream>
+#include <vector>
+
+#include "katana/PropertyGraph.h"
+#include "katana/analytics/Plan.h"
+
+namespace katana::analytics {
+
+/// The neighborhood similarity measure used by TopKSimilarity. With
+/// N(u) the set of out-neighbors of u:
+enum class SimilarityMetric {
+  /// |N(u) & N(v)| / |N(u) | N(v)|
+  kJaccard,
+  /// |N(u) & N(v)| / sqrt(|N(u)| * |N(v)|)
+  kCosine,
+};
+
+/// A computational plan for TopKSimilarity, specifying the algorithm and any
+/// parameters associated with it.
+class TopKSimilarityPlan : public Plan {
+public:
+  enum Algorithm {
+    /// Enumerate the whole 2-hop neighborhood of each source, counting
+    /// common neighbors in a per-thread hash table, and keep the best k in a
+    /// per-thread heap. Once the heap is full, candidates whose degree alone
+    /// rules them out are not scored; they are still enumerated.
+    kTwoHop,
+  };
+
+private:
+  Algorithm algorithm_;
+
+  TopKSimilarityPlan(Architecture architecture, Algorithm algorithm)
+      : Plan(architecture), algorithm_(algorithm) {}
+
+public:
+  TopKSimilarityPlan() : TopKSimilarityPlan(kCPU, kTwoHop) {}
+
+  Algorithm algorithm() const { return algorithm_; }
+
+  static TopKSimilarityPlan TwoHop() { return {kCPU, kTwoHop}; }
+};
+
+/// For each node in source_nodes (every node if source_nodes is empty), find
+/// the k other nodes most similar to it. Only nodes sharing at least one
+/// out-neighbor with a source are candidates; ties are broken in favor of
+/// smaller node IDs.
+///
+/// The results are stored in two node properties, both of type
+/// large_list: output_nodes_property_name holds the uint32 IDs of the
+/// similar nodes, most similar first, and output_similarities_property_name
+/// holds their float64 similarities. Nodes that are not sources have empty
+/// lists. Both properties are created by this function and may not exist
+/// before the call.
+///
+/// The graph must not have duplicate edges.
+KATANA_EXPORT Result<void> TopKSimilarity(
+    PropertyGraph* pg, const std::vector<uint32_t>& source_nodes, uint32_t k,
+    SimilarityMetric metric, const std::string& output_nodes_property_name,
+    const std::string& output_similarities_property_name,
+    katana::TxnContext* txn_ctx, TopKSimilarityPlan plan = {});
+
+KATANA_EXPORT Result<void> TopKSimilarityAssertValid(
+    PropertyGraph* pg, uint32_t k, const std::string& nodes_property_name,
+    const std::string& similarities_property_name);
+
+struct KATANA_EXPORT TopKSimilarityStatistics {
+  /// The number of nodes with a non-empty result.
+  uint64_t num_nodes_with_results;
+  /// The total number of similar nodes reported over all nodes.
+  uint64_t num_results;
+  /// The highest similarity reported.
+  double max_similarity;
+  /// The average of all similarities reported.
+  double average_similarity;
+
+  /// Print the statistics in a human readable form.
+  void Print(std::ostream& os = std::cout) const;
+
+  static katana::Result<TopKSimilarityStatistics> Compute(
+      katana::PropertyGraph* pg, const std::string& nodes_property_name,
+      const std::string& similarities_property_name);
+};
+
+}  // namespace katana::analytics
+
+#endif
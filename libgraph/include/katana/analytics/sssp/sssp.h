@@ -2,6 +2,9 @@
 #define KATANA_LIBGRAPH_KATANA_ANALYTICS_SSSP_SSSP_H_
 
 #include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
 
 #include "katana/AtomicHelpers.h"
 #include "katana/analytics/Plan.h"
@@ -132,6 +135,50 @@ KATANA_EXPORT Result<void> SsspAssertValid(
     const std::string& edge_weight_property_name,
     const std::string& output_property_name);
 
+/// The number of sources MultiSourceSssp relaxes together.
+constexpr size_t kMultiSourceSsspBatchSize = 64;
+
+/// Bounds on the paths MultiSourceSssp follows. Nodes that are only
+/// reachable by paths beyond the bounds are reported as unreachable.
+struct MultiSourceSsspBounds {
+  /// The maximum number of edges in a path
+  uint32_t max_hops = std::numeric_limits<uint32_t>::max();
+  /// The maximum length of a path
+  double max_distance = std::numeric_limits<double>::infinity();
+};
+
+/// Compute the shortest path lengths from each node in sources to all nodes
+/// of pg. Sources are processed in batches of kMultiSourceSsspBatchSize: the
+/// distances of a node from the sources of a batch are stored next to each
+/// other and relaxed together, so a batch traverses the graph once rather
+/// than once per source. With a hop bound, each round extends paths by one
+/// edge and only rows that changed in the previous round are pushed on.
+/// Without one, the batch is relaxed by delta-stepping, and a node relaxes
+/// only the distances that improved since it was last relaxed. Edge weights
+/// are taken from the property named edge_weight_property_name, as in Sssp.
+/// They must not be negative; if any is, MultiSourceSssp fails with
+/// InvalidArgument.
+///
+/// The result is stored in a large_list property named by
+/// output_property_name whose values have the type of the edge weights.
+/// Element i of the list of a node is its distance from sources[i], or the
+/// distance Sssp uses for unreachable nodes (the maximum value of the type
+/// divided by 4). The property is created by this function and may not exist
+/// before the call.
+KATANA_EXPORT Result<void> MultiSourceSssp(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MultiSourceSsspBounds bounds = {});
+
+/// Check that the distances computed by an unbounded MultiSourceSssp and
+/// stored in output_property_name are shortest path lengths. This check is
+/// exhaustive and costs one pass over the edges per source.
+KATANA_EXPORT Result<void> MultiSourceSsspAssertValid(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name);
+
 struct KATANA_EXPORT SsspStatistics {
   /// The number of nodes reachable from the source node.
   uint64_t n_reached_nodes;
@@ -5,6 +5,7 @@
 #include <cstdlib>
 #include <deque>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <limits>
 #include <map>
@@ -19,6 +20,7 @@
 #include <arrow/array.h>
 #include <arrow/io/api.h>
 #include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
 #include <parquet/arrow/reader.h>
@@ -29,7 +31,9 @@
 #include "katana/Galois.h"
 #include "katana/Logging.h"
 #include "katana/ParallelSTL.h"
+#include "katana/ParquetReader.h"
 #include "katana/PropertyGraph.h"
+#include "katana/PropertyGraphRetractor.h"
 #include "katana/SharedMemSys.h"
 #include "katana/Threads.h"
 
@@ -703,23 +707,6 @@ AddLabelInternal(
   }
 }
 
-/***********************************/
-/* Functions for handling topology */
-/***********************************/
-
-// Used to build the out_dests component of the CSR representation
-uint64_t
-SetEdgeID(
-    TopologyState* topology_builder, std::vector<uint64_t>* offsets,
-    size_t index) {
-  uint32_t src = topology_builder->sources[index];
-  uint64_t base = src ? topology_builder->out_indices[src - 1] : 0;
-  uint64_t i = base + offsets->at(src)++;
-
-  topology_builder->out_dests[i] = topology_builder->destinations[index];
-  return i;
-}
-
 /******************************************************************************/
 /* Functions for ensuring all arrow arrays are of the right length in the end */
 /******************************************************************************/
@@ -792,7 +779,8 @@ ArrowArrays
 RearrangeArray(
     std::shared_ptr<T> builder,
     const std::shared_ptr<arrow::ChunkedArray>& chunked_array,
-    const std::vector<size_t>& mapping, WriterProperties* properties) {
+    const std::vector<size_t>& mapping, size_t begin, size_t end,
+    WriterProperties* properties) {
   auto chunk_size = properties->chunk_size;
   ArrowArrays chunks;
   auto st = builder->Reserve(chunk_size);
@@ -809,15 +797,15 @@ RearrangeArray(
       properties->null_arrays.first.find(builder->type()->id())->second;
 
   // add non-null values
-  for (size_t i = 0; i < mapping.size(); i++) {
+  for (size_t i = begin; i < end; i++) {
     auto array = arrays[mapping[i] / chunk_size];
 
     if (!array->IsNull(mapping[i] % chunk_size)) {
       auto val = array->Value(mapping[i] % chunk_size);
-      AddTypedValue(val, builder, &chunks, null_array, properties, i);
+      AddTypedValue(val, builder, &chunks, null_array, properties, i - begin);
     }
   }
-  EvenOutArray(&chunks, builder, null_array, properties, mapping.size());
+  EvenOutArray(&chunks, builder, null_array, properties, end - begin);
   return chunks;
 }
 
@@ -826,7 +814,8 @@ ArrowArrays
 RearrangeArray(
     std::shared_ptr<arrow::StringBuilder> builder,
     const std::shared_ptr<arrow::ChunkedArray>& chunked_array,
-    const std::vector<size_t>& mapping, WriterProperties* properties) {
+    const std::vector<size_t>& mapping, size_t begin, size_t end,
+    WriterProperties* properties) {
   auto chunk_size = properties->chunk_size;
   ArrowArrays chunks;
   auto st = builder->Reserve(chunk_size);
@@ -843,15 +832,15 @@ RearrangeArray(
       properties->null_arrays.first.find(builder->type()->id())->second;
 
   // add non-null values
-  for (size_t i = 0; i < mapping.size(); i++) {
+  for (size_t i = begin; i < end; i++) {
     auto array = arrays[mapping[i] / chunk_size];
 
     if (!array->IsNull(mapping[i] % chunk_size)) {
       auto val = array->GetView(mapping[i] % chunk_size);
-      AddTypedValue(val, builder, &chunks, null_array, properties, i);
+      AddTypedValue(val, builder, &chunks, null_array, properties, i - begin);
     }
   }
-  EvenOutArray(&chunks, builder, null_array, properties, mapping.size());
+  EvenOutArray(&chunks, builder, null_array, properties, end - begin);
   return chunks;
 }
 
@@ -860,7 +849,8 @@ ArrowArrays
 RearrangeArray(
     std::shared_ptr<arrow::BooleanBuilder> builder,
     const std::shared_ptr<arrow::ChunkedArray>& chunked_array,
-    const std::vector<size_t>& mapping, WriterProperties* properties) {
+    const std::vector<size_t>& mapping, size_t begin, size_t end,
+    WriterProperties* properties) {
   auto chunk_size = properties->chunk_size;
   ArrowArrays chunks;
   auto st = builder->Reserve(chunk_size);
@@ -875,13 +865,13 @@ RearrangeArray(
   }
 
   // add non-null values
-  for (size_t i = 0; i < mapping.size(); i++) {
+  for (size_t i = begin; i < end; i++) {
     auto val = arrays[mapping[i] / chunk_size]->Value(mapping[i] % chunk_size);
     if (val) {
-      AddLabelInternal(builder, &chunks, properties, i);
+      AddLabelInternal(builder, &chunks, properties, i - begin);
     }
   }
-  EvenOutArray(&chunks, builder, properties, mapping.size());
+  EvenOutArray(&chunks, builder, properties, end - begin);
   return chunks;
 }
 
@@ -891,7 +881,8 @@ ArrowArrays
 RearrangeArray(
     const std::shared_ptr<arrow::ListBuilder>& builder, T* type_builder,
     const std::shared_ptr<arrow::ChunkedArray>& chunked_array,
-    const std::vector<size_t>& mapping, WriterProperties* properties) {
+    const std::vector<size_t>& mapping, size_t begin, size_t end,
+    WriterProperties* properties) {
   auto chunk_size = properties->chunk_size;
   ArrowArrays chunks;
   auto st = builder->Reserve(chunk_size);
@@ -911,17 +902,17 @@ RearrangeArray(
       properties->null_arrays.second.find(type_builder->type()->id())->second;
 
   // add values
-  for (size_t i = 0; i < mapping.size(); i++) {
+  for (size_t i = begin; i < end; i++) {
     auto list_array = list_arrays[mapping[i] / chunk_size];
     auto sub_array = sub_arrays[mapping[i] / chunk_size];
     auto index = mapping[i] % chunk_size;
     if (!list_array->IsNull(index)) {
       AddArray(
           list_array, sub_array, index, builder, type_builder, &chunks,
-          null_array, properties, i);
+          null_array, properties, i - begin);
     }
   }
-  EvenOutArray(&chunks, builder, null_array, properties, mapping.size());
+  EvenOutArray(&chunks, builder, null_array, properties, end - begin);
   return chunks;
 }
 
@@ -929,7 +920,8 @@ RearrangeArray(
 ArrowArrays
 RearrangeListArray(
     const std::shared_ptr<arrow::ChunkedArray>& list_chunked_array,
-    const std::vector<size_t>& mapping, WriterProperties* properties) {
+    const std::vector<size_t>& mapping, size_t begin, size_t end,
+    WriterProperties* properties) {
   auto* pool = arrow::default_memory_pool();
   ArrowArrays chunks;
   auto list_type =
@@ -942,7 +934,7 @@ RearrangeListArray(
         pool, std::make_shared<arrow::StringBuilder>());
     auto sb = static_cast<arrow::StringBuilder*>(builder->value_builder());
     chunks = RearrangeArray<arrow::StringBuilder, arrow::StringArray>(
-        builder, sb, list_chunked_array, mapping, properties);
+        builder, sb, list_chunked_array, mapping, begin, end, properties);
     break;
   }
   case arrow::Type::INT64: {
@@ -950,7 +942,7 @@ RearrangeListArray(
         pool, std::make_shared<arrow::Int64Builder>());
     auto lb = static_cast<arrow::Int64Builder*>(builder->value_builder());
     chunks = RearrangeArray<arrow::Int64Builder, arrow::Int64Array>(
-        builder, lb, list_chunked_array, mapping, properties);
+        builder, lb, list_chunked_array, mapping, begin, end, properties);
     break;
   }
   case arrow::Type::INT32: {
@@ -958,7 +950,7 @@ RearrangeListArray(
         pool, std::make_shared<arrow::Int32Builder>());
     auto ib = static_cast<arrow::Int32Builder*>(builder->value_builder());
     chunks = RearrangeArray<arrow::Int32Builder, arrow::Int32Array>(
-        builder, ib, list_chunked_array, mapping, properties);
+        builder, ib, list_chunked_array, mapping, begin, end, properties);
     break;
   }
   case arrow::Type::DOUBLE: {
@@ -966,7 +958,7 @@ RearrangeListArray(
         pool, std::make_shared<arrow::DoubleBuilder>());
     auto db = static_cast<arrow::DoubleBuilder*>(builder->value_builder());
     chunks = RearrangeArray<arrow::DoubleBuilder, arrow::DoubleArray>(
-        builder, db, list_chunked_array, mapping, properties);
+        builder, db, list_chunked_array, mapping, begin, end, properties);
     break;
   }
   case arrow::Type::FLOAT: {
@@ -974,7 +966,7 @@ RearrangeListArray(
         pool, std::make_shared<arrow::FloatBuilder>());
     auto fb = static_cast<arrow::FloatBuilder*>(builder->value_builder());
     chunks = RearrangeArray<arrow::FloatBuilder, arrow::FloatArray>(
-        builder, fb, list_chunked_array, mapping, properties);
+        builder, fb, list_chunked_array, mapping, begin, end, properties);
     break;
   }
   case arrow::Type::BOOL: {
@@ -982,7 +974,7 @@ RearrangeListArray(
         pool, std::make_shared<arrow::BooleanBuilder>());
     auto bb = static_cast<arrow::BooleanBuilder*>(builder->value_builder());
     chunks = RearrangeArray<arrow::BooleanBuilder, arrow::BooleanArray>(
-        builder, bb, list_chunked_array, mapping, properties);
+        builder, bb, list_chunked_array, mapping, begin, end, properties);
     break;
   }
   case arrow::Type::TIMESTAMP: {
@@ -990,7 +982,7 @@ RearrangeListArray(
         pool, std::make_shared<arrow::TimestampBuilder>(list_type, pool));
     auto tb = static_cast<arrow::TimestampBuilder*>(builder->value_builder());
     chunks = RearrangeArray<arrow::TimestampBuilder, arrow::TimestampArray>(
-        builder, tb, list_chunked_array, mapping, properties);
+        builder, tb, list_chunked_array, mapping, begin, end, properties);
     break;
   }
   case arrow::Type::UINT8: {
@@ -998,7 +990,7 @@ RearrangeListArray(
         pool, std::make_shared<arrow::UInt8Builder>());
     auto bb = static_cast<arrow::UInt8Builder*>(builder->value_builder());
     chunks = RearrangeArray<arrow::UInt8Builder, arrow::UInt8Array>(
-        builder, bb, list_chunked_array, mapping, properties);
+        builder, bb, list_chunked_array, mapping, begin, end, properties);
     break;
   }
   default: {
@@ -1010,85 +1002,123 @@ RearrangeListArray(
   return chunks;
 }
 
+// Rearrange rows [begin, end) of a column so that their entries match up with
+// those of mapping
+ArrowArrays
+RearrangeColumn(
+    const std::shared_ptr<arrow::ChunkedArray>& array,
+    const std::vector<size_t>& mapping, size_t begin, size_t end,
+    WriterProperties* properties) {
+  auto arrayType = array->type()->id();
+
+  switch (arrayType) {
+  case arrow::Type::STRING: {
+    auto sb = std::make_shared<arrow::StringBuilder>();
+    return RearrangeArray(sb, array, mapping, begin, end, properties);
+  }
+  case arrow::Type::INT64: {
+    auto lb = std::make_shared<arrow::Int64Builder>();
+    return RearrangeArray<arrow::Int64Builder, arrow::Int64Array>(
+        lb, array, mapping, begin, end, properties);
+  }
+  case arrow::Type::INT32: {
+    auto ib = std::make_shared<arrow::Int32Builder>();
+    return RearrangeArray<arrow::Int32Builder, arrow::Int32Array>(
+        ib, array, mapping, begin, end, properties);
+  }
+  case arrow::Type::DOUBLE: {
+    auto db = std::make_shared<arrow::DoubleBuilder>();
+    return RearrangeArray<arrow::DoubleBuilder, arrow::DoubleArray>(
+        db, array, mapping, begin, end, properties);
+  }
+  case arrow::Type::FLOAT: {
+    auto fb = std::make_shared<arrow::FloatBuilder>();
+    return RearrangeArray<arrow::FloatBuilder, arrow::FloatArray>(
+        fb, array, mapping, begin, end, properties);
+  }
+  case arrow::Type::BOOL: {
+    auto bb = std::make_shared<arrow::BooleanBuilder>();
+    return RearrangeArray<arrow::BooleanBuilder, arrow::BooleanArray>(
+        bb, array, mapping, begin, end, properties);
+  }
+  case arrow::Type::TIMESTAMP: {
+    auto tb = std::make_shared<arrow::TimestampBuilder>(
+        array->type(), arrow::default_memory_pool());
+    return RearrangeArray<arrow::TimestampBuilder, arrow::TimestampArray>(
+        tb, array, mapping, begin, end, properties);
+  }
+  case arrow::Type::UINT8: {
+    auto bb = std::make_shared<arrow::UInt8Builder>();
+    return RearrangeArray<arrow::UInt8Builder, arrow::UInt8Array>(
+        bb, array, mapping, begin, end, properties);
+  }
+  case arrow::Type::LIST: {
+    return RearrangeListArray(array, mapping, begin, end, properties);
+  }
+  default: {
+    KATANA_LOG_FATAL(
+        "Unsupported arrow array type passed to RearrangeTable: {}",
+        arrayType);
+  }
+  }
+}
+
+// Rearrange num_columns columns of num_rows rows by splitting each column into
+// pieces of whole chunks that are rearranged in parallel, each with its own
+// builder, and then concatenating the chunks of the pieces. Since pieces
+// start on chunk boundaries the result has the same chunks as rearranging the
+// whole column at once. rearrange(n, begin, end) returns the chunks for rows
+// [begin, end) of column n.
+template <typename RearrangeFn>
+std::vector<ArrowArrays>
+RearrangeInPieces(
+    size_t num_columns, size_t num_rows, WriterProperties* properties,
+    const RearrangeFn& rearrange) {
+  size_t chunk_size = properties->chunk_size;
+  size_t num_chunks = (num_rows + chunk_size - 1) / chunk_size;
+  // aim for a few pieces per thread in total
+  size_t pieces_wanted = std::max<size_t>(
+      1, 4 * katana::getActiveThreads() / std::max<size_t>(num_columns, 1));
+  size_t chunks_per_piece =
+      std::max<size_t>(1, (num_chunks + pieces_wanted - 1) / pieces_wanted);
+  size_t piece_rows = chunks_per_piece * chunk_size;
+  size_t num_pieces =
+      std::max<size_t>(1, (num_rows + piece_rows - 1) / piece_rows);
+
+  std::vector<std::vector<ArrowArrays>> pieces(
+      num_columns, std::vector<ArrowArrays>(num_pieces));
+  katana::do_all(
+      katana::iterate(static_cast<size_t>(0), num_columns * num_pieces),
+      [&](const size_t& work) {
+        size_t n = work / num_pieces;
+        size_t p = work % num_pieces;
+        size_t begin = std::min(p * piece_rows, num_rows);
+        size_t end = std::min(begin + piece_rows, num_rows);
+        pieces[n][p] = rearrange(n, begin, end);
+      },
+      katana::steal());
+
+  std::vector<ArrowArrays> rearranged;
+  rearranged.resize(num_columns);
+  for (size_t n = 0; n < num_columns; ++n) {
+    for (auto& piece : pieces[n]) {
+      rearranged[n].insert(rearranged[n].end(), piece.begin(), piece.end());
+    }
+  }
+  return rearranged;
+}
+
 // Rearrange each column in a table so that their entries match up with those of
 // mapping
 std::vector<ArrowArrays>
 RearrangeTable(
     const ChunkedArrays& initial, const std::vector<size_t>& mapping,
     WriterProperties* properties) {
-  std::vector<ArrowArrays> rearranged;
-  rearranged.resize(initial.size());
-
-  katana::do_all(
-      katana::iterate(static_cast<size_t>(0), initial.size()),
-      [&](const size_t& n) {
-        auto array = initial[n];
-        auto arrayType = array->type()->id();
-        ArrowArrays ca;
-
-        switch (arrayType) {
-        case arrow::Type::STRING: {
-          auto sb = std::make_shared<arrow::StringBuilder>();
-          ca = RearrangeArray(sb, array, mapping, properties);
-          break;
-        }
-        case arrow::Type::INT64: {
-          auto lb = std::make_shared<arrow::Int64Builder>();
-          ca = RearrangeArray<arrow::Int64Builder, arrow::Int64Array>(
-              lb, array, mapping, properties);
-          break;
-        }
-        case arrow::Type::INT32: {
-          auto ib = std::make_shared<arrow::Int32Builder>();
-          ca = RearrangeArray<arrow::Int32Builder, arrow::Int32Array>(
-              ib, array, mapping, properties);
-          break;
-        }
-        case arrow::Type::DOUBLE: {
-          auto db = std::make_shared<arrow::DoubleBuilder>();
-          ca = RearrangeArray<arrow::DoubleBuilder, arrow::DoubleArray>(
-              db, array, mapping, properties);
-          break;
-        }
-        case arrow::Type::FLOAT: {
-          auto fb = std::make_shared<arrow::FloatBuilder>();
-          ca = RearrangeArray<arrow::FloatBuilder, arrow::FloatArray>(
-              fb, array, mapping, properties);
-          break;
-        }
-        case arrow::Type::BOOL: {
-          auto bb = std::make_shared<arrow::BooleanBuilder>();
-          ca = RearrangeArray<arrow::BooleanBuilder, arrow::BooleanArray>(
-              bb, array, mapping, properties);
-          break;
-        }
-        case arrow::Type::TIMESTAMP: {
-          auto tb = std::make_shared<arrow::TimestampBuilder>(
-              array->type(), arrow::default_memory_pool());
-          ca = RearrangeArray<arrow::TimestampBuilder, arrow::TimestampArray>(
-              tb, array, mapping, properties);
-          break;
-        }
-        case arrow::Type::UINT8: {
-          auto bb = std::make_shared<arrow::UInt8Builder>();
-          ca = RearrangeArray<arrow::UInt8Builder, arrow::UInt8Array>(
-              bb, array, mapping, properties);
-          break;
-        }
-        case arrow::Type::LIST: {
-          ca = RearrangeListArray(array, mapping, properties);
-          break;
-        }
-        default: {
-          KATANA_LOG_FATAL(
-              "Unsupported arrow array type passed to RearrangeTable: {}",
-              arrayType);
-        }
-        }
-        rearranged[n] = ca;
-        array.reset();
+  return RearrangeInPieces(
+      initial.size(), mapping.size(), properties,
+      [&](size_t n, size_t begin, size_t end) {
+        return RearrangeColumn(initial[n], mapping, begin, end, properties);
       });
-  return rearranged;
 }
 
 // Rearrange each column in a table so that their entries match up with those of
@@ -1097,21 +1127,12 @@ std::vector<ArrowArrays>
 RearrangeTypeTable(
     const ChunkedArrays& initial, const std::vector<size_t>& mapping,
     WriterProperties* properties) {
-  std::vector<ArrowArrays> rearranged;
-  rearranged.resize(initial.size());
-
-  katana::do_all(
-      katana::iterate(static_cast<size_t>(0), initial.size()),
-      [&](const size_t& n) {
-        auto array = initial[n];
-
+  return RearrangeInPieces(
+      initial.size(), mapping.size(), properties,
+      [&](size_t n, size_t begin, size_t end) {
         auto bb = std::make_shared<arrow::BooleanBuilder>();
-        auto ca = RearrangeArray(bb, array, mapping, properties);
-        rearranged[n] = ca;
-
-        array.reset();
+        return RearrangeArray(bb, initial[n], mapping, begin, end, properties);
       });
-  return rearranged;
 }
 
 template <typename BuilderType, typename ValueType>
@@ -1157,6 +1178,7 @@ katana::PropertyGraphBuilder::PropertyGraphBuilder(size_t chunk_size)
       node_labels_(LabelsState{}),
       edge_types_(LabelsState{}),
       topology_builder_(TopologyState{}),
+      spill_(SpillState{}),
       nodes_(0),
       edges_(0),
       building_node_(false),
@@ -1268,6 +1290,7 @@ katana::PropertyGraphBuilder::FinishNode() {
   }
   nodes_++;
   building_node_ = false;
+  MaybeSpillChunks(true, nodes_);
 
   return true;
 }
@@ -1349,6 +1372,7 @@ katana::PropertyGraphBuilder::FinishEdge() {
   }
   edges_++;
   building_edge_ = false;
+  MaybeSpillChunks(false, edges_);
 
   return true;
 }
@@ -1629,56 +1653,112 @@ katana::PropertyGraphBuilder::AddLabel(const std::string& name) {
 
 // Resolve string node IDs to node indexes, if a node does not exist create an
 // empty node
+//
+// IDs are looked up in parallel; only the IDs of nodes that do not exist yet
+// are handled serially.
 void
 katana::PropertyGraphBuilder::ResolveIntermediateIDs() {
   TopologyState* topology = &topology_builder_;
+  using Intermediate = std::pair<const size_t, std::string>;
+
+  auto resolve = [&](const std::unordered_map<size_t, std::string>& ids,
+                     std::vector<uint32_t>* resolved) {
+    std::vector<const Intermediate*> entries;
+    entries.reserve(ids.size());
+    for (const auto& entry : ids) {
+      entries.emplace_back(&entry);
+    }
+
+    // the map of node indexes is only read here
+    katana::do_all(
+        katana::iterate(static_cast<size_t>(0), entries.size()),
+        [&](const size_t& i) {
+          const auto& [index, str_id] = *entries[i];
+          auto node_index = topology->node_indexes.find(str_id);
+          if (node_index != topology->node_indexes.end()) {
+            resolved->at(index) = static_cast<uint32_t>(node_index->second);
+          }
+        },
+        katana::no_stats());
 
-  for (auto [index, str_id] : topology->destinations_intermediate) {
-    auto dest_index = topology->node_indexes.find(str_id);
-    uint32_t dest;
     // if node does not exist, create it
-    if (dest_index == topology->node_indexes.end()) {
-      dest = nodes_;
-      this->AddNode(str_id);
-    } else {
-      dest = static_cast<uint32_t>(dest_index->second);
+    for (const auto* entry : entries) {
+      const auto& [index, str_id] = *entry;
+      if (resolved->at(index) != std::numeric_limits<uint32_t>::max()) {
+        continue;
+      }
+      auto node_index = topology->node_indexes.find(str_id);
+      if (node_index == topology->node_indexes.end()) {
+        resolved->at(index) = nodes_;
+        this->AddNode(str_id);
+      } else {
+        resolved->at(index) = static_cast<uint32_t>(node_index->second);
+      }
     }
-    topology->destinations[index] = dest;
-  }
+    return entries;
+  };
 
-  for (auto [index, str_id] : topology->sources_intermediate) {
-    auto src_index = topology->node_indexes.find(str_id);
-    uint32_t src;
-    if (src_index == topology->node_indexes.end()) {
-      src = nodes_;
-      this->AddNode(str_id);
-    } else {
-      src = static_cast<uint32_t>(src_index->second);
-    }
-    topology->sources[index] = src;
-    topology->out_indices[src]++;
-  }
+  resolve(topology->destinations_intermediate, &topology->destinations);
+  auto sources = resolve(topology->sources_intermediate, &topology->sources);
+
+  katana::do_all(
+      katana::iterate(static_cast<size_t>(0), sources.size()),
+      [&](const size_t& i) {
+        uint32_t src = topology->sources[sources[i]->first];
+        __atomic_fetch_add(&topology->out_indices[src], 1, __ATOMIC_RELAXED);
+      },
+      katana::no_stats());
 }
 
-// Build CSR format and rearrange edge tables to correspond to the CSR
-katana::GraphComponent
-katana::PropertyGraphBuilder::BuildFinalEdges(bool verbose) {
+// Build CSR format and return the mapping from edge IDs to the order in
+// which the edges were added
+std::vector<size_t>
+katana::PropertyGraphBuilder::BuildFinalTopology() {
+  TopologyState* topology = &topology_builder_;
+
   katana::ParallelSTL::partial_sum(
-      topology_builder_.out_indices.begin(),
-      topology_builder_.out_indices.end(),
-      topology_builder_.out_indices.begin());
+      topology->out_indices.begin(), topology->out_indices.end(),
+      topology->out_indices.begin());
 
+  // Counting sort of the edges by source: every edge claims a slot in the
+  // range of its source, then each range is put back in insertion order so
+  // that the edge IDs do not depend on the schedule
   std::vector<size_t> edge_mapping;
   edge_mapping.resize(edges_, std::numeric_limits<uint64_t>::max());
 
   std::vector<uint64_t> offsets;
   offsets.resize(nodes_, 0);
 
-  // get edge indices
-  for (size_t i = 0; i < topology_builder_.sources.size(); i++) {
-    uint64_t edgeID = SetEdgeID(&topology_builder_, &offsets, i);
-    edge_mapping[edgeID] = i;
-  }
+  katana::do_all(
+      katana::iterate(static_cast<size_t>(0), topology->sources.size()),
+      [&](const size_t& i) {
+        uint32_t src = topology->sources[i];
+        uint64_t base = src ? topology->out_indices[src - 1] : 0;
+        uint64_t offset =
+            __atomic_fetch_add(&offsets[src], 1, __ATOMIC_RELAXED);
+        edge_mapping[base + offset] = i;
+      },
+      katana::no_stats());
+
+  katana::do_all(
+      katana::iterate(static_cast<size_t>(0), topology->out_indices.size()),
+      [&](const size_t& n) {
+        uint64_t begin = n ? topology->out_indices[n - 1] : 0;
+        uint64_t end = topology->out_indices[n];
+        std::sort(edge_mapping.begin() + begin, edge_mapping.begin() + end);
+        for (uint64_t e = begin; e < end; ++e) {
+          topology->out_dests[e] = topology->destinations[edge_mapping[e]];
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  return edge_mapping;
+}
+
+// Build CSR format and rearrange edge tables to correspond to the CSR
+katana::GraphComponent
+katana::PropertyGraphBuilder::BuildFinalEdges(bool verbose) {
+  std::vector<size_t> edge_mapping = BuildFinalTopology();
 
   auto initial_edges = BuildChunks(&edge_properties_.chunks);
   auto initial_types = BuildChunks(&edge_types_.chunks);
@@ -1700,13 +1780,9 @@ katana::PropertyGraphBuilder::BuildFinalEdges(bool verbose) {
       BuildTable(&final_type_builders, &edge_types_.schema)};
 }
 
-katana::Result<GraphComponents>
-katana::PropertyGraphBuilder::Finish(bool verbose) {
-  topology_builder_.out_dests.resize(
-      edges_, std::numeric_limits<uint32_t>::max());
-  this->ResolveIntermediateIDs();
-
-  // add buffered rows and even out columns
+// Add buffered rows and even out columns
+void
+katana::PropertyGraphBuilder::EvenOutColumns() {
   EvenOutChunkBuilders(
       &node_properties_.builders, &node_properties_.chunks, &properties_,
       nodes_);
@@ -1717,6 +1793,20 @@ katana::PropertyGraphBuilder::Finish(bool verbose) {
       edges_);
   EvenOutChunkBuilders(
       &edge_types_.builders, &edge_types_.chunks, &properties_, edges_);
+}
+
+katana::Result<GraphComponents>
+katana::PropertyGraphBuilder::Finish(bool verbose) {
+  if (!spill_.dir.empty()) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "properties were spilled to {}, use FinishAndWrite instead",
+        spill_.dir);
+  }
+  topology_builder_.out_dests.resize(
+      edges_, std::numeric_limits<uint32_t>::max());
+  this->ResolveIntermediateIDs();
+  this->EvenOutColumns();
 
   if (verbose) {
     std::cout << "Node Properties:\n";
@@ -1769,6 +1859,234 @@ katana::PropertyGraphBuilder::Finish(bool verbose) {
       nodes_tables, edges_tables, std::move(pg_topo)};
 }
 
+/*************************************/
+/* Functions for spilling properties */
+/*************************************/
+
+katana::Result<void>
+katana::PropertyGraphBuilder::SpillPropertiesTo(const std::string& dir) {
+  if (nodes_ > 0 || edges_ > 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument,
+        "properties must be spilled before any nodes or edges are added");
+  }
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(dir, ec);
+  if (ec) {
+    return KATANA_ERROR(
+        ErrorCode::LocalStorageError, "creating spill directory {}: {}",
+        std::quoted(dir), ec.message());
+  }
+  spill_.dir = dir;
+  return katana::ResultSuccess();
+}
+
+// Spill once every chunk_size rows, when every column has finished all of
+// the chunks it is going to finish for those rows. Errors are reported by
+// FinishAndWrite.
+void
+katana::PropertyGraphBuilder::MaybeSpillChunks(bool for_node, size_t num_rows) {
+  if (spill_.dir.empty() || spill_.error ||
+      num_rows % properties_.chunk_size != 0) {
+    return;
+  }
+  if (auto res = SpillChunks(for_node); !res) {
+    spill_.error = res.error();
+  }
+}
+
+katana::Result<void>
+katana::PropertyGraphBuilder::SpillChunks(bool for_node) {
+  if (spill_.dir.empty()) {
+    return katana::ResultSuccess();
+  }
+  PropertiesState* state = for_node ? &node_properties_ : &edge_properties_;
+  SpilledColumns* spilled = for_node ? &spill_.nodes : &spill_.edges;
+
+  for (size_t i = 0; i < state->chunks.size(); ++i) {
+    auto schema = arrow::schema({state->schema[i]});
+    // columns are only ever appended, so open files for the new ones
+    if (i == spilled->writers.size()) {
+      std::string path = fmt::format(
+          "{}/{}-{}.parquet", spill_.dir, for_node ? "node" : "edge", i);
+      std::shared_ptr<arrow::io::OutputStream> sink =
+          KATANA_CHECKED(arrow::io::FileOutputStream::Open(path));
+      std::unique_ptr<parquet::arrow::FileWriter> writer;
+      // keep the arrow schema so that the column reads back with the types
+      // it was built with
+      KATANA_CHECKED_CONTEXT(
+          parquet::arrow::FileWriter::Open(
+              *schema, arrow::default_memory_pool(), sink,
+              parquet::default_writer_properties(),
+              parquet::ArrowWriterProperties::Builder().store_schema()->build(),
+              &writer),
+          "opening spill file {}", std::quoted(path));
+      spilled->files.emplace_back(std::move(path));
+      spilled->sinks.emplace_back(std::move(sink));
+      spilled->writers.emplace_back(std::move(writer));
+      spilled->num_spilled.emplace_back(0);
+    }
+
+    ArrowArrays& chunks = state->chunks[i];
+    for (size_t& c = spilled->num_spilled[i]; c < chunks.size(); ++c) {
+      auto table = arrow::Table::Make(schema, {chunks[c]});
+      KATANA_CHECKED_CONTEXT(
+          spilled->writers[i]->WriteTable(*table, chunks[c]->length()),
+          "spilling {}", state->schema[i]->name());
+      chunks[c].reset();
+    }
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraphBuilder::CloseSpilledColumns() {
+  for (SpilledColumns* spilled : {&spill_.nodes, &spill_.edges}) {
+    for (size_t i = 0; i < spilled->writers.size(); ++i) {
+      KATANA_CHECKED_CONTEXT(
+          spilled->writers[i]->Close(), "closing {}",
+          std::quoted(spilled->files[i]));
+      KATANA_CHECKED(spilled->sinks[i]->Close());
+    }
+    spilled->writers.clear();
+    spilled->sinks.clear();
+  }
+  return katana::ResultSuccess();
+}
+
+// Return column i, reading it back if it was spilled, and release the
+// builder's copy of it
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::PropertyGraphBuilder::TakeColumn(bool for_node, size_t i) {
+  PropertiesState* state = for_node ? &node_properties_ : &edge_properties_;
+  SpilledColumns* spilled = for_node ? &spill_.nodes : &spill_.edges;
+
+  if (i < spilled->files.size()) {
+    state->chunks[i].clear();
+    katana::ParquetReader::ReadOpts opts;
+    opts.make_canonical = false;
+    auto reader = KATANA_CHECKED(katana::ParquetReader::Make(opts));
+    auto uri = KATANA_CHECKED(katana::Uri::Make(spilled->files[i]));
+    auto table = KATANA_CHECKED_CONTEXT(
+        reader->ReadTable(uri), "reading spilled {}",
+        state->schema[i]->name());
+    return table->column(0);
+  }
+
+  auto column = std::make_shared<arrow::ChunkedArray>(
+      std::move(state->chunks[i]), state->schema[i]->type());
+  state->chunks[i].clear();
+  return column;
+}
+
+katana::Result<void>
+katana::PropertyGraphBuilder::FinishAndWrite(
+    const std::string& dir, katana::TxnContext* txn_ctx, bool verbose) {
+  if (spill_.error) {
+    return katana::ErrorInfo(spill_.error.value())
+        .WithContext("spilling properties");
+  }
+  topology_builder_.out_dests.resize(
+      edges_, std::numeric_limits<uint32_t>::max());
+  this->ResolveIntermediateIDs();
+  this->EvenOutColumns();
+
+  KATANA_CHECKED(SpillChunks(true));
+  KATANA_CHECKED(SpillChunks(false));
+  KATANA_CHECKED(CloseSpilledColumns());
+
+  // labels and types are a bit per row and stay in memory
+  auto node_labels = BuildTable(&node_labels_.chunks, &node_labels_.schema);
+  node_labels_.chunks.clear();
+
+  std::vector<size_t> edge_mapping = BuildFinalTopology();
+  auto final_type_builders = RearrangeTypeTable(
+      BuildChunks(&edge_types_.chunks), edge_mapping, &properties_);
+  auto edge_types = BuildTable(&final_type_builders, &edge_types_.schema);
+  edge_types_.chunks.clear();
+
+  katana::GraphTopology pg_topo(
+      topology_builder_.out_indices.data(),
+      topology_builder_.out_indices.size(), topology_builder_.out_dests.data(),
+      topology_builder_.out_dests.size());
+  // the ID maps and edge lists are not needed once the topology is built
+  topology_builder_ = TopologyState{};
+
+  if (verbose) {
+    std::cout << "Finished topology and ordering edges\n";
+  }
+
+  auto pg = KATANA_CHECKED_CONTEXT(
+      katana::PropertyGraph::Make(std::move(pg_topo)), "adding topology");
+  katana::PropertyGraphRetractor retractor(std::move(pg));
+  // unloading a property writes it out next to the rest of the RDG
+  KATANA_CHECKED(retractor.InformPath(dir));
+  katana::PropertyGraph& graph = retractor.property_graph();
+
+  // add properties in the same order as ConvertToPropertyGraph
+  for (size_t i = 0; i < node_properties_.schema.size(); ++i) {
+    const auto& field = node_properties_.schema[i];
+    auto column = KATANA_CHECKED(TakeColumn(true, i));
+    KATANA_CHECKED_CONTEXT(
+        graph.AddNodeProperties(
+            arrow::Table::Make(arrow::schema({field}), {column}), txn_ctx),
+        "adding node property {}", field->name());
+    KATANA_CHECKED_CONTEXT(
+        graph.UnloadNodeProperty(field->name()), "writing node property {}",
+        field->name());
+  }
+  if (node_labels->num_columns() > 0) {
+    KATANA_CHECKED_CONTEXT(
+        graph.AddNodeProperties(node_labels, txn_ctx), "adding node labels");
+  }
+
+  for (size_t i = 0; i < edge_properties_.schema.size(); ++i) {
+    const auto& field = edge_properties_.schema[i];
+    auto column = KATANA_CHECKED(TakeColumn(false, i));
+    auto rearranged = RearrangeInPieces(
+        1, edges_, &properties_, [&](size_t, size_t begin, size_t end) {
+          return RearrangeColumn(
+              column, edge_mapping, begin, end, &properties_);
+        });
+    column = std::make_shared<arrow::ChunkedArray>(
+        std::move(rearranged[0]), field->type());
+    KATANA_CHECKED_CONTEXT(
+        graph.AddEdgeProperties(
+            arrow::Table::Make(arrow::schema({field}), {column}), txn_ctx),
+        "adding edge property {}", field->name());
+    KATANA_CHECKED_CONTEXT(
+        graph.UnloadEdgeProperty(field->name()), "writing edge property {}",
+        field->name());
+  }
+  if (edge_types->num_columns() > 0) {
+    KATANA_CHECKED_CONTEXT(
+        graph.AddEdgeProperties(edge_types, txn_ctx), "adding edge labels");
+  }
+
+  if (verbose) {
+    std::cout << "Nodes: " << nodes_ << "\n";
+    std::cout << "Node Properties: " << node_properties_.schema.size() << "\n";
+    std::cout << "Node Labels: " << node_labels->num_columns() << "\n";
+    std::cout << "Edges: " << edges_ << "\n";
+    std::cout << "Edge Properties: " << edge_properties_.schema.size() << "\n";
+    std::cout << "Edge Types: " << edge_types->num_columns() << "\n";
+  }
+
+  KATANA_CHECKED(WritePropertyGraph(graph, dir));
+
+  for (const SpilledColumns* spilled : {&spill_.nodes, &spill_.edges}) {
+    for (const auto& file : spilled->files) {
+      boost::system::error_code ec;
+      if (!boost::filesystem::remove(file, ec) && ec) {
+        KATANA_LOG_WARN(
+            "could not remove spill file {}: {}", std::quoted(file),
+            ec.message());
+      }
+    }
+  }
+  return katana::ResultSuccess();
+}
+
 // NB: is_list is always initialized
 void
 ImportData::ValueFromArrowScalar(std::shared_ptr<arrow::Scalar> scalar) {
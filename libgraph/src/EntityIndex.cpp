@@ -1,7 +1,169 @@
 #include "katana/EntityIndex.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "katana/FileFrame.h"
+#include "katana/Loops.h"
+#include "katana/ParallelSTL.h"
 #include "katana/PropertyGraph.h"
 
+namespace {
+
+constexpr uint64_t kEntityIndexMagic = 0x4b4e54454e494458;  // "KNTENIDX"
+
+// On-disk layout of an index: the header, num_ids ids, padding to an 8 byte
+// boundary and, for primitive indexes, num_ids keys in the same order.
+struct EntityIndexFileHeader {
+  uint64_t magic;
+  uint64_t num_entities;
+  uint64_t num_ids;
+  uint32_t id_size;
+  uint32_t key_size;
+};
+
+uint64_t
+KeysOffset(uint64_t num_ids, uint64_t id_size) {
+  uint64_t ids_end = sizeof(EntityIndexFileHeader) + num_ids * id_size;
+  return (ids_end + 7) & ~UINT64_C(7);
+}
+
+katana::Result<void>
+WriteIndexFile(
+    const katana::Uri& uri, uint64_t num_entities, const void* ids,
+    uint64_t num_ids, uint32_t id_size, const void* keys, uint32_t key_size) {
+  katana::FileFrame ff;
+  KATANA_CHECKED(ff.Init());
+
+  EntityIndexFileHeader header{
+      .magic = kEntityIndexMagic,
+      .num_entities = num_entities,
+      .num_ids = num_ids,
+      .id_size = id_size,
+      .key_size = key_size,
+  };
+  uint64_t keys_offset = KeysOffset(num_ids, id_size);
+  uint64_t ids_end = sizeof(header) + num_ids * id_size;
+  const uint64_t padding = 0;
+
+  std::vector<std::pair<const void*, uint64_t>> pieces{
+      {&header, sizeof(header)},
+      {ids, num_ids * id_size},
+      {&padding, keys_offset - ids_end},
+      {keys, num_ids * key_size},
+  };
+  for (const auto& [data, size] : pieces) {
+    if (size == 0) {
+      continue;
+    }
+    arrow::Status aro_sts = ff.Write(data, size);
+    if (!aro_sts.ok()) {
+      return KATANA_ERROR(
+          katana::ArrowToKatana(aro_sts.code()), "writing index {}: {}", uri,
+          aro_sts.ToString());
+    }
+  }
+
+  ff.Bind(uri.string());
+  return ff.Persist();
+}
+
+/// Bind file_view to the index at uri and check that it was written for an
+/// index of the same shape. Returns the number of ids in the file.
+katana::Result<uint64_t>
+MapIndexFile(
+    const katana::Uri& uri, uint64_t num_entities, uint32_t id_size,
+    uint32_t key_size, katana::FileView* file_view) {
+  // Lookups binary search the file, so don't bother reading ahead
+  KATANA_CHECKED(
+      file_view->SetAccessPattern(katana::FileView::AccessPattern::kRandom));
+  KATANA_CHECKED_CONTEXT(file_view->Bind(uri.string(), true), "{}", uri);
+
+  if (file_view->size() < sizeof(EntityIndexFileHeader)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "index file {} is truncated", uri);
+  }
+  const auto* header = file_view->ptr<EntityIndexFileHeader>();
+  if (header->magic != kEntityIndexMagic || header->id_size != id_size ||
+      header->key_size != key_size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "{} is not an index of this type", uri);
+  }
+  if (header->num_entities != num_entities ||
+      header->num_ids > num_entities) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "index file {} is for {} entities, expected {}", uri,
+        header->num_entities, num_entities);
+  }
+  uint64_t expected_size =
+      KeysOffset(header->num_ids, id_size) + header->num_ids * key_size;
+  if (file_view->size() < expected_size) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "index file {} is truncated: {} bytes, expected {}", uri,
+        file_view->size(), expected_size);
+  }
+  return header->num_ids;
+}
+
+constexpr size_t kGroupSize = 16;
+constexpr uint8_t kEmptyCtrl = 0x80;
+
+/// The murmur3 finalizer. It is a bijection, so distinct integer keys never
+/// collide.
+uint64_t
+Mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= UINT64_C(0xff51afd7ed558ccd);
+  h ^= h >> 33;
+  h *= UINT64_C(0xc4ceb9fe1a85ec53);
+  h ^= h >> 33;
+  return h;
+}
+
+template <typename key_type>
+uint64_t
+HashKey(key_type key) {
+  if constexpr (std::is_same_v<key_type, std::string_view>) {
+    return Mix(std::hash<std::string_view>{}(key));
+  } else {
+    return Mix(static_cast<uint64_t>(key));
+  }
+}
+
+/// The low 7 bits of the hash are kept in the control byte of a slot; the
+/// rest select the group where probing starts.
+uint8_t
+HashTag(uint64_t hash) {
+  return hash & 0x7f;
+}
+
+/// Returns a mask with bit i set if group[i] == ctrl
+uint32_t
+MatchGroup(const uint8_t* group, uint8_t ctrl) {
+#if defined(__SSE2__)
+  __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+  return _mm_movemask_epi8(
+      _mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(ctrl))));
+#else
+  uint32_t mask = 0;
+  for (size_t i = 0; i < kGroupSize; ++i) {
+    mask |= static_cast<uint32_t>(group[i] == ctrl) << i;
+  }
+  return mask;
+#endif
+}
+
+}  // namespace
+
 namespace katana {
 
 // Switch statement over creation of per-type indexes.
@@ -9,9 +171,46 @@ template <typename node_or_edge>
 Result<std::unique_ptr<EntityIndex<node_or_edge>>>
 MakeTypedEntityIndex(
     const std::string& column_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property) {
+    std::shared_ptr<arrow::Array> property, EntityIndexKind kind) {
   std::unique_ptr<EntityIndex<node_or_edge>> index;
 
+  if (kind == EntityIndexKind::kHash) {
+    switch (property->type_id()) {
+    case arrow::Type::UINT8:
+      index = std::make_unique<HashEntityIndex<node_or_edge, uint8_t>>(
+          column_name, num_entities, property);
+      break;
+    case arrow::Type::INT32:
+      index = std::make_unique<HashEntityIndex<node_or_edge, int32_t>>(
+          column_name, num_entities, property);
+      break;
+    case arrow::Type::UINT32:
+      index = std::make_unique<HashEntityIndex<node_or_edge, uint32_t>>(
+          column_name, num_entities, property);
+      break;
+    case arrow::Type::INT64:
+      index = std::make_unique<HashEntityIndex<node_or_edge, int64_t>>(
+          column_name, num_entities, property);
+      break;
+    case arrow::Type::UINT64:
+      index = std::make_unique<HashEntityIndex<node_or_edge, uint64_t>>(
+          column_name, num_entities, property);
+      break;
+    case arrow::Type::LARGE_STRING:
+      index =
+          std::make_unique<HashEntityIndex<node_or_edge, std::string_view>>(
+              column_name, num_entities, property);
+      break;
+    default:
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument,
+          "Column has type unknown for hash indexing: {}",
+          property->type()->ToString());
+    }
+    return Result<std::unique_ptr<EntityIndex<node_or_edge>>>(
+        std::move(index));
+  }
+
   switch (property->type_id()) {
   case arrow::Type::BOOL:
     index = std::make_unique<PrimitiveEntityIndex<node_or_edge, bool>>(
@@ -55,18 +254,61 @@ PrimitiveEntityIndex<node_or_edge, c_type>::BuildFromProperty() {
         ErrorCode::InvalidArgument, "Property does not contain all entities");
   }
 
-  // TODO(osh): Index build should be parallelized.
-  for (node_or_edge i = 0; i < num_entities_; ++i) {
-    // The keys inserted are the node ids - the set translates these into
-    // property values.
-    if (property_->IsValid(i)) {
-      set_.insert(IndexID{i});
-    }
-  }
+  // Sort (is_null, key, id) triples so that the keys being compared are
+  // adjacent in memory and the null entities collect at the end.
+  using Entry = std::tuple<bool, c_type, node_or_edge>;
+  NUMAArray<Entry> entries;
+  entries.allocateBlocked(num_entities_);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_entities_),
+      [&](size_t i) {
+        node_or_edge id = i;
+        bool is_null = !property_->IsValid(id);
+        entries[i] =
+            Entry{is_null, is_null ? c_type{} : property_->Value(id), id};
+      },
+      katana::no_stats());
+  katana::ParallelSTL::sort(entries.begin(), entries.end());
+
+  size_t num_null = property_->Slice(0, num_entities_)->null_count();
+  size_t num_valid = num_entities_ - num_null;
+  this->id_storage_.allocateBlocked(num_valid);
+  key_storage_.allocateBlocked(num_valid);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_valid),
+      [&](size_t i) {
+        key_storage_[i] = std::get<1>(entries[i]);
+        this->id_storage_[i] = std::get<2>(entries[i]);
+      },
+      katana::no_stats());
+
+  this->UseIdStorage();
+  keys_ = key_storage_.data();
 
   return katana::ResultSuccess();
 }
 
+template <typename node_or_edge, typename c_type>
+Result<void>
+PrimitiveEntityIndex<node_or_edge, c_type>::BuildFromFile(const Uri& uri) {
+  this->num_ids_ = KATANA_CHECKED(MapIndexFile(
+      uri, num_entities_, sizeof(node_or_edge), sizeof(c_type), &this->file_));
+  this->ids_ =
+      this->file_.template ptr<node_or_edge>(sizeof(EntityIndexFileHeader));
+  keys_ = this->file_.template ptr<c_type>(
+      KeysOffset(this->num_ids_, sizeof(node_or_edge)));
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge, typename c_type>
+Result<void>
+PrimitiveEntityIndex<node_or_edge, c_type>::WriteToFile(const Uri& uri) const {
+  return WriteIndexFile(
+      uri, num_entities_, this->ids_, this->num_ids_, sizeof(node_or_edge),
+      keys_, sizeof(c_type));
+}
+
 template <typename node_or_edge>
 Result<void>
 StringEntityIndex<node_or_edge>::BuildFromProperty() {
@@ -75,18 +317,208 @@ StringEntityIndex<node_or_edge>::BuildFromProperty() {
         ErrorCode::InvalidArgument, "Property does not contain all entities");
   }
 
-  // TODO(osh): Index build should be parallelized.
-  for (node_or_edge i = 0; i < num_entities_; ++i) {
-    // The keys inserted are the node ids - the set translates these into
-    // property values.
-    if (property_->IsValid(i)) {
-      set_.insert(IndexID{i});
+  NUMAArray<node_or_edge> ids;
+  ids.allocateBlocked(num_entities_);
+  katana::ParallelSTL::iota(ids.begin(), ids.end(), node_or_edge{0});
+  katana::ParallelSTL::sort(
+      ids.begin(), ids.end(), [this](node_or_edge a, node_or_edge b) {
+        bool a_null = !property_->IsValid(a);
+        bool b_null = !property_->IsValid(b);
+        if (a_null || b_null) {
+          return a_null == b_null ? a < b : b_null;
+        }
+        std::string_view a_val = GetValue(a);
+        std::string_view b_val = GetValue(b);
+        return a_val == b_val ? a < b : a_val < b_val;
+      });
+
+  size_t num_null = property_->Slice(0, num_entities_)->null_count();
+  size_t num_valid = num_entities_ - num_null;
+  this->id_storage_.allocateBlocked(num_valid);
+  katana::ParallelSTL::copy(
+      ids.begin(), ids.begin() + num_valid, this->id_storage_.begin());
+
+  this->UseIdStorage();
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge>
+Result<void>
+StringEntityIndex<node_or_edge>::BuildFromFile(const Uri& uri) {
+  this->num_ids_ = KATANA_CHECKED(MapIndexFile(
+      uri, num_entities_, sizeof(node_or_edge), 0, &this->file_));
+  this->ids_ =
+      this->file_.template ptr<node_or_edge>(sizeof(EntityIndexFileHeader));
+
+  return katana::ResultSuccess();
+}
+
+template <typename node_or_edge>
+Result<void>
+StringEntityIndex<node_or_edge>::WriteToFile(const Uri& uri) const {
+  return WriteIndexFile(
+      uri, num_entities_, this->ids_, this->num_ids_, sizeof(node_or_edge),
+      nullptr, 0);
+}
+
+template <typename node_or_edge, typename key_type>
+key_type
+HashEntityIndex<node_or_edge, key_type>::GetValue(node_or_edge id) const {
+  if constexpr (std::is_same_v<key_type, std::string_view>) {
+    arrow::util::string_view arrow_view = property_->GetView(id);
+    return std::string_view(arrow_view.data(), arrow_view.length());
+  } else {
+    return property_->Value(id);
+  }
+}
+
+template <typename node_or_edge, typename key_type>
+std::pair<
+    typename HashEntityIndex<node_or_edge, key_type>::iterator,
+    typename HashEntityIndex<node_or_edge, key_type>::iterator>
+HashEntityIndex<node_or_edge, key_type>::EqualRange(key_type key) const {
+  if (ctrl_.size() == 0) {
+    return {this->end(), this->end()};
+  }
+
+  uint64_t hash = HashKey(key);
+  uint8_t tag = HashTag(hash);
+  uint64_t group_mask = ctrl_.size() / kGroupSize - 1;
+  // The table always has an empty slot, so probing terminates
+  for (uint64_t g = (hash >> 7) & group_mask;; g = (g + 1) & group_mask) {
+    const uint8_t* group = &ctrl_[g * kGroupSize];
+    for (uint32_t match = MatchGroup(group, tag); match != 0;
+         match &= match - 1) {
+      uint64_t run = slots_[g * kGroupSize + __builtin_ctz(match)];
+      uint64_t first = run_starts_[run];
+      if (GetValue(this->ids_[first]) == key) {
+        return {this->begin() + first, this->begin() + run_starts_[run + 1]};
+      }
+    }
+    if (MatchGroup(group, kEmptyCtrl) != 0) {
+      return {this->end(), this->end()};
     }
   }
+}
+
+template <typename node_or_edge, typename key_type>
+Result<void>
+HashEntityIndex<node_or_edge, key_type>::BuildFromProperty() {
+  if (static_cast<uint64_t>(property_->length()) < num_entities_) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "Property does not contain all entities");
+  }
+
+  // Sort (is_null, hash, id) triples so that entities with equal keys form
+  // runs and the null entities collect at the end. Keys are only compared
+  // when their hashes collide.
+  using Entry = std::tuple<bool, uint64_t, node_or_edge>;
+  NUMAArray<Entry> entries;
+  entries.allocateBlocked(num_entities_);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_entities_),
+      [&](size_t i) {
+        node_or_edge id = i;
+        bool is_null = !property_->IsValid(id);
+        entries[i] = Entry{is_null, is_null ? 0 : HashKey(GetValue(id)), id};
+      },
+      katana::no_stats());
+  katana::ParallelSTL::sort(
+      entries.begin(), entries.end(), [this](const Entry& a, const Entry& b) {
+        const auto& [a_null, a_hash, a_id] = a;
+        const auto& [b_null, b_hash, b_id] = b;
+        if (a_null != b_null || a_hash != b_hash || a_null) {
+          return a < b;
+        }
+        key_type a_val = GetValue(a_id);
+        key_type b_val = GetValue(b_id);
+        return a_val == b_val ? a_id < b_id : a_val < b_val;
+      });
+
+  size_t num_null = property_->Slice(0, num_entities_)->null_count();
+  size_t num_valid = num_entities_ - num_null;
+
+  // Number the runs: is_start[i] is 1 when entry i begins a run, and its
+  // running sum is one more than the run of entry i.
+  NUMAArray<uint64_t> run_of;
+  run_of.allocateBlocked(num_valid);
+  this->id_storage_.allocateBlocked(num_valid);
+  katana::do_all(
+      katana::iterate(size_t{0}, num_valid),
+      [&](size_t i) {
+        const auto& [is_null, hash, id] = entries[i];
+        this->id_storage_[i] = id;
+        run_of[i] = i == 0 || std::get<1>(entries[i - 1]) != hash ||
+                    GetValue(std::get<2>(entries[i - 1])) != GetValue(id);
+      },
+      katana::no_stats());
+  katana::ParallelSTL::partial_sum(
+      run_of.begin(), run_of.end(), run_of.begin());
+
+  size_t num_runs = num_valid == 0 ? 0 : run_of[num_valid - 1];
+  run_starts_.allocateBlocked(num_runs + 1);
+  run_starts_[num_runs] = num_valid;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_valid),
+      [&](size_t i) {
+        if (i == 0 || run_of[i] != run_of[i - 1]) {
+          run_starts_[run_of[i] - 1] = i;
+        }
+      },
+      katana::no_stats());
+
+  // Keep the load factor at most 7/8 so that probe sequences stay short
+  size_t capacity = kGroupSize;
+  while (capacity * 7 / 8 <= num_runs) {
+    capacity *= 2;
+  }
+  ctrl_.allocateBlocked(capacity);
+  slots_.allocateBlocked(capacity);
+  katana::ParallelSTL::fill(ctrl_.begin(), ctrl_.end(), kEmptyCtrl);
+
+  // Keys are distinct, so each run claims the first empty slot along its
+  // probe sequence. Groups only fill up, so a lookup that stops at the first
+  // group with an empty slot cannot miss a key inserted concurrently.
+  uint64_t group_mask = capacity / kGroupSize - 1;
+  katana::do_all(
+      katana::iterate(size_t{0}, num_runs),
+      [&](size_t run) {
+        uint64_t hash = std::get<1>(entries[run_starts_[run]]);
+        uint8_t tag = HashTag(hash);
+        for (uint64_t g = (hash >> 7) & group_mask;; g = (g + 1) & group_mask) {
+          for (size_t i = g * kGroupSize; i < (g + 1) * kGroupSize; ++i) {
+            uint8_t expected = kEmptyCtrl;
+            if (__atomic_compare_exchange_n(
+                    &ctrl_[i], &expected, tag, false, __ATOMIC_RELAXED,
+                    __ATOMIC_RELAXED)) {
+              slots_[i] = run;
+              return;
+            }
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  this->UseIdStorage();
 
   return katana::ResultSuccess();
 }
 
+template <typename node_or_edge, typename key_type>
+Result<void>
+HashEntityIndex<node_or_edge, key_type>::BuildFromFile(const Uri& uri) {
+  return KATANA_ERROR(
+      ErrorCode::NotImplemented, "hash indexes are not persisted: {}", uri);
+}
+
+template <typename node_or_edge, typename key_type>
+Result<void>
+HashEntityIndex<node_or_edge, key_type>::WriteToFile(const Uri& uri) const {
+  return KATANA_ERROR(
+      ErrorCode::NotImplemented, "hash indexes are not persisted: {}", uri);
+}
+
 // Forward declare template types to allow implementation in .cpp.
 template class PrimitiveEntityIndex<GraphTopology::Node, bool>;
 template class PrimitiveEntityIndex<GraphTopology::Edge, bool>;
@@ -102,13 +534,26 @@ template class PrimitiveEntityIndex<GraphTopology::Edge, double_t>;
 template class StringEntityIndex<GraphTopology::Node>;
 template class StringEntityIndex<GraphTopology::Edge>;
 
+template class HashEntityIndex<GraphTopology::Node, uint8_t>;
+template class HashEntityIndex<GraphTopology::Edge, uint8_t>;
+template class HashEntityIndex<GraphTopology::Node, int32_t>;
+template class HashEntityIndex<GraphTopology::Edge, int32_t>;
+template class HashEntityIndex<GraphTopology::Node, uint32_t>;
+template class HashEntityIndex<GraphTopology::Edge, uint32_t>;
+template class HashEntityIndex<GraphTopology::Node, int64_t>;
+template class HashEntityIndex<GraphTopology::Edge, int64_t>;
+template class HashEntityIndex<GraphTopology::Node, uint64_t>;
+template class HashEntityIndex<GraphTopology::Edge, uint64_t>;
+template class HashEntityIndex<GraphTopology::Node, std::string_view>;
+template class HashEntityIndex<GraphTopology::Edge, std::string_view>;
+
 template Result<std::unique_ptr<EntityIndex<GraphTopology::Node>>>
 MakeTypedEntityIndex(
     const std::string& column_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property, EntityIndexKind kind);
 template Result<std::unique_ptr<EntityIndex<GraphTopology::Edge>>>
 MakeTypedEntityIndex(
     const std::string& column_name, size_t num_entities,
-    std::shared_ptr<arrow::Array> property);
+    std::shared_ptr<arrow::Array> property, EntityIndexKind kind);
 
 }  // namespace katana
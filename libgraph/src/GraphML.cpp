@@ -592,30 +592,17 @@ ProcessGraph(
   }
 }
 
-}  // end of unnamed namespace
-
-katana::Result<katana::GraphComponents>
-katana::ConvertGraphML(
-    const std::string& infilename, size_t chunk_size, bool verbose) {
-  xmlTextReaderPtr reader;
-
-  reader = xmlNewTextReaderFilename(infilename.c_str());
-  if (reader == NULL) {
-    return KATANA_ERROR(ErrorCode::NotFound, "Unable to open {}", infilename);
-  }
-  auto res = ConvertGraphML(reader, chunk_size, verbose);
-  xmlFreeTextReader(reader);
-  return res;
-}
-
-katana::Result<katana::GraphComponents>
-katana::ConvertGraphML(
-    xmlTextReaderPtr reader, size_t chunk_size, bool verbose) {
+/*
+ * reads in "key" xml nodes and adds builders for them, then parses the first
+ * "graph" xml node using those keys
+ */
+katana::Result<void>
+ProcessGraphML(
+    xmlTextReaderPtr reader, katana::PropertyGraphBuilder* builder,
+    bool verbose) {
   int ret = 0;
   bool finishedGraph = false;
 
-  katana::PropertyGraphBuilder builder{chunk_size};
-
   // procedure:
   // read in "key" xml nodes and add them to nodeKeys and edgeKeys
   // once we reach the first "graph" xml node we parse it using the above keys
@@ -633,16 +620,16 @@ katana::ConvertGraphML(
         if (!key.id.empty() && key.id != std::string("label") &&
             key.id != std::string("IGNORE")) {
           if (key.for_node) {
-            builder.AddBuilder(std::move(key));
+            builder->AddBuilder(std::move(key));
           } else if (key.for_edge) {
-            builder.AddBuilder(std::move(key));
+            builder->AddBuilder(std::move(key));
           }
         }
       } else if (xmlStrEqual(name, BAD_CAST "graph")) {
         if (verbose) {
           std::cout << "Finished processing property headers\n";
         }
-        ProcessGraph(reader, &builder, false);
+        ProcessGraph(reader, builder, false);
         finishedGraph = true;
       }
     }
@@ -650,11 +637,60 @@ katana::ConvertGraphML(
   }
   if (ret < 0) {
     return KATANA_ERROR(
-        ErrorCode::InvalidArgument,
+        katana::ErrorCode::InvalidArgument,
         "failed to parse: incorrect xml format\n"
         "Please verify there are no illegal characters in the GraphML file\n"
         "To remove invalid characters use: \"sed -i $'s/[^[:print:]\t]//g' "
         "<file>\", warning this will alter the original file");
   }
+  return katana::ResultSuccess();
+}
+
+}  // end of unnamed namespace
+
+katana::Result<katana::GraphComponents>
+katana::ConvertGraphML(
+    const std::string& infilename, size_t chunk_size, bool verbose) {
+  xmlTextReaderPtr reader;
+
+  reader = xmlNewTextReaderFilename(infilename.c_str());
+  if (reader == NULL) {
+    return KATANA_ERROR(ErrorCode::NotFound, "Unable to open {}", infilename);
+  }
+  auto res = ConvertGraphML(reader, chunk_size, verbose);
+  xmlFreeTextReader(reader);
+  return res;
+}
+
+katana::Result<katana::GraphComponents>
+katana::ConvertGraphML(
+    xmlTextReaderPtr reader, size_t chunk_size, bool verbose) {
+  katana::PropertyGraphBuilder builder{chunk_size};
+
+  KATANA_CHECKED(ProcessGraphML(reader, &builder, verbose));
   return builder.Finish(verbose);
 }
+
+katana::Result<void>
+katana::ConvertGraphMLStreaming(
+    const std::string& infilename, const std::string& dir,
+    const std::string& spill_dir, katana::TxnContext* txn_ctx,
+    size_t chunk_size, bool verbose) {
+  xmlTextReaderPtr reader;
+
+  reader = xmlNewTextReaderFilename(infilename.c_str());
+  if (reader == NULL) {
+    return KATANA_ERROR(ErrorCode::NotFound, "Unable to open {}", infilename);
+  }
+
+  katana::PropertyGraphBuilder builder{chunk_size};
+  auto res = builder.SpillPropertiesTo(spill_dir);
+  if (res) {
+    res = ProcessGraphML(reader, &builder, verbose);
+  }
+  xmlFreeTextReader(reader);
+  if (!res) {
+    return res.error();
+  }
+  return builder.FinishAndWrite(dir, txn_ctx, verbose);
+}
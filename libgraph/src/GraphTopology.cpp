@@ -482,7 +482,7 @@ katana::CondensedTypeIDMap::MakeFromEdgeTypes(
 
   // ordered map
   std::set<katana::EntityTypeID> mergedSet;
-  for (uint32_t i = 0; i < katana::activeThreads; ++i) {
+  for (uint32_t i = 0; i < katana::getActiveThreads(); ++i) {
     auto& edgeTypesSet = *edgeTypes.getRemote(i);
     for (auto edgeType : edgeTypesSet) {
       mergedSet.insert(edgeType);
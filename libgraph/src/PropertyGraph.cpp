@@ -3,6 +3,8 @@
 #include <stdio.h>
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <iomanip>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -20,12 +22,14 @@
 #include "katana/PerThreadStorage.h"
 #include "katana/Platform.h"
 #include "katana/Properties.h"
+#include "katana/PropertyManager.h"
 #include "katana/RDG.h"
 #include "katana/RDGManifest.h"
 #include "katana/RDGPrefix.h"
 #include "katana/RDGStorageFormatVersion.h"
 #include "katana/RDGTopology.h"
 #include "katana/Result.h"
+#include "katana/file.h"
 #include "katana/tsuba.h"
 
 namespace {
@@ -93,6 +97,84 @@ MapEntityTypeIDsArray(
   return katana::MakeResult(std::move(entity_type_id_array));
 }
 
+/// The file holding the index over the property stored at prop_uri. Property
+/// files are never modified in place, so an index written next to one stays
+/// valid for as long as the property is unchanged.
+katana::Uri
+IndexUri(const katana::Uri& prop_uri) {
+  return prop_uri + std::string(".index");
+}
+
+/// Map the index stored next to the property if there is a usable one,
+/// otherwise build it from the property. Only sorted indexes are persisted.
+template <typename node_or_edge>
+katana::Result<void>
+BuildIndex(
+    katana::EntityIndex<node_or_edge>* index,
+    const katana::Result<katana::Uri>& prop_uri) {
+  if (prop_uri && index->kind() == katana::EntityIndexKind::kSorted) {
+    katana::Uri index_uri = IndexUri(prop_uri.value());
+    katana::StatBuf stat_buf;
+    if (katana::FileStat(index_uri.string(), &stat_buf)) {
+      auto res = index->BuildFromFile(index_uri);
+      if (res) {
+        return katana::ResultSuccess();
+      }
+      KATANA_LOG_WARN("rebuilding index {}: {}", index_uri, res.error());
+    }
+  }
+  return index->BuildFromProperty();
+}
+
+template <typename node_or_edge>
+katana::Result<void>
+PersistIndex(
+    const std::vector<std::unique_ptr<katana::EntityIndex<node_or_edge>>>&
+        indexes,
+    const std::string& column_name,
+    const katana::Result<katana::Uri>& prop_uri) {
+  auto it = std::find_if(indexes.begin(), indexes.end(), [&](const auto& i) {
+    return i->column_name() == column_name &&
+           i->kind() == katana::EntityIndexKind::kSorted;
+  });
+  if (it == indexes.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "no sorted index for column {}",
+        std::quoted(column_name));
+  }
+  if (!prop_uri) {
+    return prop_uri.error().WithContext(
+        "index for column {} cannot be persisted", std::quoted(column_name));
+  }
+  return (*it)->WriteToFile(IndexUri(prop_uri.value()));
+}
+
+/// Write each sorted index in indexes next to its property as stored in
+/// dir, unless an earlier write already did. Other kinds of index are
+/// rebuilt when the graph is loaded.
+template <typename node_or_edge, typename StorageUriFn>
+katana::Result<void>
+PersistIndexes(
+    const std::vector<std::unique_ptr<katana::EntityIndex<node_or_edge>>>&
+        indexes,
+    const katana::Uri& dir, StorageUriFn storage_uri) {
+  for (const auto& index : indexes) {
+    if (index->kind() != katana::EntityIndexKind::kSorted) {
+      continue;
+    }
+    katana::Uri prop_uri = KATANA_CHECKED(storage_uri(index->column_name()));
+    katana::Uri index_uri = IndexUri(dir.Join(prop_uri.BaseName()));
+    katana::StatBuf stat_buf;
+    if (katana::FileStat(index_uri.string(), &stat_buf)) {
+      continue;
+    }
+    KATANA_CHECKED_CONTEXT(
+        index->WriteToFile(index_uri), "persisting index over {}",
+        std::quoted(index->column_name()));
+  }
+  return katana::ResultSuccess();
+}
+
 katana::Result<std::unique_ptr<katana::FileFrame>>
 WriteEntityTypeIDsArray(
     const katana::NUMAArray<katana::EntityTypeID>& entity_type_id_array) {
@@ -141,6 +223,15 @@ MakeDefaultEntityTypeIDArray(size_t vec_sz) {
   return type_ids;
 }
 
+/// PropertyManager accounts for properties as single column tables
+std::shared_ptr<arrow::Table>
+ColumnAsTable(
+    const std::string& name,
+    const std::shared_ptr<arrow::ChunkedArray>& column) {
+  return arrow::Table::Make(
+      arrow::schema({arrow::field(name, column->type())}), {column});
+}
+
 }  // namespace
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
@@ -218,8 +309,10 @@ katana::PropertyGraph::Make(
     std::unique_ptr<RDGFile> rdg_file, katana::TxnContext* txn_ctx,
     const katana::RDGLoadOptions& opts) {
   auto rdg = KATANA_CHECKED(RDG::Make(*rdg_file, opts));
-  return katana::PropertyGraph::Make(
-      std::move(rdg_file), std::move(rdg), txn_ctx);
+  auto pg = KATANA_CHECKED(katana::PropertyGraph::Make(
+      std::move(rdg_file), std::move(rdg), txn_ctx));
+  pg->lazy_properties_ = opts.lazy_properties;
+  return MakeResult(std::move(pg));
 }
 
 katana::Result<std::unique_ptr<katana::PropertyGraph>>
@@ -425,11 +518,28 @@ katana::PropertyGraph::DoWrite(
   std::unique_ptr<katana::FileFrame> edge_entity_type_id_array_res =
       KATANA_CHECKED(WriteEntityTypeIDsArray(edge_entity_type_ids_));
 
-  return rdg_.Store(
+  KATANA_CHECKED(rdg_.Store(
       handle, command_line, versioning_action,
       std::move(node_entity_type_id_array_res),
       std::move(edge_entity_type_id_array_res), node_entity_type_manager(),
-      edge_entity_type_manager());
+      edge_entity_type_manager()));
+
+  // Indexes are written after the commit, once every property they cover
+  // has a file. They only save rebuilding, so failing to write one does not
+  // fail the write.
+  katana::Uri dir = katana::GetRDGDir(handle);
+  auto persisted = PersistIndexes(node_indexes_, dir, [&](const auto& name) {
+    return rdg_.NodePropertyStorageUri(name);
+  });
+  if (persisted) {
+    persisted = PersistIndexes(edge_indexes_, dir, [&](const auto& name) {
+      return rdg_.EdgePropertyStorageUri(name);
+    });
+  }
+  if (!persisted) {
+    KATANA_LOG_WARN("indexes will be rebuilt on load: {}", persisted.error());
+  }
+  return katana::ResultSuccess();
 }
 
 katana::Result<void>
@@ -719,7 +829,11 @@ katana::PropertyGraph::ReportDiff(const PropertyGraph* other) const {
 
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 katana::PropertyGraph::GetNodeProperty(const std::string& name) const {
-  auto ret = rdg_.node_properties()->GetColumnByName(name);
+  if (lazy_properties_) {
+    // Loading an absent property does not change the logical graph
+    return const_cast<PropertyGraph*>(this)->LoadNodePropertyOnAccess(name);
+  }
+  auto ret = node_properties()->GetColumnByName(name);
   if (ret) {
     return MakeResult(std::move(ret));
   }
@@ -729,7 +843,11 @@ katana::PropertyGraph::GetNodeProperty(const std::string& name) const {
 
 katana::Result<std::shared_ptr<arrow::ChunkedArray>>
 katana::PropertyGraph::GetEdgeProperty(const std::string& name) const {
-  auto ret = rdg_.edge_properties()->GetColumnByName(name);
+  if (lazy_properties_) {
+    // Loading an absent property does not change the logical graph
+    return const_cast<PropertyGraph*>(this)->LoadEdgePropertyOnAccess(name);
+  }
+  auto ret = edge_properties()->GetColumnByName(name);
   if (ret) {
     return MakeResult(std::move(ret));
   }
@@ -737,6 +855,117 @@ katana::PropertyGraph::GetEdgeProperty(const std::string& name) const {
       ErrorCode::PropertyNotFound, "edge property does not exist: {}", name);
 }
 
+void
+katana::PropertyGraph::ReleaseManagedProperty(
+    std::unordered_set<std::string>* managed, const std::string& name,
+    const std::shared_ptr<arrow::ChunkedArray>& column) {
+  if (managed->erase(name) == 0) {
+    return;
+  }
+  KATANA_LOG_DEBUG_ASSERT(property_manager_ != nullptr && column);
+  property_manager_->PropertyUnloadedCallback(ColumnAsTable(name, column));
+}
+
+katana::Result<void>
+katana::PropertyGraph::DoNodePropertyLoad(const std::string& name, int i) {
+  if (property_manager_ == nullptr) {
+    return rdg_.LoadNodeProperty(name, i);
+  }
+  // The property may still be in standby memory from when it was unloaded
+  auto uri = KATANA_CHECKED(rdg_.NodePropertyStorageUri(name));
+  if (auto standby = property_manager_->AddProperty(uri); standby) {
+    KATANA_CHECKED(rdg_.RestoreNodeProperty(standby.value(), i));
+  } else {
+    KATANA_CHECKED(rdg_.LoadNodeProperty(name, i));
+    property_manager_->PropertyLoadedCallback(
+        ColumnAsTable(name, rdg_.node_properties()->GetColumnByName(name)));
+  }
+  managed_node_properties_.emplace(name);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::DoNodePropertyUnload(const std::string& name) {
+  auto column = rdg_.node_properties()->GetColumnByName(name);
+  KATANA_CHECKED(rdg_.UnloadNodeProperty(name));
+  if (managed_node_properties_.erase(name) > 0) {
+    // Unloading wrote the property if it was modified, so it has a location
+    auto uri = KATANA_CHECKED(rdg_.NodePropertyStorageUri(name));
+    property_manager_->UnloadProperty(uri, ColumnAsTable(name, column));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::PropertyGraph::LoadNodePropertyOnAccess(const std::string& name) {
+  std::lock_guard<std::mutex> lock(*property_mutex_);
+  // Another thread may have loaded the property while we waited
+  if (auto ret = rdg_.node_properties()->GetColumnByName(name); ret) {
+    return MakeResult(std::move(ret));
+  }
+  auto stored = rdg_.ListFullNodeProperties();
+  if (std::find(stored.cbegin(), stored.cend(), name) == stored.cend()) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "node property does not exist: {}", name);
+  }
+  KATANA_CHECKED_CONTEXT(
+      DoNodePropertyLoad(name, -1), "loading node property {} on access",
+      std::quoted(name));
+  auto ret = rdg_.node_properties()->GetColumnByName(name);
+  KATANA_LOG_ASSERT(ret);
+  return MakeResult(std::move(ret));
+}
+
+katana::Result<void>
+katana::PropertyGraph::DoEdgePropertyLoad(const std::string& name, int i) {
+  if (property_manager_ == nullptr) {
+    return rdg_.LoadEdgeProperty(name, i);
+  }
+  // The property may still be in standby memory from when it was unloaded
+  auto uri = KATANA_CHECKED(rdg_.EdgePropertyStorageUri(name));
+  if (auto standby = property_manager_->AddProperty(uri); standby) {
+    KATANA_CHECKED(rdg_.RestoreEdgeProperty(standby.value(), i));
+  } else {
+    KATANA_CHECKED(rdg_.LoadEdgeProperty(name, i));
+    property_manager_->PropertyLoadedCallback(
+        ColumnAsTable(name, rdg_.edge_properties()->GetColumnByName(name)));
+  }
+  managed_edge_properties_.emplace(name);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::PropertyGraph::DoEdgePropertyUnload(const std::string& name) {
+  auto column = rdg_.edge_properties()->GetColumnByName(name);
+  KATANA_CHECKED(rdg_.UnloadEdgeProperty(name));
+  if (managed_edge_properties_.erase(name) > 0) {
+    // Unloading wrote the property if it was modified, so it has a location
+    auto uri = KATANA_CHECKED(rdg_.EdgePropertyStorageUri(name));
+    property_manager_->UnloadProperty(uri, ColumnAsTable(name, column));
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<std::shared_ptr<arrow::ChunkedArray>>
+katana::PropertyGraph::LoadEdgePropertyOnAccess(const std::string& name) {
+  std::lock_guard<std::mutex> lock(*property_mutex_);
+  // Another thread may have loaded the property while we waited
+  if (auto ret = rdg_.edge_properties()->GetColumnByName(name); ret) {
+    return MakeResult(std::move(ret));
+  }
+  auto stored = rdg_.ListFullEdgeProperties();
+  if (std::find(stored.cbegin(), stored.cend(), name) == stored.cend()) {
+    return KATANA_ERROR(
+        ErrorCode::PropertyNotFound, "edge property does not exist: {}", name);
+  }
+  KATANA_CHECKED_CONTEXT(
+      DoEdgePropertyLoad(name, -1), "loading edge property {} on access",
+      std::quoted(name));
+  auto ret = rdg_.edge_properties()->GetColumnByName(name);
+  KATANA_LOG_ASSERT(ret);
+  return MakeResult(std::move(ret));
+}
+
 katana::Result<void>
 katana::PropertyGraph::Write(
     const std::string& rdg_name, const std::string& command_line) {
@@ -758,6 +987,7 @@ katana::PropertyGraph::AddNodeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology().NumNodes(), props->num_rows());
   }
+  std::lock_guard<std::mutex> lock(*property_mutex_);
   return rdg_.AddNodeProperties(props, txn_ctx);
 }
 
@@ -773,29 +1003,46 @@ katana::PropertyGraph::UpsertNodeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology().NumNodes(), props->num_rows());
   }
+  std::lock_guard<std::mutex> lock(*property_mutex_);
   return rdg_.UpsertNodeProperties(props, txn_ctx);
 }
 
+katana::Result<void>
+katana::PropertyGraph::DoNodePropertyRemove(
+    int i, katana::TxnContext* txn_ctx) {
+  const auto& props = rdg_.node_properties();
+  std::shared_ptr<arrow::ChunkedArray> column;
+  std::string name;
+  if (i < props->num_columns()) {
+    column = props->column(i);
+    name = props->field(i)->name();
+  }
+  KATANA_CHECKED(rdg_.RemoveNodeProperty(i, txn_ctx));
+  ReleaseManagedProperty(&managed_node_properties_, name, column);
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::PropertyGraph::RemoveNodeProperty(int i, katana::TxnContext* txn_ctx) {
-  return rdg_.RemoveNodeProperty(i, txn_ctx);
+  std::lock_guard<std::mutex> lock(*property_mutex_);
+  return DoNodePropertyRemove(i, txn_ctx);
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveNodeProperty(
     const std::string& prop_name, katana::TxnContext* txn_ctx) {
-  auto col_names = rdg_.node_properties()->ColumnNames();
-  auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
-  if (pos != col_names.cend()) {
-    return rdg_.RemoveNodeProperty(
-        std::distance(col_names.cbegin(), pos), txn_ctx);
+  std::lock_guard<std::mutex> lock(*property_mutex_);
+  int i = rdg_.node_properties()->schema()->GetFieldIndex(prop_name);
+  if (i == -1) {
+    return katana::ErrorCode::PropertyNotFound;
   }
-  return katana::ErrorCode::PropertyNotFound;
+  return DoNodePropertyRemove(i, txn_ctx);
 }
 
 katana::Result<void>
 katana::PropertyGraph::LoadNodeProperty(const std::string& name, int i) {
-  return rdg_.LoadNodeProperty(name, i);
+  std::lock_guard<std::mutex> lock(*property_mutex_);
+  return DoNodePropertyLoad(name, i);
 }
 /// Load a node property by name if it is absent and append its column to
 /// the table do nothing otherwise
@@ -809,7 +1056,8 @@ katana::PropertyGraph::EnsureNodePropertyLoaded(const std::string& name) {
 
 katana::Result<void>
 katana::PropertyGraph::UnloadNodeProperty(const std::string& prop_name) {
-  return rdg_.UnloadNodeProperty(prop_name);
+  std::lock_guard<std::mutex> lock(*property_mutex_);
+  return DoNodePropertyUnload(prop_name);
 }
 
 katana::Result<void>
@@ -824,6 +1072,7 @@ katana::PropertyGraph::AddEdgeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology().NumEdges(), props->num_rows());
   }
+  std::lock_guard<std::mutex> lock(*property_mutex_);
   return rdg_.AddEdgeProperties(props, txn_ctx);
 }
 
@@ -839,34 +1088,52 @@ katana::PropertyGraph::UpsertEdgeProperties(
         ErrorCode::InvalidArgument, "expected {} rows found {} instead",
         topology().NumEdges(), props->num_rows());
   }
+  std::lock_guard<std::mutex> lock(*property_mutex_);
   return rdg_.UpsertEdgeProperties(props, txn_ctx);
 }
 
+katana::Result<void>
+katana::PropertyGraph::DoEdgePropertyRemove(
+    int i, katana::TxnContext* txn_ctx) {
+  const auto& props = rdg_.edge_properties();
+  std::shared_ptr<arrow::ChunkedArray> column;
+  std::string name;
+  if (i < props->num_columns()) {
+    column = props->column(i);
+    name = props->field(i)->name();
+  }
+  KATANA_CHECKED(rdg_.RemoveEdgeProperty(i, txn_ctx));
+  ReleaseManagedProperty(&managed_edge_properties_, name, column);
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::PropertyGraph::RemoveEdgeProperty(int i, katana::TxnContext* txn_ctx) {
-  return rdg_.RemoveEdgeProperty(i, txn_ctx);
+  std::lock_guard<std::mutex> lock(*property_mutex_);
+  return DoEdgePropertyRemove(i, txn_ctx);
 }
 
 katana::Result<void>
 katana::PropertyGraph::RemoveEdgeProperty(
     const std::string& prop_name, katana::TxnContext* txn_ctx) {
-  auto col_names = rdg_.edge_properties()->ColumnNames();
-  auto pos = std::find(col_names.cbegin(), col_names.cend(), prop_name);
-  if (pos != col_names.cend()) {
-    return rdg_.RemoveEdgeProperty(
-        std::distance(col_names.cbegin(), pos), txn_ctx);
+  std::lock_guard<std::mutex> lock(*property_mutex_);
+  int i = rdg_.edge_properties()->schema()->GetFieldIndex(prop_name);
+  if (i == -1) {
+    return katana::ErrorCode::PropertyNotFound;
   }
-  return katana::ErrorCode::PropertyNotFound;
+  return DoEdgePropertyRemove(i, txn_ctx);
 }
 
 katana::Result<void>
 katana::PropertyGraph::UnloadEdgeProperty(const std::string& prop_name) {
-  return rdg_.UnloadEdgeProperty(prop_name);
+  std::lock_guard<std::mutex> lock(*property_mutex_);
+  return DoEdgePropertyUnload(prop_name);
 }
 
 katana::Result<void>
 katana::PropertyGraph::LoadEdgeProperty(const std::string& name, int i) {
-  return rdg_.LoadEdgeProperty(name, i);
+  std::lock_guard<std::mutex> lock(*property_mutex_);
+  return DoEdgePropertyLoad(name, i);
 }
 
 /// Load an edge property by name if it is absent and append its column to
@@ -881,9 +1148,11 @@ katana::PropertyGraph::EnsureEdgePropertyLoaded(const std::string& name) {
 
 // Build an index over nodes.
 katana::Result<void>
-katana::PropertyGraph::MakeNodeIndex(const std::string& column_name) {
+katana::PropertyGraph::MakeNodeIndex(
+    const std::string& column_name, katana::EntityIndexKind kind) {
   for (const auto& existing_index : node_indexes_) {
-    if (existing_index->column_name() == column_name) {
+    if (existing_index->column_name() == column_name &&
+        existing_index->kind() == kind) {
       return KATANA_ERROR(
           katana::ErrorCode::AlreadyExists,
           "Index already exists for column {}", column_name);
@@ -899,22 +1168,31 @@ katana::PropertyGraph::MakeNodeIndex(const std::string& column_name) {
   // Create an index based on the type of the field.
   std::unique_ptr<katana::EntityIndex<GraphTopology::Node>> index =
       KATANA_CHECKED(katana::MakeTypedEntityIndex<katana::GraphTopology::Node>(
-          column_name, NumNodes(), property));
+          column_name, NumNodes(), property, kind));
 
-  KATANA_CHECKED(index->BuildFromProperty());
+  KATANA_CHECKED(
+      BuildIndex(index.get(), rdg_.NodePropertyStorageUri(column_name)));
 
   node_indexes_.push_back(std::move(index));
 
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::PropertyGraph::PersistNodeIndex(const std::string& column_name) {
+  return PersistIndex(
+      node_indexes_, column_name, rdg_.NodePropertyStorageUri(column_name));
+}
+
 katana::Result<void>
 katana::PropertyGraph::DeleteNodeIndex(const std::string& column_name) {
-  for (auto it = node_indexes_.begin(); it != node_indexes_.end(); it++) {
-    if ((*it)->column_name() == column_name) {
-      node_indexes_.erase(it);
-      return katana::ResultSuccess();
-    }
+  // Remove every kind of index over the column
+  auto it = std::remove_if(
+      node_indexes_.begin(), node_indexes_.end(),
+      [&](const auto& index) { return index->column_name() == column_name; });
+  if (it != node_indexes_.end()) {
+    node_indexes_.erase(it, node_indexes_.end());
+    return katana::ResultSuccess();
   }
 
   // TODO(Chak-Pong) make deleteNodeIndex always successful
@@ -926,9 +1204,11 @@ katana::PropertyGraph::DeleteNodeIndex(const std::string& column_name) {
 
 // Build an index over edges.
 katana::Result<void>
-katana::PropertyGraph::MakeEdgeIndex(const std::string& column_name) {
+katana::PropertyGraph::MakeEdgeIndex(
+    const std::string& column_name, katana::EntityIndexKind kind) {
   for (const auto& existing_index : edge_indexes_) {
-    if (existing_index->column_name() == column_name) {
+    if (existing_index->column_name() == column_name &&
+        existing_index->kind() == kind) {
       return KATANA_ERROR(
           katana::ErrorCode::AlreadyExists,
           "Index already exists for column {}", column_name);
@@ -944,22 +1224,31 @@ katana::PropertyGraph::MakeEdgeIndex(const std::string& column_name) {
   // Create an index based on the type of the field.
   std::unique_ptr<katana::EntityIndex<katana::GraphTopology::Edge>> index =
       KATANA_CHECKED(katana::MakeTypedEntityIndex<katana::GraphTopology::Edge>(
-          column_name, NumEdges(), property));
+          column_name, NumEdges(), property, kind));
 
-  KATANA_CHECKED(index->BuildFromProperty());
+  KATANA_CHECKED(
+      BuildIndex(index.get(), rdg_.EdgePropertyStorageUri(column_name)));
 
   edge_indexes_.push_back(std::move(index));
 
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::PropertyGraph::PersistEdgeIndex(const std::string& column_name) {
+  return PersistIndex(
+      edge_indexes_, column_name, rdg_.EdgePropertyStorageUri(column_name));
+}
+
 katana::Result<void>
 katana::PropertyGraph::DeleteEdgeIndex(const std::string& column_name) {
-  for (auto it = edge_indexes_.begin(); it != edge_indexes_.end(); it++) {
-    if ((*it)->column_name() == column_name) {
-      edge_indexes_.erase(it);
-      return katana::ResultSuccess();
-    }
+  // Remove every kind of index over the column
+  auto it = std::remove_if(
+      edge_indexes_.begin(), edge_indexes_.end(),
+      [&](const auto& index) { return index->column_name() == column_name; });
+  if (it != edge_indexes_.end()) {
+    edge_indexes_.erase(it, edge_indexes_.end());
+    return katana::ResultSuccess();
   }
   return KATANA_ERROR(katana::ErrorCode::NotFound, "edge index not found");
 }
@@ -1259,11 +1548,23 @@ katana::CreateTransposeGraphTopology(const GraphTopology& topology) {
 }
 
 katana::Result<katana::EntityIndex<katana::GraphTopology::Node>*>
-katana::PropertyGraph::GetNodeIndex(const std::string& property_name) const {
+katana::PropertyGraph::GetNodeIndex(
+    const std::string& property_name, katana::EntityIndexKind kind) const {
   for (const auto& index : node_indexes()) {
-    if (index->column_name() == property_name) {
+    if (index->column_name() == property_name && index->kind() == kind) {
       return index.get();
     }
   }
   return KATANA_ERROR(katana::ErrorCode::NotFound, "node index not found");
 }
+
+katana::Result<katana::EntityIndex<katana::GraphTopology::Edge>*>
+katana::PropertyGraph::GetEdgeIndex(
+    const std::string& property_name, katana::EntityIndexKind kind) const {
+  for (const auto& index : edge_indexes()) {
+    if (index->column_name() == property_name && index->kind() == kind) {
+      return index.get();
+    }
+  }
+  return KATANA_ERROR(katana::ErrorCode::NotFound, "edge index not found");
+}
@@ -1,10 +1,12 @@
 #include "katana/TopologyGeneration.h"
 
+#include <set>
+
 namespace {
-template <typename F>
+template <typename Builder = katana::SymmetricGraphTopologyBuilder, typename F>
 std::unique_ptr<katana::PropertyGraph>
 MakeTopologyImpl(F builder_fun) {
-  katana::SymmetricGraphTopologyBuilder builder;
+  Builder builder;
   builder_fun(builder);
 
   katana::GraphTopology topo = builder.ConvertToCSR();
@@ -176,4 +178,90 @@ MakeTriangle(size_t num_rows) noexcept {
   });
 }
 
+std::vector<GeneratedEdge>
+MakeRandomEdges(
+    const RandomGraphOptions& options,
+    std::vector<uint32_t>* weights) noexcept {
+  KATANA_LOG_ASSERT(options.num_nodes > options.num_isolated);
+
+  std::mt19937 gen(options.seed);
+  std::uniform_int_distribution<uint32_t> node(
+      0, options.num_nodes - options.num_isolated - 1);
+  std::set<GeneratedEdge> seen;
+  std::vector<GeneratedEdge> edges;
+  while (edges.size() < options.num_edges) {
+    uint32_t src = node(gen);
+    uint32_t dst = node(gen);
+    if (options.edge_filter && !options.edge_filter(src, dst)) {
+      continue;
+    }
+    if (options.distinct &&
+        (src == dst || !seen.emplace(src, dst).second)) {
+      continue;
+    }
+    edges.emplace_back(src, dst);
+    if (options.weight_generator) {
+      uint32_t weight = options.weight_generator(&gen);
+      if (weights) {
+        weights->emplace_back(weight);
+      }
+    }
+  }
+  return edges;
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeRandomGraph(const RandomGraphOptions& options) noexcept {
+  std::vector<uint32_t> weights;
+  std::vector<GeneratedEdge> edges = MakeRandomEdges(options, &weights);
+  return MakeGraphFromEdges(
+      options.num_nodes, edges, options.symmetric, weights);
+}
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraphFromEdges(
+    size_t num_nodes, const std::vector<GeneratedEdge>& edges, bool symmetric,
+    const std::vector<uint32_t>& weights) noexcept {
+  KATANA_LOG_ASSERT(weights.empty() || weights.size() == edges.size());
+
+  auto add_edges = [&](auto& builder) {
+    builder.AddNodes(num_nodes);
+    for (const auto& [src, dst] : edges) {
+      builder.AddEdge(src, dst);
+    }
+  };
+  // Edges may repeat, which the default builders reject
+  std::unique_ptr<katana::PropertyGraph> pg =
+      symmetric ? MakeTopologyImpl<TopologyBuilderImpl<true, true>>(add_edges)
+                : MakeTopologyImpl<TopologyBuilderImpl<false, true>>(add_edges);
+  if (weights.empty()) {
+    return pg;
+  }
+
+  // The builders keep the out-edges of each node in the order they were
+  // added, so replaying the edges finds the position of each
+  const auto& topo = pg->topology();
+  std::vector<uint64_t> next_edge(num_nodes);
+  for (size_t n = 0; n < num_nodes; ++n) {
+    next_edge[n] = *topo.OutEdges(n).begin();
+  }
+  std::vector<uint32_t> edge_weights(topo.NumEdges());
+  for (size_t i = 0; i < edges.size(); ++i) {
+    const auto& [src, dst] = edges[i];
+    edge_weights[next_edge[src]++] = weights[i];
+    if (symmetric) {
+      edge_weights[next_edge[dst]++] = weights[i];
+    }
+  }
+
+  katana::TxnContext txn_ctx;
+  auto res = AddEdgeProperties(
+      pg.get(), &txn_ctx,
+      PropertyGenerator("weight", [&](GraphTopology::Edge e) {
+        return edge_weights[e];
+      }));
+  KATANA_LOG_VASSERT(res, "adding weights: {}", res.error());
+  return pg;
+}
+
 }  // namespace katana
@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "BCLevel.h"
+#include "betweenness_centrality_impl.h"
+#include "katana/NUMAArray.h"
+#include "katana/Properties.h"
+#include "katana/TypedPropertyGraph.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+struct NodeBC : public katana::PODProperty<float> {};
+
+using BatchGraph = BCLevelGraph;
+using BatchGNode = BCLevelGNode;
+
+/// One lane per source of the batch, and the sums of the samples
+struct BCBatchData {
+  BCLevelData<BetweennessCentralityPlan::kMaxSourcesPerBatch> level;
+
+  //! sum and sum of squares of the normalized dependency over all samples
+  katana::NUMAArray<double> sum;
+  katana::NUMAArray<double> sum_of_squares;
+};
+
+/******************************************************************************/
+/* Functions for running the algorithm */
+/******************************************************************************/
+void
+BatchInitializeGraph(
+    const BatchGraph& graph, uint32_t sources_per_batch, BCBatchData* data) {
+  BCLevelInitializeGraph(graph, sources_per_batch, &data->level);
+  data->sum.allocateBlocked(graph.size());
+  data->sum_of_squares.allocateBlocked(graph.size());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](BatchGNode n) {
+        data->sum[n] = 0;
+        data->sum_of_squares[n] = 0;
+      },
+      katana::no_stats(), katana::loopname("InitializeSums"));
+}
+
+/**
+ * One pass over a batch of sources: the forward and backward phases of the
+ * level algorithm, adding the normalized dependency of each node on each
+ * source of the batch to its sums.
+ */
+void
+BatchIteration(
+    const BatchGraph& graph, const std::vector<BatchGNode>& batch,
+    BCBatchData* data) {
+  double normalization = graph.size() - 2;
+  // worklist; last one will be empty
+  katana::gstl::Vector<BCLevelWorklistType> worklists =
+      BCLevelSSSP(graph, batch, &data->level);
+  BCLevelBackwardBrandes(
+      graph, &worklists, &data->level,
+      [&](BatchGNode n, uint32_t, float dependency) {
+        double sample = dependency / normalization;
+        data->sum[n] += sample;
+        data->sum_of_squares[n] += sample * sample;
+      });
+}
+
+/**
+ * Largest half-width, over all nodes, of the empirical Bernstein confidence
+ * interval of the mean normalized dependency after num_samples samples,
+ * with each interval failing with probability at most node_delta.
+ */
+double
+MaxErrorBound(
+    const BatchGraph& graph, const BCBatchData& data, uint64_t num_samples,
+    double node_delta) {
+  double r = num_samples;
+  double log_term = std::log(4 / node_delta);
+  katana::GReduceMax<double> max_bound;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](BatchGNode n) {
+        double variance =
+            std::max(
+                0.0, data.sum_of_squares[n] - data.sum[n] * data.sum[n] / r) /
+            (r - 1);
+        max_bound.update(
+            std::sqrt(2 * variance * log_term / r) +
+            7 * log_term / (3 * (r - 1)));
+      },
+      katana::no_stats(), katana::loopname("MaxErrorBound"));
+  return max_bound.reduce();
+}
+
+katana::Result<void>
+ExtractBC(
+    katana::PropertyGraph* pg, const BatchGraph& graph,
+    const BCBatchData& data, uint64_t num_samples,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx) {
+  KATANA_CHECKED(katana::analytics::ConstructNodeProperties<std::tuple<NodeBC>>(
+      pg, txn_ctx, {output_property_name}));
+
+  using NewGraph = katana::TypedPropertyGraphView<
+      katana::PropertyGraphViews::Default, std::tuple<NodeBC>, std::tuple<>>;
+  auto new_graph =
+      KATANA_CHECKED(NewGraph::Make(pg, {output_property_name}, {}));
+
+  // scale the mean normalized dependency back to a sum over all sources
+  double scale = 0;
+  if (num_samples > 0) {
+    scale = double(graph.size()) * (graph.size() - 2) / num_samples;
+  }
+  katana::do_all(
+      katana::iterate(graph),
+      [&](BatchGNode node_id) {
+        new_graph.GetData<NodeBC>(node_id) = data.sum[node_id] * scale;
+      },
+      katana::loopname("ExtractBC"), katana::no_stats());
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+BetweennessCentralityApproximate(
+    katana::PropertyGraph* pg,
+    katana::analytics::BetweennessCentralitySources sources,
+    const std::string& output_property_name,
+    katana::analytics::BetweennessCentralityPlan plan,
+    katana::TxnContext* txn_ctx) {
+  if (!std::holds_alternative<uint32_t>(sources)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "the approximate algorithm samples its own sources");
+  }
+  if (plan.epsilon() <= 0 || plan.delta() <= 0 || plan.delta() >= 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "epsilon must be positive and delta must be in (0, 1)");
+  }
+  uint32_t sources_per_batch = plan.sources_per_batch();
+  if (sources_per_batch == 0 ||
+      sources_per_batch > BetweennessCentralityPlan::kMaxSourcesPerBatch) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "sources per batch must be between 1 and {}",
+        BetweennessCentralityPlan::kMaxSourcesPerBatch);
+  }
+
+  BatchGraph graph = KATANA_CHECKED(BatchGraph::Make(pg, {}, {}));
+  katana::ReportPageAllocGuard page_alloc;
+
+  BCBatchData data;
+  BatchInitializeGraph(graph, sources_per_batch, &data);
+
+  // With fewer than 3 nodes no node is strictly between two others
+  if (graph.size() < 3) {
+    return ExtractBC(pg, graph, data, 0, output_property_name, txn_ctx);
+  }
+
+  // Half of delta is for the Hoeffding bound that holds once max_samples
+  // sources were sampled, half for the empirical Bernstein bounds checked
+  // whenever the number of samples doubles
+  double num_nodes = graph.size();
+  auto max_samples = static_cast<uint64_t>(std::ceil(
+      std::log(4 * num_nodes / plan.delta()) /
+      (2 * plan.epsilon() * plan.epsilon())));
+  if (sources != kBetweennessCentralityAllNodes) {
+    max_samples = std::min<uint64_t>(max_samples, std::get<uint32_t>(sources));
+  }
+  // the sample variance needs at least 2 samples
+  uint64_t first_check = std::max<uint64_t>(2, sources_per_batch);
+  uint64_t num_checks = 1;
+  for (uint64_t c = first_check; c < max_samples; c *= 2) {
+    num_checks++;
+  }
+  double node_delta = plan.delta() / (2 * num_checks * num_nodes);
+
+  std::mt19937_64 generator(plan.seed());
+  std::uniform_int_distribution<BatchGNode> distribution(0, graph.size() - 1);
+
+  katana::StatTimer exec_time("Approximate", "BetweennessCentrality");
+  exec_time.start();
+
+  uint64_t num_samples = 0;
+  uint64_t next_check = first_check;
+  std::vector<BatchGNode> batch;
+  while (num_samples < max_samples) {
+    batch.clear();
+    while (batch.size() < sources_per_batch &&
+           num_samples + batch.size() < max_samples) {
+      batch.push_back(distribution(generator));
+    }
+    num_samples += batch.size();
+
+    BatchIteration(graph, batch, &data);
+
+    if (num_samples >= next_check && num_samples < max_samples) {
+      if (MaxErrorBound(graph, data, num_samples, node_delta) <=
+          plan.epsilon()) {
+        break;
+      }
+      next_check *= 2;
+    }
+  }
+  exec_time.stop();
+
+  katana::ReportStatSingle("BetweennessCentrality", "Samples", num_samples);
+  katana::ReportStatSingle(
+      "BetweennessCentrality", "MaxSamples", max_samples);
+
+  return ExtractBC(
+      pg, graph, data, num_samples, output_property_name, txn_ctx);
+}
@@ -19,8 +19,12 @@
 
 #include "katana/analytics/bfs/bfs.h"
 
+#include <algorithm>
 #include <deque>
 #include <type_traits>
+#include <vector>
+
+#include <arrow/api.h>
 
 #include "katana/DynamicBitset.h"
 #include "katana/ErrorCode.h"
@@ -74,18 +78,6 @@ struct EdgeTileMaker {
   }
 };
 
-struct NodePushWrap {
-  template <typename C>
-  void operator()(C& cont, const GNode& n, const char* const /*tag*/) const {
-    (*this)(cont, n);
-  }
-
-  template <typename C>
-  void operator()(C& cont, const GNode& n) const {
-    cont.push(n);
-  }
-};
-
 struct EdgeTilePushWrap {
   Graph* graph;
   BfsImplementation& impl;
@@ -116,26 +108,117 @@ struct OneTilePushWrap {
   }
 };
 
-template <typename WL>
+constexpr uint32_t kBitsPerWord = katana::DynamicBitset::kNumBitsInUint64;
+
+/// Per-thread buffers of the nodes a top-down step adds to the frontier
+using FrontierBuffers = katana::PerThreadStorage<std::vector<GNode>>;
+
+/// Concatenate the per-thread buffers into queue and empty the buffers
 void
-WlToBitset(const WL& wl, katana::DynamicBitset* bitset) {
+GatherQueue(FrontierBuffers* buffers, std::vector<GNode>* queue) {
+  std::vector<size_t> offsets(buffers->size() + 1, 0);
+  for (unsigned i = 0; i < buffers->size(); ++i) {
+    offsets[i + 1] = offsets[i] + buffers->getRemote(i)->size();
+  }
+  queue->resize(offsets.back());
   katana::do_all(
-      katana::iterate(wl), [&](const GNode& src) { bitset->set(src); },
-      katana::chunk_size<kChunkSize>(), katana::loopname("WlToBitset"));
+      katana::iterate(0U, buffers->size()),
+      [&](unsigned i) {
+        std::vector<GNode>& buffer = *buffers->getRemote(i);
+        std::copy(buffer.begin(), buffer.end(), queue->begin() + offsets[i]);
+        buffer.clear();
+      },
+      katana::no_stats());
 }
 
-template <typename G, typename WL>
 void
-BitsetToWl(const G& graph, const katana::DynamicBitset& bitset, WL* wl) {
-  wl->clear();
+QueueToBitmap(const std::vector<GNode>& queue, katana::DynamicBitset* bitmap) {
+  auto& words = bitmap->get_vec();
   katana::do_all(
-      katana::iterate(graph),
+      katana::iterate(size_t{0}, words.size()), [&](size_t w) { words[w] = 0; },
+      katana::no_stats());
+  katana::do_all(
+      katana::iterate(queue), [&](const GNode& n) { bitmap->set(n); },
+      katana::chunk_size<kChunkSize>(), katana::loopname("QueueToBitmap"));
+}
+
+void
+BitmapToQueue(const katana::DynamicBitset& bitmap, std::vector<GNode>* queue) {
+  queue->clear();
+  // Counts the set bits of each thread's block of words in parallel and
+  // writes the nodes in order
+  bitmap.AppendOffsets(queue);
+}
+
+/// Expand the frontier queue along out-edges. The parents of newly reached
+/// nodes are set with a CAS and the nodes are pushed to buffers.
+///
+/// @return the number of out-edges of the next frontier
+uint64_t
+TopDownStep(
+    const BiDirGraphView& bidir_view, katana::NUMAArray<GNode>* node_data,
+    const std::vector<GNode>& frontier, FrontierBuffers* buffers) {
+  katana::GAccumulator<uint64_t> scout_count;
+  katana::do_all(
+      katana::iterate(frontier),
       [&](const GNode& src) {
-        if (bitset.test(src)) {
-          wl->push(src);
+        std::vector<GNode>& next = *buffers->getLocal();
+        for (auto e : bidir_view.OutEdges(src)) {
+          auto dst = bidir_view.OutEdgeDst(e);
+          GNode& ddata = (*node_data)[dst];
+          if (ddata == BfsImplementation::kDistanceInfinity &&
+              __sync_bool_compare_and_swap(
+                  &ddata, BfsImplementation::kDistanceInfinity, src)) {
+            next.emplace_back(dst);
+            scout_count += bidir_view.OutDegree(dst);
+          }
+        }
+      },
+      katana::steal(), katana::chunk_size<kChunkSize>(),
+      katana::loopname("SyncDO-push"));
+  return scout_count.reduce();
+}
+
+/// Every unvisited node looks for a parent among its in-neighbors in front
+/// and joins next if it finds one. Nodes are processed a bitmap word at a
+/// time, so each word of next is written whole by one thread, without
+/// atomics and without clearing next first.
+///
+/// @return the number of nodes in next
+uint64_t
+BottomUpStep(
+    const BiDirGraphView& bidir_view, katana::NUMAArray<GNode>* node_data,
+    const katana::DynamicBitset& front, katana::DynamicBitset* next) {
+  uint64_t num_nodes = bidir_view.NumNodes();
+  auto& next_words = next->get_vec();
+  katana::GAccumulator<uint64_t> awake_count;
+  katana::do_all(
+      katana::iterate(size_t{0}, next_words.size()),
+      [&](size_t w) {
+        uint64_t begin = w * kBitsPerWord;
+        uint64_t end = std::min(begin + kBitsPerWord, num_nodes);
+        uint64_t word = 0;
+        for (uint64_t dst = begin; dst < end; ++dst) {
+          GNode& ddata = (*node_data)[dst];
+          if (ddata != BfsImplementation::kDistanceInfinity) {
+            continue;
+          }
+          for (auto e : bidir_view.InEdges(dst)) {
+            auto src = bidir_view.InEdgeSrc(e);
+            if (front.test(src)) {
+              // assign parents on the bfs path.
+              ddata = src;
+              word |= uint64_t{1} << (dst - begin);
+              break;
+            }
+          }
         }
+        next_words[w] = word;
+        awake_count += __builtin_popcountll(word);
       },
-      katana::chunk_size<kChunkSize>(), katana::loopname("BitsetToWl"));
+      katana::steal(), katana::chunk_size<kChunkSize / kBitsPerWord>(),
+      katana::loopname("SyncDO-pull"));
+  return awake_count.reduce();
 }
 
 template <typename T, typename P, typename R>
@@ -216,109 +299,68 @@ AsynchronousAlgo(
   }
 }
 
-template <typename P>
+/// Direction-optimizing BFS (Beamer et al.). The frontier is a queue of
+/// nodes during top-down steps and a bitmap during bottom-up steps, which
+/// scan the in-edges of unvisited nodes instead of the out-edges of the
+/// frontier. Bottom-up steps start when the frontier has more than 1/alpha
+/// of the unexplored edges and stop when it shrinks to fewer than 1/beta of
+/// the nodes.
 void
 SynchronousDirectOpt(
     const BiDirGraphView& bidir_view, katana::NUMAArray<GNode>* node_data,
-    const GNode source, const P& pushWrap, const uint32_t alpha,
-    const uint32_t beta) {
-  using Cont = katana::InsertBag<GNode>;
-  using Loop = katana::DoAll;
-
-  katana::GAccumulator<uint32_t> work_items;
-  katana::StatTimer bitset_to_wl_timer("Bitset_To_WL_Timer");
-  katana::StatTimer wl_to_bitset_timer("WL_To_Bitset_Timer");
-
-  Loop loop;
-
-  katana::DynamicBitset front_bitset;
-  katana::DynamicBitset next_bitset;
+    const GNode source, const uint32_t alpha, const uint32_t beta) {
+  katana::StatTimer bitmap_to_queue_timer("Bitmap_To_Queue_Timer");
+  katana::StatTimer queue_to_bitmap_timer("Queue_To_Bitmap_Timer");
 
   uint32_t num_nodes = bidir_view.NumNodes();
   uint64_t num_edges = bidir_view.NumEdges();
 
-  front_bitset.resize(num_nodes);
-  next_bitset.resize(num_nodes);
+  katana::DynamicBitset front_bitmap;
+  katana::DynamicBitset next_bitmap;
+  front_bitmap.resize(num_nodes);
+  next_bitmap.resize(num_nodes);
 
-  auto frontier = std::make_unique<Cont>();
-  auto next_frontier = std::make_unique<Cont>();
+  std::vector<GNode> frontier{source};
+  FrontierBuffers buffers;
 
   (*node_data)[source] = source;
 
-  pushWrap(*next_frontier, source, "parallel");
-
-  work_items += 1;
-
   int64_t edges_to_check = num_edges;
   int64_t scout_count = bidir_view.OutDegree(source);
-  uint64_t old_num_work_items{0};
-
-  katana::GAccumulator<uint64_t> writes_pull;
-  katana::GAccumulator<uint64_t> writes_push;
+  uint64_t num_top_down_steps = 0;
+  uint64_t num_bottom_up_steps = 0;
 
-  while (!next_frontier->empty()) {
-    std::swap(frontier, next_frontier);
-    next_frontier->clear();
+  while (!frontier.empty()) {
     if (scout_count > edges_to_check / alpha) {
-      wl_to_bitset_timer.start();
-      WlToBitset(*frontier, &front_bitset);
-      wl_to_bitset_timer.stop();
+      queue_to_bitmap_timer.start();
+      QueueToBitmap(frontier, &front_bitmap);
+      queue_to_bitmap_timer.stop();
+
+      uint64_t awake_count = frontier.size();
+      uint64_t old_awake_count = 0;
       do {
-        old_num_work_items = work_items.reduce();
-        work_items.reset();
-
-        loop(
-            katana::iterate(bidir_view),
-            [&](const GNode& dst) {
-              GNode& ddata = (*node_data)[dst];
-              if (ddata == BfsImplementation::kDistanceInfinity) {
-                for (auto e : bidir_view.InEdges(dst)) {
-                  auto src = bidir_view.InEdgeSrc(e);
-
-                  if (front_bitset.test(src)) {
-                    // assign parents on the bfs path.
-                    ddata = src;
-                    next_bitset.set(dst);
-                    work_items += 1;
-                    break;
-                  }
-                }
-              }
-            },
-            katana::steal(), katana::chunk_size<kChunkSize>(),
-            katana::loopname(std::string("SyncDO-pull").c_str()));
-        std::swap(front_bitset, next_bitset);
-        next_bitset.reset();
-      } while (work_items.reduce() >= old_num_work_items ||
-               (work_items.reduce() > num_nodes / beta));
-      bitset_to_wl_timer.start();
-      BitsetToWl(bidir_view, front_bitset, next_frontier.get());
-      bitset_to_wl_timer.stop();
+        old_awake_count = awake_count;
+        awake_count =
+            BottomUpStep(bidir_view, node_data, front_bitmap, &next_bitmap);
+        std::swap(front_bitmap, next_bitmap);
+        ++num_bottom_up_steps;
+      } while (awake_count >= old_awake_count ||
+               awake_count > num_nodes / beta);
+
+      bitmap_to_queue_timer.start();
+      BitmapToQueue(front_bitmap, &frontier);
+      bitmap_to_queue_timer.stop();
       scout_count = 1;
     } else {
       edges_to_check -= scout_count;
-      work_items.reset();
-
-      loop(
-          katana::iterate(*frontier),
-          [&](const GNode& src) {
-            for (auto e : bidir_view.OutEdges(src)) {
-              auto dst = bidir_view.OutEdgeDst(e);
-              GNode& ddata = (*node_data)[dst];
-              if (ddata == BfsImplementation::kDistanceInfinity) {
-                GNode old_parent = ddata;
-                if (__sync_bool_compare_and_swap(&ddata, old_parent, src)) {
-                  next_frontier->push(dst);
-                  work_items += bidir_view.OutDegree(dst);
-                }
-              }
-            }
-          },
-          katana::steal(), katana::chunk_size<kChunkSize>(),
-          katana::loopname(std::string("SyncDO-push").c_str()));
-      scout_count = work_items.reduce();
+      scout_count = TopDownStep(bidir_view, node_data, frontier, &buffers);
+      GatherQueue(&buffers, &frontier);
+      ++num_top_down_steps;
     }
   }
+
+  katana::ReportStatSingle("BFS", "TopDownSteps", num_top_down_steps);
+  katana::ReportStatSingle("BFS", "BottomUpSteps", num_bottom_up_steps);
 }
 
 template <typename NDType, typename ValueTy>
@@ -383,8 +425,7 @@ RunAlgo(
 
     exec_time.start();
     SynchronousDirectOpt(
-        bidir_view, &node_data, source, NodePushWrap(), algo.alpha(),
-        algo.beta());
+        bidir_view, &node_data, source, algo.alpha(), algo.beta());
     exec_time.stop();
 
     UpdateGraphNodeData(graph, node_data);
@@ -665,3 +706,331 @@ void
 katana::analytics::BfsStatistics::Print(std::ostream& os) const {
   os << "Number of reached nodes = " << n_reached_nodes << std::endl;
 }
+
+namespace {
+
+using MultiSourceGraph = katana::PropertyGraphViews::BiDirectional;
+using MultiSourceNode = MultiSourceGraph::Node;
+
+/// One bit per source of a MultiSourceBfs batch
+using LaneMask = uint64_t;
+
+constexpr uint32_t kMultiSourceUnreached = BfsImplementation::kDistanceInfinity;
+
+/// The state of a batch of up to kMultiSourceBfsBatchSize searches that run
+/// together. Bit i of the masks of a node belongs to source base + i.
+struct MultiSourceBatch {
+  const MultiSourceGraph& graph;
+  const std::vector<uint32_t>& sources;
+  size_t base{0};
+  LaneMask all_lanes{0};
+
+  /// Sources that have reached each node
+  katana::NUMAArray<LaneMask> seen;
+  /// Sources whose frontier holds each node
+  katana::NUMAArray<LaneMask> front;
+  /// Sources that reach each node in the current step
+  katana::NUMAArray<LaneMask> next;
+  /// Nodes with a non-zero front mask
+  std::vector<MultiSourceNode> frontier;
+  /// Nodes whose next mask a step made non-zero
+  FrontierBuffers buffers;
+
+  /// Out-edges of the frontier
+  uint64_t frontier_edges{0};
+  /// In-edges of nodes that some source of the batch has not reached
+  uint64_t unexplored_edges{0};
+
+  MultiSourceBatch(
+      const MultiSourceGraph& graph, const std::vector<uint32_t>& sources)
+      : graph(graph), sources(sources) {
+    seen.allocateInterleaved(graph.NumNodes());
+    front.allocateInterleaved(graph.NumNodes());
+    next.allocateInterleaved(graph.NumNodes());
+    // Steps leave front and next clear, so only seen is reset per batch
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const MultiSourceNode& n) {
+          front[n] = 0;
+          next[n] = 0;
+        },
+        katana::no_stats());
+  }
+};
+
+/// Push the masks of the frontier along out-edges. Many frontier nodes may
+/// reach the same node, so next is updated with an atomic OR, and the thread
+/// that makes it non-zero buffers the node.
+void
+MultiSourceTopDownStep(MultiSourceBatch* batch) {
+  const MultiSourceGraph& graph = batch->graph;
+  katana::do_all(
+      katana::iterate(batch->frontier),
+      [&](const MultiSourceNode& src) {
+        LaneMask lanes = batch->front[src];
+        for (auto e : graph.OutEdges(src)) {
+          auto dst = graph.OutEdgeDst(e);
+          LaneMask new_lanes = lanes & ~batch->seen[dst];
+          if (new_lanes & ~batch->next[dst]) {
+            if (__sync_fetch_and_or(&batch->next[dst], new_lanes) == 0) {
+              batch->buffers.getLocal()->emplace_back(dst);
+            }
+          }
+        }
+      },
+      katana::steal(), katana::chunk_size<kChunkSize>(),
+      katana::loopname("MultiSourceBfs-push"));
+}
+
+/// Pull the masks of the frontier along the in-edges of nodes that some
+/// source has not reached, stopping once every such source is found.
+void
+MultiSourceBottomUpStep(MultiSourceBatch* batch) {
+  const MultiSourceGraph& graph = batch->graph;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const MultiSourceNode& dst) {
+        LaneMask unseen = batch->all_lanes & ~batch->seen[dst];
+        if (!unseen) {
+          return;
+        }
+        LaneMask new_lanes = 0;
+        for (auto e : graph.InEdges(dst)) {
+          new_lanes |= batch->front[graph.InEdgeSrc(e)] & unseen;
+          if (new_lanes == unseen) {
+            break;
+          }
+        }
+        if (new_lanes) {
+          batch->next[dst] = new_lanes;
+          batch->buffers.getLocal()->emplace_back(dst);
+        }
+      },
+      katana::steal(), katana::chunk_size<kChunkSize>(),
+      katana::loopname("MultiSourceBfs-pull"));
+}
+
+/// Make the nodes reached in this step the frontier, record their distances
+/// and update the edges that choose the direction of the next step. Only the
+/// previous frontier and the nodes the step buffered are visited.
+void
+MultiSourceAdvance(
+    MultiSourceBatch* batch, uint32_t level, uint32_t* distances) {
+  const MultiSourceGraph& graph = batch->graph;
+  size_t num_sources = batch->sources.size();
+  katana::do_all(
+      katana::iterate(batch->frontier),
+      [&](const MultiSourceNode& n) { batch->front[n] = 0; },
+      katana::no_stats());
+  GatherQueue(&batch->buffers, &batch->frontier);
+
+  katana::GAccumulator<uint64_t> frontier_edges;
+  katana::GAccumulator<uint64_t> explored_edges;
+  katana::do_all(
+      katana::iterate(batch->frontier),
+      [&](const MultiSourceNode& n) {
+        LaneMask new_lanes = batch->next[n];
+        batch->next[n] = 0;
+        batch->front[n] = new_lanes;
+        batch->seen[n] |= new_lanes;
+        frontier_edges += graph.OutDegree(n);
+        if (batch->seen[n] == batch->all_lanes) {
+          explored_edges += graph.InDegree(n);
+        }
+        uint32_t* n_distances = distances + n * num_sources + batch->base;
+        for (LaneMask m = new_lanes; m != 0; m &= m - 1) {
+          n_distances[__builtin_ctzll(m)] = level;
+        }
+      },
+      katana::steal(), katana::chunk_size<kChunkSize>(),
+      katana::loopname("MultiSourceBfs-advance"));
+  batch->frontier_edges = frontier_edges.reduce();
+  batch->unexplored_edges -= explored_edges.reduce();
+}
+
+/// Search from the sources starting at base, up to kMultiSourceBfsBatchSize
+/// of them
+void
+MultiSourceBfsBatch(
+    MultiSourceBatch* batch, size_t base, uint32_t alpha,
+    uint32_t* distances) {
+  const MultiSourceGraph& graph = batch->graph;
+  size_t num_sources = batch->sources.size();
+  size_t num_lanes =
+      std::min(num_sources - base, size_t{kMultiSourceBfsBatchSize});
+  batch->base = base;
+  batch->all_lanes = num_lanes == kMultiSourceBfsBatchSize
+                         ? ~LaneMask{0}
+                         : (LaneMask{1} << num_lanes) - 1;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const MultiSourceNode& n) { batch->seen[n] = 0; },
+      katana::no_stats());
+
+  batch->frontier.clear();
+  batch->frontier_edges = 0;
+  for (size_t i = 0; i < num_lanes; ++i) {
+    MultiSourceNode source = batch->sources[base + i];
+    if (!batch->front[source]) {
+      batch->frontier.emplace_back(source);
+      batch->frontier_edges += graph.OutDegree(source);
+    }
+    batch->seen[source] |= LaneMask{1} << i;
+    batch->front[source] |= LaneMask{1} << i;
+    distances[source * num_sources + base + i] = 0;
+  }
+  batch->unexplored_edges = graph.NumEdges();
+  for (MultiSourceNode source : batch->frontier) {
+    if (batch->seen[source] == batch->all_lanes) {
+      batch->unexplored_edges -= graph.InDegree(source);
+    }
+  }
+
+  for (uint32_t level = 1; !batch->frontier.empty(); ++level) {
+    if (batch->frontier_edges > batch->unexplored_edges / alpha) {
+      MultiSourceBottomUpStep(batch);
+    } else {
+      MultiSourceTopDownStep(batch);
+    }
+    MultiSourceAdvance(batch, level, distances);
+  }
+}
+
+katana::Result<std::shared_ptr<arrow::LargeListArray>>
+GetDistancesProperty(
+    const katana::PropertyGraph* pg, const std::string& name,
+    size_t num_sources) {
+  auto property = KATANA_CHECKED(pg->GetNodeProperty(name));
+  if (property->num_chunks() != 1 ||
+      !property->type()->Equals(arrow::large_list(arrow::uint32()))) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "property {} must be a single chunk of large_list<uint32>", name);
+  }
+  auto distances =
+      std::static_pointer_cast<arrow::LargeListArray>(property->chunk(0));
+  if (distances->null_count() != 0 ||
+      distances->value_offset(pg->NumNodes()) !=
+          static_cast<int64_t>(pg->NumNodes() * num_sources)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "property {} must hold a distance per source for every node", name);
+  }
+  return distances;
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MultiSourceBfs(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    BfsPlan algo) {
+  if (algo.algorithm() != BfsPlan::kSynchronousDirectOpt) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotImplemented, "Unsupported algorithm: {}",
+        algo.algorithm());
+  }
+  if (sources.empty()) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "no source nodes");
+  }
+  uint64_t num_nodes = pg->NumNodes();
+  for (uint32_t source : sources) {
+    if (source >= num_nodes) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "source node {} does not exist",
+          source);
+    }
+  }
+
+  uint64_t num_sources = sources.size();
+  uint64_t num_distances = num_nodes * num_sources;
+
+  katana::ReportPageAllocGuard page_alloc;
+
+  // The distances of each node are contiguous, the layout of a large_list
+  auto offsets_buffer = KATANA_CHECKED(
+      arrow::AllocateBuffer((num_nodes + 1) * sizeof(int64_t)));
+  auto distances_buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_distances * sizeof(uint32_t)));
+  auto* offsets = reinterpret_cast<int64_t*>(offsets_buffer->mutable_data());
+  auto* distances =
+      reinterpret_cast<uint32_t*>(distances_buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes + 1),
+      [&](uint64_t n) { offsets[n] = n * num_sources; }, katana::no_stats());
+  katana::ParallelSTL::fill(
+      distances, distances + num_distances, kMultiSourceUnreached);
+
+  katana::StatTimer exec_time("MultiSourceBfs");
+  exec_time.start();
+
+  MultiSourceGraph graph = pg->BuildView<MultiSourceGraph>();
+  MultiSourceBatch batch(graph, sources);
+  for (size_t base = 0; base < num_sources; base += kMultiSourceBfsBatchSize) {
+    MultiSourceBfsBatch(&batch, base, algo.alpha(), distances);
+  }
+
+  exec_time.stop();
+
+  auto distances_array = std::make_shared<arrow::LargeListArray>(
+      arrow::large_list(arrow::uint32()), num_nodes, std::move(offsets_buffer),
+      std::make_shared<arrow::UInt32Array>(
+          num_distances, std::move(distances_buffer)));
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(
+          output_property_name, arrow::large_list(arrow::uint32()))}),
+      {distances_array});
+  return pg->AddNodeProperties(table, txn_ctx);
+}
+
+katana::Result<void>
+katana::analytics::MultiSourceBfsAssertValid(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& property_name) {
+  size_t num_sources = sources.size();
+  auto distances_list = KATANA_CHECKED(
+      GetDistancesProperty(pg, property_name, num_sources));
+  auto distances =
+      std::static_pointer_cast<arrow::UInt32Array>(distances_list->values());
+  MultiSourceGraph graph = pg->BuildView<MultiSourceGraph>();
+
+  // A node is at distance d > 0 from a source if no in-neighbor is closer
+  // than d - 1 and some in-neighbor is at d - 1
+  auto is_bad = [&](const MultiSourceNode& n) {
+    int64_t n_offset = distances_list->value_offset(n);
+    for (size_t i = 0; i < num_sources; ++i) {
+      uint32_t n_distance = distances->Value(n_offset + i);
+      bool is_source = sources[i] == n;
+      if (is_source != (n_distance == 0)) {
+        return true;
+      }
+      bool found_parent = is_source;
+      for (auto e : graph.InEdges(n)) {
+        auto src = graph.InEdgeSrc(e);
+        uint32_t src_distance =
+            distances->Value(distances_list->value_offset(src) + i);
+        if (src_distance == kMultiSourceUnreached) {
+          continue;
+        }
+        if (n_distance > src_distance + 1) {
+          return true;
+        }
+        found_parent |= n_distance == src_distance + 1;
+      }
+      if (n_distance != kMultiSourceUnreached && !found_parent) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  if (katana::ParallelSTL::find_if(pg->begin(), pg->end(), is_bad) !=
+      pg->end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "found a node whose distance does not follow from its in-neighbors");
+  }
+
+  return katana::ResultSuccess();
+}
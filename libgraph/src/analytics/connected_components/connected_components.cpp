@@ -19,6 +19,8 @@
 
 #include "katana/analytics/connected_components/connected_components.h"
 
+#include <arrow/api.h>
+
 #include "katana/ArrowRandomAccessBuilder.h"
 #include "katana/TypedPropertyGraph.h"
 
@@ -40,6 +42,8 @@ struct ConnectedComponentsNode
       : katana::UnionFindNode<ConnectedComponentsNode>(this) {}
   ConnectedComponentsNode(const ConnectedComponentsNode& o)
       : katana::UnionFindNode<ConnectedComponentsNode>(o.m_component) {}
+  explicit ConnectedComponentsNode(ConnectedComponentsNode* component)
+      : katana::UnionFindNode<ConnectedComponentsNode>(component) {}
 
   ConnectedComponentsNode& operator=(const ConnectedComponentsNode& o) {
     ConnectedComponentsNode c(o);
@@ -1238,6 +1242,104 @@ katana::analytics::ConnectedComponents(
   }
 }
 
+katana::Result<void>
+katana::analytics::ConnectedComponentsIncremental(
+    PropertyGraph* pg, const std::string& previous_property_name,
+    const std::vector<std::pair<uint32_t, uint32_t>>& inserted_edges,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx) {
+  using Graph = katana::PropertyGraphViews::Default;
+  using GNode = Graph::Node;
+
+  for (const auto& [src, dst] : inserted_edges) {
+    if (src >= pg->NumNodes() || dst >= pg->NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "inserted edge ({}, {}) has an endpoint that does not exist", src,
+          dst);
+    }
+  }
+
+  katana::ReportPageAllocGuard page_alloc;
+
+  Graph graph = pg->BuildView<Graph>();
+
+  // The forest lives in an array indexed by node ID, so merge, which links
+  // the larger address below the smaller one, keeps the smallest node ID of
+  // each component as its root. A label array of smallest node IDs is then
+  // a fully compressed forest over the same array.
+  katana::NUMAArray<ConnectedComponentsNode> nodes;
+  nodes.allocateBlocked(graph.NumNodes());
+
+  katana::StatTimer exec_time("ConnectedComponentsIncremental");
+  if (previous_property_name.empty()) {
+    katana::do_all(
+        katana::iterate(graph), [&](const GNode& n) { nodes.constructAt(n); },
+        katana::no_stats());
+
+    exec_time.start();
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& src) {
+          for (auto e : graph.OutEdges(src)) {
+            nodes[src].merge(&nodes[graph.OutEdgeDst(e)]);
+          }
+        },
+        katana::steal(), katana::loopname("MergeGraphEdges"));
+  } else {
+    auto previous = KATANA_CHECKED(
+        pg->GetNodePropertyTyped<uint64_t>(previous_property_name));
+    katana::GReduceLogicalOr invalid;
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          uint64_t label = previous->Value(n);
+          if (label > n || previous->Value(label) != label) {
+            invalid.update(true);
+            label = n;
+          }
+          nodes.constructAt(n, &nodes[label]);
+        },
+        katana::no_stats());
+    if (invalid.reduce()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "property {} does not label each node with the smallest node ID of "
+          "its component",
+          previous_property_name);
+    }
+    exec_time.start();
+  }
+
+  katana::do_all(
+      katana::iterate(inserted_edges),
+      [&](const std::pair<uint32_t, uint32_t>& edge) {
+        nodes[edge.first].merge(&nodes[edge.second]);
+      },
+      katana::loopname("MergeInsertedEdges"));
+
+  katana::do_all(
+      katana::iterate(graph), [&](const GNode& n) { nodes[n].compress(); },
+      katana::loopname("Compress"));
+  exec_time.stop();
+  katana::ReportStatSingle(
+      "ConnectedComponentsIncremental", "InsertedEdges",
+      inserted_edges.size());
+
+  auto labels_buffer = KATANA_CHECKED(
+      arrow::AllocateBuffer(graph.NumNodes() * sizeof(uint64_t)));
+  auto* labels = reinterpret_cast<uint64_t*>(labels_buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) { labels[n] = nodes[n].get() - &nodes[0]; },
+      katana::no_stats());
+
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::uint64())}),
+      {std::make_shared<arrow::UInt64Array>(
+          graph.NumNodes(), std::move(labels_buffer))});
+  return pg->AddNodeProperties(table, txn_ctx);
+}
+
 katana::Result<void>
 katana::analytics::ConnectedComponentsAssertValid(
     PropertyGraph* pg, const std::string& property_name) {
@@ -21,6 +21,7 @@
 
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/SortedIntersection.h"
 #include "katana/analytics/Utils.h"
 
 using namespace katana::analytics;
@@ -44,53 +45,26 @@ public:
       : base_(base), graph_(graph) {}
 
   uint32_t operator()(GNode n2) {
-    uint32_t intersection_size = 0;
-    // Iterate over the edges of both n2 and base in sync, based on the
-    // assumption that edges lists are sorted.
-    auto edges_n2_iter = graph_.OutEdges(n2).begin();
-    auto edges_n2_end = graph_.OutEdges(n2).end();
-    auto edges_base_iter = graph_.OutEdges(base_).begin();
-    auto edges_base_end = graph_.OutEdges(base_).end();
-    while (edges_n2_iter != edges_n2_end && edges_base_iter != edges_base_end) {
-      auto edge_n2_dst = graph_.OutEdgeDst(*edges_n2_iter);
-      auto edge_base_dst = graph_.OutEdgeDst(*edges_base_iter);
-      if (edge_n2_dst == edge_base_dst) {
-        intersection_size++;
-        edges_n2_iter++;
-        edges_base_iter++;
-      } else if (edge_n2_dst > edge_base_dst) {
-        edges_base_iter++;
-      } else if (edge_n2_dst < edge_base_dst) {
-        edges_n2_iter++;
-      }
-    }
-    return intersection_size;
+    return CountIntersection(
+        graph_.OutEdgeDsts(base_), graph_.OutDegree(base_),
+        graph_.OutEdgeDsts(n2), graph_.OutDegree(n2));
   }
 };
 
 struct IntersectWithUnsortedEdgeList {
 private:
-  std::unordered_set<GNode> base_neighbors;
+  NeighborBitmap base_neighbors_;
   const Graph& graph_;
 
 public:
   IntersectWithUnsortedEdgeList(const Graph& graph, GNode base)
-      : graph_(graph) {
-    // Collect all the neighbors of the base node into a hash set.
-    for (const auto& e : graph.OutEdges(base)) {
-      auto dest = graph.OutEdgeDst(e);
-      base_neighbors.emplace(dest);
-    }
+      : base_neighbors_(graph.NumNodes()), graph_(graph) {
+    // Collect all the neighbors of the base node into a bitmap.
+    base_neighbors_.Load(graph.OutEdgeDsts(base), graph.OutDegree(base));
   }
 
   uint32_t operator()(GNode n2) {
-    uint32_t intersection_size = 0;
-    for (const auto& e : graph_.OutEdges(n2)) {
-      auto neighbor = graph_.OutEdgeDst(e);
-      if (base_neighbors.count(neighbor) > 0)
-        intersection_size++;
-    }
-    return intersection_size;
+    return base_neighbors_.Count(graph_.OutEdgeDsts(n2), graph_.OutDegree(n2));
   }
 };
 
@@ -20,6 +20,7 @@
 #include "katana/analytics/k_core/k_core.h"
 
 #include "katana/ArrowRandomAccessBuilder.h"
+#include "katana/Obim.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
 
@@ -266,6 +267,159 @@ katana::analytics::KCore(
   return KCoreMarkAliveNodes(&graph_final, k_core_number);
 }
 
+/*******************************************************************************
+ * Functions for computing the coreness of every node
+ ******************************************************************************/
+struct KCoreNodeCoreness : public katana::PODProperty<uint32_t> {};
+
+struct KCoreNodeDegeneracyRank : public katana::PODProperty<uint32_t> {};
+
+constexpr static const uint32_t kCorenessUnset =
+    std::numeric_limits<uint32_t>::max();
+
+/// A node and its current degree, which is the bucket it is peeled from.
+struct KCorePeelRequest {
+  uint32_t node;
+  uint32_t degree;
+};
+
+struct KCorePeelRequestIndexer {
+  uint32_t operator()(const KCorePeelRequest& req) const { return req.degree; }
+};
+
+/**
+ * Peel nodes in increasing order of degree. The OBIM buckets are the current
+ * degrees, and the barrier between buckets makes every node of bucket k be
+ * peeled before any node of bucket k + 1, so a node's core number is the
+ * bucket it is peeled from. When peeling a node from bucket k drops the
+ * degree of a neighbor to d >= k, the neighbor moves to bucket d; a neighbor
+ * whose degree drops below k is already in bucket k. Requests left behind in
+ * higher buckets are skipped.
+ *
+ * Nodes are ranked in the order in which they are peeled. Every neighbor
+ * ranked after a node was still present when the node was peeled, so each
+ * node has at most degeneracy neighbors ranked after it.
+ *
+ * @param graph Graph to operate on
+ * @param coreness Core number of each node
+ * @param rank Position of each node in the degeneracy order
+ */
+template <typename GraphTy>
+void
+BucketPeelKCore(
+    const GraphTy& graph, katana::NUMAArray<std::atomic<uint32_t>>* coreness,
+    katana::NUMAArray<uint32_t>* rank) {
+  using GNode = typename GraphTy::Node;
+  katana::NUMAArray<std::atomic<uint32_t>> current_degree;
+  current_degree.allocateBlocked(graph.NumNodes());
+
+  katana::InsertBag<KCorePeelRequest> initial_worklist;
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& node) {
+        uint32_t degree = Degree(graph, node);
+        current_degree[node] = degree;
+        (*coreness)[node] = kCorenessUnset;
+        initial_worklist.push(KCorePeelRequest{node, degree});
+      },
+      katana::loopname("CorenessInitialize"), katana::no_stats());
+
+  std::atomic<uint32_t> next_rank = 0;
+  using PSchunk = katana::PerSocketChunkFIFO<KCorePlan::kChunkSize>;
+  using OBIMBarrier = typename katana::OrderedByIntegerMetric<
+      KCorePeelRequestIndexer, PSchunk>::template with_barrier<true>::type;
+  katana::for_each(
+      katana::iterate(initial_worklist),
+      [&](const KCorePeelRequest& req, auto& ctx) {
+        uint32_t unset = kCorenessUnset;
+        if (!(*coreness)[req.node].compare_exchange_strong(
+                unset, req.degree)) {
+          return;
+        }
+        (*rank)[req.node] = next_rank.fetch_add(1);
+
+        for (auto e : Edges(graph, req.node)) {
+          auto dest = EdgeDst(graph, e);
+          if ((*coreness)[dest] != kCorenessUnset) {
+            continue;
+          }
+          uint32_t new_degree = current_degree[dest].fetch_sub(1) - 1;
+          if (new_degree >= req.degree) {
+            ctx.push(KCorePeelRequest{dest, new_degree});
+          }
+        }
+      },
+      katana::disable_conflict_detection(), katana::wl<OBIMBarrier>(),
+      katana::loopname("KCore Bucket Peeling"));
+}
+
+template <typename GraphTy>
+static katana::Result<void>
+KCorenessImpl(
+    const GraphTy& graph, katana::NUMAArray<std::atomic<uint32_t>>* coreness,
+    katana::NUMAArray<uint32_t>* rank) {
+  katana::ReportPageAllocGuard page_alloc;
+
+  coreness->allocateBlocked(graph.NumNodes());
+  rank->allocateBlocked(graph.NumNodes());
+
+  katana::StatTimer exec_time("KCoreness");
+  exec_time.start();
+  BucketPeelKCore(graph, coreness, rank);
+  exec_time.stop();
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::analytics::KCoreness(
+    katana::PropertyGraph* pg, const std::string& output_property_name,
+    const std::string& degeneracy_rank_property_name,
+    katana::TxnContext* txn_ctx, const bool& is_symmetric) {
+  katana::NUMAArray<std::atomic<uint32_t>> coreness;
+  katana::NUMAArray<uint32_t> rank;
+  if (is_symmetric) {
+    auto graph = pg->BuildView<katana::PropertyGraphViews::Default>();
+    KATANA_CHECKED(KCorenessImpl(graph, &coreness, &rank));
+  } else {
+    auto graph = pg->BuildView<katana::PropertyGraphViews::Undirected>();
+    KATANA_CHECKED(KCorenessImpl(graph, &coreness, &rank));
+  }
+
+  KATANA_CHECKED(
+      katana::analytics::ConstructNodeProperties<
+          std::tuple<KCoreNodeCoreness>>(pg, txn_ctx, {output_property_name}));
+  using CorenessGraph =
+      katana::TypedPropertyGraph<std::tuple<KCoreNodeCoreness>, std::tuple<>>;
+  auto coreness_graph =
+      KATANA_CHECKED(CorenessGraph::Make(pg, {output_property_name}, {}));
+  katana::do_all(
+      katana::iterate(coreness_graph),
+      [&](const CorenessGraph::Node& node) {
+        coreness_graph.GetData<KCoreNodeCoreness>(node) = coreness[node];
+      },
+      katana::no_stats());
+
+  if (degeneracy_rank_property_name.empty()) {
+    return katana::ResultSuccess();
+  }
+  KATANA_CHECKED(katana::analytics::ConstructNodeProperties<
+                 std::tuple<KCoreNodeDegeneracyRank>>(
+      pg, txn_ctx, {degeneracy_rank_property_name}));
+  using RankGraph = katana::TypedPropertyGraph<
+      std::tuple<KCoreNodeDegeneracyRank>, std::tuple<>>;
+  auto rank_graph =
+      KATANA_CHECKED(RankGraph::Make(pg, {degeneracy_rank_property_name}, {}));
+  katana::do_all(
+      katana::iterate(rank_graph),
+      [&](const RankGraph::Node& node) {
+        rank_graph.GetData<KCoreNodeDegeneracyRank>(node) = rank[node];
+      },
+      katana::no_stats());
+
+  return katana::ResultSuccess();
+}
+
 // Doxygen doesn't correctly handle implementation annotations that do not
 // appear in the declaration.
 /// \cond DO_NOT_DOCUMENT
@@ -21,6 +21,7 @@
 
 #include "katana/ArrowRandomAccessBuilder.h"
 #include "katana/TypedPropertyGraph.h"
+#include "katana/analytics/SortedIntersection.h"
 
 using namespace katana::analytics;
 
@@ -95,39 +96,24 @@ IsValidDegreeNoLessThanJ(const SortedGraphView& g, GNode n, unsigned int j) {
 bool
 IsSupportNoLessThanJ(
     const SortedGraphView& g, GNode src, GNode dest, unsigned int j) {
-  size_t numValidEqual = 0;
-  auto srcI = g.OutEdges(src).begin(), srcE = g.OutEdges(src).end(),
-       dstI = g.OutEdges(dest).begin(), dstE = g.OutEdges(dest).end();
-
-  while (true) {
-    //! Find the first valid edge.
-    while (srcI != srcE && (g.GetEdgeData<EdgeFlag>(*srcI) & removed)) {
-      ++srcI;
-    }
-    while (dstI != dstE && (g.GetEdgeData<EdgeFlag>(*dstI) & removed)) {
-      ++dstI;
-    }
-
-    if (srcI == srcE || dstI == dstE) {
-      return numValidEqual >= j;
-    }
-
-    //! Check for intersection.
-    auto sN = g.OutEdgeDst(*srcI), dN = g.OutEdgeDst(*dstI);
-    if (sN < dN) {
-      ++srcI;
-    } else if (dN < sN) {
-      ++dstI;
-    } else {
-      numValidEqual += 1;
-      if (numValidEqual >= j) {
-        return true;
-      }
-      ++srcI;
-      ++dstI;
-    }
+  if (j == 0) {
+    return true;
   }
 
+  auto src_edges = *g.OutEdges(src).begin();
+  auto dst_edges = *g.OutEdges(dest).begin();
+  size_t numValidEqual = 0;
+  ForEachIntersection(
+      g.OutEdgeDsts(src), g.OutDegree(src), g.OutEdgeDsts(dest),
+      g.OutDegree(dest), [&](size_t src_i, size_t dst_i) {
+        //! Only count triangles whose edges have not been removed.
+        if (!(g.GetEdgeData<EdgeFlag>(src_edges + src_i) & removed) &&
+            !(g.GetEdgeData<EdgeFlag>(dst_edges + dst_i) & removed)) {
+          numValidEqual += 1;
+        }
+        return numValidEqual < j;
+      });
+
   return numValidEqual >= j;
 }
 
@@ -35,23 +35,29 @@ struct GraphTypes {
       CurrentSubCommunityID, NodeWeight>;
   using EdgeData = std::tuple<EdgeWeight<EdgeWeightType>>;
   using Graph = katana::TypedPropertyGraphView<GraphViewTy, NodeData, EdgeData>;
+
+  using CoarseGraph = ClusteringCoarseGraph<NodeData, EdgeWeightType>;
 };
 
 template <typename EdgeWeightType, typename GraphViewTy>
 struct LeidenClusteringImplementation
     : public katana::analytics::ClusteringImplementationBase<
-          typename GraphTypes<EdgeWeightType, GraphViewTy>::Graph,
+          typename GraphTypes<EdgeWeightType, GraphViewTy>::CoarseGraph,
           EdgeWeightType, LeidenCommunityType<EdgeWeightType>> {
   using NodeData = typename GraphTypes<EdgeWeightType, GraphViewTy>::NodeData;
-  using EdgeData = typename GraphTypes<EdgeWeightType, GraphViewTy>::EdgeData;
   using CommTy = LeidenCommunityType<EdgeWeightType>;
   using CommunityArray = katana::NUMAArray<CommTy>;
 
-  using Graph = typename GraphTypes<EdgeWeightType, GraphViewTy>::Graph;
+  // The input graph is only read to build the first level; every level is
+  // clustered as a CoarseGraph
+  using InputGraph = typename GraphTypes<EdgeWeightType, GraphViewTy>::Graph;
+  using Graph = typename GraphTypes<EdgeWeightType, GraphViewTy>::CoarseGraph;
   using GNode = typename Graph::Node;
 
   using Base = katana::analytics::ClusteringImplementationBase<
       Graph, EdgeWeightType, CommTy>;
+  using InputBase = katana::analytics::ClusteringImplementationBase<
+      InputGraph, EdgeWeightType, CommTy>;
 
   katana::Result<double> LeidenWithoutLockingDoAll(
       Graph* graph, double lower, double modularity_threshold_per_round,
@@ -100,6 +106,9 @@ struct LeidenClusteringImplementation
     }
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
+
+    katana::PerThreadStorage<typename Base::ClusterWeights> cluster_weights;
+
     while (true) {
       num_iter++;
 
@@ -114,21 +123,16 @@ struct LeidenClusteringImplementation
 
             uint64_t degree = Degree(*graph, n);
             uint64_t local_target = Base::UNASSIGNED;
-            std::map<uint64_t, uint64_t>
-                cluster_local_map;  // Map each neighbor's cluster to local number:
-                                    // Community --> Index
-            std::vector<EdgeWeightType>
-                counter;  // Number of edges to each unique cluster
             EdgeWeightType self_loop_wt = 0;
 
             if (degree > 0) {
+              auto& local_weights = *cluster_weights.getLocal();
               Base::template FindNeighboringClusters<EdgeWeightType>(
-                  *graph, n, cluster_local_map, counter, self_loop_wt);
+                  *graph, n, &local_weights, self_loop_wt);
               // Find the max gain in modularity
               local_target = Base::MaxModularityWithoutSwaps(
-                  cluster_local_map, counter, self_loop_wt, c_info,
-                  n_data_node_wt, n_data_curr_comm_id,
-                  constant_for_second_term);
+                  local_weights, self_loop_wt, c_info, n_data_node_wt,
+                  n_data_curr_comm_id, constant_for_second_term);
             } else {
               local_target = Base::UNASSIGNED;
             }
@@ -258,6 +262,8 @@ struct LeidenClusteringImplementation
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
 
+    katana::PerThreadStorage<typename Base::ClusterWeights> cluster_weights;
+
     while (true) {
       num_iter++;
 
@@ -275,21 +281,16 @@ struct LeidenClusteringImplementation
 
               uint64_t degree = Degree(*graph, n);
 
-              std::map<uint64_t, uint64_t>
-                  cluster_local_map;  // Map each neighbor's cluster to local number:
-                                      // Community --> Index
-              std::vector<EdgeWeightType>
-                  counter;  // Number of edges to each unique cluster
               EdgeWeightType self_loop_wt = 0;
 
               if (degree > 0) {
+                auto& local_weights = *cluster_weights.getLocal();
                 Base::template FindNeighboringClusters<EdgeWeightType>(
-                    *graph, n, cluster_local_map, counter, self_loop_wt);
+                    *graph, n, &local_weights, self_loop_wt);
                 // Find the max gain in modularity
                 local_target[n] = Base::MaxModularityWithoutSwaps(
-                    cluster_local_map, counter, self_loop_wt, c_info,
-                    n_data_degree_wt, n_data_curr_comm_id,
-                    constant_for_second_term);
+                    local_weights, self_loop_wt, c_info, n_data_degree_wt,
+                    n_data_curr_comm_id, constant_for_second_term);
 
               } else {
                 local_target[n] = 0;
@@ -387,77 +388,25 @@ public:
   katana::Result<void> LeidenClustering(
       katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
       const std::vector<std::string>& temp_node_property_names,
-      katana::NUMAArray<uint64_t>& clusters_orig, LeidenClusteringPlan plan,
-      katana::TxnContext* txn_ctx) {
+      katana::NUMAArray<uint64_t>& clusters_orig, LeidenClusteringPlan plan) {
     katana::StatTimer TimerTotal("Timer_Leiden_Total");
     TimerTotal.start();
-    TemporaryPropertyGuard temp_edge_property{pg->EdgeMutablePropertyView()};
-    std::vector<std::string> temp_edge_property_names = {
-        temp_edge_property.name()};
 
-    /*
-     * Construct temp property graph. This graph gets coarsened as the
-     * computation proceeds.
-     */
-    std::unique_ptr<katana::PropertyGraph> pg_mutable;
-
-    Graph graph_curr = KATANA_CHECKED(
-        Graph::Make(pg, temp_node_property_names, {edge_weight_property_name}));
+    InputGraph graph_input = KATANA_CHECKED(InputGraph::Make(
+        pg, temp_node_property_names, {edge_weight_property_name}));
 
     /*
-    * Vertex following optimization
-    */
-    if (plan.enable_vf()) {
-      Base::VertexFollowing(&graph_curr);  // Find nodes that follow other nodes
-
-      uint64_t num_unique_clusters =
-          Base::template RenumberClustersContiguously<CurrentCommunityID>(
-              &graph_curr);
-
-      /*
-     * Initialize node cluster id.
+     * Construct the first level. It gets coarsened as the computation
+     * proceeds.
      */
-      katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
-        clusters_orig[n] = graph_curr.template GetData<CurrentCommunityID>(n);
-      });
-
-      auto pg_empty = std::make_unique<katana::PropertyGraph>();
-
-      // Build new graph to remove the isolated nodes
-      auto coarsened_graph_result = Base::template GraphCoarsening<
-          NodeData, EdgeData, EdgeWeightType, CurrentCommunityID>(
-          graph_curr, pg_empty.get(), num_unique_clusters,
-          temp_node_property_names, temp_edge_property_names, txn_ctx);
-      if (!coarsened_graph_result) {
-        return coarsened_graph_result.error();
-      }
-
-      pg_mutable = std::move(coarsened_graph_result.value());
-
-    } else {
-      /*
-       * Initialize node cluster id.
-       */
-      katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
-        clusters_orig[n] = Base::UNASSIGNED;
-      });
-
-      auto pg_dup = KATANA_CHECKED(Base::DuplicateGraphWithSameTopo(*pg));
-      KATANA_CHECKED(Base::CopyEdgeProperty(
-          pg, pg_dup.get(), edge_weight_property_name,
-          temp_edge_property_names[0], txn_ctx));
-      KATANA_CHECKED(ConstructNodeProperties<NodeData>(pg_dup.get(), txn_ctx));
-
-      pg_mutable = std::move(pg_dup);
-    }
-
-    KATANA_LOG_ASSERT(pg_mutable);
+    Graph graph_curr =
+        InputBase::template MakeFirstLevel<EdgeWeightType, Graph>(
+            &graph_input, plan.enable_vf(), &clusters_orig);
 
     double prev_mod = -1;  // Previous modularity
     double curr_mod = -1;  // Current modularity
     uint32_t phase = 0;
 
-    std::unique_ptr<katana::PropertyGraph> pg_curr = std::move(pg_mutable);
     uint32_t iter = 0;
     uint64_t num_nodes_orig = clusters_orig.size();
 
@@ -465,8 +414,6 @@ public:
       iter++;
       phase++;
 
-      graph_curr = KATANA_CHECKED(Graph::Make(pg_curr.get()));
-
       if (iter == 1) {
         /* Initialization each node to its own cluster */
         katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
@@ -556,25 +503,19 @@ public:
           katana::atomicAdd(cluster_node_wt[n_curr_sub_comm], n_node_wt);
         });
 
-        auto coarsened_graph_result = Base::template GraphCoarsening<
-            NodeData, EdgeData, EdgeWeightType, CurrentSubCommunityID>(
-            graph_curr, pg_curr.get(), num_unique_subclusters,
-            temp_node_property_names, temp_edge_property_names, txn_ctx);
-        if (!coarsened_graph_result) {
-          return coarsened_graph_result.error();
-        }
-        pg_curr = std::move(coarsened_graph_result.value());
+        graph_curr = Base::template GraphCoarsening<
+            EdgeWeightType, CurrentSubCommunityID, Graph>(
+            graph_curr, num_unique_subclusters);
 
         prev_mod = curr_mod;
 
         /**
        * Assign cluster id from previous iteration
        */
-        Graph graph_curr_tmp = KATANA_CHECKED(Graph::Make(pg_curr.get()));
-        katana::do_all(katana::iterate(graph_curr_tmp), [&](GNode n) {
-          graph_curr_tmp.template GetData<CurrentCommunityID>(n) =
+        katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
+          graph_curr.template GetData<CurrentCommunityID>(n) =
               original_comm_ass[n];
-          graph_curr_tmp.template GetData<NodeWeight>(n) = cluster_node_wt[n];
+          graph_curr.template GetData<NodeWeight>(n) = cluster_node_wt[n];
         });
 
         original_comm_ass.deallocate();
@@ -594,22 +535,18 @@ public:
             &graph_curr);
 
     katana::do_all(katana::iterate((uint64_t)0, num_nodes_orig), [&](GNode n) {
-      clusters_orig[n] =
-          graph_curr.template GetData<CurrentCommunityID>(clusters_orig[n]);
+      if (clusters_orig[n] != Base::UNASSIGNED) {
+        clusters_orig[n] =
+            graph_curr.template GetData<CurrentCommunityID>(clusters_orig[n]);
+      }
     });
 
-    auto coarsened_graph_result = Base::template GraphCoarsening<
-        NodeData, EdgeData, EdgeWeightType, CurrentCommunityID>(
-        graph_curr, pg_curr.get(), num_unique_clusters,
-        temp_node_property_names, temp_edge_property_names, txn_ctx);
-    if (!coarsened_graph_result) {
-      return coarsened_graph_result.error();
-    }
-    pg_curr = std::move(coarsened_graph_result.value());
+    Graph graph_curr_tmp = Base::template GraphCoarsening<
+        EdgeWeightType, CurrentCommunityID, Graph>(
+        graph_curr, num_unique_clusters);
 
     prev_mod = curr_mod;
 
-    Graph graph_curr_tmp = KATANA_CHECKED(Graph::Make(pg_curr.get()));
     katana::do_all(katana::iterate(graph_curr_tmp), [&](GNode n) {
       graph_curr_tmp.template GetData<CurrentCommunityID>(n) = n;
     });
@@ -619,8 +556,10 @@ public:
         plan.resolution()));
 
     katana::do_all(katana::iterate((uint64_t)0, num_nodes_orig), [&](GNode n) {
-      clusters_orig[n] =
-          graph_curr_tmp.template GetData<CurrentCommunityID>(clusters_orig[n]);
+      if (clusters_orig[n] != Base::UNASSIGNED) {
+        clusters_orig[n] = graph_curr_tmp.template GetData<CurrentCommunityID>(
+            clusters_orig[n]);
+      }
     });
 
     TimerTotal.stop();
@@ -690,7 +629,7 @@ LeidenClusteringWithWrap(
         impl{};
     KATANA_CHECKED(impl.LeidenClustering(
         pg, edge_weight_property_name, temp_node_property_names, clusters_orig,
-        plan, txn_ctx));
+        plan));
   } else {
     using Impl = LeidenClusteringImplementation<
         EdgeWeightType, katana::PropertyGraphViews::Undirected>;
@@ -702,7 +641,7 @@ LeidenClusteringWithWrap(
         impl{};
     KATANA_CHECKED(impl.LeidenClustering(
         pg, edge_weight_property_name, temp_node_property_names, clusters_orig,
-        plan, txn_ctx));
+        plan));
   }
 
   KATANA_CHECKED(ConstructNodeProperties<std::tuple<CurrentCommunityID>>(
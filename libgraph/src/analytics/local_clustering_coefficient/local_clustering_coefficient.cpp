@@ -20,6 +20,7 @@
 #include "katana/analytics/local_clustering_coefficient/local_clustering_coefficient.h"
 
 #include "katana/AtomicHelpers.h"
+#include "katana/analytics/SortedIntersection.h"
 
 using namespace katana::analytics;
 
@@ -49,27 +50,22 @@ struct LocalClusteringCoefficientAtomics {
   void OrderedCountFunc(
       const SortedGraphView& graph, Node n, CountVec* count_vec) {
     // TODO(amber): replace with NodeIteratingAlgo for triangle counting
-    for (auto edges_n : graph.OutEdges(n)) {
-      auto v = graph.OutEdgeDst(edges_n);
-      if (v > n) {
-        break;
-      }
-      auto e_it_n = graph.OutEdges(n).begin();
-
-      for (auto edges_v : graph.OutEdges(v)) {
-        auto dst_v = graph.OutEdgeDst(edges_v);
-        if (dst_v > v) {
-          break;
-        }
-        while (graph.OutEdgeDst(*e_it_n) < dst_v) {
-          e_it_n++;
-        }
-        if (dst_v == graph.OutEdgeDst(*e_it_n)) {
-          __sync_fetch_and_add(&(*count_vec)[n], uint32_t{1});
-          __sync_fetch_and_add(&(*count_vec)[v], uint32_t{1});
-          __sync_fetch_and_add(&(*count_vec)[dst_v], uint32_t{1});
-        }
-      }
+    const Node* n_dsts = graph.OutEdgeDsts(n);
+    const Node* n_end = n_dsts + graph.OutDegree(n);
+    for (const Node* it = n_dsts; it != n_end && *it <= n; ++it) {
+      Node v = *it;
+      const Node* v_dsts = graph.OutEdgeDsts(v);
+      const Node* v_end =
+          std::upper_bound(v_dsts, v_dsts + graph.OutDegree(v), v);
+      ForEachIntersection(
+          n_dsts, it - n_dsts + 1, v_dsts, v_end - v_dsts,
+          [&](size_t i, size_t) {
+            Node dst_v = n_dsts[i];
+            __sync_fetch_and_add(&(*count_vec)[n], uint32_t{1});
+            __sync_fetch_and_add(&(*count_vec)[v], uint32_t{1});
+            __sync_fetch_and_add(&(*count_vec)[dst_v], uint32_t{1});
+            return true;
+          });
     }
   }
 
@@ -134,27 +130,22 @@ struct LocalClusteringCoefficientPerThread {
   void OrderedCountFunc(
       const SortedGraphView& graph, Node n, IterPair per_thread_count_range) {
     // TODO(amber): replace with NodeIteratingAlgo for triangle counting
-    for (auto edges_n : graph.OutEdges(n)) {
-      auto v = graph.OutEdgeDst(edges_n);
-      if (v > n) {
-        break;
-      }
-      auto e_it_n = graph.OutEdges(n).begin();
-
-      for (auto edges_v : graph.OutEdges(v)) {
-        auto dst_v = graph.OutEdgeDst(edges_v);
-        if (dst_v > v) {
-          break;
-        }
-        while (graph.OutEdgeDst(*e_it_n) < dst_v) {
-          e_it_n++;
-        }
-        if (dst_v == graph.OutEdgeDst(*e_it_n)) {
-          *(per_thread_count_range.first + n) += 1;
-          *(per_thread_count_range.first + v) += 1;
-          *(per_thread_count_range.first + dst_v) += 1;
-        }
-      }
+    const Node* n_dsts = graph.OutEdgeDsts(n);
+    const Node* n_end = n_dsts + graph.OutDegree(n);
+    for (const Node* it = n_dsts; it != n_end && *it <= n; ++it) {
+      Node v = *it;
+      const Node* v_dsts = graph.OutEdgeDsts(v);
+      const Node* v_end =
+          std::upper_bound(v_dsts, v_dsts + graph.OutDegree(v), v);
+      ForEachIntersection(
+          n_dsts, it - n_dsts + 1, v_dsts, v_end - v_dsts,
+          [&](size_t i, size_t) {
+            Node dst_v = n_dsts[i];
+            *(per_thread_count_range.first + n) += 1;
+            *(per_thread_count_range.first + v) += 1;
+            *(per_thread_count_range.first + dst_v) += 1;
+            return true;
+          });
     }
   }
 
@@ -37,23 +37,29 @@ struct GraphTypes {
   using EdgeData = std::tuple<EdgeWeight<EdgeWeightType>>;
 
   using Graph = katana::TypedPropertyGraphView<GraphViewTy, NodeData, EdgeData>;
+
+  using CoarseGraph = ClusteringCoarseGraph<NodeData, EdgeWeightType>;
 };
 
 template <typename EdgeWeightType, typename GraphViewTy>
 struct LouvainClusteringImplementation
     : public katana::analytics::ClusteringImplementationBase<
-          typename GraphTypes<EdgeWeightType, GraphViewTy>::Graph,
+          typename GraphTypes<EdgeWeightType, GraphViewTy>::CoarseGraph,
           EdgeWeightType, CommunityType<EdgeWeightType>> {
   using CommTy = CommunityType<EdgeWeightType>;
   using CommunityArray = katana::NUMAArray<CommTy>;
 
-  using Graph = typename GraphTypes<EdgeWeightType, GraphViewTy>::Graph;
+  // The input graph is only read to build the first level; every level is
+  // clustered as a CoarseGraph
+  using InputGraph = typename GraphTypes<EdgeWeightType, GraphViewTy>::Graph;
+  using Graph = typename GraphTypes<EdgeWeightType, GraphViewTy>::CoarseGraph;
   using NodeData = typename GraphTypes<EdgeWeightType, GraphViewTy>::NodeData;
-  using EdgeData = typename GraphTypes<EdgeWeightType, GraphViewTy>::EdgeData;
   using GNode = typename Graph::Node;
 
   using Base = katana::analytics::ClusteringImplementationBase<
       Graph, EdgeWeightType, CommTy>;
+  using InputBase = katana::analytics::ClusteringImplementationBase<
+      InputGraph, EdgeWeightType, CommTy>;
 
   katana::Result<double> LouvainWithoutLockingDoAll(
       Graph* graph, double lower, double modularity_threshold_per_round,
@@ -92,6 +98,9 @@ struct LouvainClusteringImplementation
 
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
+
+    katana::PerThreadStorage<typename Base::ClusterWeights> cluster_weights;
+
     while (true) {
       num_iter++;
 
@@ -110,22 +119,16 @@ struct LouvainClusteringImplementation
 
             uint64_t degree = Degree(*graph, n);
             uint64_t local_target = Base::UNASSIGNED;
-            // TODO(amber): use scalable allocator with these containers
-            std::map<uint64_t, uint64_t>
-                cluster_local_map;  // Map each neighbor's cluster to local number:
-                                    // Community --> Index
-            std::vector<EdgeWeightType>
-                counter;  // Number of edges to each unique cluster
             EdgeWeightType self_loop_wt = 0;
 
             if (degree > 0) {
+              auto& local_weights = *cluster_weights.getLocal();
               Base::template FindNeighboringClusters<EdgeWeightType>(
-                  *graph, n, cluster_local_map, counter, self_loop_wt);
+                  *graph, n, &local_weights, self_loop_wt);
               // Find the max gain in modularity
               local_target = Base::MaxModularityWithoutSwaps(
-                  cluster_local_map, counter, self_loop_wt, c_info,
-                  n_data_degree_wt, n_data_curr_comm_id,
-                  constant_for_second_term);
+                  local_weights, self_loop_wt, c_info, n_data_degree_wt,
+                  n_data_curr_comm_id, constant_for_second_term);
 
             } else {
               local_target = Base::UNASSIGNED;
@@ -245,6 +248,8 @@ struct LouvainClusteringImplementation
     katana::StatTimer TimerClusteringWhile("Timer_Clustering_While");
     TimerClusteringWhile.start();
 
+    katana::PerThreadStorage<typename Base::ClusterWeights> cluster_weights;
+
     while (true) {
       num_iter++;
 
@@ -261,22 +266,16 @@ struct LouvainClusteringImplementation
 
               uint64_t degree = Degree(*graph, n);
 
-              // TODO(amber): use scalable allocators
-              std::map<uint64_t, uint64_t>
-                  cluster_local_map;  // Map each neighbor's cluster to local number:
-                                      // Community --> Index
-              std::vector<EdgeWeightType>
-                  counter;  // Number of edges to each unique cluster
               EdgeWeightType self_loop_wt = 0;
 
               if (degree > 0) {
+                auto& local_weights = *cluster_weights.getLocal();
                 Base::template FindNeighboringClusters<EdgeWeightType>(
-                    *graph, n, cluster_local_map, counter, self_loop_wt);
+                    *graph, n, &local_weights, self_loop_wt);
                 // Find the max gain in modularity
                 local_target[n] = Base::MaxModularityWithoutSwaps(
-                    cluster_local_map, counter, self_loop_wt, c_info,
-                    n_data_degree_wt, n_data_curr_comm_id,
-                    constant_for_second_term);
+                    local_weights, self_loop_wt, c_info, n_data_degree_wt,
+                    n_data_curr_comm_id, constant_for_second_term);
 
               } else {
                 local_target[n] = Base::UNASSIGNED;
@@ -359,82 +358,28 @@ public:
   katana::Result<void> LouvainClustering(
       katana::PropertyGraph* pg, const std::string& edge_weight_property_name,
       const std::vector<std::string>& temp_node_property_names,
-      katana::NUMAArray<uint64_t>& clusters_orig, LouvainClusteringPlan plan,
-      katana::TxnContext* txn_ctx) {
-    TemporaryPropertyGuard temp_edge_property{pg->EdgeMutablePropertyView()};
-    std::vector<std::string> temp_edge_property_names = {
-        temp_edge_property.name()};
+      katana::NUMAArray<uint64_t>& clusters_orig, LouvainClusteringPlan plan) {
+    InputGraph graph_input = KATANA_CHECKED(InputGraph::Make(
+        pg, temp_node_property_names, {edge_weight_property_name}));
 
     /*
-     * Construct temp property graph. This graph gets coarsened as the
-     * computation proceeds.
-     */
-    std::unique_ptr<katana::PropertyGraph> pg_mutable;
-
-    Graph graph_curr = KATANA_CHECKED(
-        Graph::Make(pg, temp_node_property_names, {edge_weight_property_name}));
-
-    /*
-    * Vertex following optimization
-    */
-    if (plan.enable_vf()) {
-      Base::VertexFollowing(&graph_curr);  // Find nodes that follow other nodes
-
-      uint64_t num_unique_clusters =
-          Base::template RenumberClustersContiguously<CurrentCommunityID>(
-              &graph_curr);
-
-      /*
-     * Initialize node cluster id.
+     * Construct the first level. It gets coarsened as the computation
+     * proceeds.
      */
-      katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
-        clusters_orig[n] = graph_curr.template GetData<CurrentCommunityID>(n);
-      });
-
-      auto pg_empty = std::make_unique<katana::PropertyGraph>();
-
-      // Build new graph to remove the isolated nodes
-      auto coarsened_graph_result = Base::template GraphCoarsening<
-          NodeData, EdgeData, EdgeWeightType, CurrentCommunityID>(
-          graph_curr, pg_empty.get(), num_unique_clusters,
-          temp_node_property_names, temp_edge_property_names, txn_ctx);
-      if (!coarsened_graph_result) {
-        return coarsened_graph_result.error();
-      }
-
-      pg_mutable = std::move(coarsened_graph_result.value());
-
-    } else {
-      /*
-       * Initialize node cluster id.
-       */
-      katana::do_all(katana::iterate(graph_curr), [&](GNode n) {
-        clusters_orig[n] = Base::UNASSIGNED;
-      });
-
-      auto pg_dup = KATANA_CHECKED(Base::DuplicateGraphWithSameTopo(*pg));
-      KATANA_CHECKED(Base::CopyEdgeProperty(
-          pg, pg_dup.get(), edge_weight_property_name,
-          temp_edge_property_names[0], txn_ctx));
-      KATANA_CHECKED(ConstructNodeProperties<NodeData>(pg_dup.get(), txn_ctx));
-
-      pg_mutable = std::move(pg_dup);
-    }
-
-    KATANA_LOG_ASSERT(pg_mutable);
+    Graph graph_curr =
+        InputBase::template MakeFirstLevel<EdgeWeightType, Graph>(
+            &graph_input, plan.enable_vf(), &clusters_orig);
 
     double prev_mod = -1;  // Previous modularity
     double curr_mod = -1;  // Current modularity
     uint32_t phase = 0;
 
-    std::unique_ptr<katana::PropertyGraph> pg_curr = std::move(pg_mutable);
     uint32_t iter = 0;
     uint64_t num_nodes_orig = clusters_orig.size();
     while (true) {
       iter++;
       phase++;
 
-      Graph graph_curr = KATANA_CHECKED(Graph::Make(pg_curr.get()));
       if (graph_curr.NumNodes() > plan.min_graph_size()) {
         switch (plan.algorithm()) {
         case LouvainClusteringPlan::kDoAll: {
@@ -482,15 +427,9 @@ public:
               });
         }
 
-        auto coarsened_graph_result = Base::template GraphCoarsening<
-            NodeData, EdgeData, EdgeWeightType, CurrentCommunityID>(
-            graph_curr, pg_curr.get(), num_unique_clusters,
-            temp_node_property_names, temp_edge_property_names, txn_ctx);
-        if (!coarsened_graph_result) {
-          return coarsened_graph_result.error();
-        }
-
-        pg_curr = std::move(coarsened_graph_result.value());
+        graph_curr = Base::template GraphCoarsening<
+            EdgeWeightType, CurrentCommunityID, Graph>(
+            graph_curr, num_unique_clusters);
 
         prev_mod = curr_mod;
       } else {
@@ -561,7 +500,7 @@ LouvainClusteringWithWrap(
     LouvainClusteringImplementation<EdgeWeightType, GraphViewTy> impl{};
     KATANA_CHECKED(impl.LouvainClustering(
         pg, edge_weight_property_name, temp_node_property_names, clusters_orig,
-        plan, txn_ctx));
+        plan));
   } else {
     using GraphViewTy = katana::PropertyGraphViews::Undirected;
     using Impl = LouvainClusteringImplementation<EdgeWeightType, GraphViewTy>;
@@ -571,7 +510,7 @@ LouvainClusteringWithWrap(
     LouvainClusteringImplementation<EdgeWeightType, GraphViewTy> impl{};
     KATANA_CHECKED(impl.LouvainClustering(
         pg, edge_weight_property_name, temp_node_property_names, clusters_orig,
-        plan, txn_ctx));
+        plan));
   }
 
   KATANA_CHECKED(ConstructNodeProperties<std::tuple<CurrentCommunityID>>(
@@ -21,6 +21,7 @@
 #define KATANA_LIBGRAPH_ANALYTICS_PAGERANK_PAGERANKIMPL_H_
 
 #include <iostream>
+#include <vector>
 
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
@@ -49,4 +50,22 @@ katana::Result<void> PagerankPushSynchronous(
     katana::PropertyGraph* pg, const std::string& output_property_name,
     katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx);
 
+katana::Result<void> PagerankPushIncremental(
+    katana::PropertyGraph* pg, const std::string& previous_property_name,
+    const std::vector<uint32_t>& changed_nodes,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx);
+
+katana::Result<std::vector<katana::analytics::PersonalizedPagerankTopK>>
+PersonalizedPagerankForwardPush(
+    katana::PropertyGraph* pg,
+    const std::vector<std::vector<uint32_t>>& seed_sets, uint32_t k,
+    katana::analytics::PersonalizedPagerankPlan plan);
+
+katana::Result<std::vector<katana::analytics::PersonalizedPagerankTopK>>
+PersonalizedPagerankMonteCarlo(
+    katana::PropertyGraph* pg,
+    const std::vector<std::vector<uint32_t>>& seed_sets, uint32_t k,
+    katana::analytics::PersonalizedPagerankPlan plan);
+
 #endif
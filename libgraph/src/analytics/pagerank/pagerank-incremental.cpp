@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <cmath>
+
+#include <arrow/api.h>
+
+#include "katana/AtomicHelpers.h"
+#include "katana/Bag.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Statistics.h"
+#include "pagerank-impl.h"
+
+using katana::atomicAdd;
+
+namespace {
+
+using Graph = katana::PropertyGraphViews::BiDirectional;
+using GNode = Graph::Node;
+
+using AtomicArray = katana::NUMAArray<std::atomic<PRTy>>;
+
+/// Find the nodes whose residual may no longer be near zero: the changed
+/// nodes and the out-neighbors of the changed nodes, whose share of the
+/// rank of a changed node depends on its out-degree. The nodes are gathered
+/// per thread and deduplicated afterwards, so this takes time in the number
+/// of affected edges rather than the size of the graph.
+std::vector<GNode>
+AffectedNodes(const Graph& graph, const std::vector<uint32_t>& changed_nodes) {
+  katana::InsertBag<GNode> affected;
+  katana::do_all(
+      katana::iterate(changed_nodes.begin(), changed_nodes.end()),
+      [&](const GNode& n) {
+        affected.push(n);
+        for (auto e : graph.OutEdges(n)) {
+          affected.push(graph.OutEdgeDst(e));
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  std::vector<GNode> nodes(affected.begin(), affected.end());
+  katana::ParallelSTL::sort(nodes.begin(), nodes.end());
+  nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+  return nodes;
+}
+
+}  // namespace
+
+katana::Result<void>
+PagerankPushIncremental(
+    katana::PropertyGraph* pg, const std::string& previous_property_name,
+    const std::vector<uint32_t>& changed_nodes,
+    const std::string& output_property_name,
+    katana::analytics::PagerankPlan plan, katana::TxnContext* txn_ctx) {
+  for (uint32_t n : changed_nodes) {
+    if (n >= pg->NumNodes()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "changed node {} does not exist",
+          n);
+    }
+  }
+  auto previous =
+      KATANA_CHECKED(pg->GetNodePropertyTyped<PRTy>(previous_property_name));
+
+  katana::ReportPageAllocGuard page_alloc;
+
+  Graph graph = pg->BuildView<Graph>();
+
+  // Every node needs its previous rank and a zero residual, and the output
+  // holds a rank for every node, so this pass and the copy to the output are
+  // linear in the number of nodes. Neither reads any edges.
+  AtomicArray value;
+  AtomicArray residual;
+  value.allocateInterleaved(graph.NumNodes());
+  residual.allocateInterleaved(graph.NumNodes());
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const GNode& n) {
+        value[n] = previous->Value(n);
+        residual[n] = 0;
+      },
+      katana::no_stats());
+
+  katana::StatTimer exec_time("PagerankIncremental");
+  exec_time.start();
+
+  // The previous ranks have a residual below the tolerance everywhere except
+  // at the affected nodes, where the residual is recomputed from the
+  // in-neighbors: the push algorithms keep residual = (1 - alpha) +
+  // alpha * (sum of in-neighbor value / out-degree) - value.
+  std::vector<GNode> affected = AffectedNodes(graph, changed_nodes);
+  katana::do_all(
+      katana::iterate(affected),
+      [&](const GNode& dst) {
+        PRTy sum = 0;
+        for (auto e : graph.InEdges(dst)) {
+          auto src = graph.InEdgeSrc(e);
+          sum += value[src] / graph.OutDegree(src);
+        }
+        residual[dst] =
+            plan.initial_residual() + plan.alpha() * sum - value[dst];
+      },
+      katana::steal(), katana::loopname("ResidualIncremental"));
+
+  // Residuals of changed nodes may be negative, so nodes are processed while
+  // the magnitude of their residual is above the tolerance
+  using WL = katana::PerSocketChunkFIFO<
+      katana::analytics::PagerankPlan::kChunkSize>;
+  katana::for_each(
+      katana::iterate(affected),
+      [&](const GNode& src, auto& ctx) {
+        auto& src_residual = residual[src];
+        if (std::fabs(src_residual.load()) <= plan.tolerance()) {
+          return;
+        }
+        PRTy old_residual = src_residual.exchange(0.0);
+        atomicAdd(value[src], old_residual);
+        auto src_nout = graph.OutDegree(src);
+        if (src_nout == 0) {
+          return;
+        }
+        PRTy delta = old_residual * plan.alpha() / src_nout;
+        for (auto e : graph.OutEdges(src)) {
+          auto dst = graph.OutEdgeDst(e);
+          PRTy old = atomicAdd(residual[dst], delta);
+          if (std::fabs(old) <= plan.tolerance() &&
+              std::fabs(old + delta) > plan.tolerance()) {
+            ctx.push(dst);
+          }
+        }
+      },
+      katana::loopname("PushResidualIncremental"),
+      katana::disable_conflict_detection(), katana::wl<WL>());
+
+  exec_time.stop();
+  katana::ReportStatSingle(
+      "PagerankIncremental", "AffectedNodes", affected.size());
+
+  auto values_buffer = KATANA_CHECKED(
+      arrow::AllocateBuffer(graph.NumNodes() * sizeof(PRTy)));
+  auto* values = reinterpret_cast<PRTy*>(values_buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(graph), [&](const GNode& n) { values[n] = value[n]; },
+      katana::no_stats());
+
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(output_property_name, arrow::float32())}),
+      {std::make_shared<arrow::FloatArray>(
+          graph.NumNodes(), std::move(values_buffer))});
+  return pg->AddNodeProperties(table, txn_ctx);
+}
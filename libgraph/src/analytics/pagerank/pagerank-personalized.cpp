@@ -0,0 +1,348 @@
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#include "katana/DynamicBitset.h"
+#include "katana/Statistics.h"
+#include "katana/analytics/random_walks/random_walks.h"
+#include "pagerank-impl.h"
+
+namespace {
+
+using Graph = katana::PropertyGraphViews::BiDirectional;
+using GNode = Graph::Node;
+
+using katana::analytics::PersonalizedPagerankPlan;
+using katana::analytics::PersonalizedPagerankTopK;
+
+constexpr size_t kLanes = katana::analytics::kPersonalizedPagerankBatchSize;
+constexpr uint32_t kNotPushed = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t kLostWalk = std::numeric_limits<uint32_t>::max();
+
+/// One value per seed set of a batch. Rows have a fixed width, and lanes
+/// past the end of the batch stay 0, so loops over the lanes vectorize.
+struct alignas(64) Row {
+  PRTy lanes[kLanes];
+};
+
+using TopKLanes = std::array<PersonalizedPagerankTopK, kLanes>;
+
+/// Whether a ranks before b: higher ranks first, then lower node IDs
+bool
+RanksBefore(
+    const std::pair<uint32_t, float>& a, const std::pair<uint32_t, float>& b) {
+  return a.second > b.second || (a.second == b.second && a.first < b.first);
+}
+
+/// Add node to heap, a heap of at most k nodes with the node that ranks last
+/// at its front, if it ranks before one of them
+void
+OfferTopK(
+    PersonalizedPagerankTopK* heap, uint32_t k, uint32_t node, float rank) {
+  std::pair<uint32_t, float> item{node, rank};
+  if (heap->size() < k) {
+    heap->emplace_back(item);
+    std::push_heap(heap->begin(), heap->end(), RanksBefore);
+    return;
+  }
+  if (!RanksBefore(item, heap->front())) {
+    return;
+  }
+  std::pop_heap(heap->begin(), heap->end(), RanksBefore);
+  heap->back() = item;
+  std::push_heap(heap->begin(), heap->end(), RanksBefore);
+}
+
+/// Merge the per-thread heaps of lane into the k nodes that rank first
+PersonalizedPagerankTopK
+MergeTopK(katana::PerThreadStorage<TopKLanes>* heaps, size_t lane, uint32_t k) {
+  PersonalizedPagerankTopK top;
+  for (unsigned t = 0; t < heaps->size(); ++t) {
+    auto& heap = (*heaps->getRemote(t))[lane];
+    top.insert(top.end(), heap.begin(), heap.end());
+    heap.clear();
+  }
+  std::sort(top.begin(), top.end(), RanksBefore);
+  if (top.size() > k) {
+    top.resize(k);
+  }
+  return top;
+}
+
+void
+ClearBitmap(katana::DynamicBitset* bitmap) {
+  auto& words = bitmap->get_vec();
+  katana::do_all(
+      katana::iterate(size_t{0}, words.size()), [&](size_t w) { words[w] = 0; },
+      katana::no_stats());
+}
+
+/// The estimates and residuals of a batch of seed sets, one row per node.
+/// Only the rows of touched nodes are non-zero, and they are cleared after
+/// each batch, so a batch costs time proportional to the part of the graph
+/// it reaches.
+struct ForwardPushBatch {
+  const Graph& graph;
+  PRTy alpha;
+  PRTy epsilon;
+
+  katana::NUMAArray<Row> estimate;
+  katana::NUMAArray<Row> residual;
+  /// The index of each node in frontier, or kNotPushed
+  katana::NUMAArray<uint32_t> frontier_index;
+  /// The nodes whose rows may be non-zero
+  katana::DynamicBitset touched;
+  /// The out-neighbors of the frontier, then the nodes to push next
+  katana::DynamicBitset candidates;
+
+  /// The nodes pushed this round
+  std::vector<GNode> frontier;
+  /// The residual each node of frontier sends along each of its out-edges
+  std::vector<Row> pushed;
+  std::vector<GNode> candidate_queue;
+
+  ForwardPushBatch(const Graph& graph, const PersonalizedPagerankPlan& plan)
+      : graph(graph), alpha(plan.alpha()), epsilon(plan.epsilon()) {
+    estimate.allocateInterleaved(graph.NumNodes());
+    residual.allocateInterleaved(graph.NumNodes());
+    frontier_index.allocateInterleaved(graph.NumNodes());
+    katana::do_all(
+        katana::iterate(graph),
+        [&](const GNode& n) {
+          estimate[n] = Row{};
+          residual[n] = Row{};
+          frontier_index[n] = kNotPushed;
+        },
+        katana::no_stats());
+    touched.resize(graph.NumNodes());
+    candidates.resize(graph.NumNodes());
+  }
+
+  /// Whether the residual of some lane of n is above epsilon per out-edge
+  bool NeedsPush(const GNode& n) const {
+    PRTy threshold = epsilon * std::max<PRTy>(graph.OutDegree(n), PRTy{1});
+    PRTy max_residual = 0;
+    for (size_t k = 0; k < kLanes; ++k) {
+      max_residual = std::max(max_residual, residual[n].lanes[k]);
+    }
+    return max_residual > threshold;
+  }
+};
+
+/// Push every node of the frontier, in all lanes at once. Each node keeps
+/// (1 - alpha) of its residual and passes the rest to its out-neighbors,
+/// which pull it over their in-edges, so every row is written by one thread
+/// without atomics.
+void
+ForwardPushRound(ForwardPushBatch* batch) {
+  const Graph& graph = batch->graph;
+  PRTy alpha = batch->alpha;
+
+  ClearBitmap(&batch->candidates);
+  batch->pushed.resize(batch->frontier.size());
+  katana::do_all(
+      katana::iterate(size_t{0}, batch->frontier.size()),
+      [&](size_t i) {
+        GNode src = batch->frontier[i];
+        batch->frontier_index[src] = i;
+        Row& residual = batch->residual[src];
+        Row& estimate = batch->estimate[src];
+        Row& pushed = batch->pushed[i];
+        auto degree = graph.OutDegree(src);
+        PRTy share = degree == 0 ? PRTy{0} : alpha / degree;
+        for (size_t k = 0; k < kLanes; ++k) {
+          estimate.lanes[k] += (1 - alpha) * residual.lanes[k];
+          pushed.lanes[k] = share * residual.lanes[k];
+          residual.lanes[k] = 0;
+        }
+        for (auto e : graph.OutEdges(src)) {
+          batch->candidates.set(graph.OutEdgeDst(e));
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  batch->candidate_queue.clear();
+  batch->candidates.AppendOffsets(&batch->candidate_queue);
+  katana::do_all(
+      katana::iterate(batch->candidate_queue),
+      [&](const GNode& dst) {
+        batch->touched.set(dst);
+        Row& residual = batch->residual[dst];
+        for (auto e : graph.InEdges(dst)) {
+          uint32_t i = batch->frontier_index[graph.InEdgeSrc(e)];
+          if (i == kNotPushed) {
+            continue;
+          }
+          const Row& pushed = batch->pushed[i];
+          for (size_t k = 0; k < kLanes; ++k) {
+            residual.lanes[k] += pushed.lanes[k];
+          }
+        }
+      },
+      katana::steal(), katana::loopname("PersonalizedPagerank-pull"));
+
+  katana::do_all(
+      katana::iterate(batch->frontier),
+      [&](const GNode& n) { batch->frontier_index[n] = kNotPushed; },
+      katana::no_stats());
+
+  // Only out-neighbors of the frontier gained residual, so they are the only
+  // nodes that may need to be pushed next
+  ClearBitmap(&batch->candidates);
+  katana::do_all(
+      katana::iterate(batch->candidate_queue),
+      [&](const GNode& n) {
+        if (batch->NeedsPush(n)) {
+          batch->candidates.set(n);
+        }
+      },
+      katana::no_stats());
+  batch->frontier.clear();
+  batch->candidates.AppendOffsets(&batch->frontier);
+}
+
+/// Rank the nodes for seed sets [base, base + kLanes) and add their top k
+/// nodes to results
+void
+ForwardPushBatchRun(
+    ForwardPushBatch* batch,
+    const std::vector<std::vector<uint32_t>>& seed_sets, size_t base,
+    uint32_t k, std::vector<PersonalizedPagerankTopK>* results,
+    uint64_t* num_rounds) {
+  size_t num_lanes = std::min(seed_sets.size() - base, kLanes);
+
+  for (size_t lane = 0; lane < num_lanes; ++lane) {
+    const auto& seeds = seed_sets[base + lane];
+    PRTy mass = PRTy{1} / seeds.size();
+    for (uint32_t seed : seeds) {
+      batch->residual[seed].lanes[lane] += mass;
+      batch->touched.set(seed);
+    }
+  }
+  batch->frontier.clear();
+  batch->touched.AppendOffsets(&batch->frontier);
+
+  while (!batch->frontier.empty()) {
+    ++*num_rounds;
+    ForwardPushRound(batch);
+  }
+
+  std::vector<GNode> touched;
+  batch->touched.AppendOffsets(&touched);
+  katana::PerThreadStorage<TopKLanes> heaps;
+  katana::do_all(
+      katana::iterate(touched),
+      [&](const GNode& n) {
+        TopKLanes& local = *heaps.getLocal();
+        Row& estimate = batch->estimate[n];
+        for (size_t lane = 0; lane < num_lanes; ++lane) {
+          if (estimate.lanes[lane] > 0) {
+            OfferTopK(&local[lane], k, n, estimate.lanes[lane]);
+          }
+        }
+        estimate = Row{};
+        batch->residual[n] = Row{};
+      },
+      katana::steal(), katana::no_stats());
+  ClearBitmap(&batch->touched);
+
+  for (size_t lane = 0; lane < num_lanes; ++lane) {
+    (*results)[base + lane] = MergeTopK(&heaps, lane, k);
+  }
+}
+
+}  // namespace
+
+katana::Result<std::vector<PersonalizedPagerankTopK>>
+PersonalizedPagerankForwardPush(
+    katana::PropertyGraph* pg,
+    const std::vector<std::vector<uint32_t>>& seed_sets, uint32_t k,
+    katana::analytics::PersonalizedPagerankPlan plan) {
+  katana::ReportPageAllocGuard page_alloc;
+
+  Graph graph = pg->BuildView<Graph>();
+  std::vector<PersonalizedPagerankTopK> results(seed_sets.size());
+
+  katana::StatTimer exec_time("PersonalizedPagerank");
+  exec_time.start();
+
+  ForwardPushBatch batch(graph, plan);
+  uint64_t num_rounds = 0;
+  for (size_t base = 0; base < seed_sets.size(); base += kLanes) {
+    ForwardPushBatchRun(&batch, seed_sets, base, k, &results, &num_rounds);
+  }
+
+  exec_time.stop();
+  katana::ReportStatSingle("PersonalizedPagerank", "Rounds", num_rounds);
+
+  return results;
+}
+
+katana::Result<std::vector<PersonalizedPagerankTopK>>
+PersonalizedPagerankMonteCarlo(
+    katana::PropertyGraph* pg,
+    const std::vector<std::vector<uint32_t>>& seed_sets, uint32_t k,
+    katana::analytics::PersonalizedPagerankPlan plan) {
+  katana::ReportPageAllocGuard page_alloc;
+
+  Graph graph = pg->BuildView<Graph>();
+  std::vector<PersonalizedPagerankTopK> results(seed_sets.size());
+  uint64_t walks_per_set = plan.number_of_walks();
+  if (walks_per_set == 0) {
+    return results;
+  }
+
+  katana::StatTimer exec_time("PersonalizedPagerank");
+  exec_time.start();
+
+  // The node each walk stopped at, for kLanes seed sets at a time
+  katana::NUMAArray<uint32_t> ends;
+  ends.allocateInterleaved(kLanes * walks_per_set);
+
+  for (size_t base = 0; base < seed_sets.size(); base += kLanes) {
+    size_t num_sets = std::min(seed_sets.size() - base, kLanes);
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_sets * walks_per_set),
+        [&](uint64_t i) {
+          // Walks are numbered across batches so that each has its own
+          // random stream
+          uint64_t walk = base * walks_per_set + i;
+          katana::analytics::WalkRandom random(plan.seed(), walk);
+          const auto& seeds = seed_sets[base + i / walks_per_set];
+          GNode n = seeds[random.NextIndex(seeds.size())];
+          while (random.NextDouble() < plan.alpha()) {
+            auto degree = graph.OutDegree(n);
+            if (degree == 0) {
+              n = kLostWalk;
+              break;
+            }
+            n = graph.OutEdgeDst(
+                *graph.OutEdges(n).begin() + random.NextIndex(degree));
+          }
+          ends[i] = n;
+        },
+        katana::steal(), katana::loopname("PersonalizedPagerank-walks"));
+
+    katana::do_all(
+        katana::iterate(size_t{0}, num_sets),
+        [&](size_t set) {
+          uint32_t* begin = &ends[set * walks_per_set];
+          uint32_t* end = begin + walks_per_set;
+          std::sort(begin, end);
+          PersonalizedPagerankTopK heap;
+          for (uint32_t* run = begin; run != end && *run != kLostWalk;) {
+            uint32_t* run_end = std::upper_bound(run, end, *run);
+            float rank = static_cast<float>(run_end - run) / walks_per_set;
+            OfferTopK(&heap, k, *run, rank);
+            run = run_end;
+          }
+          std::sort(heap.begin(), heap.end(), RanksBefore);
+          results[base + set] = std::move(heap);
+        },
+        katana::no_stats());
+  }
+
+  exec_time.stop();
+
+  return results;
+}
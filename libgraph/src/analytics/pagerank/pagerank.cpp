@@ -38,6 +38,63 @@ katana::analytics::Pagerank(
   }
 }
 
+katana::Result<void>
+katana::analytics::PagerankIncremental(
+    katana::PropertyGraph* pg, const std::string& previous_property_name,
+    const std::vector<uint32_t>& changed_nodes,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    katana::analytics::PagerankPlan plan) {
+  if (plan.algorithm() != PagerankPlan::kPushAsynchronous &&
+      plan.algorithm() != PagerankPlan::kPushSynchronous) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "incremental Page Rank continues a push algorithm");
+  }
+  return PagerankPushIncremental(
+      pg, previous_property_name, changed_nodes, output_property_name, plan,
+      txn_ctx);
+}
+
+katana::Result<std::vector<katana::analytics::PersonalizedPagerankTopK>>
+katana::analytics::PersonalizedPagerank(
+    katana::PropertyGraph* pg,
+    const std::vector<std::vector<uint32_t>>& seed_sets, uint32_t k,
+    katana::analytics::PersonalizedPagerankPlan plan) {
+  if (plan.alpha() < 0 || plan.alpha() >= 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "alpha must be in [0, 1)");
+  }
+  for (size_t i = 0; i < seed_sets.size(); ++i) {
+    if (seed_sets[i].empty()) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "seed set {} is empty", i);
+    }
+    for (uint32_t n : seed_sets[i]) {
+      if (n >= pg->NumNodes()) {
+        return KATANA_ERROR(
+            katana::ErrorCode::InvalidArgument,
+            "seed {} of seed set {} does not exist", n, i);
+      }
+    }
+  }
+  if (k == 0) {
+    return std::vector<PersonalizedPagerankTopK>(seed_sets.size());
+  }
+
+  switch (plan.algorithm()) {
+  case PersonalizedPagerankPlan::kForwardPush:
+    if (plan.epsilon() <= 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument, "epsilon must be positive");
+    }
+    return PersonalizedPagerankForwardPush(pg, seed_sets, k, plan);
+  case PersonalizedPagerankPlan::kMonteCarlo:
+    return PersonalizedPagerankMonteCarlo(pg, seed_sets, k, plan);
+  default:
+    return katana::ErrorCode::InvalidArgument;
+  }
+}
+
 /// \cond DO_NOT_DOCUMENT
 katana::Result<void>
 katana::analytics::PagerankAssertValid(
@@ -19,6 +19,9 @@
 
 #include "katana/analytics/random_walks/random_walks.h"
 
+#include <arrow/api.h>
+#include <arrow/compute/api.h>
+
 #include "katana/TypedPropertyGraph.h"
 
 using namespace katana::analytics;
@@ -29,6 +32,15 @@ namespace {
 
 using SortedPropertyGraphView = katana::PropertyGraphViews::EdgesSortedByDestID;
 
+/// Alias tables (Vose's method) for every node, stored per edge: out-edge i
+/// of a node is kept with probability prob[i] and otherwise replaced by the
+/// out-edge alias[i] of the same node. Sampling an out-edge in proportion to
+/// its weight then takes two random numbers regardless of degree.
+struct AliasTables {
+  katana::NUMAArray<float> prob;
+  katana::NUMAArray<uint32_t> alias;
+};
+
 struct Node2VecAlgo {
   using NodeData = std::tuple<>;
   using EdgeData = std::tuple<>;
@@ -40,135 +52,232 @@ struct Node2VecAlgo {
   const RandomWalksPlan& plan_;
   Node2VecAlgo(const RandomWalksPlan& plan) : plan_(plan) {}
 
-  GNode FindSampleNeighbor(
-      const SortedGraphView& graph, const GNode& n,
-      const katana::NUMAArray<uint64_t>& degree, const double prob) {
-    if (degree[n] == 0) {
-      return graph.NumNodes();
-    }
-    double total_wt = degree[n];
-
-    uint32_t edge_index = std::floor(prob * total_wt);
-    auto ei = graph.OutEdges(n).begin() + edge_index;
-    return graph.OutEdgeDst(*ei);
-  }
-
-  void GraphRandomWalk(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    katana::PerThreadStorage<std::mt19937> generator;
-    katana::PerThreadStorage<std::uniform_real_distribution<double>*>
-        distribution;
-
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      *distribution.getRemote(i) =
-          new std::uniform_real_distribution<double>(0.0, 1.0);
+  /// Number of slots of each walk: the start node and one per step. Every
+  /// walk takes at least one step.
+  uint32_t WalkWidth() const { return std::max(plan_.walk_length(), 1U) + 1; }
+
+  /// Build the alias tables of the edge weights in property_name. Nodes
+  /// whose out-edges all have weight 0 get degree 0 so walks stop there.
+  katana::Result<void> BuildAliasTables(
+      const SortedGraphView& graph, katana::PropertyGraph* pg,
+      const std::string& property_name, katana::NUMAArray<uint64_t>* degree,
+      AliasTables* tables) {
+    auto property = KATANA_CHECKED(pg->GetEdgeProperty(property_name));
+    auto cast = KATANA_CHECKED_CONTEXT(
+        arrow::compute::Cast(property, arrow::float64()),
+        "edge weight property {} must be numeric", property_name);
+    auto weights_array = KATANA_CHECKED(
+        arrow::Concatenate(cast.chunked_array()->chunks()));
+    if (weights_array->null_count() > 0) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge weight property {} has nulls", property_name);
     }
+    const double* weights =
+        std::static_pointer_cast<arrow::DoubleArray>(weights_array)
+            ->raw_values();
 
-    double prob_forward = 1.0 / plan_.forward_probability();
-    double prob_backward = 1.0 / plan_.backward_probability();
-
-    double upper_bound = 1.0;
-
-    upper_bound = (upper_bound > prob_forward) ? upper_bound : prob_forward;
-    upper_bound = (upper_bound > prob_backward) ? upper_bound : prob_backward;
-
-    double lower_bound = 1.0;
+    tables->prob.allocateBlocked(graph.NumEdges());
+    tables->alias.allocateBlocked(graph.NumEdges());
 
-    lower_bound = (lower_bound < prob_forward) ? lower_bound : prob_forward;
-    lower_bound = (lower_bound < prob_backward) ? lower_bound : prob_backward;
-
-    uint64_t total_walks = graph.size() * plan_.number_of_walks();
+    struct Scratch {
+      std::vector<double> scaled;
+      std::vector<uint32_t> small;
+      std::vector<uint32_t> large;
+    };
+    katana::PerThreadStorage<Scratch> scratch;
+    std::atomic<bool> negative{false};
 
     katana::do_all(
-        katana::iterate(uint64_t(0), total_walks),
-        [&](uint64_t idx) {
-          GNode n = idx % graph.size();
-
-          //check if n has no neighbor
-          if (degree[n] == 0) {
+        katana::iterate(graph),
+        [&](GNode n) {
+          auto first = *graph.OutEdges(n).begin();
+          uint32_t d = (*degree)[n];
+          Scratch& s = *scratch.getLocal();
+
+          double total = 0;
+          s.scaled.resize(d);
+          for (uint32_t i = 0; i < d; ++i) {
+            double w =
+                weights[graph.GetEdgePropertyIndexFromOutEdge(first + i)];
+            if (w < 0) {
+              negative = true;
+            }
+            s.scaled[i] = w;
+            total += w;
+          }
+          if (!(total > 0)) {
+            (*degree)[n] = 0;
             return;
           }
 
-          std::uniform_real_distribution<double>* dist =
-              *distribution.getLocal();
+          s.small.clear();
+          s.large.clear();
+          for (uint32_t i = 0; i < d; ++i) {
+            s.scaled[i] *= d / total;
+            (s.scaled[i] < 1 ? s.small : s.large).emplace_back(i);
+          }
+          while (!s.small.empty() && !s.large.empty()) {
+            uint32_t less = s.small.back();
+            uint32_t more = s.large.back();
+            s.small.pop_back();
+            tables->prob[first + less] = s.scaled[less];
+            tables->alias[first + less] = more;
+            s.scaled[more] -= 1 - s.scaled[less];
+            if (s.scaled[more] < 1) {
+              s.large.pop_back();
+              s.small.emplace_back(more);
+            }
+          }
+          // Whatever is left is 1 up to rounding error
+          for (const auto* rest : {&s.small, &s.large}) {
+            for (uint32_t i : *rest) {
+              tables->prob[first + i] = 1;
+              tables->alias[first + i] = i;
+            }
+          }
+        },
+        katana::steal(), katana::loopname("Node2vec alias tables"),
+        katana::no_stats());
 
-          std::vector<uint32_t> walk;
-          walk.push_back(n);
+    if (negative) {
+      return KATANA_ERROR(
+          katana::ErrorCode::InvalidArgument,
+          "edge weight property {} has negative weights", property_name);
+    }
+    return katana::ResultSuccess();
+  }
 
-          //random value between 0 and 1
-          double prob = (*dist)(*generator.getLocal());
+  GNode SampleNeighbor(
+      const SortedGraphView& graph, const GNode& n,
+      const katana::NUMAArray<uint64_t>& degree, const AliasTables* tables,
+      WalkRandom* random) {
+    auto first = *graph.OutEdges(n).begin();
+    auto e = first + random->NextIndex(degree[n]);
+    if (tables != nullptr && random->NextDouble() >= tables->prob[e]) {
+      e = first + tables->alias[e];
+    }
+    return graph.OutEdgeDst(e);
+  }
 
-          //Assumption: All edges have weight 1
-          auto nbr = FindSampleNeighbor(graph, n, degree, prob);
-          KATANA_LOG_ASSERT(nbr < graph.NumNodes());
+  /// Fill walk[0, WalkWidth()) with a walk from n, returning the number of
+  /// nodes visited
+  uint32_t Walk(
+      const SortedGraphView& graph, GNode n,
+      const katana::NUMAArray<uint64_t>& degree, const AliasTables* tables,
+      WalkRandom* random, uint32_t* walk) {
+    double prob_forward = 1.0 / plan_.forward_probability();
+    double prob_backward = 1.0 / plan_.backward_probability();
+    double upper_bound = std::max({1.0, prob_forward, prob_backward});
+    double lower_bound = std::min({1.0, prob_forward, prob_backward});
 
-          walk.push_back(std::move(nbr));
+    walk[0] = n;
+    walk[1] = SampleNeighbor(graph, n, degree, tables, random);
 
-          for (uint32_t current_walk = 2; current_walk <= plan_.walk_length();
-               current_walk++) {
-            uint32_t curr = walk[current_walk - 1];
-            uint32_t prev = walk[current_walk - 2];
+    uint32_t width = WalkWidth();
+    for (uint32_t i = 2; i < width; ++i) {
+      GNode curr = walk[i - 1];
+      GNode prev = walk[i - 2];
 
-            //check if n has no neighbor
-            if (degree[curr] == 0) {
-              break;
-            }
-            //acceptance-rejection sampling
-            while (true) {
-              //sample x
-              double prob = (*dist)(*generator.getLocal());
+      //check if curr has no neighbor
+      if (degree[curr] == 0) {
+        return i;
+      }
 
-              auto nbr = FindSampleNeighbor(graph, curr, degree, prob);
-              KATANA_LOG_ASSERT(nbr < graph.NumNodes());
+      //acceptance-rejection sampling of the second order transition
+      while (true) {
+        GNode nbr = SampleNeighbor(graph, curr, degree, tables, random);
+
+        double y = random->NextDouble() * upper_bound;
+        if (y <= lower_bound) {
+          walk[i] = nbr;
+          break;
+        }
+
+        double alpha;
+        if (nbr == prev) {
+          alpha = prob_backward;
+        } else if (graph.HasEdge(prev, nbr)) {
+          //nbr is also a neighbor of the previous node on this walk; edges
+          //are sorted so this is a binary search
+          alpha = 1.0;
+        } else {
+          alpha = prob_forward;
+        }
+
+        if (y <= alpha) {
+          walk[i] = nbr;
+          break;
+        }
+      }
+    }
+    return width;
+  }
 
-              //sample y
-              double y = (*dist)(*generator.getLocal());
-              y = y * upper_bound;
+  katana::Result<std::shared_ptr<arrow::FixedSizeListArray>> operator()(
+      const SortedGraphView& graph, katana::PropertyGraph* pg,
+      katana::NUMAArray<uint64_t>* degree) {
+    AliasTables tables;
+    const AliasTables* tables_ptr = nullptr;
+    if (!plan_.edge_weight_property_name().empty()) {
+      KATANA_CHECKED(BuildAliasTables(
+          graph, pg, plan_.edge_weight_property_name(), degree, &tables));
+      tables_ptr = &tables;
+    }
 
-              if (y <= lower_bound) {
-                //accept this sample
-                walk.push_back(std::move(nbr));
-                break;
-              } else {
-                //compute transition probability
-                double alpha;
-
-                //check if nbr is same as the previous node on this walk
-                if (nbr == prev) {
-                  alpha = prob_backward;
-                }  //check if nbr is also a neighbor of the previous node on this walk
-                else if (graph.HasEdge(prev, nbr)) {
-                  alpha = 1.0;
-                } else {
-                  alpha = prob_forward;
-                }
-
-                if (y <= alpha) {
-                  //accept y
-                  walk.push_back(std::move(nbr));
-                  break;
-                }
-              }
-            }
-          }
+    // Walks start at every node that can take a first step
+    std::vector<GNode> starts;
+    for (GNode n : graph) {
+      if ((*degree)[n] > 0) {
+        starts.emplace_back(n);
+      }
+    }
+
+    uint32_t width = WalkWidth();
+    uint64_t num_walks = starts.size() * plan_.number_of_walks();
+    uint64_t num_slots = num_walks * width;
+    auto buffer =
+        KATANA_CHECKED(arrow::AllocateBuffer(num_slots * sizeof(uint32_t)));
+    auto* walks = reinterpret_cast<uint32_t*>(buffer->mutable_data());
+    std::atomic<bool> has_short_walks{false};
 
-          walks->push(std::move(walk));
+    katana::do_all(
+        katana::iterate(uint64_t{0}, num_walks),
+        [&](uint64_t idx) {
+          WalkRandom random(plan_.seed(), idx);
+          uint32_t* walk = walks + idx * width;
+          uint32_t length = Walk(
+              graph, starts[idx % starts.size()], *degree, tables_ptr, &random,
+              walk);
+          if (length < width) {
+            std::fill(walk + length, walk + width, 0);
+            has_short_walks = true;
+          }
         },
         katana::steal(), katana::chunk_size<RandomWalksPlan::kChunkSize>(),
         katana::loopname("Node2vec walks"), katana::no_stats());
 
-    for (uint32_t i = 0; i < distribution.size(); i++) {
-      delete (*distribution.getRemote(i));
+    std::shared_ptr<arrow::Buffer> validity;
+    int64_t null_count = 0;
+    if (has_short_walks) {
+      validity = KATANA_CHECKED(arrow::AllocateBitmap(num_slots));
+      uint8_t* bits = validity->mutable_data();
+      for (uint64_t idx = 0; idx < num_walks; ++idx) {
+        const uint32_t* walk = walks + idx * width;
+        // A walk is padded once a node without out-edges is reached
+        bool valid = true;
+        for (uint32_t i = 0; i < width; ++i) {
+          arrow::BitUtil::SetBitTo(bits, idx * width + i, valid);
+          null_count += !valid;
+          valid = valid && (i == 0 || (*degree)[walk[i]] > 0);
+        }
+      }
     }
-  }
 
-  void operator()(
-      const SortedGraphView& graph,
-      katana::InsertBag<std::vector<uint32_t>>* walks,
-      const katana::NUMAArray<uint64_t>& degree) {
-    GraphRandomWalk(graph, walks, degree);
+    auto values = std::make_shared<arrow::UInt32Array>(
+        num_slots, std::move(buffer), validity, null_count);
+    return std::make_shared<arrow::FixedSizeListArray>(
+        arrow::fixed_size_list(arrow::uint32(), width), num_walks, values);
   }
 };
 
@@ -477,15 +586,57 @@ InitializeDegrees(const Graph& graph, katana::NUMAArray<uint64_t>* degree) {
   });
 }
 
+/// Copy walks into a FixedSizeListArray as wide as the longest walk,
+/// padding shorter walks with nulls
+katana::Result<std::shared_ptr<arrow::FixedSizeListArray>>
+FlattenWalks(const std::vector<std::vector<uint32_t>>& walks) {
+  size_t width = 0;
+  for (const auto& walk : walks) {
+    width = std::max(width, walk.size());
+  }
+
+  arrow::UInt32Builder builder;
+  KATANA_CHECKED(builder.Reserve(walks.size() * width));
+  for (const auto& walk : walks) {
+    builder.UnsafeAppend(walk.data(), walk.size());
+    KATANA_CHECKED(builder.AppendNulls(width - walk.size()));
+  }
+  auto values = KATANA_CHECKED(builder.Finish());
+  return std::make_shared<arrow::FixedSizeListArray>(
+      arrow::fixed_size_list(arrow::uint32(), width), walks.size(), values);
+}
+
 }  //namespace
 
-template <typename Algorithm>
+static katana::Result<std::shared_ptr<arrow::FixedSizeListArray>>
+Node2VecWithWrap(katana::PropertyGraph* pg, const RandomWalksPlan& plan) {
+  katana::ReportPageAllocGuard page_alloc;
+
+  auto graph = KATANA_CHECKED(Node2VecAlgo::SortedGraphView::Make(pg, {}, {}));
+
+  Node2VecAlgo algo(plan);
+
+  katana::NUMAArray<uint64_t> degree;
+  degree.allocateBlocked(graph.size());
+  InitializeDegrees(graph, &degree);
+
+  katana::StatTimer execTime("RandomWalks");
+  execTime.start();
+  auto walks = KATANA_CHECKED(algo(graph, pg, &degree));
+  execTime.stop();
+
+  return walks;
+}
+
 static katana::Result<std::vector<std::vector<uint32_t>>>
-RandomWalksWithWrap(
-    const typename Algorithm::SortedGraphView& graph, RandomWalksPlan plan) {
+Edge2VecWithWrap(katana::PropertyGraph* pg, const RandomWalksPlan& plan) {
   katana::ReportPageAllocGuard page_alloc;
 
-  Algorithm algo(plan);
+  TemporaryPropertyGuard tmp_edge_prop{pg->NodeMutablePropertyView()};
+  auto graph = KATANA_CHECKED(
+      Edge2VecAlgo::SortedGraphView::Make(pg, {}, {tmp_edge_prop.name()}));
+
+  Edge2VecAlgo algo(plan);
 
   katana::NUMAArray<uint64_t> degree;
   degree.allocateBlocked(graph.size());
@@ -507,15 +658,42 @@ katana::Result<std::vector<std::vector<uint32_t>>>
 katana::analytics::RandomWalks(PropertyGraph* pg, RandomWalksPlan plan) {
   switch (plan.algorithm()) {
   case RandomWalksPlan::kNode2Vec: {
-    auto graph =
-        KATANA_CHECKED(Node2VecAlgo::SortedGraphView::Make(pg, {}, {}));
-    return RandomWalksWithWrap<Node2VecAlgo>(graph, plan);
+    auto flat = KATANA_CHECKED(Node2VecWithWrap(pg, plan));
+    const auto& values =
+        static_cast<const arrow::UInt32Array&>(*flat->values());
+    std::vector<std::vector<uint32_t>> walks(flat->length());
+    katana::do_all(
+        katana::iterate(int64_t{0}, flat->length()),
+        [&](int64_t idx) {
+          int64_t begin = flat->value_offset(idx);
+          int64_t end = begin + flat->value_length();
+          while (end > begin && values.IsNull(end - 1)) {
+            --end;
+          }
+          walks[idx].assign(
+              values.raw_values() + begin, values.raw_values() + end);
+        },
+        katana::no_stats());
+    return walks;
+  }
+  case RandomWalksPlan::kEdge2Vec:
+    return Edge2VecWithWrap(pg, plan);
+  default:
+    return ErrorCode::InvalidArgument;
   }
+}
+
+katana::Result<std::shared_ptr<arrow::FixedSizeListArray>>
+katana::analytics::RandomWalksFlat(PropertyGraph* pg, RandomWalksPlan plan) {
+  switch (plan.algorithm()) {
+  case RandomWalksPlan::kNode2Vec:
+    return Node2VecWithWrap(pg, plan);
   case RandomWalksPlan::kEdge2Vec: {
-    TemporaryPropertyGuard tmp_edge_prop{pg->NodeMutablePropertyView()};
-    auto graph = KATANA_CHECKED(
-        Edge2VecAlgo::SortedGraphView::Make(pg, {}, {tmp_edge_prop.name()}));
-    return RandomWalksWithWrap<Edge2VecAlgo>(graph, plan);
+    // Edge2vec keeps only the walks that take every step, and how many there
+    // are is not known until all iterations are done, so its walks are
+    // collected and then copied
+    auto walks = KATANA_CHECKED(Edge2VecWithWrap(pg, plan));
+    return FlattenWalks(walks);
   }
   default:
     return ErrorCode::InvalidArgument;
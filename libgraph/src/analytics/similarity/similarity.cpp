@@ -0,0 +1,320 @@
+#include "katana/analytics/similarity/similarity.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <arrow/api.h>
+
+#include "katana/Galois.h"
+#include "katana/ParallelSTL.h"
+#include "katana/Reduction.h"
+#include "katana/Statistics.h"
+#include "katana/analytics/ClusterWeightAccumulator.h"
+#include "katana/analytics/Utils.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Graph = katana::PropertyGraphViews::BiDirectional;
+using Node = Graph::Node;
+
+struct Candidate {
+  Node node;
+  double similarity;
+};
+
+/// The order of results: higher similarity first, then smaller node ID
+bool
+Better(const Candidate& a, const Candidate& b) {
+  return a.similarity > b.similarity ||
+         (a.similarity == b.similarity && a.node < b.node);
+}
+
+double
+Similarity(
+    SimilarityMetric metric, uint64_t common, uint64_t degree_u,
+    uint64_t degree_v) {
+  switch (metric) {
+  case SimilarityMetric::kJaccard:
+    return static_cast<double>(common) / (degree_u + degree_v - common);
+  case SimilarityMetric::kCosine:
+    return common / std::sqrt(static_cast<double>(degree_u) * degree_v);
+  }
+  return 0;
+}
+
+/// The similarity of u and v if one of their neighbor sets contained the
+/// other, the most they could share
+double
+SimilarityBound(SimilarityMetric metric, uint64_t degree_u, uint64_t degree_v) {
+  return Similarity(metric, std::min(degree_u, degree_v), degree_u, degree_v);
+}
+
+/// Scratch space reused by all of the sources a thread processes
+struct TopKScratch {
+  /// Number of out-neighbors shared with the current source, by node. It is
+  /// sparse, so its size is bounded by the largest 2-hop neighborhood a
+  /// thread visits rather than by the number of nodes.
+  ClusterWeightAccumulator<uint32_t> common;
+  /// The best candidates so far, with the worst of them at the front
+  std::vector<Candidate> heap;
+};
+
+/// Find the k nodes most similar to u. Common out-neighbors w of u and v are
+/// found by walking from u to w along out-edges and back to v along the
+/// in-edges of w, so only the 2-hop neighborhood of u is visited.
+void
+TopKForSource(
+    const Graph& graph, Node u, uint32_t k, SimilarityMetric metric,
+    TopKScratch* scratch, std::vector<Candidate>* result) {
+  auto& common = scratch->common;
+  auto& heap = scratch->heap;
+
+  for (auto e : graph.OutEdges(u)) {
+    Node w = graph.OutEdgeDst(e);
+    for (auto in_e : graph.InEdges(w)) {
+      Node v = graph.InEdgeSrc(in_e);
+      if (v != u) {
+        common.Add(v, 1);
+      }
+    }
+  }
+
+  uint64_t degree_u = graph.OutDegree(u);
+  for (size_t i = 0; i < common.size(); ++i) {
+    Node v = common.cluster(i);
+    uint32_t num_common = common.weight(i);
+
+    // Enumeration is already paid for; this only saves scoring candidates
+    // that cannot beat the k-th best
+    uint64_t degree_v = graph.OutDegree(v);
+    if (heap.size() == k &&
+        !Better(
+            {v, SimilarityBound(metric, degree_u, degree_v)}, heap.front())) {
+      continue;
+    }
+
+    Candidate candidate{v, Similarity(metric, num_common, degree_u, degree_v)};
+    if (heap.size() < k) {
+      heap.emplace_back(candidate);
+      std::push_heap(heap.begin(), heap.end(), Better);
+    } else if (Better(candidate, heap.front())) {
+      std::pop_heap(heap.begin(), heap.end(), Better);
+      heap.back() = candidate;
+      std::push_heap(heap.begin(), heap.end(), Better);
+    }
+  }
+  common.Clear();
+
+  std::sort_heap(heap.begin(), heap.end(), Better);
+  result->assign(heap.begin(), heap.end());
+  heap.clear();
+}
+
+katana::Result<std::shared_ptr<arrow::LargeListArray>>
+GetListProperty(
+    const katana::PropertyGraph* pg, const std::string& name,
+    const std::shared_ptr<arrow::DataType>& value_type) {
+  auto property = KATANA_CHECKED(pg->GetNodeProperty(name));
+  if (property->num_chunks() != 1 ||
+      !property->type()->Equals(arrow::large_list(value_type))) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "property {} must be a single chunk of large_list<{}>", name,
+        value_type->ToString());
+  }
+  return std::static_pointer_cast<arrow::LargeListArray>(property->chunk(0));
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::TopKSimilarity(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& source_nodes,
+    uint32_t k, SimilarityMetric metric,
+    const std::string& output_nodes_property_name,
+    const std::string& output_similarities_property_name,
+    katana::TxnContext* txn_ctx, TopKSimilarityPlan) {
+  if (k == 0) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "k must be positive");
+  }
+  uint64_t num_nodes = pg->NumNodes();
+  for (uint32_t source : source_nodes) {
+    if (source >= num_nodes) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "source node {} does not exist",
+          source);
+    }
+  }
+
+  katana::ReportPageAllocGuard page_alloc;
+
+  katana::StatTimer exec_time("TopKSimilarity");
+  exec_time.start();
+
+  Graph graph = pg->BuildView<Graph>();
+
+  // results[n] is empty for nodes that are not sources
+  std::vector<std::vector<Candidate>> results(num_nodes);
+  katana::PerThreadStorage<TopKScratch> scratch;
+  auto process = [&](Node u) {
+    TopKForSource(graph, u, k, metric, scratch.getLocal(), &results[u]);
+  };
+  if (source_nodes.empty()) {
+    katana::do_all(
+        katana::iterate(graph), process, katana::steal(),
+        katana::loopname("TopKSimilarity"));
+  } else {
+    // Each source owns its slot in results, so process each only once
+    std::vector<uint32_t> sources(source_nodes);
+    std::sort(sources.begin(), sources.end());
+    sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+    katana::do_all(
+        katana::iterate(sources.begin(), sources.end()), process,
+        katana::steal(), katana::loopname("TopKSimilarity"));
+  }
+
+  exec_time.stop();
+
+  // Lay the results out as the offsets and values of two large_lists
+  auto offsets_buffer = KATANA_CHECKED(
+      arrow::AllocateBuffer((num_nodes + 1) * sizeof(int64_t)));
+  auto* offsets = reinterpret_cast<int64_t*>(offsets_buffer->mutable_data());
+  offsets[0] = 0;
+  for (uint64_t n = 0; n < num_nodes; ++n) {
+    offsets[n + 1] = offsets[n] + results[n].size();
+  }
+  int64_t num_results = offsets[num_nodes];
+
+  auto nodes_buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_results * sizeof(uint32_t)));
+  auto similarities_buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_results * sizeof(double)));
+  auto* nodes = reinterpret_cast<uint32_t*>(nodes_buffer->mutable_data());
+  auto* similarities =
+      reinterpret_cast<double*>(similarities_buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes),
+      [&](uint64_t n) {
+        int64_t offset = offsets[n];
+        for (const auto& candidate : results[n]) {
+          nodes[offset] = candidate.node;
+          similarities[offset] = candidate.similarity;
+          ++offset;
+        }
+      },
+      katana::no_stats());
+
+  std::shared_ptr<arrow::Buffer> shared_offsets = std::move(offsets_buffer);
+  auto nodes_array = std::make_shared<arrow::LargeListArray>(
+      arrow::large_list(arrow::uint32()), num_nodes, shared_offsets,
+      std::make_shared<arrow::UInt32Array>(
+          num_results, std::move(nodes_buffer)));
+  auto similarities_array = std::make_shared<arrow::LargeListArray>(
+      arrow::large_list(arrow::float64()), num_nodes, shared_offsets,
+      std::make_shared<arrow::DoubleArray>(
+          num_results, std::move(similarities_buffer)));
+
+  auto table = arrow::Table::Make(
+      arrow::schema({
+          arrow::field(
+              output_nodes_property_name, arrow::large_list(arrow::uint32())),
+          arrow::field(
+              output_similarities_property_name,
+              arrow::large_list(arrow::float64())),
+      }),
+      {nodes_array, similarities_array});
+  return pg->AddNodeProperties(table, txn_ctx);
+}
+
+constexpr static const double EPSILON = 1e-6;
+
+katana::Result<void>
+katana::analytics::TopKSimilarityAssertValid(
+    katana::PropertyGraph* pg, uint32_t k,
+    const std::string& nodes_property_name,
+    const std::string& similarities_property_name) {
+  auto nodes_list = KATANA_CHECKED(
+      GetListProperty(pg, nodes_property_name, arrow::uint32()));
+  auto similarities_list = KATANA_CHECKED(
+      GetListProperty(pg, similarities_property_name, arrow::float64()));
+  auto nodes =
+      std::static_pointer_cast<arrow::UInt32Array>(nodes_list->values());
+  auto similarities =
+      std::static_pointer_cast<arrow::DoubleArray>(similarities_list->values());
+
+  auto is_bad = [&](const Node& n) {
+    int64_t begin = nodes_list->value_offset(n);
+    int64_t end = nodes_list->value_offset(n + 1);
+    if (end - begin > k || similarities_list->value_offset(n) != begin ||
+        similarities_list->value_offset(n + 1) != end) {
+      return true;
+    }
+    for (int64_t i = begin; i < end; ++i) {
+      double similarity = similarities->Value(i);
+      if (nodes->Value(i) == n || nodes->Value(i) >= pg->NumNodes() ||
+          similarity <= 0 || similarity > 1 + EPSILON) {
+        return true;
+      }
+      if (i > begin && similarity > similarities->Value(i - 1)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  if (katana::ParallelSTL::find_if(pg->begin(), pg->end(), is_bad) !=
+      pg->end()) {
+    return katana::ErrorCode::AssertionFailed;
+  }
+
+  return katana::ResultSuccess();
+}
+
+katana::Result<TopKSimilarityStatistics>
+katana::analytics::TopKSimilarityStatistics::Compute(
+    katana::PropertyGraph* pg, const std::string& nodes_property_name,
+    const std::string& similarities_property_name) {
+  auto nodes_list = KATANA_CHECKED(
+      GetListProperty(pg, nodes_property_name, arrow::uint32()));
+  auto similarities_list = KATANA_CHECKED(
+      GetListProperty(pg, similarities_property_name, arrow::float64()));
+  auto similarities =
+      std::static_pointer_cast<arrow::DoubleArray>(similarities_list->values());
+
+  katana::GAccumulator<uint64_t> num_nodes_with_results;
+  katana::GReduceMax<double> max_similarity;
+  katana::GAccumulator<double> total_similarity;
+
+  katana::do_all(
+      katana::iterate(*pg),
+      [&](const Node& n) {
+        int64_t begin = similarities_list->value_offset(n);
+        int64_t end = similarities_list->value_offset(n + 1);
+        if (begin == end) {
+          return;
+        }
+        num_nodes_with_results += 1;
+        // Results are sorted, the first is the largest
+        max_similarity.update(similarities->Value(begin));
+        for (int64_t i = begin; i < end; ++i) {
+          total_similarity += similarities->Value(i);
+        }
+      },
+      katana::loopname("TopKSimilarity Statistics"), katana::no_stats());
+
+  uint64_t num_results = nodes_list->values()->length();
+  return TopKSimilarityStatistics{
+      num_nodes_with_results.reduce(), num_results,
+      num_results > 0 ? max_similarity.reduce() : 0.0,
+      num_results > 0 ? total_similarity.reduce() / num_results : 0.0};
+}
+
+void
+katana::analytics::TopKSimilarityStatistics::Print(std::ostream& os) const {
+  os << "Nodes with results = " << num_nodes_with_results << std::endl;
+  os << "Number of results = " << num_results << std::endl;
+  os << "Maximum similarity = " << max_similarity << std::endl;
+  os << "Average similarity = " << average_similarity << std::endl;
+}
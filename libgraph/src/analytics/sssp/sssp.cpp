@@ -19,6 +19,13 @@
 
 #include "katana/analytics/sssp/sssp.h"
 
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+#include <arrow/api.h>
+
+#include "katana/DynamicBitset.h"
 #include "katana/Reduction.h"
 #include "katana/Statistics.h"
 #include "katana/TypedPropertyGraph.h"
@@ -728,3 +735,562 @@ SsspStatistics::Print(std::ostream& os) const {
   os << "Maximum distance = " << max_distance << std::endl;
   os << "Average distance = " << average_visited_distance << std::endl;
 }
+
+namespace {
+
+using MultiSourceGraph = katana::PropertyGraphViews::BiDirectional;
+using MultiSourceNode = MultiSourceGraph::Node;
+
+/// One bit per source of a MultiSourceSssp batch
+using LaneMask = uint64_t;
+static_assert(
+    katana::analytics::kMultiSourceSsspBatchSize <= sizeof(LaneMask) * 8);
+
+/// The distances of the nodes of pg from a batch of sources, one row of
+/// num_lanes distances per node
+template <typename Weight>
+struct MultiSourceSsspBatch {
+  const MultiSourceGraph& graph;
+  /// With a hop bound, the weight of each in-edge of graph, which rounds
+  /// pull along; otherwise the weight of each out-edge, which delta-stepping
+  /// pushes along
+  const katana::NUMAArray<Weight>& edge_weights;
+  /// Paths longer than this are not followed
+  Weight max_distance;
+  bool hop_bounded;
+  size_t num_lanes{0};
+
+  katana::NUMAArray<Weight> distances;
+
+  /// The nodes whose rows changed in the last round
+  katana::DynamicBitset active;
+  /// The out-neighbors of active nodes, whose rows may change in this round
+  katana::DynamicBitset candidates;
+  std::vector<MultiSourceNode> candidate_queue;
+  /// The new rows of the candidates
+  std::vector<Weight> candidate_rows;
+
+  /// Without a hop bound, the lanes of each node that improved since it was
+  /// last relaxed
+  katana::NUMAArray<LaneMask> changed;
+
+  MultiSourceSsspBatch(
+      const MultiSourceGraph& graph,
+      const katana::NUMAArray<Weight>& edge_weights, Weight max_distance,
+      bool hop_bounded)
+      : graph(graph),
+        edge_weights(edge_weights),
+        max_distance(max_distance),
+        hop_bounded(hop_bounded) {
+    distances.allocateInterleaved(
+        graph.NumNodes() * katana::analytics::kMultiSourceSsspBatchSize);
+    if (hop_bounded) {
+      active.resize(graph.NumNodes());
+      candidates.resize(graph.NumNodes());
+    } else {
+      changed.allocateInterleaved(graph.NumNodes());
+    }
+  }
+
+  Weight* Row(MultiSourceNode n) { return &distances[n * num_lanes]; }
+};
+
+/// The length of a path of length dist extended by an edge of weight, or
+/// infinity if that is longer than max_distance or dist is infinite
+template <typename Weight>
+Weight
+ExtendPath(Weight dist, Weight weight, Weight max_distance) {
+  constexpr Weight kInfinity = SsspImplementation<Weight>::kDistanceInfinity;
+  // Compare before adding, which could overflow for heavy edges
+  if (dist == kInfinity || weight > max_distance ||
+      dist > max_distance - weight) {
+    return kInfinity;
+  }
+  return dist + weight;
+}
+
+void
+ClearBitmap(katana::DynamicBitset* bitmap) {
+  auto& words = bitmap->get_vec();
+  katana::do_all(
+      katana::iterate(size_t{0}, words.size()), [&](size_t w) { words[w] = 0; },
+      katana::no_stats());
+}
+
+/// Recompute the rows of the out-neighbors of active nodes from the rows of
+/// their active in-neighbors. New rows are written to candidate_rows, and
+/// the rows of active nodes are only read, so each round extends paths by
+/// exactly one edge. Each row is owned by one thread and its lanes are
+/// relaxed together without atomics.
+///
+/// @return the number of nodes whose rows changed
+template <typename Weight>
+uint64_t
+MultiSourceSsspRound(MultiSourceSsspBatch<Weight>* batch) {
+  const MultiSourceGraph& graph = batch->graph;
+  size_t num_lanes = batch->num_lanes;
+
+  ClearBitmap(&batch->candidates);
+  std::vector<MultiSourceNode> active_queue;
+  batch->active.AppendOffsets(&active_queue);
+  katana::do_all(
+      katana::iterate(active_queue),
+      [&](const MultiSourceNode& src) {
+        for (auto e : graph.OutEdges(src)) {
+          batch->candidates.set(graph.OutEdgeDst(e));
+        }
+      },
+      katana::steal(), katana::no_stats());
+
+  batch->candidate_queue.clear();
+  batch->candidates.AppendOffsets(&batch->candidate_queue);
+  batch->candidate_rows.resize(batch->candidate_queue.size() * num_lanes);
+
+  katana::do_all(
+      katana::iterate(size_t{0}, batch->candidate_queue.size()),
+      [&](size_t i) {
+        MultiSourceNode dst = batch->candidate_queue[i];
+        Weight* row = &batch->candidate_rows[i * num_lanes];
+        const Weight* old_row = batch->Row(dst);
+        std::copy(old_row, old_row + num_lanes, row);
+        for (auto e : graph.InEdges(dst)) {
+          auto src = graph.InEdgeSrc(e);
+          if (!batch->active.test(src)) {
+            continue;
+          }
+          Weight weight = batch->edge_weights[e];
+          const Weight* src_row = batch->Row(src);
+          for (size_t k = 0; k < num_lanes; ++k) {
+            row[k] = std::min(
+                row[k], ExtendPath(src_row[k], weight, batch->max_distance));
+          }
+        }
+      },
+      katana::steal(), katana::loopname("MultiSourceSssp-pull"));
+
+  // The candidates whose rows improved are active in the next round
+  ClearBitmap(&batch->active);
+  katana::GAccumulator<uint64_t> num_changed;
+  katana::do_all(
+      katana::iterate(size_t{0}, batch->candidate_queue.size()),
+      [&](size_t i) {
+        MultiSourceNode dst = batch->candidate_queue[i];
+        const Weight* row = &batch->candidate_rows[i * num_lanes];
+        Weight* old_row = batch->Row(dst);
+        if (std::equal(row, row + num_lanes, old_row)) {
+          return;
+        }
+        std::copy(row, row + num_lanes, old_row);
+        batch->active.set(dst);
+        num_changed += 1;
+      },
+      katana::no_stats());
+  return num_changed.reduce();
+}
+
+/// Lower *target to value unless it is already lower, and return the value it
+/// had. Rows are plain arrays shared with the rounds, so this uses the
+/// generic GCC atomics rather than std::atomic.
+template <typename T>
+T
+AtomicLower(T* target, T value) {
+  T old;
+  __atomic_load(target, &old, __ATOMIC_RELAXED);
+  while (old > value &&
+         !__atomic_compare_exchange(
+             target, &old, &value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+  return old;
+}
+
+/// Relax a batch by delta-stepping, for paths with any number of hops. A
+/// work item is a node and the smallest of its distances that improved when
+/// it was pushed. Processing a node takes the lanes that improved since it
+/// was last processed and relaxes only those, so an item whose lanes an
+/// earlier item already took does nothing. The rows of the sources must be
+/// set and their lanes marked as changed.
+template <typename Weight>
+void
+MultiSourceSsspDeltaStep(
+    MultiSourceSsspBatch<Weight>* batch,
+    const std::vector<MultiSourceNode>& sources) {
+  using Impl = SsspImplementation<Weight>;
+  using UpdateRequest = typename Impl::UpdateRequest;
+  const MultiSourceGraph& graph = batch->graph;
+
+  katana::InsertBag<UpdateRequest> initial;
+  for (MultiSourceNode source : sources) {
+    initial.push(UpdateRequest(source, 0));
+  }
+
+  katana::for_each(
+      katana::iterate(initial),
+      [&](const UpdateRequest& item, auto& ctx) {
+        // Pairs with the release below, so the lowered distances of the
+        // lanes taken are visible
+        LaneMask lanes = __atomic_exchange_n(
+            &batch->changed[item.src], LaneMask{0}, __ATOMIC_ACQ_REL);
+        if (!lanes) {
+          return;
+        }
+        Weight* src_row = batch->Row(item.src);
+        for (auto e : graph.OutEdges(item.src)) {
+          auto dst = graph.OutEdgeDst(e);
+          Weight weight = batch->edge_weights[e];
+          Weight* dst_row = batch->Row(dst);
+          LaneMask improved = 0;
+          Weight min_dist = Impl::kDistanceInfinity;
+          for (LaneMask m = lanes; m != 0; m &= m - 1) {
+            int k = __builtin_ctzll(m);
+            Weight dist;
+            __atomic_load(&src_row[k], &dist, __ATOMIC_RELAXED);
+            Weight new_dist = ExtendPath(dist, weight, batch->max_distance);
+            if (new_dist < AtomicLower(&dst_row[k], new_dist)) {
+              improved |= LaneMask{1} << k;
+              min_dist = std::min(min_dist, new_dist);
+            }
+          }
+          if (improved) {
+            __atomic_fetch_or(
+                &batch->changed[dst], improved, __ATOMIC_RELEASE);
+            ctx.push(UpdateRequest(dst, min_dist));
+          }
+        }
+      },
+      katana::wl<typename Impl::OBIM>(
+          typename Impl::UpdateRequestIndexer(SsspPlan::kDefaultDelta)),
+      katana::disable_conflict_detection(),
+      katana::loopname("MultiSourceSssp-delta"));
+}
+
+/// Compute the distances from sources [base, base + num_lanes) and copy them
+/// to their columns of output
+template <typename Weight>
+void
+MultiSourceSsspBatchRun(
+    MultiSourceSsspBatch<Weight>* batch, const std::vector<uint32_t>& sources,
+    size_t base, uint32_t max_hops, Weight* output, uint64_t* num_rounds) {
+  constexpr Weight kInfinity = SsspImplementation<Weight>::kDistanceInfinity;
+  const MultiSourceGraph& graph = batch->graph;
+  size_t num_lanes = std::min(
+      sources.size() - base, katana::analytics::kMultiSourceSsspBatchSize);
+  batch->num_lanes = num_lanes;
+
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const MultiSourceNode& n) {
+        Weight* row = batch->Row(n);
+        std::fill(row, row + num_lanes, kInfinity);
+        if (!batch->hop_bounded) {
+          batch->changed[n] = 0;
+        }
+      },
+      katana::no_stats());
+
+  if (!batch->hop_bounded) {
+    std::vector<MultiSourceNode> batch_sources;
+    for (size_t k = 0; k < num_lanes; ++k) {
+      MultiSourceNode source = sources[base + k];
+      batch->Row(source)[k] = 0;
+      if (!batch->changed[source]) {
+        batch_sources.emplace_back(source);
+      }
+      batch->changed[source] |= LaneMask{1} << k;
+    }
+    MultiSourceSsspDeltaStep(batch, batch_sources);
+  } else {
+    ClearBitmap(&batch->active);
+    for (size_t k = 0; k < num_lanes; ++k) {
+      batch->Row(sources[base + k])[k] = 0;
+      batch->active.set(sources[base + k]);
+    }
+
+    for (uint32_t hops = 0; hops < max_hops; ++hops) {
+      ++*num_rounds;
+      if (MultiSourceSsspRound(batch) == 0) {
+        break;
+      }
+    }
+  }
+
+  size_t num_sources = sources.size();
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const MultiSourceNode& n) {
+        const Weight* row = batch->Row(n);
+        std::copy(row, row + num_lanes, output + n * num_sources + base);
+      },
+      katana::no_stats());
+}
+
+template <typename Weight>
+katana::Result<void>
+MultiSourceSsspImpl(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    katana::analytics::MultiSourceSsspBounds bounds) {
+  constexpr Weight kInfinity = SsspImplementation<Weight>::kDistanceInfinity;
+  using ArrowType = typename arrow::CTypeTraits<Weight>::ArrowType;
+  using ArrayType = typename arrow::CTypeTraits<Weight>::ArrayType;
+
+  auto weights = KATANA_CHECKED(
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name));
+
+  uint64_t num_nodes = pg->NumNodes();
+  uint64_t num_sources = sources.size();
+  uint64_t num_distances = num_nodes * num_sources;
+
+  katana::ReportPageAllocGuard page_alloc;
+
+  auto offsets_buffer = KATANA_CHECKED(
+      arrow::AllocateBuffer((num_nodes + 1) * sizeof(int64_t)));
+  auto distances_buffer =
+      KATANA_CHECKED(arrow::AllocateBuffer(num_distances * sizeof(Weight)));
+  auto* offsets = reinterpret_cast<int64_t*>(offsets_buffer->mutable_data());
+  auto* distances = reinterpret_cast<Weight*>(distances_buffer->mutable_data());
+  katana::do_all(
+      katana::iterate(uint64_t{0}, num_nodes + 1),
+      [&](uint64_t n) { offsets[n] = n * num_sources; }, katana::no_stats());
+
+  MultiSourceGraph graph = pg->BuildView<MultiSourceGraph>();
+
+  // Rounds, which a hop bound needs, pull along in-edges; otherwise
+  // delta-stepping pushes along out-edges. Read the weights in the order
+  // the chosen one visits edges.
+  bool hop_bounded = bounds.max_hops != std::numeric_limits<uint32_t>::max();
+  katana::NUMAArray<Weight> edge_weights;
+  edge_weights.allocateInterleaved(graph.NumEdges());
+  katana::GReduceLogicalOr has_negative;
+  auto read_weight = [&](uint64_t e, uint64_t property_index) {
+    Weight weight = weights->Value(property_index);
+    if constexpr (std::is_signed_v<Weight>) {
+      has_negative.update(weight < 0);
+    }
+    edge_weights[e] = weight;
+  };
+  katana::do_all(
+      katana::iterate(graph),
+      [&](const MultiSourceNode& n) {
+        if (hop_bounded) {
+          for (auto e : graph.InEdges(n)) {
+            read_weight(e, graph.GetEdgePropertyIndexFromInEdge(e));
+          }
+        } else {
+          for (auto e : graph.OutEdges(n)) {
+            read_weight(e, graph.GetEdgePropertyIndexFromOutEdge(e));
+          }
+        }
+      },
+      katana::steal(), katana::no_stats());
+  // Neither rounds nor delta-stepping are correct with negative weights
+  if (has_negative.reduce()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "edge weights in {} must not be negative", edge_weight_property_name);
+  }
+
+  Weight max_distance = kInfinity;
+  if (bounds.max_distance < static_cast<double>(kInfinity)) {
+    max_distance = static_cast<Weight>(bounds.max_distance);
+  }
+
+  katana::StatTimer exec_time("MultiSourceSssp");
+  exec_time.start();
+
+  MultiSourceSsspBatch<Weight> batch(
+      graph, edge_weights, max_distance, hop_bounded);
+  uint64_t num_rounds = 0;
+  for (size_t base = 0; base < num_sources;
+       base += katana::analytics::kMultiSourceSsspBatchSize) {
+    MultiSourceSsspBatchRun(
+        &batch, sources, base, bounds.max_hops, distances, &num_rounds);
+  }
+
+  exec_time.stop();
+  katana::ReportStatSingle("MultiSourceSssp", "Rounds", num_rounds);
+
+  auto distances_array = std::make_shared<arrow::LargeListArray>(
+      arrow::large_list(arrow::TypeTraits<ArrowType>::type_singleton()),
+      num_nodes, std::move(offsets_buffer),
+      std::make_shared<ArrayType>(num_distances, std::move(distances_buffer)));
+  auto table = arrow::Table::Make(
+      arrow::schema({arrow::field(
+          output_property_name, distances_array->type())}),
+      {distances_array});
+  return pg->AddNodeProperties(table, txn_ctx);
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MultiSourceSssp(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name, katana::TxnContext* txn_ctx,
+    MultiSourceSsspBounds bounds) {
+  if (sources.empty()) {
+    return KATANA_ERROR(ErrorCode::InvalidArgument, "no source nodes");
+  }
+  for (uint32_t source : sources) {
+    if (source >= pg->NumNodes()) {
+      return KATANA_ERROR(
+          ErrorCode::InvalidArgument, "source node {} does not exist",
+          source);
+    }
+  }
+  if (bounds.max_distance < 0) {
+    return KATANA_ERROR(
+        ErrorCode::InvalidArgument, "max_distance must not be negative");
+  }
+
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return MultiSourceSsspImpl<uint32_t>(
+        pg, sources, edge_weight_property_name, output_property_name, txn_ctx,
+        bounds);
+  case arrow::Int32Type::type_id:
+    return MultiSourceSsspImpl<int32_t>(
+        pg, sources, edge_weight_property_name, output_property_name, txn_ctx,
+        bounds);
+  case arrow::UInt64Type::type_id:
+    return MultiSourceSsspImpl<uint64_t>(
+        pg, sources, edge_weight_property_name, output_property_name, txn_ctx,
+        bounds);
+  case arrow::Int64Type::type_id:
+    return MultiSourceSsspImpl<int64_t>(
+        pg, sources, edge_weight_property_name, output_property_name, txn_ctx,
+        bounds);
+  case arrow::FloatType::type_id:
+    return MultiSourceSsspImpl<float>(
+        pg, sources, edge_weight_property_name, output_property_name, txn_ctx,
+        bounds);
+  case arrow::DoubleType::type_id:
+    return MultiSourceSsspImpl<double>(
+        pg, sources, edge_weight_property_name, output_property_name, txn_ctx,
+        bounds);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
+
+namespace {
+
+template <typename Weight>
+katana::Result<void>
+MultiSourceSsspValidateImpl(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  constexpr Weight kInfinity = SsspImplementation<Weight>::kDistanceInfinity;
+  using ArrayType = typename arrow::CTypeTraits<Weight>::ArrayType;
+
+  auto weights = KATANA_CHECKED(
+      pg->GetEdgePropertyTyped<Weight>(edge_weight_property_name));
+  auto property = KATANA_CHECKED(pg->GetNodeProperty(output_property_name));
+  size_t num_sources = sources.size();
+  if (property->num_chunks() != 1 ||
+      property->type()->id() != arrow::Type::LARGE_LIST) {
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError,
+        "property {} must be a single chunk of large_list",
+        output_property_name);
+  }
+  auto list =
+      std::static_pointer_cast<arrow::LargeListArray>(property->chunk(0));
+  auto distances = std::dynamic_pointer_cast<ArrayType>(list->values());
+  if (!distances || list->value_offset(pg->NumNodes()) !=
+                        static_cast<int64_t>(pg->NumNodes() * num_sources)) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "property {} must hold a distance per source for every node",
+        output_property_name);
+  }
+
+  MultiSourceGraph graph = pg->BuildView<MultiSourceGraph>();
+  auto distance = [&](MultiSourceNode n, size_t i) {
+    return distances->Value(list->value_offset(n) + i);
+  };
+
+  // A node is at distance d from a source if no in-neighbor offers a
+  // shorter path and some in-neighbor offers a path of length d
+  auto is_bad = [&](const MultiSourceNode& n) {
+    for (size_t i = 0; i < num_sources; ++i) {
+      Weight n_distance = distance(n, i);
+      bool is_source = sources[i] == n;
+      if (is_source && n_distance != 0) {
+        return true;
+      }
+      bool found_parent = is_source;
+      for (auto e : graph.InEdges(n)) {
+        Weight src_distance = distance(graph.InEdgeSrc(e), i);
+        if (src_distance == kInfinity) {
+          continue;
+        }
+        Weight new_distance =
+            src_distance +
+            weights->Value(graph.GetEdgePropertyIndexFromInEdge(e));
+        if (new_distance < n_distance) {
+          return true;
+        }
+        found_parent |= new_distance == n_distance;
+      }
+      if (n_distance != kInfinity && !found_parent) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  if (katana::ParallelSTL::find_if(pg->begin(), pg->end(), is_bad) !=
+      pg->end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::AssertionFailed,
+        "found a node whose distance does not follow from its in-neighbors");
+  }
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+katana::Result<void>
+katana::analytics::MultiSourceSsspAssertValid(
+    PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    const std::string& edge_weight_property_name,
+    const std::string& output_property_name) {
+  switch (KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+              ->type()
+              ->id()) {
+  case arrow::UInt32Type::type_id:
+    return MultiSourceSsspValidateImpl<uint32_t>(
+        pg, sources, edge_weight_property_name, output_property_name);
+  case arrow::Int32Type::type_id:
+    return MultiSourceSsspValidateImpl<int32_t>(
+        pg, sources, edge_weight_property_name, output_property_name);
+  case arrow::UInt64Type::type_id:
+    return MultiSourceSsspValidateImpl<uint64_t>(
+        pg, sources, edge_weight_property_name, output_property_name);
+  case arrow::Int64Type::type_id:
+    return MultiSourceSsspValidateImpl<int64_t>(
+        pg, sources, edge_weight_property_name, output_property_name);
+  case arrow::FloatType::type_id:
+    return MultiSourceSsspValidateImpl<float>(
+        pg, sources, edge_weight_property_name, output_property_name);
+  case arrow::DoubleType::type_id:
+    return MultiSourceSsspValidateImpl<double>(
+        pg, sources, edge_weight_property_name, output_property_name);
+  default:
+    return KATANA_ERROR(
+        katana::ErrorCode::TypeError, "Unsupported type: {}",
+        KATANA_CHECKED(pg->GetEdgeProperty(edge_weight_property_name))
+            ->type()
+            ->ToString());
+  }
+}
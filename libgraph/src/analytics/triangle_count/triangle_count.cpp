@@ -19,6 +19,7 @@
 
 #include "katana/analytics/triangle_count/triangle_count.h"
 
+#include "katana/analytics/SortedIntersection.h"
 #include "katana/analytics/Utils.h"
 
 using namespace katana::analytics;
@@ -59,31 +60,6 @@ LowerBound(Iterator first, Iterator last, Compare comp) {
   return first;
 }
 
-/**
- * std::set_intersection over edge_iterators.
- */
-template <typename G>
-size_t
-CountEqual(
-    const G& g, typename G::edge_iterator aa, typename G::edge_iterator ea,
-    typename G::edge_iterator bb, typename G::edge_iterator eb) {
-  size_t retval = 0;
-  while (aa != ea && bb != eb) {
-    typename G::Node a = g.OutEdgeDst(*aa);
-    typename G::Node b = g.OutEdgeDst(*bb);
-    if (a < b) {
-      ++aa;
-    } else if (b < a) {
-      ++bb;
-    } else {
-      retval += 1;
-      ++aa;
-      ++bb;
-    }
-  }
-  return retval;
-}
-
 template <typename G>
 struct LessThan {
   const G& g;
@@ -159,26 +135,18 @@ void
 OrderedCountFunc(
     const SortedGraphView* graph, Node n,
     katana::GAccumulator<size_t>& numTriangles) {
+  const Node* n_dsts = graph->OutEdgeDsts(n);
+  const Node* n_end = n_dsts + graph->OutDegree(n);
   size_t numTriangles_local = 0;
-  for (auto edges_n : graph->OutEdges(n)) {
-    Node v = graph->OutEdgeDst(edges_n);
-    if (v > n) {
-      break;
-    }
-    edge_iterator it_n = graph->OutEdges(n).begin();
-
-    for (auto edges_v : graph->OutEdges(v)) {
-      auto dst_v = graph->OutEdgeDst(edges_v);
-      if (dst_v > v) {
-        break;
-      }
-      while (graph->OutEdgeDst(*it_n) < dst_v) {
-        it_n++;
-      }
-      if (dst_v == graph->OutEdgeDst(*it_n)) {
-        numTriangles_local += 1;
-      }
-    }
+  for (const Node* it = n_dsts; it != n_end && *it <= n; ++it) {
+    Node v = *it;
+    // Count w <= v adjacent to both n and v; since edges are sorted, the
+    // candidates in n's list are the ones up to and including v
+    const Node* v_dsts = graph->OutEdgeDsts(v);
+    const Node* v_end =
+        std::upper_bound(v_dsts, v_dsts + graph->OutDegree(v), v);
+    numTriangles_local +=
+        CountIntersection(n_dsts, it - n_dsts + 1, v_dsts, v_end - v_dsts);
   }
   numTriangles += numTriangles_local;
 }
@@ -239,21 +207,17 @@ EdgeIteratingAlgo(const SortedGraphView* graph) {
       [&](const WorkItem& w) {
         // Compute intersection of range (w.src, w.dst) in neighbors of
         // w.src and w.dst
-        edge_iterator abegin = graph->OutEdges(w.src).begin();
-        edge_iterator aend = graph->OutEdges(w.src).end();
-        edge_iterator bbegin = graph->OutEdges(w.dst).begin();
-        edge_iterator bend = graph->OutEdges(w.dst).end();
+        const Node* a = graph->OutEdgeDsts(w.src);
+        const Node* a_end = a + graph->OutDegree(w.src);
+        const Node* b = graph->OutEdgeDsts(w.dst);
+        const Node* b_end = b + graph->OutDegree(w.dst);
 
-        edge_iterator aa = LowerBound(
-            abegin, aend, GreaterThanOrEqual<SortedGraphView>(*graph, w.src));
-        edge_iterator ea =
-            LowerBound(abegin, aend, LessThan<SortedGraphView>(*graph, w.dst));
-        edge_iterator bb = LowerBound(
-            bbegin, bend, GreaterThanOrEqual<SortedGraphView>(*graph, w.src));
-        edge_iterator eb =
-            LowerBound(bbegin, bend, LessThan<SortedGraphView>(*graph, w.dst));
+        const Node* aa = std::upper_bound(a, a_end, w.src);
+        const Node* ea = std::lower_bound(aa, a_end, w.dst);
+        const Node* bb = std::upper_bound(b, b_end, w.src);
+        const Node* eb = std::lower_bound(bb, b_end, w.dst);
 
-        numTriangles += CountEqual(*graph, aa, ea, bb, eb);
+        numTriangles += CountIntersection(aa, ea - aa, bb, eb - bb);
       },
       katana::loopname("TriangleCount_EdgeIteratingAlgo"),
       katana::chunk_size<kChunkSize>(), katana::steal());
@@ -1,15 +1,21 @@
+#include <thread>
+#include <vector>
+
 #include <arrow/api.h>
 #include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
 #include "katana/Logging.h"
+#include "katana/MemorySupervisor.h"
 #include "katana/PropertyGraph.h"
+#include "katana/PropertyManager.h"
 #include "katana/SharedMemSys.h"
 #include "katana/URI.h"
 
 namespace {
 
 namespace fs = boost::filesystem;
+using katana::count_t;
 std::string command_line;
 
 template <typename T>
@@ -349,6 +355,119 @@ TestRoundTrip() {
   }
 }
 
+void
+TestLazyProperties() {
+  constexpr size_t test_length = 10;
+  using ValueType = int32_t;
+  katana::TxnContext txn_ctx;
+
+  RandomPolicy policy{1};
+  auto g = MakeFileGraph<uint32_t>(test_length, 0, &policy, &txn_ctx);
+
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      MakeProps<ValueType>("node-name", test_length), &txn_ctx));
+  KATANA_LOG_ASSERT(g->AddEdgeProperties(
+      MakeProps<ValueType>("edge-name", test_length), &txn_ctx));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+
+  auto write_result = g->Write(rdg_dir, command_line);
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  katana::RDGLoadOptions opts;
+  opts.lazy_properties = true;
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, &txn_ctx, opts);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  katana::PropertyManager manager;
+  g2->set_property_manager(&manager);
+
+  // Nothing is loaded until asked for
+  KATANA_LOG_ASSERT(g2->lazy_properties());
+  KATANA_LOG_ASSERT(g2->GetNumNodeProperties() == 0);
+  KATANA_LOG_ASSERT(g2->GetNumEdgeProperties() == 0);
+  KATANA_LOG_ASSERT(g2->ListFullNodeProperties().size() == 1);
+
+  // Concurrent first accesses load the column once and agree on it
+  constexpr int kNumThreads = 4;
+  std::vector<std::shared_ptr<arrow::ChunkedArray>> seen(kNumThreads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&g2, &seen, i]() {
+      auto res = g2->GetNodeProperty("node-name");
+      KATANA_LOG_ASSERT(res);
+      seen[i] = res.value();
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (const auto& col : seen) {
+    KATANA_LOG_ASSERT(col == seen[0]);
+  }
+  KATANA_LOG_ASSERT(g2->GetNumNodeProperties() == 1);
+  KATANA_LOG_ASSERT(g2->GetNumEdgeProperties() == 0);
+
+  auto edge_res = g2->GetEdgeProperty("edge-name");
+  KATANA_LOG_ASSERT(edge_res);
+  KATANA_LOG_ASSERT(g2->GetNumEdgeProperties() == 1);
+
+  auto node_data =
+      std::static_pointer_cast<arrow::Int32Array>(seen[0]->chunk(0));
+  auto edge_data =
+      std::static_pointer_cast<arrow::Int32Array>(edge_res.value()->chunk(0));
+  ValueType value{};
+  for (size_t i = 0; i < test_length; ++i) {
+    KATANA_LOG_ASSERT(node_data->Value(i) == value);
+    KATANA_LOG_ASSERT(edge_data->Value(i) == value);
+    ++value;
+  }
+
+  auto missing_res = g2->GetNodeProperty("no-such-property");
+  KATANA_LOG_ASSERT(
+      !missing_res &&
+      missing_res.error() == katana::ErrorCode::PropertyNotFound);
+
+  auto& supervisor = katana::MemorySupervisor::Get();
+  count_t node_bytes = katana::ApproxTableMemUse(
+      arrow::Table::Make(g2->loaded_node_schema(), {seen[0]}));
+  KATANA_LOG_ASSERT(supervisor.GetActive() >= node_bytes);
+
+  // Unloaded properties wait in standby memory and come back from there on
+  // the next access
+  KATANA_LOG_ASSERT(g2->UnloadNodeProperty("node-name"));
+  KATANA_LOG_ASSERT(g2->GetNumNodeProperties() == 0);
+  KATANA_LOG_ASSERT(supervisor.GetStandby() == node_bytes);
+  auto reload_res = g2->GetNodeProperty("node-name");
+  KATANA_LOG_ASSERT(reload_res && reload_res.value() == seen[0]);
+  KATANA_LOG_ASSERT(g2->GetNumNodeProperties() == 1);
+  KATANA_LOG_ASSERT(supervisor.GetStandby() == 0);
+
+  // Once reclaimed, they are read from storage again
+  KATANA_LOG_ASSERT(g2->UnloadNodeProperty("node-name"));
+  count_t budget = supervisor.GetMemoryBudget();
+  supervisor.SetMemoryBudget(supervisor.GetActive());
+  KATANA_LOG_ASSERT(supervisor.GetStandby() == 0);
+  supervisor.SetMemoryBudget(budget);
+  reload_res = g2->GetNodeProperty("node-name");
+  KATANA_LOG_ASSERT(reload_res && reload_res.value() != seen[0]);
+  KATANA_LOG_ASSERT(reload_res.value()->Equals(*seen[0]));
+
+  KATANA_LOG_ASSERT(g2->UnloadNodeProperty("node-name"));
+  KATANA_LOG_ASSERT(g2->UnloadEdgeProperty("edge-name"));
+
+  fs::remove_all(rdg_dir);
+}
+
 void
 TestGarbageMetadata() {
   auto uri_res = katana::Uri::MakeRand("/tmp/propertyfilegraph");
@@ -471,6 +590,7 @@ main(int argc, char** argv) {
   command_line = cmdout.str();
 
   TestRoundTrip();
+  TestLazyProperties();
   TestGarbageMetadata();
   TestSimplePGs();
   TestTopologyAccess();
@@ -0,0 +1,138 @@
+#include <random>
+#include <string>
+
+#include <arrow/api.h>
+
+#include "katana/BuildGraph.h"
+#include "katana/Logging.h"
+#include "katana/PropertyGraph.h"
+#include "katana/SharedMemSys.h"
+#include "katana/Threads.h"
+
+namespace {
+
+constexpr uint32_t kNumNodes = 500;
+// Edges also name nodes that were never added, which Finish creates
+constexpr uint32_t kNumIDs = 600;
+constexpr uint32_t kNumEdges = 6000;
+
+katana::ImportData
+MakeInt(int64_t value) {
+  katana::ImportData data(katana::ImportDataType::kInt64, false);
+  data.value = value;
+  return data;
+}
+
+katana::ImportData
+MakeString(std::string value) {
+  katana::ImportData data(katana::ImportDataType::kString, false);
+  data.value = std::move(value);
+  return data;
+}
+
+/// Build the same random graph with num_threads threads. Chunks are small
+/// so that property columns span many chunks.
+std::unique_ptr<katana::PropertyGraph>
+Build(unsigned num_threads) {
+  katana::setActiveThreads(num_threads);
+
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<uint32_t> id(0, kNumIDs - 1);
+  katana::PropertyGraphBuilder pgb(64);
+  using katana::PropertyKey;
+
+  PropertyKey value_pk(
+      "value", true, false, "value", katana::ImportDataType::kInt64, false);
+  for (uint32_t i = 0; i < kNumNodes; ++i) {
+    KATANA_LOG_ASSERT(pgb.StartNode("n" + std::to_string(i)));
+    pgb.AddLabel(i % 2 == 0 ? "even" : "odd");
+    // Leave some values null
+    if (i % 3 != 0) {
+      pgb.AddValue(
+          "value", [&]() { return value_pk; },
+          [i](katana::ImportDataType, bool) { return MakeInt(i); });
+    }
+    pgb.FinishNode();
+  }
+
+  PropertyKey weight_pk(
+      "weight", false, true, "weight", katana::ImportDataType::kInt64, false);
+  PropertyKey name_pk(
+      "name", false, true, "name", katana::ImportDataType::kString, false);
+  for (uint32_t i = 0; i < kNumEdges; ++i) {
+    uint32_t src = id(gen);
+    uint32_t dst = id(gen);
+    KATANA_LOG_ASSERT(pgb.StartEdge(
+        "n" + std::to_string(src), "n" + std::to_string(dst)));
+    pgb.AddLabel(i % 3 == 0 ? "a" : "b");
+    pgb.AddValue(
+        "weight", [&]() { return weight_pk; },
+        [i](katana::ImportDataType, bool) { return MakeInt(i); });
+    if (i % 5 != 0) {
+      pgb.AddValue(
+          "name", [&]() { return name_pk; },
+          [i](katana::ImportDataType, bool) {
+            return MakeString("e" + std::to_string(i));
+          });
+    }
+    pgb.FinishEdge();
+  }
+
+  auto components_result = pgb.Finish(false);
+  KATANA_LOG_VASSERT(
+      components_result, "Failed to construct graph: {}",
+      components_result.error());
+  katana::TxnContext txn_ctx;
+  auto graph_result = katana::ConvertToPropertyGraph(
+      std::move(components_result.value()), &txn_ctx);
+  KATANA_LOG_VASSERT(
+      graph_result, "Failed to construct graph: {}", graph_result.error());
+  return std::move(graph_result.value());
+}
+
+void
+CheckSameChunks(
+    const std::shared_ptr<arrow::ChunkedArray>& a,
+    const std::shared_ptr<arrow::ChunkedArray>& b) {
+  KATANA_LOG_ASSERT(a->num_chunks() == b->num_chunks());
+  for (int i = 0; i < a->num_chunks(); ++i) {
+    KATANA_LOG_ASSERT(a->chunk(i)->length() == b->chunk(i)->length());
+  }
+}
+
+/// A parallel Finish numbers nodes and edges exactly like a serial one
+void
+TestDeterministicFinish() {
+  auto serial = Build(1);
+  unsigned num_threads = katana::setActiveThreads(8);
+  auto parallel = Build(num_threads);
+
+  KATANA_LOG_ASSERT(
+      serial->NumNodes() > kNumNodes && serial->NumNodes() <= kNumIDs);
+  KATANA_LOG_ASSERT(serial->NumEdges() == kNumEdges);
+  KATANA_LOG_ASSERT(serial->topology().Equals(parallel->topology()));
+  KATANA_LOG_ASSERT(
+      serial->full_node_schema()->Equals(*parallel->full_node_schema()));
+  KATANA_LOG_ASSERT(
+      serial->full_edge_schema()->Equals(*parallel->full_edge_schema()));
+  KATANA_LOG_ASSERT(serial->GetNodeProperty("value").value()->Equals(
+      parallel->GetNodeProperty("value").value()));
+  for (const auto& name : {"weight", "name"}) {
+    auto a = serial->GetEdgeProperty(name).value();
+    auto b = parallel->GetEdgeProperty(name).value();
+    KATANA_LOG_VASSERT(a->Equals(b), "edge property {} differs", name);
+    CheckSameChunks(a, b);
+  }
+  KATANA_LOG_ASSERT(serial->Equals(parallel.get()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestDeterministicFinish();
+
+  return 0;
+}
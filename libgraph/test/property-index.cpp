@@ -1,17 +1,31 @@
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
 #include <arrow/api.h>
 #include <arrow/type.h>
 #include <arrow/type_traits.h>
+#include <boost/filesystem.hpp>
 
 #include "TestTypedPropertyGraph.h"
 #include "katana/EntityIndex.h"
 #include "katana/Logging.h"
 #include "katana/Properties.h"
 #include "katana/SharedMemSys.h"
+#include "katana/URI.h"
+
+namespace fs = boost::filesystem;
 
 template <typename node_or_edge>
 struct NodeOrEdge {
   static katana::Result<katana::EntityIndex<node_or_edge>*> MakeIndex(
+      katana::PropertyGraph* pg, const std::string& column_name,
+      katana::EntityIndexKind kind = katana::EntityIndexKind::kSorted);
+  static katana::Result<katana::EntityIndex<node_or_edge>*> GetIndex(
       katana::PropertyGraph* pg, const std::string& column_name);
+  static katana::Result<katana::EntityIndex<node_or_edge>*> GetIndex(
+      katana::PropertyGraph* pg, const std::string& column_name,
+      katana::EntityIndexKind kind);
   static katana::Result<void> AddProperties(
       katana::PropertyGraph* pg, std::shared_ptr<arrow::Table> properties,
       katana::TxnContext* txn_ctx);
@@ -23,14 +37,16 @@ using Edge = NodeOrEdge<katana::GraphTopology::Edge>;
 
 template <>
 katana::Result<katana::EntityIndex<katana::GraphTopology::Node>*>
-Node::MakeIndex(katana::PropertyGraph* pg, const std::string& column_name) {
-  auto result = pg->MakeNodeIndex(column_name);
+Node::MakeIndex(
+    katana::PropertyGraph* pg, const std::string& column_name,
+    katana::EntityIndexKind kind) {
+  auto result = pg->MakeNodeIndex(column_name, kind);
   if (!result) {
     return result.error();
   }
 
   for (const auto& index : pg->node_indexes()) {
-    if (index->column_name() == column_name) {
+    if (index->column_name() == column_name && index->kind() == kind) {
       return index.get();
     }
   }
@@ -40,14 +56,16 @@ Node::MakeIndex(katana::PropertyGraph* pg, const std::string& column_name) {
 
 template <>
 katana::Result<katana::EntityIndex<katana::GraphTopology::Edge>*>
-Edge::MakeIndex(katana::PropertyGraph* pg, const std::string& column_name) {
-  auto result = pg->MakeEdgeIndex(column_name);
+Edge::MakeIndex(
+    katana::PropertyGraph* pg, const std::string& column_name,
+    katana::EntityIndexKind kind) {
+  auto result = pg->MakeEdgeIndex(column_name, kind);
   if (!result) {
     return result.error();
   }
 
   for (const auto& index : pg->edge_indexes()) {
-    if (index->column_name() == column_name) {
+    if (index->column_name() == column_name && index->kind() == kind) {
       return index.get();
     }
   }
@@ -55,6 +73,34 @@ Edge::MakeIndex(katana::PropertyGraph* pg, const std::string& column_name) {
   return KATANA_ERROR(katana::ErrorCode::NotFound, "Created index not found");
 }
 
+template <>
+katana::Result<katana::EntityIndex<katana::GraphTopology::Node>*>
+Node::GetIndex(katana::PropertyGraph* pg, const std::string& column_name) {
+  return pg->GetNodeIndex(column_name);
+}
+
+template <>
+katana::Result<katana::EntityIndex<katana::GraphTopology::Node>*>
+Node::GetIndex(
+    katana::PropertyGraph* pg, const std::string& column_name,
+    katana::EntityIndexKind kind) {
+  return pg->GetNodeIndex(column_name, kind);
+}
+
+template <>
+katana::Result<katana::EntityIndex<katana::GraphTopology::Edge>*>
+Edge::GetIndex(katana::PropertyGraph* pg, const std::string& column_name) {
+  return pg->GetEdgeIndex(column_name);
+}
+
+template <>
+katana::Result<katana::EntityIndex<katana::GraphTopology::Edge>*>
+Edge::GetIndex(
+    katana::PropertyGraph* pg, const std::string& column_name,
+    katana::EntityIndexKind kind) {
+  return pg->GetEdgeIndex(column_name, kind);
+}
+
 template <>
 size_t
 Node::num_entities(katana::PropertyGraph* pg) {
@@ -273,6 +319,227 @@ TestStringIndex(size_t num_nodes, size_t line_width) {
   KATANA_LOG_ASSERT(typed_prop->GetView(*it) == "aaam");
 }
 
+template <typename node_or_edge, typename DataType>
+void
+TestHashIndex(size_t num_nodes, size_t line_width) {
+  constexpr bool kIsString = std::is_same_v<DataType, std::string_view>;
+  using IndexType = katana::HashEntityIndex<node_or_edge, DataType>;
+
+  LinePolicy policy{line_width};
+
+  katana::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy, &txn_ctx);
+  size_t num_entities = NodeOrEdge<node_or_edge>::num_entities(g.get());
+
+  auto make_prop = [&](const std::string& name, bool uniform) {
+    if constexpr (kIsString) {
+      return CreateStringProperty(name, uniform, num_entities);
+    } else {
+      return CreatePrimitiveProperty<DataType>(name, uniform, num_entities);
+    }
+  };
+  std::shared_ptr<arrow::Table> uniform_prop = make_prop("uniform", true);
+  std::shared_ptr<arrow::Table> nonuniform_prop =
+      make_prop("nonuniform", false);
+  KATANA_LOG_ASSERT(
+      NodeOrEdge<node_or_edge>::AddProperties(g.get(), uniform_prop, &txn_ctx));
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::AddProperties(
+      g.get(), nonuniform_prop, &txn_ctx));
+
+  auto uniform_index_result = NodeOrEdge<node_or_edge>::MakeIndex(
+      g.get(), "uniform", katana::EntityIndexKind::kHash);
+  KATANA_LOG_VASSERT(
+      uniform_index_result, "Could not create index: {}",
+      uniform_index_result.error());
+  auto nonuniform_index_result = NodeOrEdge<node_or_edge>::MakeIndex(
+      g.get(), "nonuniform", katana::EntityIndexKind::kHash);
+  KATANA_LOG_VASSERT(
+      nonuniform_index_result, "Could not create index: {}",
+      nonuniform_index_result.error());
+
+  auto* uniform_index = static_cast<IndexType*>(uniform_index_result.value());
+  auto* nonuniform_index =
+      static_cast<IndexType*>(nonuniform_index_result.value());
+
+  DataType first_key{};
+  DataType missing_key{};
+  if constexpr (kIsString) {
+    first_key = "aaaa";
+    missing_key = "aaab";
+  } else {
+    first_key = 42;
+    missing_key = 43;
+  }
+
+  // Every entity has the same key in the uniform index.
+  KATANA_LOG_ASSERT(uniform_index->num_keys() == 1);
+  KATANA_LOG_ASSERT(uniform_index->Find(missing_key) == uniform_index->end());
+  auto [first, last] = uniform_index->EqualRange(first_key);
+  std::vector<bool> found(num_entities, false);
+  for (auto it = first; it != last; ++it) {
+    node_or_edge id = *it;
+    KATANA_LOG_VASSERT(id < num_entities, "Invalid id: {}", id);
+    KATANA_LOG_VASSERT(!found[id], "Duplicate id: {}", id);
+    found[id] = true;
+  }
+  for (node_or_edge id = 0; id < num_entities; ++id) {
+    KATANA_LOG_VASSERT(found[id], "Not in index: {}", id);
+  }
+
+  // Every key in the non-uniform index is distinct and finds its entity.
+  KATANA_LOG_ASSERT(nonuniform_index->num_keys() == num_entities);
+  KATANA_LOG_ASSERT(
+      nonuniform_index->Find(missing_key) == nonuniform_index->end());
+  auto typed_prop = std::static_pointer_cast<
+      typename IndexType::ArrowArrayType>(nonuniform_prop->column(0)->chunk(0));
+  for (node_or_edge id = 0; id < num_entities; ++id) {
+    DataType key{};
+    if constexpr (kIsString) {
+      auto view = typed_prop->GetView(id);
+      key = std::string_view(view.data(), view.length());
+    } else {
+      key = typed_prop->Value(id);
+    }
+    auto [key_first, key_last] = nonuniform_index->EqualRange(key);
+    KATANA_LOG_ASSERT(key_last - key_first == 1);
+    KATANA_LOG_VASSERT(
+        *key_first == id, "Found {}, expected {}", *key_first, id);
+  }
+
+  // Sorted and hash indexes over the same column coexist.
+  KATANA_LOG_ASSERT(NodeOrEdge<node_or_edge>::MakeIndex(g.get(), "uniform"));
+  KATANA_LOG_ASSERT(!NodeOrEdge<node_or_edge>::MakeIndex(
+      g.get(), "uniform", katana::EntityIndexKind::kHash));
+
+  // Lookups without a kind find the sorted index even though the hash index
+  // was made first; a column with only a hash index has no sorted one.
+  auto sorted_result = NodeOrEdge<node_or_edge>::GetIndex(g.get(), "uniform");
+  KATANA_LOG_ASSERT(sorted_result);
+  KATANA_LOG_ASSERT(
+      sorted_result.value()->kind() == katana::EntityIndexKind::kSorted);
+  auto hash_result = NodeOrEdge<node_or_edge>::GetIndex(
+      g.get(), "uniform", katana::EntityIndexKind::kHash);
+  KATANA_LOG_ASSERT(hash_result);
+  KATANA_LOG_ASSERT(hash_result.value() == uniform_index);
+  KATANA_LOG_ASSERT(!NodeOrEdge<node_or_edge>::GetIndex(g.get(), "nonuniform"));
+}
+
+// Persist an index next to its stored property and check that recreating
+// the index maps the file and agrees with the index built in memory.
+void
+TestPersistedIndex(size_t num_nodes, size_t line_width) {
+  using IndexType =
+      katana::PrimitiveEntityIndex<katana::GraphTopology::Node, int64_t>;
+
+  LinePolicy policy{line_width};
+  katana::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      CreatePrimitiveProperty<int64_t>("nonuniform", false, g->NumNodes()),
+      &txn_ctx));
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/property-index");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  auto write_result = g->Write(rdg_dir, "property-index");
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, &txn_ctx);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+
+  KATANA_LOG_ASSERT(!g2->PersistNodeIndex("nonuniform"));
+  KATANA_LOG_ASSERT(g2->MakeNodeIndex("nonuniform"));
+  auto built = static_cast<IndexType*>(g2->GetNodeIndex("nonuniform").value());
+  std::vector<katana::GraphTopology::Node> built_ids(
+      built->begin(), built->end());
+  KATANA_LOG_ASSERT(built_ids.size() == g2->NumNodes());
+
+  auto persist_result = g2->PersistNodeIndex("nonuniform");
+  if (!persist_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("persisting index: {}", persist_result.error());
+  }
+  KATANA_LOG_ASSERT(g2->DeleteNodeIndex("nonuniform"));
+
+  KATANA_LOG_ASSERT(g2->MakeNodeIndex("nonuniform"));
+  auto mapped = static_cast<IndexType*>(g2->GetNodeIndex("nonuniform").value());
+  std::vector<katana::GraphTopology::Node> mapped_ids(
+      mapped->begin(), mapped->end());
+  KATANA_LOG_ASSERT(mapped_ids == built_ids);
+
+  auto it = mapped->Find(44);
+  KATANA_LOG_ASSERT(it != mapped->end() && *it == 1);
+  KATANA_LOG_ASSERT(mapped->Find(43) == mapped->end());
+  it = mapped->UpperBound(44);
+  KATANA_LOG_ASSERT(it != mapped->end() && *it == 2);
+
+  fs::remove_all(rdg_dir);
+}
+
+// Writing a graph persists its sorted indexes, which a graph loaded from
+// the write then maps.
+void
+TestIndexWrittenWithGraph(size_t num_nodes, size_t line_width) {
+  using IndexType =
+      katana::PrimitiveEntityIndex<katana::GraphTopology::Node, int64_t>;
+
+  LinePolicy policy{line_width};
+  katana::TxnContext txn_ctx;
+
+  std::unique_ptr<katana::PropertyGraph> g =
+      MakeFileGraph<int64_t>(num_nodes, 0, &policy, &txn_ctx);
+  KATANA_LOG_ASSERT(g->AddNodeProperties(
+      CreatePrimitiveProperty<int64_t>("nonuniform", false, g->NumNodes()),
+      &txn_ctx));
+  KATANA_LOG_ASSERT(g->MakeNodeIndex("nonuniform"));
+  KATANA_LOG_ASSERT(
+      g->MakeNodeIndex("nonuniform", katana::EntityIndexKind::kHash));
+  auto built = static_cast<IndexType*>(g->GetNodeIndex("nonuniform").value());
+  std::vector<katana::GraphTopology::Node> built_ids(
+      built->begin(), built->end());
+
+  auto uri_res = katana::Uri::MakeRand("/tmp/property-index");
+  KATANA_LOG_ASSERT(uri_res);
+  std::string rdg_dir(uri_res.value().path());  // path() because local
+  auto write_result = g->Write(rdg_dir, "property-index");
+  if (!write_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("writing result: {}", write_result.error());
+  }
+
+  // Only the sorted index has a file
+  size_t num_index_files = 0;
+  for (const auto& entry : fs::directory_iterator(rdg_dir)) {
+    num_index_files += entry.path().extension() == ".index";
+  }
+  KATANA_LOG_ASSERT(num_index_files == 1);
+
+  auto make_result = katana::PropertyGraph::Make(rdg_dir, &txn_ctx);
+  if (!make_result) {
+    fs::remove_all(rdg_dir);
+    KATANA_LOG_FATAL("making result: {}", make_result.error());
+  }
+  std::unique_ptr<katana::PropertyGraph> g2 = std::move(make_result.value());
+  KATANA_LOG_ASSERT(g2->MakeNodeIndex("nonuniform"));
+  auto mapped = static_cast<IndexType*>(g2->GetNodeIndex("nonuniform").value());
+  std::vector<katana::GraphTopology::Node> mapped_ids(
+      mapped->begin(), mapped->end());
+  KATANA_LOG_ASSERT(mapped_ids == built_ids);
+
+  fs::remove_all(rdg_dir);
+}
+
 int
 main() {
   katana::SharedMemSys S;
@@ -285,5 +552,14 @@ main() {
   TestStringIndex<katana::GraphTopology::Node>(10, 3);
   TestStringIndex<katana::GraphTopology::Edge>(10, 3);
 
+  TestHashIndex<katana::GraphTopology::Node, int64_t>(10, 3);
+  TestHashIndex<katana::GraphTopology::Edge, int64_t>(10, 3);
+  TestHashIndex<katana::GraphTopology::Node, uint64_t>(1000, 3);
+  TestHashIndex<katana::GraphTopology::Node, std::string_view>(10, 3);
+  TestHashIndex<katana::GraphTopology::Edge, std::string_view>(1000, 3);
+
+  TestPersistedIndex(10, 3);
+  TestIndexWrittenWithGraph(10, 3);
+
   return 0;
 }
@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "katana/Logging.h"
+#include "katana/analytics/SortedIntersection.h"
+
+namespace {
+
+std::vector<uint32_t>
+MakeList(std::mt19937* gen, size_t size, uint32_t range) {
+  std::uniform_int_distribution<uint32_t> dist(0, range - 1);
+  std::vector<uint32_t> list;
+  for (size_t i = 0; i < size; ++i) {
+    list.emplace_back(dist(*gen));
+  }
+  std::sort(list.begin(), list.end());
+  list.erase(std::unique(list.begin(), list.end()), list.end());
+  return list;
+}
+
+void
+Check(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+  std::vector<uint32_t> expected;
+  std::set_intersection(
+      a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+
+  size_t count = katana::analytics::CountIntersection(
+      a.data(), a.size(), b.data(), b.size());
+  KATANA_LOG_VASSERT(
+      count == expected.size(), "{} != {}", count, expected.size());
+
+  std::vector<uint32_t> visited;
+  katana::analytics::ForEachIntersection(
+      a.data(), a.size(), b.data(), b.size(), [&](size_t i, size_t j) {
+        KATANA_LOG_ASSERT(a[i] == b[j]);
+        visited.emplace_back(a[i]);
+        return true;
+      });
+  KATANA_LOG_ASSERT(visited == expected);
+
+  // Stopping early visits a prefix of the intersection
+  size_t num_visited = 0;
+  katana::analytics::ForEachIntersection(
+      a.data(), a.size(), b.data(), b.size(), [&](size_t, size_t) {
+        return ++num_visited < 3;
+      });
+  KATANA_LOG_ASSERT(num_visited == std::min<size_t>(expected.size(), 3));
+
+  uint32_t range = 1;
+  for (const auto& list : {a, b}) {
+    if (!list.empty()) {
+      range = std::max(range, list.back() + 1);
+    }
+  }
+  katana::analytics::NeighborBitmap bitmap(range);
+  bitmap.Load(a.data(), a.size());
+  KATANA_LOG_ASSERT(bitmap.Count(b.data(), b.size()) == expected.size());
+  bitmap.Clear(a.data(), a.size());
+  KATANA_LOG_ASSERT(bitmap.Count(a.data(), a.size()) == 0);
+}
+
+void
+TestIntersection() {
+  std::mt19937 gen(0);
+
+  Check({}, {});
+  Check({1, 2, 3}, {});
+  Check({1, 2, 3}, {4, 5, 6});
+  Check({0, 1, 2, 3, 4, 5, 6, 7}, {0, 1, 2, 3, 4, 5, 6, 7});
+
+  for (size_t trial = 0; trial < 1000; ++trial) {
+    uint32_t range = 64 + gen() % 4096;
+    // Similar sizes exercise the block merge, skewed sizes galloping
+    size_t a_size = gen() % 256;
+    size_t b_size = trial % 4 == 0 ? gen() % 16384 : gen() % 256;
+    Check(MakeList(&gen, a_size, range), MakeList(&gen, b_size, range));
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  TestIntersection();
+
+  return 0;
+}
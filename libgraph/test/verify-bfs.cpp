@@ -0,0 +1,121 @@
+#include <deque>
+#include <limits>
+#include <numeric>
+
+#include <arrow/api.h>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/bfs/bfs.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr uint32_t kUnreached = std::numeric_limits<uint32_t>::max();
+
+/// A random directed graph in which the last nodes have no edges
+std::unique_ptr<katana::PropertyGraph>
+MakeRandomGraph(uint32_t num_nodes, uint32_t num_edges) {
+  katana::RandomGraphOptions options;
+  options.num_nodes = num_nodes;
+  options.num_edges = num_edges;
+  options.num_isolated = 4;
+  return katana::MakeRandomGraph(options);
+}
+
+std::vector<uint32_t>
+SerialBfs(const katana::PropertyGraph& pg, uint32_t source) {
+  const auto& topo = pg.topology();
+  std::vector<uint32_t> levels(pg.NumNodes(), kUnreached);
+  std::deque<uint32_t> queue{source};
+  levels[source] = 0;
+  while (!queue.empty()) {
+    uint32_t n = queue.front();
+    queue.pop_front();
+    for (auto e : topo.OutEdges(n)) {
+      uint32_t dst = topo.OutEdgeDst(e);
+      if (levels[dst] == kUnreached) {
+        levels[dst] = levels[n] + 1;
+        queue.emplace_back(dst);
+      }
+    }
+  }
+  return levels;
+}
+
+void
+RunMultiSourceBfs(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    uint32_t alpha) {
+  katana::TxnContext txn_ctx;
+  auto result = MultiSourceBfs(
+      pg, sources, "levels", &txn_ctx, BfsPlan::SynchronousDirectOpt(alpha));
+  KATANA_LOG_VASSERT(result, "MultiSourceBfs failed: {}", result.error());
+  KATANA_LOG_ASSERT(MultiSourceBfsAssertValid(pg, sources, "levels"));
+
+  auto levels_list = std::static_pointer_cast<arrow::LargeListArray>(
+      pg->GetNodeProperty("levels").value()->chunk(0));
+  auto levels =
+      std::static_pointer_cast<arrow::UInt32Array>(levels_list->values());
+  for (size_t i = 0; i < sources.size(); ++i) {
+    auto expected = SerialBfs(*pg, sources[i]);
+    for (uint32_t n = 0; n < pg->NumNodes(); ++n) {
+      KATANA_LOG_ASSERT(
+          levels_list->value_length(n) ==
+          static_cast<int64_t>(sources.size()));
+      uint32_t level = levels->Value(levels_list->value_offset(n) + i);
+      KATANA_LOG_VASSERT(
+          level == expected[n], "node {} from {}: found {}, expected {}", n,
+          sources[i], level, expected[n]);
+    }
+  }
+
+  // The levels are not valid for other sources
+  std::vector<uint32_t> shifted(sources);
+  shifted[0] = (shifted[0] + 1) % pg->NumNodes();
+  KATANA_LOG_ASSERT(!MultiSourceBfsAssertValid(pg, shifted, "levels"));
+
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("levels", &txn_ctx));
+}
+
+void
+RunAll(std::unique_ptr<katana::PropertyGraph>&& pg) {
+  std::vector<uint32_t> all(pg->NumNodes());
+  std::iota(all.begin(), all.end(), 0);
+  // Duplicates and more sources than one batch, so the last batch is
+  // partly used
+  all.emplace_back(0);
+  all.emplace_back(all.size() / 2);
+
+  // A small alpha stays top-down, a large one goes bottom-up early
+  for (uint32_t alpha : {1, 15, 1000}) {
+    RunMultiSourceBfs(pg.get(), {0}, alpha);
+    RunMultiSourceBfs(pg.get(), all, alpha);
+  }
+}
+
+void
+TestInvalid() {
+  auto pg = katana::MakeGrid(3, 3, false);
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(!MultiSourceBfs(pg.get(), {}, "levels", &txn_ctx));
+  KATANA_LOG_ASSERT(!MultiSourceBfs(pg.get(), {9}, "levels", &txn_ctx));
+  KATANA_LOG_ASSERT(!MultiSourceBfs(
+      pg.get(), {0}, "levels", &txn_ctx, BfsPlan::Asynchronous()));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  RunAll(MakeRandomGraph(100, 250));
+  RunAll(MakeRandomGraph(200, 2000));
+  RunAll(katana::MakeGrid(9, 10, true));
+  RunAll(katana::MakeSawtooth(40));
+  TestInvalid();
+
+  return 0;
+}
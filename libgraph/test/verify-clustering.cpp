@@ -0,0 +1,283 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/ClusterWeightAccumulator.h"
+#include "katana/analytics/ClusteringImplementationBase.h"
+#include "katana/analytics/leiden_clustering/leiden_clustering.h"
+#include "katana/analytics/louvain_clustering/louvain_clustering.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using CoarseGraph =
+    ClusteringCoarseGraph<std::tuple<CurrentCommunityID>, uint32_t>;
+using Base = ClusteringImplementationBase<
+    CoarseGraph, uint32_t, CommunityType<uint32_t>>;
+
+constexpr uint64_t kUnassigned = Base::UNASSIGNED;
+constexpr double kEpsilon = 1.0e-9;
+
+struct WeightedEdge {
+  uint32_t src;
+  uint32_t dst;
+  uint32_t weight;
+};
+
+/// Three groups of nodes joined in a ring by edges of weight 1: a clique of
+/// nodes 0 to 3 with weight 2, of nodes 4 to 8 with weight 1 and of nodes 9
+/// to 11 with weight 3. Node 12 is isolated.
+constexpr uint32_t kNumNodes = 13;
+
+std::vector<WeightedEdge>
+GroupEdges() {
+  std::vector<WeightedEdge> edges;
+  auto add_clique = [&](uint32_t begin, uint32_t end, uint32_t weight) {
+    for (uint32_t src = begin; src < end; ++src) {
+      for (uint32_t dst = src + 1; dst < end; ++dst) {
+        edges.emplace_back(WeightedEdge{src, dst, weight});
+      }
+    }
+  };
+  add_clique(0, 4, 2);
+  add_clique(4, 9, 1);
+  add_clique(9, 12, 3);
+  edges.emplace_back(WeightedEdge{3, 4, 1});
+  edges.emplace_back(WeightedEdge{8, 9, 1});
+  edges.emplace_back(WeightedEdge{0, 11, 1});
+  return edges;
+}
+
+/// The clusters the deterministic plans find for the groups, and the
+/// modularity of that clustering, 62/68 - 1560/68^2
+const std::vector<uint64_t> kGroupClusters{0, 0, 0, 0, 1, 1, 1,
+                                           1, 1, 2, 2, 2, kUnassigned};
+constexpr double kGroupModularity = 0.5743944636678201;
+
+/// ClusterWeightAccumulator sums weights like a map, keeps clusters in the
+/// order they were first added, and can be reused after Clear
+void
+TestClusterWeightAccumulator() {
+  std::mt19937 gen(0);
+  ClusterWeightAccumulator<uint64_t> accumulator;
+  for (uint64_t num_clusters : {1, 5, 100, 3000}) {
+    std::uniform_int_distribution<uint64_t> pick(0, num_clusters - 1);
+    // Cluster IDs that differ only in their high bits
+    auto cluster_id = [](uint64_t i) { return i << 40 | i; };
+
+    accumulator.Clear();
+    KATANA_LOG_ASSERT(accumulator.size() == 0);
+    std::map<uint64_t, uint64_t> expected;
+    std::vector<uint64_t> order;
+    for (uint64_t i = 0; i < 4 * num_clusters; ++i) {
+      uint64_t cluster = cluster_id(pick(gen));
+      if (expected.count(cluster) == 0) {
+        order.emplace_back(cluster);
+      }
+      expected[cluster] += i;
+      accumulator.Add(cluster, i);
+    }
+
+    KATANA_LOG_ASSERT(accumulator.size() == order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+      KATANA_LOG_VASSERT(
+          accumulator.cluster(i) == order[i], "cluster {} is {}, expected {}",
+          i, accumulator.cluster(i), order[i]);
+      KATANA_LOG_ASSERT(accumulator.weight(i) == expected[order[i]]);
+    }
+  }
+}
+
+/// The graph of GroupEdges with a self loop of weight 4 at node 5, with
+/// each edge stored in both directions
+CoarseGraph
+MakeGroupGraph() {
+  std::vector<std::vector<std::pair<uint32_t, uint32_t>>> neighbors(
+      kNumNodes);
+  for (const auto& edge : GroupEdges()) {
+    neighbors[edge.src].emplace_back(edge.dst, edge.weight);
+    neighbors[edge.dst].emplace_back(edge.src, edge.weight);
+  }
+  neighbors[5].emplace_back(5, 4);
+
+  katana::NUMAArray<uint64_t> adj_indices;
+  adj_indices.allocateBlocked(kNumNodes);
+  std::vector<uint32_t> dests;
+  std::vector<uint32_t> weights;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    for (const auto& [dst, weight] : neighbors[n]) {
+      dests.emplace_back(dst);
+      weights.emplace_back(weight);
+    }
+    adj_indices[n] = dests.size();
+  }
+  katana::NUMAArray<uint32_t> dest_array;
+  dest_array.allocateBlocked(dests.size());
+  std::copy(dests.begin(), dests.end(), dest_array.begin());
+  katana::NUMAArray<uint32_t> weight_array;
+  weight_array.allocateBlocked(weights.size());
+  std::copy(weights.begin(), weights.end(), weight_array.begin());
+
+  return CoarseGraph(
+      katana::GraphTopology(std::move(adj_indices), std::move(dest_array)),
+      std::move(weight_array));
+}
+
+/// Sort the nodes of the groups by cluster and merge each group into one
+/// node. The expected coarse graph is the one the map-based coarsening
+/// built: for each cluster, the clusters its nodes reach, in the order they
+/// are first reached, with the summed weights.
+void
+TestCoarsening() {
+  CoarseGraph graph = MakeGroupGraph();
+  // Cluster IDs are not in node order; the isolated node is unassigned
+  const std::vector<uint64_t> clusters{2, 2, 2, 2, 0, 0, 0,
+                                       0, 0, 1, 1, 1, kUnassigned};
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    graph.GetData<CurrentCommunityID>(n) = clusters[n];
+  }
+
+  katana::NUMAArray<uint64_t> cluster_offsets;
+  katana::NUMAArray<uint32_t> cluster_nodes;
+  Base::SortNodesByCluster<CurrentCommunityID>(
+      graph, 3, &cluster_offsets, &cluster_nodes);
+  KATANA_LOG_ASSERT(
+      std::vector<uint64_t>(cluster_offsets.begin(), cluster_offsets.end()) ==
+      std::vector<uint64_t>({0, 5, 8, 12}));
+  KATANA_LOG_ASSERT(
+      std::vector<uint32_t>(cluster_nodes.begin(), cluster_nodes.end()) ==
+      std::vector<uint32_t>({4, 5, 6, 7, 8, 9, 10, 11, 0, 1, 2, 3}));
+
+  CoarseGraph coarse =
+      Base::GraphCoarsening<uint32_t, CurrentCommunityID, CoarseGraph>(
+          graph, 3);
+  const std::vector<std::vector<std::pair<uint32_t, uint32_t>>> expected{
+      {{0, 24}, {2, 1}, {1, 1}},
+      {{1, 18}, {0, 1}, {2, 1}},
+      {{2, 24}, {1, 1}, {0, 1}}};
+  KATANA_LOG_ASSERT(coarse.NumNodes() == expected.size());
+  for (uint32_t n = 0; n < coarse.NumNodes(); ++n) {
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    for (auto e : coarse.OutEdges(n)) {
+      edges.emplace_back(
+          coarse.OutEdgeDst(e), coarse.GetEdgeData<EdgeWeight<uint32_t>>(e));
+    }
+    KATANA_LOG_VASSERT(edges == expected[n], "coarse node {} differs", n);
+    KATANA_LOG_ASSERT(coarse.GetData<CurrentCommunityID>(n) == 0);
+  }
+
+  // Coarsening keeps the modularity of the clustering:
+  // 66/72 - 1752/72^2 with the self loop
+  constexpr double kModularity = 0.57870370370370372;
+  double modularity =
+      Base::CalModularityFinal<uint32_t, CurrentCommunityID>(graph);
+  KATANA_LOG_VASSERT(
+      std::abs(modularity - kModularity) < kEpsilon, "modularity {}",
+      modularity);
+  for (uint32_t n = 0; n < coarse.NumNodes(); ++n) {
+    coarse.GetData<CurrentCommunityID>(n) = n;
+  }
+  double coarse_modularity =
+      Base::CalModularityFinal<uint32_t, CurrentCommunityID>(coarse);
+  KATANA_LOG_VASSERT(
+      std::abs(coarse_modularity - kModularity) < kEpsilon,
+      "coarse modularity {}", coarse_modularity);
+}
+
+/// The graph of GroupEdges, with each edge in both directions if symmetric
+/// and otherwise in one direction, reversed for every third edge
+std::unique_ptr<katana::PropertyGraph>
+MakeGroupPropertyGraph(bool symmetric) {
+  std::vector<katana::GeneratedEdge> edges;
+  std::vector<uint32_t> weights;
+  std::vector<WeightedEdge> group_edges = GroupEdges();
+  for (size_t i = 0; i < group_edges.size(); ++i) {
+    const auto& edge = group_edges[i];
+    if (!symmetric && i % 3 == 0) {
+      edges.emplace_back(edge.dst, edge.src);
+    } else {
+      edges.emplace_back(edge.src, edge.dst);
+    }
+    weights.emplace_back(edge.weight);
+  }
+  return katana::MakeGraphFromEdges(kNumNodes, edges, symmetric, weights);
+}
+
+std::vector<uint64_t>
+GetClusters(katana::PropertyGraph* pg, const std::string& property_name) {
+  auto clusters = pg->GetNodePropertyTyped<uint64_t>(property_name).value();
+  return std::vector<uint64_t>(
+      clusters->raw_values(), clusters->raw_values() + clusters->length());
+}
+
+void
+CheckClusters(
+    const std::string& test, const std::vector<uint64_t>& found,
+    const std::vector<uint64_t>& expected, double modularity) {
+  KATANA_LOG_ASSERT(found.size() == expected.size());
+  for (size_t n = 0; n < found.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        found[n] == expected[n], "{}: node {} is in cluster {}, expected {}",
+        test, n, found[n], expected[n]);
+  }
+  KATANA_LOG_VASSERT(
+      std::abs(modularity - kGroupModularity) < kEpsilon,
+      "{}: modularity {}, expected {}", test, modularity, kGroupModularity);
+}
+
+/// The deterministic plans find the groups whether the graph is symmetric
+/// or is read as undirected
+void
+TestClustering(bool symmetric) {
+  auto pg = MakeGroupPropertyGraph(symmetric);
+  katana::TxnContext txn_ctx;
+  std::string kind = symmetric ? "symmetric" : "non-symmetric";
+
+  // The default minimum graph size would leave such a small graph alone
+  auto louvain_plan =
+      LouvainClusteringPlan::Deterministic(false, 0.01, 0.01, 1000, 0);
+  auto louvain = LouvainClustering(
+      pg.get(), "weight", "louvain", &txn_ctx, symmetric, louvain_plan);
+  KATANA_LOG_VASSERT(louvain, "LouvainClustering failed: {}", louvain.error());
+  auto louvain_stats = LouvainClusteringStatistics::Compute(
+      pg.get(), "weight", "louvain", &txn_ctx);
+  KATANA_LOG_ASSERT(louvain_stats);
+  CheckClusters(
+      "Louvain " + kind, GetClusters(pg.get(), "louvain"), kGroupClusters,
+      louvain_stats.value().modularity);
+
+  auto leiden_plan =
+      LeidenClusteringPlan::Deterministic(false, 0.01, 0.01, 1000, 0);
+  auto leiden = LeidenClustering(
+      pg.get(), "weight", "leiden", &txn_ctx, symmetric, leiden_plan);
+  KATANA_LOG_VASSERT(leiden, "LeidenClustering failed: {}", leiden.error());
+  auto leiden_stats = LeidenClusteringStatistics::Compute(
+      pg.get(), "weight", "leiden", &txn_ctx);
+  KATANA_LOG_ASSERT(leiden_stats);
+  // The last pass of Leiden moves isolated nodes to cluster 0
+  std::vector<uint64_t> leiden_clusters = kGroupClusters;
+  leiden_clusters.back() = 0;
+  CheckClusters(
+      "Leiden " + kind, GetClusters(pg.get(), "leiden"), leiden_clusters,
+      leiden_stats.value().modularity);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  TestClusterWeightAccumulator();
+  TestCoarsening();
+  TestClustering(true);
+  TestClustering(false);
+
+  return 0;
+}
@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/connected_components/connected_components.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using Edges = std::vector<katana::GeneratedEdge>;
+
+constexpr uint32_t kNumNodes = 300;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const Edges& edges) {
+  return katana::MakeGraphFromEdges(kNumNodes, edges);
+}
+
+/// Edges between random nodes, with self loops and repeated edges
+Edges
+RandomEdges(uint32_t num_edges, std::mt19937* gen) {
+  katana::RandomGraphOptions options;
+  options.num_nodes = kNumNodes;
+  options.num_edges = num_edges;
+  options.seed = (*gen)();
+  Edges edges = katana::MakeRandomEdges(options);
+  if (!edges.empty()) {
+    edges.emplace_back(edges.front());
+    edges.emplace_back(edges.front().first, edges.front().first);
+  }
+  return edges;
+}
+
+/// The smallest node ID of the component of each node, by serial
+/// union-find over edges treated as undirected
+std::vector<uint64_t>
+SerialLabels(const Edges& edges) {
+  std::vector<uint64_t> parents(kNumNodes);
+  std::iota(parents.begin(), parents.end(), 0);
+  auto find = [&](uint64_t n) {
+    while (parents[n] != n) {
+      n = parents[n];
+    }
+    return n;
+  };
+  for (const auto& [src, dst] : edges) {
+    uint64_t a = find(src);
+    uint64_t b = find(dst);
+    parents[std::max(a, b)] = std::min(a, b);
+  }
+  std::vector<uint64_t> labels(kNumNodes);
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    labels[n] = find(n);
+  }
+  return labels;
+}
+
+std::vector<uint64_t>
+GetLabels(katana::PropertyGraph* pg, const std::string& property_name) {
+  auto labels = pg->GetNodePropertyTyped<uint64_t>(property_name).value();
+  return std::vector<uint64_t>(
+      labels->raw_values(), labels->raw_values() + labels->length());
+}
+
+/// Check that found and expected split the nodes into the same components,
+/// whatever label each one uses for a component
+void
+CheckSameComponents(
+    const std::vector<uint64_t>& found, const std::vector<uint64_t>& expected) {
+  KATANA_LOG_ASSERT(found.size() == expected.size());
+  std::map<uint64_t, uint64_t> found_to_expected;
+  std::map<uint64_t, uint64_t> expected_to_found;
+  for (size_t n = 0; n < found.size(); ++n) {
+    auto it = found_to_expected.emplace(found[n], expected[n]).first;
+    KATANA_LOG_VASSERT(
+        it->second == expected[n], "node {} is in component {}, expected {}",
+        n, found[n], expected[n]);
+    auto rit = expected_to_found.emplace(expected[n], found[n]).first;
+    KATANA_LOG_VASSERT(
+        rit->second == found[n], "node {} is in component {}, expected {}", n,
+        found[n], expected[n]);
+  }
+}
+
+/// The labels ConnectedComponents computes from scratch for the graph of
+/// edges
+std::vector<uint64_t>
+RunFromScratch(const Edges& edges) {
+  auto pg = MakeGraph(edges);
+  katana::TxnContext txn_ctx;
+  auto result = ConnectedComponents(pg.get(), "component", &txn_ctx);
+  KATANA_LOG_VASSERT(result, "ConnectedComponents failed: {}", result.error());
+  return GetLabels(pg.get(), "component");
+}
+
+/// Add labels as the property named property_name of pg
+void
+AddLabels(
+    katana::PropertyGraph* pg, const std::string& property_name,
+    const std::vector<uint64_t>& labels, katana::TxnContext* txn_ctx) {
+  auto res = katana::AddNodeProperties(
+      pg, txn_ctx,
+      katana::PropertyGenerator(
+          property_name, [&](katana::GraphTopology::Node n) -> uint64_t {
+            return labels[n];
+          }));
+  KATANA_LOG_VASSERT(res, "adding labels: {}", res.error());
+}
+
+/// Label the components of a random graph from its edges, then insert edge
+/// batches one after the other, comparing the labels after each batch with
+/// a run from scratch over all the edges so far
+void
+TestBatches(uint32_t num_edges, std::mt19937* gen) {
+  Edges edges = RandomEdges(num_edges, gen);
+  auto pg = MakeGraph(edges);
+  katana::TxnContext txn_ctx;
+
+  // Without previous labels the edges of the graph are merged as well
+  Edges first_batch = RandomEdges(5, gen);
+  auto result = ConnectedComponentsIncremental(
+      pg.get(), "", first_batch, "labels_0", &txn_ctx);
+  KATANA_LOG_VASSERT(
+      result, "ConnectedComponentsIncremental failed: {}", result.error());
+  edges.insert(edges.end(), first_batch.begin(), first_batch.end());
+  KATANA_LOG_ASSERT(GetLabels(pg.get(), "labels_0") == SerialLabels(edges));
+
+  std::string previous = "labels_0";
+  for (uint32_t batch_size : {0, 1, 10, 50, 200}) {
+    Edges batch = RandomEdges(batch_size, gen);
+    std::string output = "labels_" + std::to_string(batch_size + 1);
+    auto batch_result = ConnectedComponentsIncremental(
+        pg.get(), previous, batch, output, &txn_ctx);
+    KATANA_LOG_VASSERT(
+        batch_result, "ConnectedComponentsIncremental failed: {}",
+        batch_result.error());
+    edges.insert(edges.end(), batch.begin(), batch.end());
+
+    std::vector<uint64_t> labels = GetLabels(pg.get(), output);
+    // Labels are the smallest node ID, whatever order edges arrive in
+    KATANA_LOG_ASSERT(labels == SerialLabels(edges));
+    CheckSameComponents(labels, RunFromScratch(edges));
+
+    auto new_pg = MakeGraph(edges);
+    AddLabels(new_pg.get(), output, labels, &txn_ctx);
+    KATANA_LOG_ASSERT(ConnectedComponentsAssertValid(new_pg.get(), output));
+
+    KATANA_LOG_ASSERT(pg->RemoveNodeProperty(previous, &txn_ctx));
+    previous = output;
+  }
+}
+
+void
+TestInvalid() {
+  auto pg = MakeGraph({{0, 1}, {2, 3}});
+  katana::TxnContext txn_ctx;
+  std::vector<uint64_t> labels(kNumNodes);
+  std::iota(labels.begin(), labels.end(), 0);
+  labels[1] = 0;
+  labels[3] = 2;
+  AddLabels(pg.get(), "valid", labels, &txn_ctx);
+  KATANA_LOG_ASSERT(ConnectedComponentsIncremental(
+      pg.get(), "valid", {{1, 3}}, "merged", &txn_ctx));
+  std::vector<uint64_t> merged = GetLabels(pg.get(), "merged");
+  KATANA_LOG_ASSERT(merged[0] == 0 && merged[1] == 0);
+  KATANA_LOG_ASSERT(merged[2] == 0 && merged[3] == 0);
+  KATANA_LOG_ASSERT(merged[4] == 4);
+
+  // A label larger than the node is not the smallest ID of its component
+  labels[0] = 1;
+  labels[1] = 1;
+  AddLabels(pg.get(), "larger", labels, &txn_ctx);
+  // A label that is not a root: 3 points to 1, which points to 0
+  labels[0] = 0;
+  labels[1] = 0;
+  labels[3] = 1;
+  AddLabels(pg.get(), "not_root", labels, &txn_ctx);
+  for (const char* previous : {"larger", "not_root"}) {
+    auto result = ConnectedComponentsIncremental(
+        pg.get(), previous, {}, "output", &txn_ctx);
+    KATANA_LOG_ASSERT(!result);
+    KATANA_LOG_ASSERT(result.error() == katana::ErrorCode::InvalidArgument);
+  }
+
+  // Endpoints that do not exist
+  auto result = ConnectedComponentsIncremental(
+      pg.get(), "valid", {{0, kNumNodes}}, "output", &txn_ctx);
+  KATANA_LOG_ASSERT(!result);
+  KATANA_LOG_ASSERT(result.error() == katana::ErrorCode::InvalidArgument);
+  KATANA_LOG_ASSERT(!ConnectedComponentsIncremental(
+      pg.get(), "missing", {}, "output", &txn_ctx));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  std::mt19937 gen(0);
+  // Mostly isolated nodes, many small components, and nearly one component
+  for (uint32_t num_edges : {0, 100, 250}) {
+    TestBatches(num_edges, &gen);
+  }
+  TestInvalid();
+
+  return 0;
+}
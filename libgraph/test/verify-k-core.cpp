@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <vector>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/k_core/k_core.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+/// The neighbors of each node, with edges treated as undirected unless pg
+/// is symmetric
+std::vector<std::vector<uint32_t>>
+Neighbors(const katana::PropertyGraph& pg, bool is_symmetric) {
+  const auto& topo = pg.topology();
+  std::vector<std::vector<uint32_t>> neighbors(pg.NumNodes());
+  for (uint32_t n = 0; n < pg.NumNodes(); ++n) {
+    for (auto e : topo.OutEdges(n)) {
+      uint32_t dst = topo.OutEdgeDst(e);
+      neighbors[n].emplace_back(dst);
+      if (!is_symmetric) {
+        neighbors[dst].emplace_back(n);
+      }
+    }
+  }
+  return neighbors;
+}
+
+/// Core numbers by serially peeling a node of smallest remaining degree
+std::vector<uint32_t>
+SerialPeel(const std::vector<std::vector<uint32_t>>& neighbors) {
+  size_t num_nodes = neighbors.size();
+  std::vector<uint32_t> degrees(num_nodes);
+  std::vector<bool> peeled(num_nodes, false);
+  for (size_t n = 0; n < num_nodes; ++n) {
+    degrees[n] = neighbors[n].size();
+  }
+  std::vector<uint32_t> coreness(num_nodes);
+  uint32_t k = 0;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    size_t min_node = num_nodes;
+    for (size_t n = 0; n < num_nodes; ++n) {
+      if (!peeled[n] &&
+          (min_node == num_nodes || degrees[n] < degrees[min_node])) {
+        min_node = n;
+      }
+    }
+    k = std::max(k, degrees[min_node]);
+    coreness[min_node] = k;
+    peeled[min_node] = true;
+    for (uint32_t dst : neighbors[min_node]) {
+      if (!peeled[dst]) {
+        --degrees[dst];
+      }
+    }
+  }
+  return coreness;
+}
+
+std::vector<uint32_t>
+GetValues(katana::PropertyGraph* pg, const std::string& property_name) {
+  auto values = pg->GetNodePropertyTyped<uint32_t>(property_name).value();
+  return std::vector<uint32_t>(
+      values->raw_values(), values->raw_values() + values->length());
+}
+
+void
+CheckCoreness(katana::PropertyGraph* pg, bool is_symmetric) {
+  katana::TxnContext txn_ctx;
+  auto result = KCoreness(pg, "coreness", "rank", &txn_ctx, is_symmetric);
+  KATANA_LOG_VASSERT(result, "KCoreness failed: {}", result.error());
+  std::vector<uint32_t> coreness = GetValues(pg, "coreness");
+  std::vector<uint32_t> ranks = GetValues(pg, "rank");
+
+  auto neighbors = Neighbors(*pg, is_symmetric);
+  std::vector<uint32_t> expected = SerialPeel(neighbors);
+  for (uint32_t n = 0; n < pg->NumNodes(); ++n) {
+    KATANA_LOG_VASSERT(
+        coreness[n] == expected[n], "node {} has core number {}, expected {}",
+        n, coreness[n], expected[n]);
+  }
+
+  // The k-core is the nodes with a core number of at least k
+  uint32_t degeneracy = *std::max_element(coreness.begin(), coreness.end());
+  for (uint32_t k : {1U, 2U, 3U, 5U, degeneracy, degeneracy + 1}) {
+    std::string alive_property = "alive_" + std::to_string(k);
+    auto k_core_result = KCore(pg, k, alive_property, &txn_ctx, is_symmetric);
+    KATANA_LOG_VASSERT(
+        k_core_result, "KCore failed: {}", k_core_result.error());
+    std::vector<uint32_t> alive = GetValues(pg, alive_property);
+    for (uint32_t n = 0; n < pg->NumNodes(); ++n) {
+      KATANA_LOG_VASSERT(
+          (alive[n] != 0) == (coreness[n] >= k),
+          "node {} with core number {} is alive {} in the {}-core", n,
+          coreness[n], alive[n], k);
+    }
+    KATANA_LOG_ASSERT(pg->RemoveNodeProperty(alive_property, &txn_ctx));
+  }
+
+  // The ranks are a permutation of the nodes, in which core numbers do not
+  // decrease and each node has at most its core number of neighbors ranked
+  // after it
+  std::vector<uint32_t> order(pg->NumNodes(), pg->NumNodes());
+  for (uint32_t n = 0; n < pg->NumNodes(); ++n) {
+    KATANA_LOG_ASSERT(ranks[n] < pg->NumNodes());
+    KATANA_LOG_VASSERT(
+        order[ranks[n]] == pg->NumNodes(), "nodes {} and {} have rank {}",
+        order[ranks[n]], n, ranks[n]);
+    order[ranks[n]] = n;
+
+    uint32_t later = 0;
+    for (uint32_t dst : neighbors[n]) {
+      later += ranks[dst] > ranks[n];
+    }
+    KATANA_LOG_VASSERT(
+        later <= coreness[n], "node {} has {} later neighbors, core number {}",
+        n, later, coreness[n]);
+  }
+  for (uint32_t i = 1; i < pg->NumNodes(); ++i) {
+    KATANA_LOG_ASSERT(coreness[order[i - 1]] <= coreness[order[i]]);
+  }
+
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("coreness", &txn_ctx));
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("rank", &txn_ctx));
+
+  // The rank property is optional
+  KATANA_LOG_ASSERT(KCoreness(pg, "coreness", "", &txn_ctx, is_symmetric));
+  KATANA_LOG_ASSERT(GetValues(pg, "coreness") == coreness);
+  KATANA_LOG_ASSERT(!pg->GetNodeProperty("rank"));
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("coreness", &txn_ctx));
+}
+
+/// A random graph without self loops or parallel edges whose last nodes are
+/// isolated, directed from smaller to larger node IDs or symmetric
+std::unique_ptr<katana::PropertyGraph>
+MakeRandomGraph(uint32_t num_nodes, uint32_t num_edges, bool symmetric) {
+  katana::RandomGraphOptions options;
+  options.num_nodes = num_nodes;
+  options.num_edges = num_edges;
+  options.num_isolated = 4;
+  options.distinct = true;
+  // Each undirected edge is drawn in one direction only
+  options.edge_filter = [](uint32_t src, uint32_t dst) { return src < dst; };
+  options.symmetric = symmetric;
+  return katana::MakeRandomGraph(options);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  CheckCoreness(MakeRandomGraph(100, 200, false).get(), false);
+  CheckCoreness(MakeRandomGraph(100, 200, true).get(), true);
+  CheckCoreness(MakeRandomGraph(80, 1200, false).get(), false);
+  CheckCoreness(MakeRandomGraph(80, 1200, true).get(), true);
+  CheckCoreness(katana::MakeClique(10).get(), false);
+  CheckCoreness(katana::MakeGrid(6, 7, true).get(), false);
+  CheckCoreness(katana::MakeSawtooth(20).get(), false);
+
+  return 0;
+}
@@ -0,0 +1,187 @@
+#include <cmath>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <set>
+
+#include <arrow/api.h>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+using EdgeSet = std::set<katana::GeneratedEdge>;
+
+constexpr uint32_t kNumNodes = 200;
+// Push runs leave every residual within kTolerance. The rank of each node
+// is then within a small multiple of kTolerance of the exact rank (about
+// 5e-6 on these graphs), so ranks of two runs agree to within kEpsilon.
+constexpr float kTolerance = 1.0e-6;
+constexpr float kEpsilon = 1.0e-4;
+
+std::unique_ptr<katana::PropertyGraph>
+MakeGraph(const EdgeSet& edges) {
+  std::vector<katana::GeneratedEdge> edge_list(edges.begin(), edges.end());
+  return katana::MakeGraphFromEdges(kNumNodes, edge_list);
+}
+
+std::vector<float>
+GetRanks(katana::PropertyGraph* pg, const std::string& property_name) {
+  auto ranks = pg->GetNodePropertyTyped<float>(property_name).value();
+  return std::vector<float>(
+      ranks->raw_values(), ranks->raw_values() + ranks->length());
+}
+
+/// Run a push Page Rank from scratch and return its ranks
+std::vector<float>
+RunPagerank(katana::PropertyGraph* pg) {
+  katana::TxnContext txn_ctx;
+  auto result = Pagerank(
+      pg, "fresh", &txn_ctx, PagerankPlan::PushAsynchronous(kTolerance));
+  KATANA_LOG_VASSERT(result, "Pagerank failed: {}", result.error());
+  auto ranks = GetRanks(pg, "fresh");
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("fresh", &txn_ctx));
+  return ranks;
+}
+
+/// Store previous as the ranks of pg, update them for changed_nodes and
+/// return the updated ranks
+std::vector<float>
+RunIncremental(
+    katana::PropertyGraph* pg, const std::vector<float>& previous,
+    const std::vector<uint32_t>& changed_nodes) {
+  katana::TxnContext txn_ctx;
+  auto res = katana::AddNodeProperties(
+      pg, &txn_ctx,
+      katana::PropertyGenerator(
+          "previous", [&](katana::GraphTopology::Node n) -> float {
+            return previous[n];
+          }));
+  KATANA_LOG_VASSERT(res, "adding previous ranks: {}", res.error());
+
+  auto result = PagerankIncremental(
+      pg, "previous", changed_nodes, "updated", &txn_ctx,
+      PagerankPlan::PushAsynchronous(kTolerance));
+  KATANA_LOG_VASSERT(result, "PagerankIncremental failed: {}", result.error());
+  auto ranks = GetRanks(pg, "updated");
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("updated", &txn_ctx));
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("previous", &txn_ctx));
+  return ranks;
+}
+
+void
+CheckRanks(
+    const std::string& test, const std::vector<float>& found,
+    const std::vector<float>& expected) {
+  KATANA_LOG_ASSERT(found.size() == expected.size());
+  for (size_t n = 0; n < found.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        std::abs(found[n] - expected[n]) < kEpsilon,
+        "{}: node {} has rank {}, expected {}", test, n, found[n],
+        expected[n]);
+  }
+}
+
+EdgeSet
+RandomEdges(uint32_t num_edges, std::mt19937* gen) {
+  katana::RandomGraphOptions options;
+  options.num_nodes = kNumNodes;
+  options.num_edges = num_edges;
+  options.seed = (*gen)();
+  options.distinct = true;
+  auto edges = katana::MakeRandomEdges(options);
+  return EdgeSet(edges.begin(), edges.end());
+}
+
+void
+TestUnchangedGraph(const EdgeSet& edges) {
+  auto pg = MakeGraph(edges);
+  std::vector<float> ranks = RunPagerank(pg.get());
+
+  // Nothing changed, so nothing is pushed and the ranks are kept as they are
+  KATANA_LOG_ASSERT(RunIncremental(pg.get(), ranks, {}) == ranks);
+
+  // Every residual is recomputed, and they are all within the tolerance
+  std::vector<uint32_t> all(kNumNodes);
+  std::iota(all.begin(), all.end(), 0);
+  CheckRanks("all changed", RunIncremental(pg.get(), ranks, all), ranks);
+
+  // Starting from uniform ranks with all nodes changed is a full run
+  std::vector<float> uniform(kNumNodes, 1.0);
+  CheckRanks("from uniform", RunIncremental(pg.get(), uniform, all), ranks);
+
+  // Pull ranks are normalized differently, so pull plans are rejected
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(Pagerank(pg.get(), "previous", &txn_ctx));
+  KATANA_LOG_ASSERT(!PagerankIncremental(
+      pg.get(), "previous", all, "updated", &txn_ctx,
+      PagerankPlan::PullResidual()));
+  KATANA_LOG_ASSERT(!PagerankIncremental(
+      pg.get(), "previous", {kNumNodes}, "updated", &txn_ctx));
+}
+
+/// Insert and delete edges, and compare the update of the ranks of the old
+/// graph with ranks computed from scratch on the new graph
+void
+TestChangedGraph(const EdgeSet& edges, std::mt19937* gen) {
+  auto old_pg = MakeGraph(edges);
+  std::vector<float> old_ranks = RunPagerank(old_pg.get());
+
+  EdgeSet new_edges = edges;
+  std::set<uint32_t> changed;
+  for (const auto& edge : RandomEdges(10, gen)) {
+    if (new_edges.insert(edge).second) {
+      changed.insert({edge.first, edge.second});
+    }
+  }
+  std::uniform_int_distribution<size_t> pick(0, edges.size() - 1);
+  for (int i = 0; i < 10; ++i) {
+    auto it = std::next(edges.begin(), pick(*gen));
+    if (new_edges.erase(*it) > 0) {
+      changed.insert({it->first, it->second});
+    }
+  }
+
+  auto new_pg = MakeGraph(new_edges);
+  std::vector<float> expected = RunPagerank(new_pg.get());
+  std::vector<uint32_t> changed_nodes(changed.begin(), changed.end());
+  std::vector<float> found =
+      RunIncremental(new_pg.get(), old_ranks, changed_nodes);
+  CheckRanks("changed edges", found, expected);
+
+  // Ranks that a run from scratch moves away from the old ranks are moved by
+  // the update too, rather than kept close enough to pass the check above
+  size_t num_moved = 0;
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    if (std::abs(expected[n] - old_ranks[n]) > 2 * kEpsilon) {
+      ++num_moved;
+      KATANA_LOG_VASSERT(
+          std::abs(found[n] - old_ranks[n]) > kEpsilon,
+          "node {} kept its old rank {}, expected {}", n, old_ranks[n],
+          expected[n]);
+    }
+  }
+  KATANA_LOG_ASSERT(num_moved > 0);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  std::mt19937 gen(0);
+  for (uint32_t num_edges : {400, 2000}) {
+    EdgeSet edges = RandomEdges(num_edges, &gen);
+    TestUnchangedGraph(edges);
+    for (int i = 0; i < 3; ++i) {
+      TestChangedGraph(edges, &gen);
+    }
+  }
+
+  return 0;
+}
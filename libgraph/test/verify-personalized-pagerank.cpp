@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/pagerank/pagerank.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr float kAlpha = 0.85;
+
+/// A random graph in which the nodes that are multiples of 10 have no
+/// out-edges
+std::unique_ptr<katana::PropertyGraph>
+MakeRandomGraph(uint32_t num_nodes, uint32_t num_edges, std::mt19937* gen) {
+  katana::RandomGraphOptions options;
+  options.num_nodes = num_nodes;
+  options.num_edges = num_edges;
+  options.seed = (*gen)();
+  options.distinct = true;
+  options.edge_filter = [](uint32_t src, uint32_t) { return src % 10 != 0; };
+  return katana::MakeRandomGraph(options);
+}
+
+/// Personalized Page Rank of seeds by power iteration of
+/// ranks = (1 - alpha) * jump + alpha * (ranks spread over out-edges); walks
+/// that reach a node without out-edges are lost
+std::vector<double>
+PowerIteration(
+    const katana::PropertyGraph& pg, const std::vector<uint32_t>& seeds) {
+  const auto& topo = pg.topology();
+  std::vector<double> jump(pg.NumNodes(), 0);
+  for (uint32_t seed : seeds) {
+    jump[seed] += 1.0 / seeds.size();
+  }
+  std::vector<double> ranks = jump;
+  for (int i = 0; i < 300; ++i) {
+    std::vector<double> next(pg.NumNodes(), 0);
+    for (uint32_t n = 0; n < pg.NumNodes(); ++n) {
+      next[n] += (1 - kAlpha) * jump[n];
+      double degree = topo.OutDegree(n);
+      for (auto e : topo.OutEdges(n)) {
+        next[topo.OutEdgeDst(e)] += kAlpha * ranks[n] / degree;
+      }
+    }
+    ranks = std::move(next);
+  }
+  return ranks;
+}
+
+std::vector<PersonalizedPagerankTopK>
+Run(katana::PropertyGraph* pg,
+    const std::vector<std::vector<uint32_t>>& seed_sets, uint32_t k,
+    PersonalizedPagerankPlan plan) {
+  auto result = PersonalizedPagerank(pg, seed_sets, k, plan);
+  KATANA_LOG_VASSERT(result, "PersonalizedPagerank failed: {}", result.error());
+  KATANA_LOG_ASSERT(result.value().size() == seed_sets.size());
+  return std::move(result.value());
+}
+
+/// Check that top_k holds up to k nodes with ranks within epsilon of the
+/// exact ranks, in order, and that no node left out ranks clearly higher
+void
+CheckTopK(
+    const PersonalizedPagerankTopK& top_k, const std::vector<double>& exact,
+    uint32_t k, double epsilon) {
+  // Nodes whose exact rank is within the error may not have been reached
+  size_t num_reached = 0;
+  size_t num_clearly_reached = 0;
+  for (double rank : exact) {
+    num_reached += rank > 0;
+    num_clearly_reached += rank > 2 * epsilon;
+  }
+  KATANA_LOG_VASSERT(
+      top_k.size() <= std::min<size_t>(k, num_reached) &&
+          top_k.size() >= std::min<size_t>(k, num_clearly_reached),
+      "found {} nodes, {} reached", top_k.size(), num_reached);
+
+  std::set<uint32_t> returned;
+  for (size_t i = 0; i < top_k.size(); ++i) {
+    const auto& [node, rank] = top_k[i];
+    KATANA_LOG_VASSERT(
+        std::abs(rank - exact[node]) < epsilon, "node {} has rank {}, want {}",
+        node, rank, exact[node]);
+    if (i > 0) {
+      const auto& [prev_node, prev_rank] = top_k[i - 1];
+      KATANA_LOG_ASSERT(
+          prev_rank > rank || (prev_rank == rank && prev_node < node));
+    }
+    returned.insert(node);
+  }
+  if (top_k.empty()) {
+    return;
+  }
+  for (uint32_t n = 0; n < exact.size(); ++n) {
+    KATANA_LOG_VASSERT(
+        returned.count(n) || exact[n] < top_k.back().second + 2 * epsilon,
+        "node {} with rank {} is missing", n, exact[n]);
+  }
+}
+
+std::vector<std::vector<uint32_t>>
+MakeSeedSets(uint32_t num_nodes, std::mt19937* gen) {
+  std::uniform_int_distribution<uint32_t> node(0, num_nodes - 1);
+  // More sets than a forward push batch, single seeds and larger sets
+  std::vector<std::vector<uint32_t>> seed_sets;
+  for (size_t i = 0; i < kPersonalizedPagerankBatchSize + 4; ++i) {
+    std::vector<uint32_t> seeds(1 + i % 3);
+    for (auto& seed : seeds) {
+      seed = node(*gen);
+    }
+    seed_sets.emplace_back(seeds);
+  }
+  // A node without out-edges ranks only itself
+  seed_sets.push_back({0});
+  return seed_sets;
+}
+
+void
+TestForwardPush(katana::PropertyGraph* pg, std::mt19937* gen) {
+  auto seed_sets = MakeSeedSets(pg->NumNodes(), gen);
+  // The residual left at each node is below epsilon per out-edge, so the
+  // error of each rank is at most epsilon times the number of edges
+  float epsilon = 1.0e-8;
+  double max_error = epsilon * pg->NumEdges() + 1.0e-5;
+  for (uint32_t k : {1, 5, 1000}) {
+    auto results =
+        Run(pg, seed_sets, k, PersonalizedPagerankPlan::ForwardPush(epsilon));
+    for (size_t i = 0; i < seed_sets.size(); ++i) {
+      CheckTopK(results[i], PowerIteration(*pg, seed_sets[i]), k, max_error);
+    }
+  }
+}
+
+void
+TestMonteCarlo(katana::PropertyGraph* pg, std::mt19937* gen) {
+  auto seed_sets = MakeSeedSets(pg->NumNodes(), gen);
+  uint32_t num_walks = 200000;
+  // Five standard deviations of the fraction of walks ending at a node
+  double max_error = 5 * std::sqrt(0.25 / num_walks);
+  auto plan = PersonalizedPagerankPlan::MonteCarlo(num_walks, kAlpha, 7);
+  auto results = Run(pg, seed_sets, 5, plan);
+  for (size_t i = 0; i < seed_sets.size(); ++i) {
+    auto exact = PowerIteration(*pg, seed_sets[i]);
+    for (const auto& [node, rank] : results[i]) {
+      KATANA_LOG_VASSERT(
+          std::abs(rank - exact[node]) < max_error,
+          "set {} node {} has rank {}, want {}", i, node, rank, exact[node]);
+    }
+    // The first node is the best one, up to the sampling error
+    if (!results[i].empty()) {
+      uint32_t best = std::max_element(exact.begin(), exact.end()) -
+                      exact.begin();
+      KATANA_LOG_ASSERT(
+          exact[results[i][0].first] > exact[best] - 2 * max_error);
+    }
+  }
+
+  // The ranks are a function of the seed
+  KATANA_LOG_ASSERT(Run(pg, seed_sets, 5, plan) == results);
+  auto other_plan = PersonalizedPagerankPlan::MonteCarlo(num_walks, kAlpha, 8);
+  KATANA_LOG_ASSERT(Run(pg, seed_sets, 5, other_plan) != results);
+}
+
+/// 1 and 2 tie behind 0 and are ordered by node ID; 3 and 4 are never
+/// reached from 0
+void
+TestTiesAndUnreached() {
+  auto pg =
+      katana::MakeGraphFromEdges(5, {{0, 1}, {0, 2}, {1, 0}, {2, 0}, {3, 4}});
+  auto push = PersonalizedPagerankPlan::ForwardPush(1.0e-8);
+  auto results = Run(pg.get(), {{0}}, 2, push);
+  KATANA_LOG_ASSERT(results[0].size() == 2);
+  KATANA_LOG_ASSERT(results[0][0].first == 0 && results[0][1].first == 1);
+
+  // k is larger than the number of reached nodes
+  for (auto plan : {push, PersonalizedPagerankPlan::MonteCarlo(10000)}) {
+    results = Run(pg.get(), {{0}, {3}}, 100, plan);
+    std::set<uint32_t> from_0;
+    std::set<uint32_t> from_3;
+    for (const auto& [node, rank] : results[0]) {
+      from_0.insert(node);
+    }
+    for (const auto& [node, rank] : results[1]) {
+      from_3.insert(node);
+    }
+    KATANA_LOG_ASSERT(results[0].size() == 3);
+    KATANA_LOG_ASSERT(from_0 == std::set<uint32_t>({0, 1, 2}));
+    KATANA_LOG_ASSERT(results[1].size() == 2);
+    KATANA_LOG_ASSERT(from_3 == std::set<uint32_t>({3, 4}));
+  }
+  auto exact = PowerIteration(*pg, {0});
+  KATANA_LOG_ASSERT(exact[1] == exact[2]);
+  CheckTopK(Run(pg.get(), {{0}}, 100, push)[0], exact, 100, 1.0e-5);
+
+  KATANA_LOG_ASSERT(Run(pg.get(), {{0}}, 0, push)[0].empty());
+  KATANA_LOG_ASSERT(!PersonalizedPagerank(pg.get(), {{}}, 1, push));
+  KATANA_LOG_ASSERT(!PersonalizedPagerank(pg.get(), {{5}}, 1, push));
+  KATANA_LOG_ASSERT(!PersonalizedPagerank(
+      pg.get(), {{0}}, 1, PersonalizedPagerankPlan::ForwardPush(1.0e-8, 1)));
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  std::mt19937 gen(0);
+  auto sparse = MakeRandomGraph(100, 300, &gen);
+  auto dense = MakeRandomGraph(60, 1000, &gen);
+  for (auto* pg : {sparse.get(), dense.get()}) {
+    TestForwardPush(pg, &gen);
+    TestMonteCarlo(pg, &gen);
+  }
+  TestTiesAndUnreached();
+
+  return 0;
+}
@@ -0,0 +1,168 @@
+#include <array>
+#include <cmath>
+
+#include <arrow/api.h>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/random_walks/random_walks.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr uint32_t kNumNodes = 5;
+
+/// Node 0 has out-edges to 1, 2 and 3 with weights 1, 2 and 7; 1 and 2 lead
+/// back to 0, 3 leads to 4 and 4 has no out-edges, so walks through 3 end
+/// early.
+std::unique_ptr<katana::PropertyGraph>
+MakeWeightedGraph() {
+  katana::AsymmetricGraphTopologyBuilder builder;
+  builder.AddNodes(kNumNodes);
+  std::vector<std::array<uint32_t, 2>> edges = {{0, 1}, {0, 2}, {0, 3},
+                                                {1, 0}, {2, 0}, {3, 4}};
+  for (const auto& [src, dst] : edges) {
+    builder.AddEdge(src, dst);
+  }
+  auto pg_result = katana::PropertyGraph::Make(builder.ConvertToCSR());
+  KATANA_LOG_ASSERT(pg_result);
+  std::unique_ptr<katana::PropertyGraph> pg = std::move(pg_result.value());
+
+  katana::TxnContext txn_ctx;
+  const auto& topo = pg->topology();
+  auto weight = [&topo](katana::GraphTopology::Edge e) {
+    switch (topo.OutEdgeDst(e)) {
+    case 2:
+      return 2.0;
+    case 3:
+      return 7.0;
+    default:
+      return 1.0;
+    }
+  };
+  auto res = katana::AddEdgeProperties(
+      pg.get(), &txn_ctx, katana::PropertyGenerator("weight", weight));
+  KATANA_LOG_VASSERT(res, "adding weights: {}", res.error());
+  return pg;
+}
+
+std::shared_ptr<arrow::FixedSizeListArray>
+RunWalks(katana::PropertyGraph* pg, const RandomWalksPlan& plan) {
+  auto walks = RandomWalksFlat(pg, plan);
+  KATANA_LOG_VASSERT(walks, "RandomWalksFlat failed: {}", walks.error());
+  return walks.value();
+}
+
+void
+TestSeed(katana::PropertyGraph* pg) {
+  auto plan = RandomWalksPlan::Node2Vec(5, 100, 2.0, 0.5, "weight", 7);
+  auto walks = RunWalks(pg, plan);
+  KATANA_LOG_ASSERT(walks->Equals(*RunWalks(pg, plan)));
+
+  auto other_plan = RandomWalksPlan::Node2Vec(5, 100, 2.0, 0.5, "weight", 8);
+  KATANA_LOG_ASSERT(!walks->Equals(*RunWalks(pg, other_plan)));
+
+  // The nested form holds the same walks, without the padding
+  auto nested = RandomWalks(pg, plan);
+  KATANA_LOG_ASSERT(nested);
+  KATANA_LOG_ASSERT(
+      static_cast<int64_t>(nested.value().size()) == walks->length());
+  const auto& values = static_cast<const arrow::UInt32Array&>(*walks->values());
+  for (int64_t idx = 0; idx < walks->length(); ++idx) {
+    const auto& walk = nested.value()[idx];
+    int64_t begin = walks->value_offset(idx);
+    for (size_t i = 0; i < walk.size(); ++i) {
+      KATANA_LOG_ASSERT(values.IsValid(begin + i));
+      KATANA_LOG_ASSERT(values.Value(begin + i) == walk[i]);
+    }
+    KATANA_LOG_ASSERT(
+        walk.size() == static_cast<size_t>(walks->value_length()) ||
+        values.IsNull(begin + walk.size()));
+  }
+}
+
+void
+TestLayout(katana::PropertyGraph* pg, uint32_t walk_length) {
+  constexpr uint32_t kNumWalks = 50;
+  auto walks = RunWalks(
+      pg, RandomWalksPlan::Node2Vec(walk_length, kNumWalks, 1, 1, "weight"));
+
+  // One walk per repetition from each of nodes 0 to 3, the nodes with
+  // out-edges, in order
+  int32_t width = std::max(walk_length, 1U) + 1;
+  KATANA_LOG_VASSERT(
+      walks->value_length() == width, "width {}, expected {}",
+      walks->value_length(), width);
+  KATANA_LOG_ASSERT(
+      walks->length() == static_cast<int64_t>((kNumNodes - 1) * kNumWalks));
+
+  const auto& topo = pg->topology();
+  const auto& values = static_cast<const arrow::UInt32Array&>(*walks->values());
+  for (int64_t idx = 0; idx < walks->length(); ++idx) {
+    int64_t begin = walks->value_offset(idx);
+    KATANA_LOG_ASSERT(values.Value(begin) == idx % (kNumNodes - 1U));
+    for (int32_t i = 1; i < width; ++i) {
+      uint32_t prev = values.Value(begin + i - 1);
+      if (values.IsNull(begin + i)) {
+        // Walks end at node 4 and the rest of the walk is zeros
+        KATANA_LOG_ASSERT(values.IsNull(begin + i - 1) || prev == 4);
+        KATANA_LOG_ASSERT(values.Value(begin + i) == 0);
+        continue;
+      }
+      KATANA_LOG_ASSERT(values.IsValid(begin + i - 1));
+      bool is_edge = false;
+      for (auto e : topo.OutEdges(prev)) {
+        is_edge |= topo.OutEdgeDst(e) == values.Value(begin + i);
+      }
+      KATANA_LOG_VASSERT(
+          is_edge, "walk {} steps from {} to {}", idx, prev,
+          values.Value(begin + i));
+    }
+  }
+}
+
+void
+TestEdgeFrequencies(katana::PropertyGraph* pg) {
+  // Without second order bias every step from 0 follows the weights
+  auto walks =
+      RunWalks(pg, RandomWalksPlan::Node2Vec(4, 5000, 1, 1, "weight", 3));
+  const auto& values = static_cast<const arrow::UInt32Array&>(*walks->values());
+
+  std::array<double, kNumNodes> count{};
+  double total = 0;
+  for (int64_t idx = 0; idx < walks->length(); ++idx) {
+    int64_t begin = walks->value_offset(idx);
+    for (int32_t i = 1; i < walks->value_length(); ++i) {
+      if (values.IsValid(begin + i) && values.Value(begin + i - 1) == 0) {
+        count[values.Value(begin + i)] += 1;
+        total += 1;
+      }
+    }
+  }
+
+  std::array<double, kNumNodes> expected{0, 0.1, 0.2, 0.7, 0};
+  for (uint32_t n = 0; n < kNumNodes; ++n) {
+    KATANA_LOG_VASSERT(
+        std::abs(count[n] / total - expected[n]) < 0.02,
+        "stepped from 0 to {} with frequency {}, expected {}", n,
+        count[n] / total, expected[n]);
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  auto pg = MakeWeightedGraph();
+
+  TestSeed(pg.get());
+  TestLayout(pg.get(), 0);
+  TestLayout(pg.get(), 1);
+  TestLayout(pg.get(), 6);
+  TestEdgeFrequencies(pg.get());
+
+  return 0;
+}
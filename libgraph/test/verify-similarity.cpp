@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+#include <arrow/api.h>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/similarity/similarity.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+struct Expected {
+  uint32_t node;
+  double similarity;
+};
+
+/// Compare every pair of nodes directly
+std::vector<std::vector<Expected>>
+BruteForceTopK(
+    const katana::PropertyGraph& pg, uint32_t k, SimilarityMetric metric) {
+  const auto& topo = pg.topology();
+  uint32_t num_nodes = pg.NumNodes();
+  std::vector<std::set<uint32_t>> neighbors(num_nodes);
+  for (uint32_t n = 0; n < num_nodes; ++n) {
+    for (auto e : topo.OutEdges(n)) {
+      neighbors[n].emplace(topo.OutEdgeDst(e));
+    }
+  }
+
+  std::vector<std::vector<Expected>> top_k(num_nodes);
+  for (uint32_t u = 0; u < num_nodes; ++u) {
+    for (uint32_t v = 0; v < num_nodes; ++v) {
+      if (u == v) {
+        continue;
+      }
+      double common = 0;
+      for (uint32_t w : neighbors[u]) {
+        common += neighbors[v].count(w);
+      }
+      if (common == 0) {
+        continue;
+      }
+      double degree_u = neighbors[u].size();
+      double degree_v = neighbors[v].size();
+      double similarity = metric == SimilarityMetric::kJaccard
+                              ? common / (degree_u + degree_v - common)
+                              : common / std::sqrt(degree_u * degree_v);
+      top_k[u].emplace_back(Expected{v, similarity});
+    }
+    std::sort(
+        top_k[u].begin(), top_k[u].end(),
+        [](const Expected& a, const Expected& b) {
+          return a.similarity > b.similarity ||
+                 (a.similarity == b.similarity && a.node < b.node);
+        });
+    if (top_k[u].size() > k) {
+      top_k[u].resize(k);
+    }
+  }
+  return top_k;
+}
+
+void
+RunTopKSimilarity(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    uint32_t k, SimilarityMetric metric) {
+  katana::TxnContext txn_ctx;
+  auto result =
+      TopKSimilarity(pg, sources, k, metric, "nodes", "similarities", &txn_ctx);
+  KATANA_LOG_VASSERT(result, "TopKSimilarity failed: {}", result.error());
+  KATANA_LOG_ASSERT(
+      TopKSimilarityAssertValid(pg, k, "nodes", "similarities"));
+
+  auto nodes_list = std::static_pointer_cast<arrow::LargeListArray>(
+      pg->GetNodeProperty("nodes").value()->chunk(0));
+  auto similarities_list = std::static_pointer_cast<arrow::LargeListArray>(
+      pg->GetNodeProperty("similarities").value()->chunk(0));
+  auto nodes =
+      std::static_pointer_cast<arrow::UInt32Array>(nodes_list->values());
+  auto similarities =
+      std::static_pointer_cast<arrow::DoubleArray>(similarities_list->values());
+
+  std::set<uint32_t> is_source(sources.begin(), sources.end());
+  auto expected = BruteForceTopK(*pg, k, metric);
+  for (uint32_t n = 0; n < pg->NumNodes(); ++n) {
+    int64_t begin = nodes_list->value_offset(n);
+    int64_t end = nodes_list->value_offset(n + 1);
+    if (!sources.empty() && is_source.count(n) == 0) {
+      KATANA_LOG_VASSERT(begin == end, "node {} is not a source", n);
+      continue;
+    }
+    KATANA_LOG_VASSERT(
+        end - begin == static_cast<int64_t>(expected[n].size()),
+        "node {}: found {} results, expected {}", n, end - begin,
+        expected[n].size());
+    for (int64_t i = begin; i < end; ++i) {
+      const Expected& want = expected[n][i - begin];
+      KATANA_LOG_VASSERT(
+          nodes->Value(i) == want.node &&
+              std::abs(similarities->Value(i) - want.similarity) < 1e-12,
+          "node {} result {}: found ({}, {}), expected ({}, {})", n,
+          i - begin, nodes->Value(i), similarities->Value(i), want.node,
+          want.similarity);
+    }
+  }
+
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("nodes", &txn_ctx));
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("similarities", &txn_ctx));
+}
+
+void
+RunAll(std::unique_ptr<katana::PropertyGraph>&& pg) {
+  for (auto metric : {SimilarityMetric::kJaccard, SimilarityMetric::kCosine}) {
+    // k of 1 and 3 exercise pruning by degree; 100 keeps every candidate
+    for (uint32_t k : {1, 3, 100}) {
+      RunTopKSimilarity(pg.get(), {}, k, metric);
+      // Duplicate sources are processed once
+      RunTopKSimilarity(pg.get(), {0, 2, 2}, k, metric);
+    }
+  }
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  RunAll(katana::MakeGrid(3, 4, true));
+  RunAll(katana::MakeGrid(3, 4, false));
+  RunAll(katana::MakeFerrisWheel(6));
+  RunAll(katana::MakeSawtooth(3));
+  // Every pair of nodes ties, so results are ordered by node ID
+  RunAll(katana::MakeClique(5));
+
+  return 0;
+}
@@ -0,0 +1,206 @@
+#include <limits>
+#include <numeric>
+#include <random>
+
+#include <arrow/api.h>
+
+#include "katana/SharedMemSys.h"
+#include "katana/TopologyGeneration.h"
+#include "katana/analytics/sssp/sssp.h"
+
+using namespace katana::analytics;
+
+namespace {
+
+constexpr uint32_t kInfinity = std::numeric_limits<uint32_t>::max() / 4;
+
+/// A random graph without parallel edges whose last nodes have no edges
+std::unique_ptr<katana::PropertyGraph>
+MakeRandomGraph(uint32_t num_nodes, uint32_t num_edges) {
+  katana::RandomGraphOptions options;
+  options.num_nodes = num_nodes;
+  options.num_edges = num_edges;
+  options.num_isolated = 4;
+  options.distinct = true;
+  options.weight_generator = [](std::mt19937* gen) {
+    return std::uniform_int_distribution<uint32_t>(0, 100)(*gen);
+  };
+  return katana::MakeRandomGraph(options);
+}
+
+/// Shortest paths of at most max_hops edges and at most max_distance long,
+/// by Bellman-Ford rounds that each extend paths by one edge
+std::vector<uint32_t>
+SerialBoundedSssp(
+    katana::PropertyGraph* pg, uint32_t source, MultiSourceSsspBounds bounds) {
+  const auto& topo = pg->topology();
+  auto weights = pg->GetEdgePropertyTyped<uint32_t>("weight").value();
+  std::vector<uint32_t> distances(pg->NumNodes(), kInfinity);
+  distances[source] = 0;
+  for (uint32_t hops = 0; hops < bounds.max_hops; ++hops) {
+    std::vector<uint32_t> next = distances;
+    for (uint32_t n = 0; n < pg->NumNodes(); ++n) {
+      if (distances[n] == kInfinity) {
+        continue;
+      }
+      for (auto e : topo.OutEdges(n)) {
+        uint32_t dst = topo.OutEdgeDst(e);
+        uint64_t distance = uint64_t{distances[n]} + weights->Value(e);
+        if (distance <= bounds.max_distance && distance < next[dst]) {
+          next[dst] = distance;
+        }
+      }
+    }
+    if (next == distances) {
+      break;
+    }
+    distances = std::move(next);
+  }
+  return distances;
+}
+
+/// The distances of the sources stored in property_name, one vector per
+/// source
+std::vector<std::vector<uint32_t>>
+GetDistances(
+    katana::PropertyGraph* pg, size_t num_sources,
+    const std::string& property_name) {
+  auto list = std::static_pointer_cast<arrow::LargeListArray>(
+      pg->GetNodeProperty(property_name).value()->chunk(0));
+  auto values = std::static_pointer_cast<arrow::UInt32Array>(list->values());
+  std::vector<std::vector<uint32_t>> distances(num_sources);
+  for (size_t i = 0; i < num_sources; ++i) {
+    for (uint32_t n = 0; n < pg->NumNodes(); ++n) {
+      KATANA_LOG_ASSERT(
+          list->value_length(n) == static_cast<int64_t>(num_sources));
+      distances[i].emplace_back(values->Value(list->value_offset(n) + i));
+    }
+  }
+  return distances;
+}
+
+void
+CheckDistances(
+    const katana::PropertyGraph& pg, uint32_t source,
+    const std::vector<uint32_t>& found,
+    const std::vector<uint32_t>& expected) {
+  for (uint32_t n = 0; n < pg.NumNodes(); ++n) {
+    KATANA_LOG_VASSERT(
+        found[n] == expected[n], "node {} from {}: found {}, expected {}", n,
+        source, found[n], expected[n]);
+  }
+}
+
+void
+RunMultiSourceSssp(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources,
+    MultiSourceSsspBounds bounds) {
+  katana::TxnContext txn_ctx;
+  auto result =
+      MultiSourceSssp(pg, sources, "weight", "distances", &txn_ctx, bounds);
+  KATANA_LOG_VASSERT(result, "MultiSourceSssp failed: {}", result.error());
+  MultiSourceSsspBounds unbounded;
+  if (bounds.max_hops == unbounded.max_hops &&
+      bounds.max_distance == unbounded.max_distance) {
+    KATANA_LOG_ASSERT(
+        MultiSourceSsspAssertValid(pg, sources, "weight", "distances"));
+  }
+
+  auto distances = GetDistances(pg, sources.size(), "distances");
+  for (size_t i = 0; i < sources.size(); ++i) {
+    CheckDistances(
+        *pg, sources[i], distances[i],
+        SerialBoundedSssp(pg, sources[i], bounds));
+  }
+
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("distances", &txn_ctx));
+}
+
+/// Without bounds, MultiSourceSssp agrees with one Sssp run per source
+void
+CompareWithSssp(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& sources) {
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(
+      MultiSourceSssp(pg, sources, "weight", "distances", &txn_ctx));
+  auto distances = GetDistances(pg, sources.size(), "distances");
+
+  for (size_t i = 0; i < sources.size(); ++i) {
+    auto result = Sssp(pg, sources[i], "weight", "distance", &txn_ctx);
+    KATANA_LOG_VASSERT(result, "Sssp failed: {}", result.error());
+    auto sssp = pg->GetNodePropertyTyped<uint32_t>("distance").value();
+    std::vector<uint32_t> expected(
+        sssp->raw_values(), sssp->raw_values() + sssp->length());
+    CheckDistances(*pg, sources[i], distances[i], expected);
+    KATANA_LOG_ASSERT(pg->RemoveNodeProperty("distance", &txn_ctx));
+  }
+
+  KATANA_LOG_ASSERT(pg->RemoveNodeProperty("distances", &txn_ctx));
+}
+
+void
+RunAll(std::unique_ptr<katana::PropertyGraph>&& pg) {
+  std::vector<uint32_t> all(pg->NumNodes());
+  std::iota(all.begin(), all.end(), 0);
+  // Duplicates and more sources than one batch, so the last batch is
+  // partly used
+  all.emplace_back(0);
+  all.emplace_back(all.size() / 2);
+
+  for (const auto& sources : {std::vector<uint32_t>{0}, all}) {
+    RunMultiSourceSssp(pg.get(), sources, {});
+    for (uint32_t max_hops : {0, 1, 2, 5}) {
+      RunMultiSourceSssp(pg.get(), sources, {max_hops});
+    }
+    RunMultiSourceSssp(
+        pg.get(), sources, {std::numeric_limits<uint32_t>::max(), 50});
+    RunMultiSourceSssp(pg.get(), sources, {3, 120});
+  }
+  CompareWithSssp(pg.get(), {0, 1, 7});
+}
+
+/// A source's unreached lanes stay unreached even across an edge whose
+/// weight would overflow the unreached distance
+void
+TestHeavyEdge() {
+  uint32_t heavy = std::numeric_limits<uint32_t>::max() - 100;
+  auto pg = katana::MakeGraphFromEdges(4, {{0, 1}, {2, 3}}, false, {1, heavy});
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(
+      MultiSourceSssp(pg.get(), {0, 2}, "weight", "distances", &txn_ctx));
+  auto distances = GetDistances(pg.get(), 2, "distances");
+  std::vector<uint32_t> from_0{0, 1, kInfinity, kInfinity};
+  std::vector<uint32_t> from_2{kInfinity, kInfinity, 0, kInfinity};
+  KATANA_LOG_ASSERT(distances[0] == from_0);
+  KATANA_LOG_ASSERT(distances[1] == from_2);
+}
+
+void
+TestNegativeWeights() {
+  auto pg = katana::MakeGraphFromEdges(3, {{0, 1}, {1, 2}});
+  std::vector<int32_t> weights{4, -1};
+  katana::TxnContext txn_ctx;
+  KATANA_LOG_ASSERT(katana::AddEdgeProperties(
+      pg.get(), &txn_ctx,
+      katana::PropertyGenerator(
+          "weight",
+          [&](katana::GraphTopology::Edge e) { return weights[e]; })));
+  auto result =
+      MultiSourceSssp(pg.get(), {0}, "weight", "distances", &txn_ctx);
+  KATANA_LOG_ASSERT(!result);
+  KATANA_LOG_ASSERT(result.error() == katana::ErrorCode::InvalidArgument);
+}
+
+}  // namespace
+
+int
+main() {
+  katana::SharedMemSys S;
+
+  RunAll(MakeRandomGraph(100, 300));
+  RunAll(MakeRandomGraph(150, 1500));
+  TestHeavyEdge();
+  TestNegativeWeights();
+
+  return 0;
+}
@@ -1,7 +1,7 @@
 #ifndef KATANA_LIBSUPPORT_KATANA_CACHE_H_
 #define KATANA_LIBSUPPORT_KATANA_CACHE_H_
 
-// This is single threaded only, it is not intended to store large objects,
+// Cache is single threaded only, it is not intended to store large objects,
 // but rather metadata (e.g., a shared_ptr to a property column).
 
 // The problem witchel had implementing a multi-threaded version using
@@ -11,13 +11,24 @@
 // lock ordering is parallel-hashmap write lock, then list lock.  But without a way to
 // execute insert code with the parallel-hashmap write lock held, it seemed like there
 // would be some form of race condition.
+//
+// ConcurrentCache sidesteps the lock ordering problem by not sharing the LRU list.
+// It partitions keys among shards, each a Cache with its own lock, so every
+// operation takes exactly one lock.  The price is that LRU order is only kept within
+// a shard.
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <arrow/table.h>
 
@@ -27,6 +38,14 @@
 namespace katana {
 
 struct CacheStats {
+  CacheStats& operator+=(const CacheStats& other) {
+    get_count += other.get_count;
+    get_hit_count += other.get_hit_count;
+    insert_count += other.insert_count;
+    insert_hit_count += other.insert_hit_count;
+    return *this;
+  }
+
   float get_hit_percentage() const {
     if (get_count == 0ULL) {
       return 0.0;
@@ -274,10 +293,189 @@ private:
   std::function<size_t(const Value& value)> value_to_bytes_;
 };
 
+/// A thread safe Cache.  Keys are hashed to one of a fixed number of shards,
+/// each of which is a Cache protected by its own lock, so threads working on
+/// different keys rarely contend.  Replacement is LRU within a shard, not
+/// across the whole cache.  The capacity of a kLRUSize or kLRUBytes cache is
+/// divided among the shards, with the remainder spread one unit each over the
+/// first shards, so an object larger than a shard's share of the bytes is not
+/// cached.
+template <typename Value>
+class KATANA_EXPORT ConcurrentCache {
+  using Key = katana::Uri;
+
+public:
+  static constexpr size_t kDefaultNumShards = 16;
+
+  /// Construct an LRU cache that has a fixed number of entries.
+  ConcurrentCache(size_t capacity, size_t num_shards = kDefaultNumShards)
+      : capacity_(capacity) {
+    KATANA_LOG_VASSERT(capacity_ > 0, "cache requires positive capacity");
+    num_shards = std::clamp<size_t>(num_shards, 1, capacity);
+    for (size_t i = 0; i < num_shards; ++i) {
+      shards_.emplace_back(
+          std::make_unique<Shard>(ShardCapacity(capacity, num_shards, i)));
+    }
+  }
+  /// Construct an LRU cache that holds fixed number of bytes.
+  ConcurrentCache(
+      size_t capacity,  // bytes of entries
+      std::function<size_t(const Value& value)> value_to_bytes,
+      size_t num_shards = kDefaultNumShards)
+      : capacity_(capacity) {
+    KATANA_LOG_VASSERT(capacity_ > 0, "cache requires positive capacity");
+    num_shards = std::clamp<size_t>(num_shards, 1, capacity);
+    for (size_t i = 0; i < num_shards; ++i) {
+      shards_.emplace_back(std::make_unique<Shard>(
+          ShardCapacity(capacity, num_shards, i), value_to_bytes));
+    }
+  }
+  /// Construct an LRU cache that holds whatever we put in it and only evicts when we
+  /// explicitly tell it to do so.
+  ConcurrentCache(
+      std::function<size_t(const Value& value)> value_to_bytes,
+      size_t num_shards = kDefaultNumShards)
+      : capacity_(std::numeric_limits<size_t>::max()) {
+    num_shards = std::max<size_t>(num_shards, 1);
+    for (size_t i = 0; i < num_shards; ++i) {
+      shards_.emplace_back(std::make_unique<Shard>(value_to_bytes));
+    }
+  }
+
+  /// Returns the size of the cache (in number of elements or size of elements,
+  /// depending on the replacement policy).  With concurrent updates this is a
+  /// snapshot that may be out of date when it returns.
+  size_t size() const {
+    size_t total{};
+    for (const auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      total += shard->cache.size();
+    }
+    return total;
+  }
+
+  /// Returns the capacity (in number of elements or size of elements, depending on
+  /// the replacement policy).
+  size_t capacity() const { return capacity_; }
+
+  size_t num_shards() const { return shards_.size(); }
+
+  /// Clear cache
+  void clear() {
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      shard->cache.clear();
+    }
+  }
+
+  /// Returns true if the cache is empty
+  bool empty() const {
+    for (const auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      if (!shard->cache.empty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Try to reclaim \p goal bytes (#entries), evicting least recently used entries to
+  /// do it.  Evictions are spread over the shards so that each gives up its oldest
+  /// entries; since LRU order is per shard, each call starts at the shard after the
+  /// one the previous call started at so small goals do not always drain the same
+  /// shard.  Returns the number of bytes actually evicted.
+  size_t Reclaim(size_t goal) {
+    size_t num_shards = shards_.size();
+    size_t start = next_reclaim_shard_.fetch_add(1) % num_shards;
+    size_t reclaimed{};
+    while (reclaimed < goal) {
+      size_t share =
+          std::max<size_t>((goal - reclaimed) / num_shards, size_t{1});
+      size_t round{};
+      for (size_t i = 0; i < num_shards; ++i) {
+        if (reclaimed + round >= goal) {
+          break;
+        }
+        auto& shard = shards_[(start + i) % num_shards];
+        size_t want = std::min(share, goal - reclaimed - round);
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        round += shard->cache.Reclaim(want);
+      }
+      if (round == 0) {
+        // Everything is gone
+        break;
+      }
+      reclaimed += round;
+    }
+    return reclaimed;
+  }
+
+  bool Contains(const Key& key) const {
+    const Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.cache.Contains(key);
+  }
+
+  void Insert(const Key& key, const Value& value) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.cache.Insert(key, value);
+  }
+
+  std::optional<Value> Get(const Key& key) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.cache.Get(key);
+  }
+
+  std::optional<Value> GetAndEvict(const Key& key) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.cache.GetAndEvict(key);
+  }
+
+  CacheStats GetStats() const {
+    CacheStats stats;
+    for (const auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      stats += shard->cache.GetStats();
+    }
+    return stats;
+  }
+
+private:
+  struct Shard {
+    template <typename... Args>
+    Shard(Args&&... args) : cache(std::forward<Args>(args)...) {}
+
+    mutable std::mutex mutex;
+    Cache<Value> cache;
+  };
+
+  /// Shard \p i's share of \p capacity; the first capacity % num_shards shards
+  /// get one more than the rest
+  static size_t ShardCapacity(size_t capacity, size_t num_shards, size_t i) {
+    return capacity / num_shards + (i < capacity % num_shards ? 1 : 0);
+  }
+
+  Shard& ShardFor(const Key& key) {
+    return *shards_[Key::Hash{}(key) % shards_.size()];
+  }
+  const Shard& ShardFor(const Key& key) const {
+    return *shards_[Key::Hash{}(key) % shards_.size()];
+  }
+
+  size_t capacity_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  // Shard that the next Reclaim starts at
+  std::atomic<size_t> next_reclaim_shard_{0};
+};
+
 // The property cache contains properties NOT in use by the graph and never contains a
 // property that IS in use by the graph.  When a graph unloads a property, it goes
 // into the cache, and when it loads a property it (hopefully) comes from the cache.
-using PropertyCache = Cache<std::shared_ptr<arrow::Table>>;
+// Properties are loaded by several threads at once, so it must be thread safe.
+using PropertyCache = ConcurrentCache<std::shared_ptr<arrow::Table>>;
 
 }  // namespace katana
 
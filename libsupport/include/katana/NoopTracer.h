@@ -57,15 +57,13 @@ public:
 private:
   friend NoopTracer;
 
-  NoopSpan() : ProgressSpan(nullptr), context_(NoopContext{}) {}
-  NoopSpan(std::shared_ptr<ProgressSpan> parent)
-      : ProgressSpan(std::move(parent)), context_(NoopContext{}) {}
+  NoopSpan(const std::string& span_name, std::shared_ptr<ProgressSpan> parent)
+      : ProgressSpan(span_name, std::move(parent)), context_(NoopContext{}) {}
   static std::shared_ptr<ProgressSpan> Make(
-      std::shared_ptr<ProgressSpan> parent) {
-    return std::shared_ptr<NoopSpan>(new NoopSpan(std::move(parent)));
-  }
-  static std::shared_ptr<ProgressSpan> Make() {
-    return std::shared_ptr<NoopSpan>(new NoopSpan());
+      const std::string& span_name,
+      std::shared_ptr<ProgressSpan> parent = nullptr) {
+    return std::shared_ptr<NoopSpan>(
+        new NoopSpan(span_name, std::move(parent)));
   }
 
   void Close() override{};
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "katana/Result.h"
+#include "katana/Time.h"
 #include "katana/config.h"
 
 /// Tracers do not currently support thread-local tracers or concurrency controls.
@@ -101,6 +102,12 @@ class ProgressScope;
 class ProgressSpan;
 class ProgressContext;
 
+/// Called with the name, start time and finish time of every span when it
+/// finishes, independently of the tracer in use
+using SpanListener = std::function<void(
+    const std::string& span_name, const TimePoint& start,
+    const TimePoint& finish)>;
+
 class KATANA_EXPORT ProgressTracer {
 public:
   virtual ~ProgressTracer() = default;
@@ -112,6 +119,12 @@ public:
   static ProgressTracer& Get() { return *tracer_; }
   static void Set(std::unique_ptr<ProgressTracer> tracer);
 
+  /// Set the listener notified of finished spans; an empty listener removes
+  /// the current one. Like starting and finishing spans, this is not
+  /// thread-safe.
+  static void SetSpanListener(SpanListener listener);
+  static const SpanListener& GetSpanListener() { return span_listener_; }
+
   static uint64_t ParseProcSelfRssBytes();
   static HostStats GetHostStats();
   static long GetMaxMem();
@@ -171,6 +184,7 @@ private:
   virtual void Close() = 0;
 
   static std::unique_ptr<ProgressTracer> tracer_;
+  static SpanListener span_listener_;
 
   std::shared_ptr<ProgressSpan> active_span_ = nullptr;
   uint32_t host_id_;
@@ -253,6 +267,7 @@ public:
   virtual bool ScopeClosed();
   bool IsFinished() const { return finished_; }
   const std::shared_ptr<ProgressSpan>& GetParentSpan() { return parent_; }
+  const std::string& GetName() const { return span_name_; }
 
   /// Every ProgressSpan started must be finished
   ///
@@ -267,13 +282,17 @@ public:
   void Finish();
 
 protected:
-  ProgressSpan(std::shared_ptr<ProgressSpan> parent)
-      : parent_(std::move(parent)) {}
+  ProgressSpan(std::string span_name, std::shared_ptr<ProgressSpan> parent)
+      : span_name_(std::move(span_name)),
+        parent_(std::move(parent)),
+        start_(Now()) {}
 
 private:
   virtual void Close() = 0;
 
+  std::string span_name_;
   std::shared_ptr<ProgressSpan> parent_ = nullptr;
+  TimePoint start_;
   bool finished_ = false;
   bool scope_closed_ = false;
 };
@@ -2,6 +2,9 @@
 #define KATANA_LIBSUPPORT_KATANA_TIME_H_
 
 #include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "katana/ErrorCode.h"
 #include "katana/Logging.h"
@@ -223,7 +223,7 @@ katana::JSONSpan::Log(const std::string& message, const katana::Tags& tags) {
 katana::JSONSpan::JSONSpan(
     const std::string& span_name, std::shared_ptr<katana::ProgressSpan> parent,
     OutputCB out_callback)
-    : ProgressSpan(std::move(parent)),
+    : ProgressSpan(span_name, std::move(parent)),
       context_(JSONContext{"", ""}),
       out_callback_(std::move(out_callback)) {
   std::string parent_span_id{"null"};
@@ -254,7 +254,7 @@ katana::JSONSpan::JSONSpan(
 katana::JSONSpan::JSONSpan(
     const std::string& span_name, const katana::ProgressContext& parent,
     OutputCB out_callback)
-    : ProgressSpan(nullptr),
+    : ProgressSpan(span_name, nullptr),
       context_(JSONContext{"", ""}),
       out_callback_(std::move(out_callback)) {
   std::string parent_span_id = parent.GetSpanID();
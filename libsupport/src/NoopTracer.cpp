@@ -7,9 +7,9 @@ katana::NoopTracer::Make(uint32_t host_id, uint32_t num_hosts) {
 
 std::shared_ptr<katana::ProgressSpan>
 katana::NoopTracer::StartSpan(
-    [[maybe_unused]] const std::string& span_name,
+    const std::string& span_name,
     [[maybe_unused]] const ProgressContext& child_of) {
-  return NoopSpan::Make();
+  return NoopSpan::Make(span_name);
 }
 
 std::unique_ptr<katana::ProgressContext>
@@ -19,9 +19,8 @@ katana::NoopTracer::Extract([[maybe_unused]] const std::string& carrier) {
 
 std::shared_ptr<katana::ProgressSpan>
 katana::NoopTracer::StartSpan(
-    [[maybe_unused]] const std::string& span_name,
-    std::shared_ptr<ProgressSpan> child_of) {
-  return NoopSpan::Make(std::move(child_of));
+    const std::string& span_name, std::shared_ptr<ProgressSpan> child_of) {
+  return NoopSpan::Make(span_name, std::move(child_of));
 }
 
 std::unique_ptr<katana::ProgressContext>
@@ -21,6 +21,7 @@
 
 std::unique_ptr<katana::ProgressTracer> katana::ProgressTracer::tracer_ =
     nullptr;
+katana::SpanListener katana::ProgressTracer::span_listener_;
 
 katana::ProgressTracer&
 katana::GetTracer() {
@@ -120,6 +121,11 @@ katana::ProgressTracer::Set(std::unique_ptr<katana::ProgressTracer> tracer) {
   ProgressTracer::tracer_ = std::move(tracer);
 }
 
+void
+katana::ProgressTracer::SetSpanListener(katana::SpanListener listener) {
+  ProgressTracer::span_listener_ = std::move(listener);
+}
+
 katana::ProgressScope
 katana::ProgressTracer::StartActiveSpan(const std::string& span_name) {
   return SetActiveSpan(StartSpan(span_name, active_span_));
@@ -246,6 +252,9 @@ katana::ProgressSpan::Finish() {
   if (!finished_) {
     finished_ = true;
     Close();
+    if (const auto& listener = ProgressTracer::GetSpanListener(); listener) {
+      listener(span_name_, start_, Now());
+    }
   }
   ProgressTracer& tracer = ProgressTracer::Get();
   if (tracer.HasActiveSpan() && this == &tracer.GetActiveSpan()) {
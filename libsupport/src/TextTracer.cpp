@@ -143,7 +143,7 @@ katana::TextSpan::Log(const std::string& message, const katana::Tags& tags) {
 
 katana::TextSpan::TextSpan(
     const std::string& span_name, std::shared_ptr<katana::ProgressSpan> parent)
-    : ProgressSpan(std::move(parent)),
+    : ProgressSpan(span_name, std::move(parent)),
       context_(TextContext{"0", "0"}),
       span_name_(span_name) {
   std::string message = "starting " + span_name;
@@ -160,7 +160,7 @@ katana::TextSpan::TextSpan(
 katana::TextSpan::TextSpan(
     const std::string& span_name,
     [[maybe_unused]] const katana::ProgressContext& parent)
-    : ProgressSpan(nullptr),
+    : ProgressSpan(span_name, nullptr),
       context_(TextContext{"0", "0"}),
       span_name_(span_name) {
   std::string message = "starting " + span_name;
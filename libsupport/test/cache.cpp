@@ -1,7 +1,9 @@
 #include "katana/Cache.h"
 
+#include <atomic>
 #include <map>
 #include <random>
+#include <thread>
 
 #include "katana/Cache.h"
 #include "katana/Logging.h"
@@ -212,6 +214,97 @@ TestLRUSize(size_t lru_size, const std::vector<katana::Uri>& keys) {
   KATANA_LOG_ASSERT(cache.size() == 0);
 }
 
+void
+TestConcurrent(const std::vector<katana::Uri>& keys) {
+  constexpr size_t kNumThreads = 8;
+  size_t lru_size = keys.size() / 2;
+  katana::ConcurrentCache<CacheValue> cache(lru_size, 4);
+  KATANA_LOG_ASSERT(cache.num_shards() == 4);
+  KATANA_LOG_ASSERT(cache.capacity() == lru_size);
+
+  // Each thread inserts and then looks up its own slice of the keys
+  std::atomic<uint64_t> hits{0};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (size_t i = t; i < keys.size(); i += kNumThreads) {
+        cache.Insert(keys[i], SizeOneValue());
+      }
+      for (size_t i = t; i < keys.size(); i += kNumThreads) {
+        if (cache.Get(keys[i]).has_value()) {
+          hits++;
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  KATANA_LOG_VASSERT(
+      cache.size() <= lru_size, "size {} allocated {}", cache.size(),
+      lru_size);
+  auto stats = cache.GetStats();
+  KATANA_LOG_ASSERT(stats.insert_count == keys.size());
+  KATANA_LOG_ASSERT(stats.get_count == keys.size());
+  KATANA_LOG_ASSERT(stats.get_hit_count == hits.load());
+
+  cache.clear();
+  KATANA_LOG_ASSERT(cache.empty());
+}
+
+void
+TestConcurrentRemainder(const std::vector<katana::Uri>& keys) {
+  // 10 does not divide evenly among 4 shards; the remainder must not be lost
+  constexpr size_t kCapacity = 10;
+  katana::ConcurrentCache<CacheValue> cache(kCapacity, 4);
+  KATANA_LOG_ASSERT(keys.size() > 8 * kCapacity);
+  for (const auto& key : keys) {
+    cache.Insert(key, SizeOneValue());
+  }
+  KATANA_LOG_VASSERT(
+      cache.size() == kCapacity, "size {} capacity {}", cache.size(),
+      kCapacity);
+}
+
+void
+TestConcurrentExplicit(const std::vector<katana::Uri>& keys) {
+  katana::ConcurrentCache<CacheValue> cache(
+      [](const CacheValue& value) { return BytesInValue(value); });
+
+  std::vector<std::thread> threads;
+  constexpr size_t kNumThreads = 4;
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (size_t i = t; i < keys.size(); i += kNumThreads) {
+        cache.Insert(keys[i], SizeOneValue());
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  // Nothing is evicted until we ask
+  KATANA_LOG_ASSERT(cache.size() == keys.size());
+  for (const auto& key : keys) {
+    KATANA_LOG_ASSERT(cache.Contains(key));
+  }
+
+  auto val = cache.GetAndEvict(keys[0]);
+  KATANA_LOG_ASSERT(val.has_value() && val.value().a == 0);
+  KATANA_LOG_ASSERT(!cache.Contains(keys[0]));
+
+  size_t goal = keys.size() / 2;
+  size_t reclaimed = cache.Reclaim(goal);
+  KATANA_LOG_VASSERT(reclaimed == goal, "reclaimed {}", reclaimed);
+  KATANA_LOG_ASSERT(cache.size() == keys.size() - 1 - goal);
+
+  // Asking for more than there is empties the cache
+  reclaimed = cache.Reclaim(keys.size());
+  KATANA_LOG_ASSERT(reclaimed == keys.size() - 1 - goal);
+  KATANA_LOG_ASSERT(cache.empty());
+}
+
 int
 main(int argc, char** argv) {
   constexpr size_t lru_size = 10;
@@ -236,5 +329,11 @@ main(int argc, char** argv) {
 
   TestLRUExplicit(keys);
 
+  TestConcurrent(keys);
+
+  TestConcurrentRemainder(keys);
+
+  TestConcurrentExplicit(keys);
+
   return 0;
 }
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <future>
+#include <mutex>
 #include <optional>
 #include <string>
 
@@ -16,6 +17,15 @@ namespace katana {
 
 class KATANA_EXPORT FileView : public arrow::io::RandomAccessFile {
 public:
+  /// Hint describing how the bound region will be read. Only consulted when
+  /// the view maps a local file directly (see file_backed()), where it is
+  /// passed on to the kernel as madvise advice.
+  enum class AccessPattern {
+    kNormal,
+    kSequential,
+    kRandom,
+  };
+
   FileView() = default;
   FileView(const FileView&) = delete;
   FileView& operator=(const FileView&) = delete;
@@ -28,6 +38,8 @@ public:
         mem_start_(other.mem_start_),
         filename_(std::move(other.filename_)),
         bound_(other.bound_),
+        file_backed_(other.file_backed_),
+        access_pattern_(other.access_pattern_),
         filling_(std::move(other.filling_)),
         fetches_(std::move(other.fetches_)) {
     other.bound_ = false;
@@ -45,6 +57,8 @@ public:
       mem_start_ = other.mem_start_;
       filename_ = std::move(other.filename_);
       bound_ = other.bound_;
+      file_backed_ = other.file_backed_;
+      access_pattern_ = other.access_pattern_;
       filling_ = std::move(other.filling_);
       fetches_ =
           std::unique_ptr<std::vector<FillingRange>>(std::move(other.fetches_));
@@ -79,6 +93,17 @@ public:
 
   bool Valid() const { return bound_; }
 
+  /// True if the view maps the underlying local file directly rather than
+  /// copying pages from storage into an anonymous region. File backed views
+  /// are only created for file:// URIs when the FileViewMmapLocal
+  /// experimental feature is enabled.
+  bool file_backed() const { return file_backed_; }
+
+  /// Set the expected access pattern. If the view is currently file backed
+  /// the advice is applied immediately; it is also remembered for later
+  /// calls to Bind.
+  katana::Result<void> SetAccessPattern(AccessPattern pattern);
+
   katana::Result<void> Unbind();
 
   /// Be very careful with this function. It is the caller's responsibility to
@@ -118,12 +143,19 @@ public:
 
   ///// Begin arrow::io::RandomAccessFile methods ///////
 
+  // Read, ReadAt, Seek and Fill may be called from several threads at once;
+  // ReadAt does not move the cursor, so concurrent readers of one view
+  // should use it. Bind, Unbind and Close must not race with anything.
+
   arrow::Status Close() override;
   arrow::Result<int64_t> Tell() const override;
   bool closed() const override;
   arrow::Status Seek(int64_t) override;
   arrow::Result<int64_t> Read(int64_t, void*) override;
   arrow::Result<std::shared_ptr<arrow::Buffer>> Read(int64_t) override;
+  arrow::Result<int64_t> ReadAt(int64_t, int64_t, void*) override;
+  arrow::Result<std::shared_ptr<arrow::Buffer>> ReadAt(
+      int64_t, int64_t) override;
   arrow::Result<int64_t> GetSize() override;
 
   ///// End arrow::io::RandomAccessFile methods ///////
@@ -149,6 +181,21 @@ private:
   katana::Result<void> MarkFilled(
       uint64_t* bitmap, uint64_t begin, uint64_t end);
 
+  // Fill with mutex_ held
+  katana::Result<void> DoFill(uint64_t begin, uint64_t end, bool resolve);
+
+  // Make [position, position + nbytes) readable, with mutex_ held, and
+  // return how many of those bytes the file has
+  arrow::Result<int64_t> PrepareRead(int64_t position, int64_t nbytes);
+
+  // Map a local file directly into memory; used in place of reserving an
+  // anonymous region when the view is file backed
+  katana::Result<void> BindLocal(
+      const std::string& path, uint64_t size, uint64_t begin, uint64_t end);
+
+  // Ask the kernel to start reading [begin, end) of a file backed view
+  katana::Result<void> WillNeed(uint64_t begin, uint64_t end);
+
   // Resolve all outstanding reads that overlap with the range [cursor_, nbytes]
   katana::Result<void> Resolve(int64_t start, int64_t size);
 
@@ -169,8 +216,13 @@ private:
   int64_t mem_start_{0};
   std::string filename_;
   bool bound_{false};
+  bool file_backed_{false};
+  AccessPattern access_pattern_{AccessPattern::kNormal};
   std::vector<uint64_t> filling_;
   std::unique_ptr<std::vector<FillingRange>> fetches_;
+  // Guards cursor_, mem_start_, filling_ and fetches_ once bound; pages stay
+  // filled until Unbind, so copying out of them needs no lock
+  std::mutex mutex_;
 };
 }  // namespace katana
 
@@ -46,6 +46,11 @@ struct KATANA_EXPORT RDGLoadOptions {
   /// List of edge properties that should be loaded
   /// nullptr means all edge properties will be loaded
   std::optional<std::vector<std::string>> edge_properties{std::nullopt};
+  /// Defer loading properties until they are first accessed. Properties not
+  /// named in node_properties or edge_properties are left absent and a
+  /// PropertyGraph made from this RDG loads them on demand in
+  /// GetNodeProperty and GetEdgeProperty
+  bool lazy_properties{false};
   // Each table should only contain a single column.
   // Callback provides a pointer to the RDG so we can evict
   // even before the PropertyGraph is created.
@@ -55,6 +60,7 @@ struct KATANA_EXPORT RDGLoadOptions {
   ///  * load the partition associated with this host
   ///  * load all node properties
   ///  * load all edge properties
+  ///  * load properties eagerly
   ///  * do not use a property cache
   static RDGLoadOptions Defaults() { return RDGLoadOptions{}; }
 };
@@ -186,6 +192,23 @@ public:
   /// cannot be loaded more than once
   katana::Result<void> LoadEdgeProperty(const std::string& name, int i = -1);
 
+  /// Make an unloaded node property present again from \p props, a single
+  /// column table holding the property as it was read from storage, e.g.,
+  /// a copy kept in memory after the property was unloaded. The column is
+  /// inserted at index i as with LoadNodeProperty.
+  katana::Result<void> RestoreNodeProperty(
+      const std::shared_ptr<arrow::Table>& props, int i = -1);
+  katana::Result<void> RestoreEdgeProperty(
+      const std::shared_ptr<arrow::Table>& props, int i = -1);
+
+  /// \returns the location on storage of the named property. The location
+  /// changes whenever the property is modified and written, so it identifies
+  /// the contents of the property.
+  katana::Result<katana::Uri> NodePropertyStorageUri(
+      const std::string& name) const;
+  katana::Result<katana::Uri> EdgePropertyStorageUri(
+      const std::string& name) const;
+
   std::vector<std::string> ListFullNodeProperties() const;
   std::vector<std::string> ListLoadedNodeProperties() const;
   std::vector<std::string> ListFullEdgeProperties() const;
@@ -1,17 +1,67 @@
 #include "katana/FileView.h"
 
+#include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <iomanip>
 #include <string>
 
 #include "katana/ErrorCode.h"
+#include "katana/Experimental.h"
 #include "katana/Logging.h"
 #include "katana/Result.h"
+#include "katana/URI.h"
 #include "katana/file.h"
 
+/// FileViewMmapLocal makes FileViews of file:// URIs map the file itself
+/// (MAP_SHARED, PROT_READ) instead of reserving anonymous memory and copying
+/// pages in from LocalStorage. Readers of the view (RDGTopology::Map,
+/// ParquetReader) then operate directly on the page cache. Like the rest of
+/// FileView this assumes the underlying file is not modified while bound;
+/// see the note below.
+KATANA_EXPERIMENTAL_FEATURE(FileViewMmapLocal);
+
+namespace {
+
+int
+ToAdvice(katana::FileView::AccessPattern pattern) {
+  switch (pattern) {
+  case katana::FileView::AccessPattern::kSequential:
+    return MADV_SEQUENTIAL;
+  case katana::FileView::AccessPattern::kRandom:
+    return MADV_RANDOM;
+  case katana::FileView::AccessPattern::kNormal:
+    return MADV_NORMAL;
+  }
+  return MADV_NORMAL;
+}
+
+/// Tell the kernel that [begin, end) of the size bytes mapped at start will
+/// be read soon
+katana::Result<void>
+AdviseWillNeed(uint8_t* start, uint64_t size, uint64_t begin, uint64_t end) {
+  uint64_t in_end = std::min<uint64_t>(end, size);
+  if (start == nullptr || in_end <= begin) {
+    return katana::ResultSuccess();
+  }
+  // madvise wants a page aligned address
+  uint64_t page_size = sysconf(_SC_PAGESIZE);
+  uint64_t aligned_begin = begin - (begin % page_size);
+  if (int err =
+          madvise(start + aligned_begin, in_end - aligned_begin, MADV_WILLNEED);
+      err) {
+    return KATANA_ERROR(
+        katana::ResultErrno(), "madvise [{}, {})", begin, in_end);
+  }
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
 /*
  * SCB 2020-07-23
  * We have a problem here involving modifying the underlying file. The problem
@@ -58,6 +108,7 @@ katana::FileView::Unbind() {
     KATANA_LOG_DEBUG_ASSERT(fetches_->empty());
 
     bound_ = false;
+    file_backed_ = false;
   }
   return katana::ResultSuccess();
 }
@@ -78,6 +129,13 @@ katana::FileView::Bind(
         begin, end, buf.size);
   }
 
+  if (KATANA_EXPERIMENTAL_ENABLED(FileViewMmapLocal)) {
+    auto uri = KATANA_CHECKED(katana::Uri::Make(filename_));
+    if (uri.scheme() == katana::Uri::kFileScheme) {
+      return BindLocal(uri.path(), buf.size, begin, in_end);
+    }
+  }
+
   // SCB 2020-07-23: Given that page_shift_ is treated as a compile-time
   // constant, it seems silly to have it be a member of this class. But I can
   // imagine one day wanting to set it dynamically based on file type, file
@@ -113,8 +171,93 @@ katana::FileView::Bind(
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::FileView::BindLocal(
+    const std::string& path, uint64_t size, uint64_t begin, uint64_t end) {
+  void* tmp = nullptr;
+
+  if (size > 0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return KATANA_ERROR(
+          katana::ResultErrno(), "opening {}", std::quoted(path));
+    }
+    tmp = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (tmp == MAP_FAILED) {
+      std::error_code ec = katana::ResultErrno();
+      close(fd);
+      return KATANA_ERROR(ec, "mapping {} ({} bytes)", std::quoted(path), size);
+    }
+    // The mapping holds its own reference to the file
+    close(fd);
+
+    // Advise before the mapping is committed to this view, so that it is
+    // still ours to unmap if advising fails
+    auto advised = [&]() -> katana::Result<void> {
+      if (int err = madvise(tmp, size, ToAdvice(access_pattern_)); err) {
+        return KATANA_ERROR(
+            katana::ResultErrno(), "madvise on {}", std::quoted(path));
+      }
+      return AdviseWillNeed(static_cast<uint8_t*>(tmp), size, begin, end);
+    }();
+    if (!advised) {
+      munmap(tmp, size);
+      return advised.error();
+    }
+  }
+
+  std::string filename = std::move(filename_);
+  if (auto res = Unbind(); !res) {
+    if (tmp != nullptr) {
+      munmap(tmp, size);
+    }
+    return res.error();
+  }
+
+  filename_ = std::move(filename);
+  map_start_ = static_cast<uint8_t*>(tmp);
+  file_size_ = size;
+  page_shift_ = 20; /* 1M */
+  // Every page is backed by the file, so there is never anything to fetch
+  filling_.clear();
+  filling_.resize(page_number(size) / 64 + 1, ~UINT64_C(0));
+  mem_start_ = size > 0 ? 0 : -1;
+  fetches_ = std::make_unique<std::vector<FillingRange>>();
+  file_backed_ = true;
+
+  cursor_ = 0;
+  bound_ = true;
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::FileView::SetAccessPattern(AccessPattern pattern) {
+  access_pattern_ = pattern;
+  if (!file_backed_ || map_start_ == nullptr || file_size_ <= 0) {
+    return katana::ResultSuccess();
+  }
+  if (int err = madvise(map_start_, file_size_, ToAdvice(pattern)); err) {
+    return KATANA_ERROR(katana::ResultErrno(), "madvise on {}", filename_);
+  }
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::FileView::WillNeed(uint64_t begin, uint64_t end) {
+  KATANA_CHECKED_CONTEXT(
+      AdviseWillNeed(map_start_, file_size_, begin, end), "advising {}",
+      filename_);
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 katana::FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return DoFill(begin, end, resolve);
+}
+
+katana::Result<void>
+katana::FileView::DoFill(uint64_t begin, uint64_t end, bool resolve) {
   uint64_t in_end = std::min<uint64_t>(end, file_size_);
   uint64_t in_begin = std::min<uint64_t>(begin, in_end);
   uint64_t first_page = 0;
@@ -127,6 +270,14 @@ katana::FileView::Fill(uint64_t begin, uint64_t end, bool resolve) {
   if (!fetches_) {
     return KATANA_ERROR(ErrorCode::InvalidArgument, "not bound");
   }
+  // File backed views are populated by the kernel on access; the most we can
+  // do is tell it what is coming
+  if (file_backed_) {
+    if (resolve) {
+      return katana::ResultSuccess();
+    }
+    return WillNeed(in_begin, in_end);
+  }
   // Gracefully handle the fill zero case here to simplify Bind
   if (in_end != in_begin) {
     if (auto opt =
@@ -218,39 +369,50 @@ katana::FileView::Seek(int64_t seek_to) {
                                 std::to_string(file_size_);
     return arrow::Status(arrow::StatusCode::Invalid, message);
   }
+  std::lock_guard<std::mutex> lock(mutex_);
   cursor_ = seek_to;
   return arrow::Status::OK();
 }
 
-arrow::Result<std::shared_ptr<arrow::Buffer>>
-katana::FileView::Read(int64_t nbytes) {
+arrow::Result<int64_t>
+katana::FileView::PrepareRead(int64_t position, int64_t nbytes) {
   if (!bound_) {
     return arrow::Status(arrow::StatusCode::Invalid, "Unbound FileView");
   }
+  if (position < 0 || position > file_size_) {
+    return arrow::Status(
+        arrow::StatusCode::Invalid,
+        "Cannot read at " + std::to_string(position) + " in file of size " +
+            std::to_string(file_size_));
+  }
 
   // sanitize inputs
-  if (nbytes <= 0 || !map_start_) {
-    return std::make_shared<arrow::Buffer>(map_start_, 0);
-  }
-  int64_t nbytes_internal = nbytes;
-  if (cursor_ + nbytes > file_size_) {
-    nbytes_internal = file_size_ - cursor_;
+  int64_t nbytes_internal = std::min(nbytes, file_size_ - position);
+  if (nbytes_internal <= 0 || !map_start_) {
+    return INT64_C(0);
   }
   // fetch data from storage if necessary
-  if (auto res = Fill(cursor_, cursor_ + nbytes_internal, true); !res) {
+  if (auto res = DoFill(position, position + nbytes_internal, true); !res) {
     return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
   }
   // resolve outstanding relevant fetches
-  if (auto res = Resolve(cursor_, nbytes_internal); !res) {
+  if (auto res = Resolve(position, nbytes_internal); !res) {
     // TODO (scober): Include res.error() as part of arrow Status
     return arrow::Status(
         arrow::StatusCode::IOError, "Resolving asynchronous reads");
   }
   // prefetch
-  if (auto res = PreFetch(cursor_, nbytes_internal); !res) {
+  if (auto res = PreFetch(position, nbytes_internal); !res) {
     // TODO (scober): Include res.error() as part of arrow Status
     return arrow::Status(arrow::StatusCode::IOError, "prefetching");
   }
+  return nbytes_internal;
+}
+
+arrow::Result<std::shared_ptr<arrow::Buffer>>
+katana::FileView::Read(int64_t nbytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ARROW_ASSIGN_OR_RAISE(int64_t nbytes_internal, PrepareRead(cursor_, nbytes));
   // and return the requested data
   auto ret =
       std::make_shared<arrow::Buffer>(map_start_ + cursor_, nbytes_internal);
@@ -260,38 +422,35 @@ katana::FileView::Read(int64_t nbytes) {
 
 arrow::Result<int64_t>
 katana::FileView::Read(int64_t nbytes, void* out) {
-  // sanitize inputs
-  if (nbytes <= 0) {
-    return nbytes;
-  }
-  if (!bound_) {
-    return arrow::Status(arrow::StatusCode::Invalid, "Unbound FileView");
-  }
-  int64_t nbytes_internal = nbytes;
-  if (cursor_ + nbytes > file_size_) {
-    nbytes_internal = file_size_ - cursor_;
-  }
-  // fetch data from storage if necessary
-  if (auto res = Fill(cursor_, cursor_ + nbytes_internal, true); !res) {
-    return arrow::Status(arrow::StatusCode::IOError, "FileView::Fill");
-  }
-  // resolve outstanding relevant fetches
-  if (auto res = Resolve(cursor_, nbytes_internal); !res) {
-    // TODO (scober): Include res.error() as part of arrow Status
-    return arrow::Status(
-        arrow::StatusCode::IOError, "Resolving asynchronous reads");
-  }
-  // prefetch
-  if (auto res = PreFetch(cursor_, nbytes_internal); !res) {
-    // TODO (scober): Include res.error() as part of arrow Status
-    return arrow::Status(arrow::StatusCode::IOError, "prefetching");
-  }
-  // and return the requested data
+  std::lock_guard<std::mutex> lock(mutex_);
+  ARROW_ASSIGN_OR_RAISE(int64_t nbytes_internal, PrepareRead(cursor_, nbytes));
   std::memcpy(out, map_start_ + cursor_, nbytes_internal);
   cursor_ += nbytes_internal;
   return nbytes_internal;
 }
 
+arrow::Result<std::shared_ptr<arrow::Buffer>>
+katana::FileView::ReadAt(int64_t position, int64_t nbytes) {
+  int64_t nbytes_internal = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ARROW_ASSIGN_OR_RAISE(nbytes_internal, PrepareRead(position, nbytes));
+  }
+  return std::make_shared<arrow::Buffer>(
+      map_start_ + position, nbytes_internal);
+}
+
+arrow::Result<int64_t>
+katana::FileView::ReadAt(int64_t position, int64_t nbytes, void* out) {
+  int64_t nbytes_internal = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ARROW_ASSIGN_OR_RAISE(nbytes_internal, PrepareRead(position, nbytes));
+  }
+  std::memcpy(out, map_start_ + position, nbytes_internal);
+  return nbytes_internal;
+}
+
 arrow::Result<int64_t>
 katana::FileView::GetSize() {
   return size();
@@ -464,7 +623,9 @@ katana::FileView::Resolve(int64_t start, int64_t size) {
   // bottleneck
   for (auto it = fetches_->begin(); it != fetches_->end();) {
     auto fetch = it;
-    if (fetch->first_page <= page_number(start + size) ||
+    // Only wait for fetches that overlap the requested range so that reads
+    // of early pages are not held up by fetches of later ones
+    if (fetch->first_page <= page_number(start + size) &&
         fetch->last_page >= page_number(start)) {
       // Complete the remaining work if there is some
       if (fetch->work.valid()) {
@@ -491,6 +652,6 @@ katana::FileView::PreFetch(int64_t start, int64_t size) {
   KATANA_LOG_DEBUG_ASSERT(fetch_size >= 0);
   uint64_t begin = static_cast<uint64_t>(start + size);
   uint64_t end = static_cast<uint64_t>(start + size + fetch_size);
-  KATANA_CHECKED(Fill(begin, end, false));
+  KATANA_CHECKED(DoFill(begin, end, false));
   return katana::ResultSuccess();
 }
@@ -0,0 +1,296 @@
+#include "LocalIOQueue.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <optional>
+
+#include "katana/Env.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/file.h"
+
+namespace {
+
+bool
+IsBlockAligned(uint64_t val) {
+  return (val & katana::kBlockOffsetMask) == 0;
+}
+
+}  // namespace
+
+/// State shared by all of the requests that make up one Read or Write
+struct katana::LocalIOQueue::Batch {
+  std::string path;
+  bool is_write{false};
+  int fd{-1};
+  int direct_fd{-1};
+  std::atomic<uint64_t> remaining{0};
+  std::atomic<uint64_t> short_bytes{0};
+  std::mutex error_mutex;
+  std::optional<katana::CopyableErrorInfo> error;
+  std::promise<katana::CopyableResult<void>> promise;
+
+  Batch(std::string p, bool w) : path(std::move(p)), is_write(w) {}
+
+  Batch(const Batch& no_copy) = delete;
+  Batch& operator=(const Batch& no_copy) = delete;
+
+  ~Batch() {
+    if (fd >= 0) {
+      close(fd);
+    }
+    if (direct_fd >= 0) {
+      close(direct_fd);
+    }
+  }
+
+  void SetError(katana::CopyableErrorInfo err) {
+    std::lock_guard<std::mutex> lock(error_mutex);
+    if (!error) {
+      error = std::move(err);
+    }
+  }
+
+  void CompleteOne() {
+    if (remaining.fetch_sub(1) != 1) {
+      return;
+    }
+    if (error) {
+      promise.set_value(error.value());
+      return;
+    }
+    // if the difference in what was read from what we wanted is less than a
+    // block it's because the file size isn't well aligned so don't complain.
+    if (short_bytes.load() > katana::kBlockSize) {
+      promise.set_value(katana::CopyableErrorInfo(KATANA_ERROR(
+          katana::ErrorCode::LocalStorageError,
+          "short read of {}: missing {} bytes", std::quoted(path),
+          short_bytes.load())));
+      return;
+    }
+    promise.set_value(katana::CopyableResultSuccess());
+  }
+};
+
+katana::LocalIOQueue::Options
+katana::LocalIOQueue::Options::FromEnv() {
+  Options options;
+  if (int val = 0; GetEnv("KATANA_LOCAL_IO_THREADS", &val) && val >= 0) {
+    options.num_threads = val;
+  }
+  if (int val = 0; GetEnv("KATANA_LOCAL_IO_QUEUE_DEPTH", &val) && val > 0) {
+    options.queue_depth = val;
+  }
+  if (int val = 0; GetEnv("KATANA_LOCAL_IO_REQUEST_SIZE", &val) && val > 0) {
+    options.max_request_size = std::max<uint64_t>(
+        RoundUpToBlock(static_cast<uint64_t>(val)), kBlockSize);
+  }
+  if (bool val = false; GetEnv("KATANA_LOCAL_IO_DIRECT", &val)) {
+    options.direct = val;
+  }
+  return options;
+}
+
+katana::LocalIOQueue::~LocalIOQueue() { Stop(); }
+
+katana::Result<void>
+katana::LocalIOQueue::Start(const Options& options) {
+  if (running()) {
+    return KATANA_ERROR(
+        ErrorCode::AlreadyExists, "local I/O queue already started");
+  }
+  options_ = options;
+  stopping_ = false;
+  // num_threads == 0 leaves the queue stopped; requests are then serviced
+  // synchronously by the caller
+  for (size_t i = 0; i < options_.num_threads; ++i) {
+    threads_.emplace_back([this]() { Work(); });
+  }
+  return katana::ResultSuccess();
+}
+
+void
+katana::LocalIOQueue::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  not_empty_.notify_all();
+  for (auto& t : threads_) {
+    t.join();
+  }
+  threads_.clear();
+}
+
+std::future<katana::CopyableResult<void>>
+katana::LocalIOQueue::Read(
+    const std::string& path, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  auto batch = std::make_shared<Batch>(path, false);
+  auto future = batch->promise.get_future();
+
+  batch->fd = open(path.c_str(), O_RDONLY);
+  if (batch->fd < 0) {
+    batch->promise.set_value(katana::CopyableErrorInfo(KATANA_ERROR(
+        katana::ResultErrno(), "failed to open source file {}",
+        std::quoted(path))));
+    return future;
+  }
+  if (options_.direct) {
+    // Not fatal; we fall back to buffered reads for the whole batch
+    batch->direct_fd = open(path.c_str(), O_RDONLY | O_DIRECT);
+  }
+
+  uint64_t chunk = std::max<uint64_t>(options_.max_request_size, kBlockSize);
+  uint64_t num_requests = std::max<uint64_t>((size + chunk - 1) / chunk, 1);
+  batch->remaining = num_requests;
+  std::vector<Request> requests;
+  requests.reserve(num_requests);
+  for (uint64_t i = 0; i < num_requests; ++i) {
+    uint64_t offset = i * chunk;
+    requests.emplace_back(Request{
+        .batch = batch,
+        .offset = start + offset,
+        .size = std::min(chunk, size - std::min(size, offset)),
+        .buf = result_buf + offset,
+    });
+  }
+  SubmitBatch(std::move(requests));
+  return future;
+}
+
+std::future<katana::CopyableResult<void>>
+katana::LocalIOQueue::Write(
+    const std::string& path, const uint8_t* data, uint64_t size) {
+  auto batch = std::make_shared<Batch>(path, true);
+  auto future = batch->promise.get_future();
+
+  batch->fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (batch->fd < 0) {
+    batch->promise.set_value(katana::CopyableErrorInfo(KATANA_ERROR(
+        katana::ResultErrno(), "opening file {}", std::quoted(path))));
+    return future;
+  }
+  if (options_.direct) {
+    batch->direct_fd = open(path.c_str(), O_WRONLY | O_DIRECT);
+  }
+
+  uint64_t chunk = std::max<uint64_t>(options_.max_request_size, kBlockSize);
+  uint64_t num_requests = std::max<uint64_t>((size + chunk - 1) / chunk, 1);
+  batch->remaining = num_requests;
+  std::vector<Request> requests;
+  requests.reserve(num_requests);
+  for (uint64_t i = 0; i < num_requests; ++i) {
+    uint64_t offset = i * chunk;
+    requests.emplace_back(Request{
+        .batch = batch,
+        .offset = offset,
+        .size = std::min(chunk, size - std::min(size, offset)),
+        // pwrite does not modify the buffer; Request is shared with reads
+        .buf = const_cast<uint8_t*>(data) + offset,  // NOLINT
+    });
+  }
+  SubmitBatch(std::move(requests));
+  return future;
+}
+
+void
+katana::LocalIOQueue::SubmitBatch(std::vector<Request>&& batch) {
+  if (!running()) {
+    for (const auto& req : batch) {
+      Execute(req);
+    }
+    return;
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto& req : batch) {
+      if (queue_.size() >= options_.queue_depth) {
+        // Let the workers at what is already queued before waiting for room
+        not_empty_.notify_all();
+        not_full_.wait(
+            lock, [this]() { return queue_.size() < options_.queue_depth; });
+      }
+      queue_.emplace_back(std::move(req));
+      max_queued_ = std::max(max_queued_, queue_.size());
+    }
+  }
+  if (batch.size() == 1) {
+    not_empty_.notify_one();
+  } else {
+    not_empty_.notify_all();
+  }
+}
+
+size_t
+katana::LocalIOQueue::max_queued() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return max_queued_;
+}
+
+void
+katana::LocalIOQueue::Work() {
+  for (;;) {
+    Request req;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_empty_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+      // Drain the queue before exiting so no future is left unsatisfied
+      if (queue_.empty()) {
+        return;
+      }
+      req = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    not_full_.notify_one();
+    Execute(req);
+  }
+}
+
+void
+katana::LocalIOQueue::Execute(const Request& req) {
+  Batch& batch = *req.batch;
+
+  int fd = batch.fd;
+  if (batch.direct_fd >= 0 && IsBlockAligned(req.offset) &&
+      IsBlockAligned(req.size) &&
+      IsBlockAligned(reinterpret_cast<uintptr_t>(req.buf))) {
+    fd = batch.direct_fd;
+  }
+
+  uint64_t done = 0;
+  while (done < req.size) {
+    ssize_t ret = 0;
+    if (batch.is_write) {
+      ret = pwrite(fd, req.buf + done, req.size - done, req.offset + done);
+    } else {
+      ret = pread(fd, req.buf + done, req.size - done, req.offset + done);
+    }
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      batch.SetError(KATANA_ERROR(
+          katana::ResultErrno(), "{} {} at offset {}",
+          batch.is_write ? "writing" : "reading", std::quoted(batch.path),
+          req.offset + done));
+      break;
+    }
+    if (ret == 0) {
+      // end of file
+      batch.short_bytes += req.size - done;
+      break;
+    }
+    done += ret;
+    // a partial transfer leaves us unaligned, finish with the buffered fd
+    fd = batch.fd;
+  }
+
+  batch.CompleteOne();
+}
@@ -0,0 +1,103 @@
+#ifndef KATANA_LIBTSUBA_LOCALIOQUEUE_H_
+#define KATANA_LIBTSUBA_LOCALIOQUEUE_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "katana/Result.h"
+
+namespace katana {
+
+/// LocalIOQueue services the asynchronous requests of LocalStorage with a
+/// fixed pool of threads issuing pread/pwrite against the file system.
+///
+/// Requests are placed in a bounded queue; submitters block once the queue
+/// holds queue_depth requests, which keeps a burst of FileView fills from
+/// creating an unbounded amount of work. Large reads are split into
+/// max_request_size pieces so that a single Fill of many pages is serviced by
+/// several threads at once. The pieces of one read or write are queued as a
+/// batch, under one lock acquisition and with one wakeup of the workers, and
+/// requests are serviced in the order they were queued.
+class LocalIOQueue {
+public:
+  struct Options {
+    /// Number of threads issuing I/O
+    size_t num_threads{8};
+    /// Maximum number of requests waiting to be serviced
+    size_t queue_depth{256};
+    /// Reads larger than this are split into multiple requests
+    uint64_t max_request_size{UINT64_C(4) << 20};
+    /// Open files with O_DIRECT and use it for requests whose offset, size
+    /// and buffer are suitably aligned
+    bool direct{false};
+
+    /// Defaults overridden by KATANA_LOCAL_IO_THREADS,
+    /// KATANA_LOCAL_IO_QUEUE_DEPTH, KATANA_LOCAL_IO_REQUEST_SIZE and
+    /// KATANA_LOCAL_IO_DIRECT
+    static Options FromEnv();
+  };
+
+  LocalIOQueue() = default;
+  LocalIOQueue(const LocalIOQueue& no_copy) = delete;
+  LocalIOQueue& operator=(const LocalIOQueue& no_copy) = delete;
+  LocalIOQueue(LocalIOQueue&& no_move) = delete;
+  LocalIOQueue& operator=(LocalIOQueue&& no_move) = delete;
+  ~LocalIOQueue();
+
+  katana::Result<void> Start(const Options& options);
+
+  /// Wait for outstanding requests to complete and join the worker threads
+  void Stop();
+
+  bool running() const { return !threads_.empty(); }
+
+  /// The largest number of requests that have waited in the queue at once;
+  /// never more than queue_depth
+  size_t max_queued();
+
+  /// Read [start, start + size) of the file at path into result_buf. As with
+  /// LocalStorage::ReadFile, reading less than a block short of size
+  /// because the file ends is not an error.
+  std::future<katana::CopyableResult<void>> Read(
+      const std::string& path, uint64_t start, uint64_t size,
+      uint8_t* result_buf);
+
+  /// Replace the contents of the file at path with data. The caller must
+  /// keep data alive until the returned future is ready.
+  std::future<katana::CopyableResult<void>> Write(
+      const std::string& path, const uint8_t* data, uint64_t size);
+
+private:
+  struct Batch;
+
+  struct Request {
+    std::shared_ptr<Batch> batch;
+    uint64_t offset;
+    uint64_t size;
+    uint8_t* buf;
+  };
+
+  void SubmitBatch(std::vector<Request>&& batch);
+  void Work();
+  void Execute(const Request& req);
+
+  Options options_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<Request> queue_;
+  size_t max_queued_{0};
+  std::vector<std::thread> threads_;
+  bool stopping_{false};
+};
+
+}  // namespace katana
+
+#endif
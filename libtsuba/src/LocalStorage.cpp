@@ -127,6 +127,29 @@ katana::LocalStorage::ReadFile(
   return katana::ResultSuccess();
 }
 
+std::future<katana::CopyableResult<void>>
+katana::LocalStorage::PutAsync(
+    const std::string& uri, const uint8_t* data, uint64_t size) {
+  std::string filename = uri;
+  CleanUri(&filename);
+  if (auto res = EnsureDirectories(filename); !res) {
+    katana::CopyableErrorInfo cei{res.error()};
+    return std::async(
+        std::launch::deferred,
+        [=]() -> katana::CopyableResult<void> { return cei; });
+  }
+  return io_queue_.Write(filename, data, size);
+}
+
+std::future<katana::CopyableResult<void>>
+katana::LocalStorage::GetAsync(
+    const std::string& uri, uint64_t start, uint64_t size,
+    uint8_t* result_buf) {
+  std::string filename = uri;
+  CleanUri(&filename);
+  return io_queue_.Read(filename, start, size, result_buf);
+}
+
 katana::Result<void>
 katana::LocalStorage::Stat(const std::string& uri, StatBuf* s_buf) {
   std::string filename = uri;
@@ -8,14 +8,17 @@
 #include <string>
 #include <thread>
 
+#include "LocalIOQueue.h"
 #include "katana/FileStorage.h"
 #include "katana/Result.h"
 
 namespace katana {
 
-/// Store byte arrays to the local file system; Provided as a convenience for
-/// testing only (un-optimized)
+/// Store byte arrays to the local file system. Asynchronous requests are
+/// serviced by a LocalIOQueue started in Init.
 class LocalStorage : public FileStorage {
+  LocalIOQueue io_queue_;
+
   void CleanUri(std::string* uri);
   katana::Result<void> WriteFile(
       std::string, const uint8_t* data, uint64_t size);
@@ -28,8 +31,13 @@ class LocalStorage : public FileStorage {
 public:
   LocalStorage() : FileStorage("file://") {}
 
-  katana::Result<void> Init() override { return katana::ResultSuccess(); }
-  katana::Result<void> Fini() override { return katana::ResultSuccess(); }
+  katana::Result<void> Init() override {
+    return io_queue_.Start(LocalIOQueue::Options::FromEnv());
+  }
+  katana::Result<void> Fini() override {
+    io_queue_.Stop();
+    return katana::ResultSuccess();
+  }
   katana::Result<void> Stat(const std::string& uri, StatBuf* size) override;
 
   uint32_t Priority() const override { return 1; }
@@ -53,34 +61,10 @@ public:
 
   // get on future can potentially block (bulk synchronous parallel)
   std::future<katana::CopyableResult<void>> PutAsync(
-      const std::string& uri, const uint8_t* data, uint64_t size) override {
-    // No need for AsyncPut to local storage right now
-    if (auto write_res = WriteFile(uri, data, size); !write_res) {
-      katana::CopyableErrorInfo cei{write_res.error()};
-      return std::async(
-          std::launch::deferred,
-          [=]() -> katana::CopyableResult<void> { return cei; });
-    }
-    return std::async(
-        std::launch::deferred, []() -> katana::CopyableResult<void> {
-          return katana::CopyableResultSuccess();
-        });
-  }
+      const std::string& uri, const uint8_t* data, uint64_t size) override;
   std::future<katana::CopyableResult<void>> GetAsync(
       const std::string& uri, uint64_t start, uint64_t size,
-      uint8_t* result_buf) override {
-    // I suppose there is no need for AsyncGet to local storage either
-    if (auto read_res = ReadFile(uri, start, size, result_buf); !read_res) {
-      katana::CopyableErrorInfo cei{read_res.error()};
-      return std::async(
-          std::launch::deferred,
-          [=]() -> katana::CopyableResult<void> { return cei; });
-    }
-    return std::async(
-        std::launch::deferred, []() -> katana::CopyableResult<void> {
-          return katana::CopyableResultSuccess();
-        });
-  }
+      uint8_t* result_buf) override;
   std::future<katana::CopyableResult<void>> ListAsync(
       const std::string& uri, std::vector<std::string>* list,
       std::vector<uint64_t>* size) override;
@@ -1,5 +1,7 @@
 #include "katana/ParquetReader.h"
 
+#include <algorithm>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <unordered_map>
@@ -9,7 +11,13 @@
 #include <arrow/compute/cast.h>
 #include <arrow/type.h>
 #include <arrow/type_fwd.h>
+#include <arrow/type_traits.h>
+#include <arrow/util/bitmap_ops.h>
+#include <arrow/util/parallel.h>
+#include <arrow/util/thread_pool.h>
 #include <parquet/arrow/schema.h>
+#include <parquet/exception.h>
+#include <parquet/file_reader.h>
 
 #include "katana/ErrorCode.h"
 #include "katana/FileView.h"
@@ -62,6 +70,11 @@ BuildReader(
     std::shared_ptr<katana::FileView>* fv) {
   auto fv_tmp = std::make_shared<katana::FileView>();
   uint64_t end = preload ? std::numeric_limits<uint64_t>::max() : 0;
+  if (preload) {
+    // Preloaded files are decoded front to back
+    KATANA_CHECKED(
+        fv_tmp->SetAccessPattern(katana::FileView::AccessPattern::kSequential));
+  }
   KATANA_CHECKED_CONTEXT(
       fv_tmp->Bind(uri, 0, end, false), "opening {}; begin: {}, end: {}", uri,
       0, end);
@@ -109,6 +122,64 @@ ReadTableSlice(
   return out->Slice(row_offset, last_row - first_row);
 }
 
+/// Open a reader of its own over an already opened parquet file. Readers
+/// keep per-file decoding state and must not be shared between threads, so
+/// each concurrent row group decode gets one; reusing \p metadata skips
+/// reading and parsing the footer again, which makes this cheap.
+Result<std::unique_ptr<parquet::arrow::FileReader>>
+OpenSharedFile(
+    const std::shared_ptr<katana::FileView>& fv,
+    const std::shared_ptr<parquet::FileMetaData>& metadata) {
+  std::unique_ptr<parquet::ParquetFileReader> file_reader;
+  try {
+    file_reader = parquet::ParquetFileReader::Open(
+        fv, parquet::default_reader_properties(), metadata);
+  } catch (const parquet::ParquetException& e) {
+    return KATANA_ERROR(
+        ErrorCode::ArrowError, "opening {}: {}", fv->filename(), e.what());
+  }
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+  KATANA_CHECKED(parquet::arrow::FileReader::Make(
+      arrow::default_memory_pool(), std::move(file_reader), &reader));
+  return std::unique_ptr<parquet::arrow::FileReader>(std::move(reader));
+}
+
+/// Columns of these types are decoded straight into a single preallocated
+/// array instead of being concatenated after all row groups are read
+bool
+IsStitchable(const std::shared_ptr<arrow::DataType>& type) {
+  return arrow::is_fixed_width(type->id()) &&
+         type->id() != arrow::Type::NA && type->id() != arrow::Type::BOOL &&
+         type->id() != arrow::Type::DICTIONARY &&
+         type->id() != arrow::Type::EXTENSION;
+}
+
+/// Byte range of row group \p rg in a parquet file, covering dictionary and
+/// data pages of every column chunk
+std::pair<uint64_t, uint64_t>
+RowGroupByteRange(const parquet::FileMetaData& md, int rg) {
+  auto rg_md = md.RowGroup(rg);
+  uint64_t begin = std::numeric_limits<uint64_t>::max();
+  uint64_t end = 0;
+  for (int c = 0, num_cols = rg_md->num_columns(); c < num_cols; ++c) {
+    auto col_md = rg_md->ColumnChunk(c);
+    int64_t col_begin = col_md->data_page_offset();
+    if (col_md->has_dictionary_page() &&
+        col_md->dictionary_page_offset() > 0 &&
+        col_md->dictionary_page_offset() < col_begin) {
+      col_begin = col_md->dictionary_page_offset();
+    }
+    begin = std::min(begin, static_cast<uint64_t>(col_begin));
+    end = std::max(
+        end,
+        static_cast<uint64_t>(col_begin + col_md->total_compressed_size()));
+  }
+  if (begin > end) {
+    return {0, 0};
+  }
+  return {begin, end};
+}
+
 class BlockedParquetReader {
 public:
   /// Read a potentially blocked Parquet file at the provide uri
@@ -203,14 +274,7 @@ public:
   Result<std::shared_ptr<arrow::Table>> ReadTable(
       std::optional<katana::ParquetReader::Slice> slice = std::nullopt) {
     if (!slice) {
-      std::vector<std::shared_ptr<arrow::Table>> tables;
-      for (size_t i = 0, num_files = readers_.size(); i < num_files; ++i) {
-        KATANA_CHECKED(EnsureReader(i, true));
-        std::shared_ptr<arrow::Table> table;
-        KATANA_CHECKED(readers_[i]->ReadTable(&table));
-        tables.emplace_back(std::move(table));
-      }
-      return KATANA_CHECKED(arrow::ConcatenateTables(tables));
+      return ReadAllRowGroups();
     }
 
     int64_t curr_global_row = slice->offset;
@@ -317,6 +381,168 @@ public:
     return concatenated_table;
   }
 
+  /// Read every row group of every file, decoding row groups concurrently.
+  ///
+  /// Fetches for each row group are started up front, in table order, so the
+  /// first row groups can be decoded while later ones are still arriving from
+  /// storage. Fixed width columns are copied into one preallocated array as
+  /// each row group finishes, which leaves nothing to concatenate at the end;
+  /// other columns are returned as a ChunkedArray with a chunk per row group.
+  Result<std::shared_ptr<arrow::Table>> ReadAllRowGroups() {
+    struct RowGroupTask {
+      size_t file;
+      int row_group;
+      int64_t first_row;
+      std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+    };
+
+    std::vector<RowGroupTask> tasks;
+    int64_t num_rows = 0;
+    for (size_t i = 0, num_files = readers_.size(); i < num_files; ++i) {
+      KATANA_CHECKED(EnsureReader(i, false));
+      const auto& md = *readers_[i]->parquet_reader()->metadata();
+      for (int rg = 0, num_rgs = md.num_row_groups(); rg < num_rgs; ++rg) {
+        auto [begin, end] = RowGroupByteRange(md, rg);
+        KATANA_CHECKED(fvs_[i]->Fill(begin, end, false));
+        tasks.emplace_back(RowGroupTask{
+            .file = i,
+            .row_group = rg,
+            .first_row = num_rows,
+            .columns = {},
+        });
+        num_rows += md.RowGroup(rg)->num_rows();
+      }
+    }
+
+    std::shared_ptr<arrow::Schema> schema;
+    KATANA_CHECKED(readers_[0]->GetSchema(&schema));
+    int num_cols = schema->num_fields();
+
+    if (tasks.empty()) {
+      std::shared_ptr<arrow::Table> table;
+      KATANA_CHECKED(readers_[0]->ReadTable(&table));
+      return table;
+    }
+
+    // Output buffers for columns that are stitched in place
+    std::vector<std::shared_ptr<arrow::Buffer>> values(num_cols);
+    std::vector<int> byte_widths(num_cols, 0);
+    for (int c = 0; c < num_cols; ++c) {
+      const auto& type = schema->field(c)->type();
+      if (!IsStitchable(type)) {
+        continue;
+      }
+      byte_widths[c] =
+          static_cast<const arrow::FixedWidthType&>(*type).bit_width() / 8;
+      values[c] =
+          KATANA_CHECKED(arrow::AllocateBuffer(num_rows * byte_widths[c]));
+    }
+
+    // Row groups are decoded on Arrow's CPU thread pool, which is shared by
+    // every reader in the process, so loading many properties at once does
+    // not oversubscribe the machine. Each task decodes with a reader of its
+    // own. The readers share the file's FileView, whose ReadAt is safe to
+    // call concurrently: it locks the view only to resolve fetches, and
+    // parquet reads column chunks with ReadAt rather than through the
+    // shared cursor.
+    auto decode = [&](int t) -> arrow::Status {
+      RowGroupTask& task = tasks[t];
+      auto reader_res = OpenSharedFile(
+          fvs_[task.file], readers_[task.file]->parquet_reader()->metadata());
+      if (!reader_res) {
+        return arrow::Status::IOError(fmt::format("{}", reader_res.error()));
+      }
+      std::shared_ptr<arrow::Table> table;
+      auto status = reader_res.value()->ReadRowGroup(task.row_group, &table);
+      if (!status.ok()) {
+        return arrow::Status(
+            status.code(),
+            fmt::format(
+                "reading row group {} of {}: {}", task.row_group,
+                fvs_[task.file]->filename(), status.message()));
+      }
+      task.columns = table->columns();
+      for (int c = 0; c < num_cols; ++c) {
+        if (!values[c]) {
+          continue;
+        }
+        uint8_t* out =
+            values[c]->mutable_data() + task.first_row * byte_widths[c];
+        for (const auto& chunk : task.columns[c]->chunks()) {
+          const auto& data = chunk->data();
+          if (chunk->length() > 0) {
+            std::memcpy(
+                out, data->buffers[1]->data() + data->offset * byte_widths[c],
+                chunk->length() * byte_widths[c]);
+          }
+          out += chunk->length() * byte_widths[c];
+        }
+        // Keep the validity information until the bitmap is built; drop
+        // the decoded values now
+        if (task.columns[c]->null_count() == 0) {
+          task.columns[c].reset();
+        }
+      }
+      return arrow::Status::OK();
+    };
+
+    // ParallelFor blocks until its tasks finish. If this reader is itself
+    // running on the CPU pool, blocking a pool thread on tasks queued behind
+    // it can deadlock a busy pool, so decode serially instead.
+    bool use_threads = !arrow::internal::GetCpuThreadPool()->OwnsThisThread();
+    KATANA_CHECKED(arrow::internal::OptionalParallelFor(
+        use_threads, static_cast<int>(tasks.size()), decode));
+
+    std::vector<std::shared_ptr<arrow::ChunkedArray>> columns;
+    for (int c = 0; c < num_cols; ++c) {
+      const auto& type = schema->field(c)->type();
+      if (!values[c]) {
+        std::vector<std::shared_ptr<arrow::Array>> chunks;
+        for (auto& task : tasks) {
+          const auto& task_chunks = task.columns[c]->chunks();
+          chunks.insert(chunks.end(), task_chunks.begin(), task_chunks.end());
+          task.columns[c].reset();
+        }
+        columns.emplace_back(
+            KATANA_CHECKED(arrow::ChunkedArray::Make(std::move(chunks), type)));
+        continue;
+      }
+
+      // Rebuild the validity bitmap for row groups that had nulls
+      int64_t null_count = 0;
+      std::shared_ptr<arrow::Buffer> validity;
+      for (auto& task : tasks) {
+        if (!task.columns[c]) {
+          continue;
+        }
+        if (!validity) {
+          validity = KATANA_CHECKED(
+              arrow::AllocateBitmap(num_rows, arrow::default_memory_pool()));
+          std::memset(validity->mutable_data(), 0xff, validity->size());
+        }
+        int64_t row = task.first_row;
+        for (const auto& chunk : task.columns[c]->chunks()) {
+          const auto& data = chunk->data();
+          if (chunk->null_count() > 0 && data->buffers[0]) {
+            arrow::internal::CopyBitmap(
+                data->buffers[0]->data(), data->offset, chunk->length(),
+                validity->mutable_data(), row);
+            null_count += chunk->null_count();
+          }
+          row += chunk->length();
+        }
+        task.columns[c].reset();
+      }
+
+      auto array = arrow::MakeArray(arrow::ArrayData::Make(
+          type, num_rows, {std::move(validity), std::move(values[c])},
+          null_count));
+      columns.emplace_back(std::make_shared<arrow::ChunkedArray>(array));
+    }
+
+    return arrow::Table::Make(schema, columns, num_rows);
+  }
+
   Result<std::vector<std::string>> GetFiles() {
     std::vector<std::string> sub_files;
     sub_files.reserve(fvs_.size());
@@ -367,17 +593,17 @@ katana::ParquetReader::Make(ReadOpts opts) {
 Result<std::shared_ptr<arrow::Table>>
 katana::ParquetReader::ReadTable(
     const katana::Uri& uri, std::optional<katana::ParquetReader::Slice> slice) {
-  bool preload = true;
   if (slice) {
     if (slice->offset < 0 || slice->length < 0) {
       return KATANA_ERROR(
           ErrorCode::InvalidArgument,
           "slice offset and length must be non-negative");
     }
-    preload = false;
   }
 
-  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, preload));
+  // Whole tables are fetched a row group at a time by
+  // BlockedParquetReader::ReadAllRowGroups, so there is no need to preload
+  auto bpr = KATANA_CHECKED(BlockedParquetReader::Make(uri, false));
   return FixTable(KATANA_CHECKED(bpr->ReadTable(slice)));
 }
 
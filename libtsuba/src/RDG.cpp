@@ -514,11 +514,26 @@ katana::RDG::Make(const RDGManifest& manifest, const RDGLoadOptions& opts) {
   rdg.prop_cache_ = opts.prop_cache;
   rdg.set_rdg_dir(manifest.dir());
 
+  // When loading lazily, an unspecified list means load nothing up front
+  // rather than load everything
+  std::optional<std::vector<std::string>> node_prop_names =
+      opts.node_properties;
+  std::optional<std::vector<std::string>> edge_prop_names =
+      opts.edge_properties;
+  if (opts.lazy_properties) {
+    if (!node_prop_names) {
+      node_prop_names.emplace();
+    }
+    if (!edge_prop_names) {
+      edge_prop_names.emplace();
+    }
+  }
+
   std::vector<PropStorageInfo*> node_props = KATANA_CHECKED(
-      rdg.core_->part_header().SelectNodeProperties(opts.node_properties));
+      rdg.core_->part_header().SelectNodeProperties(node_prop_names));
 
   std::vector<PropStorageInfo*> edge_props = KATANA_CHECKED(
-      rdg.core_->part_header().SelectEdgeProperties(opts.edge_properties));
+      rdg.core_->part_header().SelectEdgeProperties(edge_prop_names));
 
   KATANA_CHECKED(rdg.DoMake(node_props, edge_props, manifest.dir()));
 
@@ -736,6 +751,70 @@ LoadProperty(
   return new_table;
 }
 
+katana::Result<std::shared_ptr<arrow::Table>>
+RestoreProperty(
+    const std::shared_ptr<arrow::Table>& props,
+    const std::shared_ptr<arrow::Table>& col, int i,
+    std::vector<katana::PropStorageInfo>* prop_info_list) {
+  if (col->num_columns() != 1) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument,
+        "expected a single column table, found {} columns", col->num_columns());
+  }
+  const std::string& name = col->field(0)->name();
+
+  auto psi_it = std::find_if(
+      prop_info_list->begin(), prop_info_list->end(),
+      [&](const katana::PropStorageInfo& psi) { return psi.name() == name; });
+
+  if (psi_it == prop_info_list->end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no property named {}",
+        std::quoted(name));
+  }
+
+  katana::PropStorageInfo& prop_info = *psi_it;
+
+  if (!prop_info.IsAbsent()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::InvalidArgument, "property {} already loaded",
+        std::quoted(name));
+  }
+
+  std::shared_ptr<arrow::Table> new_table = col;
+  if (props->num_columns() > 0) {
+    if (i < 0 || i > props->num_columns()) {
+      i = props->num_columns();
+    }
+    new_table =
+        KATANA_CHECKED(props->AddColumn(i, col->field(0), col->column(0)));
+  }
+  prop_info.WasLoaded(col->field(0)->type());
+
+  return new_table;
+}
+
+katana::Result<katana::Uri>
+PropertyStorageUri(
+    const std::vector<katana::PropStorageInfo>& prop_info_list,
+    const std::string& name, const katana::Uri& dir) {
+  auto psi_it = std::find_if(
+      prop_info_list.begin(), prop_info_list.end(),
+      [&](const katana::PropStorageInfo& psi) { return psi.name() == name; });
+
+  if (psi_it == prop_info_list.end()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::PropertyNotFound, "no property named {}",
+        std::quoted(name));
+  }
+  if (psi_it->path().empty()) {
+    return KATANA_ERROR(
+        katana::ErrorCode::NotFound, "property {} has not been stored",
+        std::quoted(name));
+  }
+  return dir.Join(psi_it->path());
+}
+
 }  // namespace
 
 katana::Result<void>
@@ -798,6 +877,38 @@ katana::RDG::LoadEdgeProperty(const std::string& name, int i) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+katana::RDG::RestoreNodeProperty(
+    const std::shared_ptr<arrow::Table>& props, int i) {
+  std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(RestoreProperty(
+      node_properties(), props, i,
+      &core_->part_header().node_prop_info_list()));
+  core_->set_node_properties(std::move(new_props));
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+katana::RDG::RestoreEdgeProperty(
+    const std::shared_ptr<arrow::Table>& props, int i) {
+  std::shared_ptr<arrow::Table> new_props = KATANA_CHECKED(RestoreProperty(
+      edge_properties(), props, i,
+      &core_->part_header().edge_prop_info_list()));
+  core_->set_edge_properties(std::move(new_props));
+  return katana::ResultSuccess();
+}
+
+katana::Result<katana::Uri>
+katana::RDG::NodePropertyStorageUri(const std::string& name) const {
+  return PropertyStorageUri(
+      core_->part_header().node_prop_info_list(), name, rdg_dir());
+}
+
+katana::Result<katana::Uri>
+katana::RDG::EdgePropertyStorageUri(const std::string& name) const {
+  return PropertyStorageUri(
+      core_->part_header().edge_prop_info_list(), name, rdg_dir());
+}
+
 std::vector<std::string>
 katana::RDG::ListFullNodeProperties() const {
   std::vector<std::string> result;
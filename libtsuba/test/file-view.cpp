@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 #include <boost/filesystem.hpp>
 
 #include "katana/FileView.h"
@@ -31,9 +35,98 @@ TestEmpty(const std::string& path) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+TestContents(const std::string& path) {
+  auto uri = KATANA_CHECKED(katana::Uri::MakeFromFile(path));
+  auto data_uri = uri.Join("data_file");
+
+  // Larger than one FileView page so that partial binds leave holes
+  std::vector<uint64_t> data((UINT64_C(3) << 20) / sizeof(uint64_t));
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = i;
+  }
+  KATANA_CHECKED(katana::FileStore(data_uri.string(), data));
+
+  katana::FileView fv;
+  KATANA_CHECKED(
+      fv.SetAccessPattern(katana::FileView::AccessPattern::kSequential));
+  KATANA_CHECKED(fv.Bind(data_uri.string(), 0, sizeof(uint64_t), true));
+  KATANA_LOG_ASSERT(fv.size() == data.size() * sizeof(uint64_t));
+
+  KATANA_CHECKED(fv.Fill(0, fv.size(), true));
+  const auto* ptr = fv.ptr<uint64_t>();
+  for (size_t i = 0; i < data.size(); ++i) {
+    KATANA_LOG_VASSERT(ptr[i] == i, "expected {} found {}", i, ptr[i]);
+  }
+
+  KATANA_CHECKED(fv.Seek(sizeof(uint64_t) * 7));
+  uint64_t val = 0;
+  int64_t nread = KATANA_CHECKED(fv.Read(sizeof(val), &val));
+  KATANA_LOG_ASSERT(nread == sizeof(val));
+  KATANA_LOG_ASSERT(val == 7);
+
+  KATANA_CHECKED(fv.Unbind());
+  KATANA_LOG_ASSERT(!fv.Valid());
+  KATANA_LOG_ASSERT(!fv.file_backed());
+
+  return katana::ResultSuccess();
+}
+
+/// Threads reading disjoint and overlapping ranges of one partially bound
+/// view with ReadAt, which fills pages on demand, all see the file contents
+katana::Result<void>
+TestConcurrentReadAt(const std::string& path) {
+  auto uri = KATANA_CHECKED(katana::Uri::MakeFromFile(path));
+  auto data_uri = uri.Join("concurrent_file");
+
+  std::vector<uint64_t> data((UINT64_C(9) << 20) / sizeof(uint64_t));
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = i * 3;
+  }
+  KATANA_CHECKED(katana::FileStore(data_uri.string(), data));
+
+  katana::FileView fv;
+  KATANA_CHECKED(fv.Bind(data_uri.string(), 0, 0, false));
+
+  constexpr size_t kNumThreads = 8;
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      // Each thread reads a quarter of the file in small pieces, so
+      // neighboring threads overlap and race to fill the same pages
+      size_t begin = t * data.size() / (2 * kNumThreads);
+      size_t end = begin + data.size() / 4;
+      std::vector<uint64_t> buf(4099);
+      for (size_t i = begin; i < end; i += buf.size()) {
+        size_t count = std::min(buf.size(), end - i);
+        int64_t size = count * sizeof(uint64_t);
+        auto nread = fv.ReadAt(i * sizeof(uint64_t), size, buf.data());
+        KATANA_LOG_VASSERT(nread.ok(), "ReadAt: {}", nread.status().ToString());
+        KATANA_LOG_ASSERT(nread.ValueOrDie() == size);
+        for (size_t j = 0; j < count; ++j) {
+          KATANA_LOG_VASSERT(
+              buf[j] == data[i + j], "expected {} found {}", data[i + j],
+              buf[j]);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // ReadAt leaves the cursor alone
+  KATANA_LOG_ASSERT(fv.Tell().ValueOrDie() == 0);
+  KATANA_CHECKED(fv.Unbind());
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& path) {
   KATANA_CHECKED_CONTEXT(TestEmpty(path), "TestEmpty");
+  KATANA_CHECKED_CONTEXT(TestContents(path), "TestContents");
+  KATANA_CHECKED_CONTEXT(TestConcurrentReadAt(path), "TestConcurrentReadAt");
 
   return katana::ResultSuccess();
 }
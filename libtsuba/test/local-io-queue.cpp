@@ -0,0 +1,202 @@
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "LocalIOQueue.h"
+#include "katana/ErrorCode.h"
+#include "katana/Logging.h"
+#include "katana/Result.h"
+#include "katana/file.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+std::vector<uint8_t>
+MakeData(uint64_t size, uint8_t seed) {
+  std::vector<uint8_t> data(size);
+  for (uint64_t i = 0; i < size; ++i) {
+    data[i] = static_cast<uint8_t>(i * 7 + seed);
+  }
+  return data;
+}
+
+bool
+IsReady(const std::future<katana::CopyableResult<void>>& future) {
+  return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+/// Write a file split into many requests and read it back, whole and in
+/// unaligned slices
+katana::Result<void>
+TestReadWrite(katana::LocalIOQueue* queue, const std::string& path) {
+  // Not a multiple of the request size, so the last piece is short
+  std::vector<uint8_t> data = MakeData(37 * katana::kBlockSize + 123, 1);
+  KATANA_CHECKED(queue->Write(path, data.data(), data.size()).get());
+
+  std::vector<uint8_t> read(data.size());
+  KATANA_CHECKED(queue->Read(path, 0, data.size(), read.data()).get());
+  KATANA_LOG_ASSERT(read == data);
+
+  for (uint64_t start : {UINT64_C(1), katana::kBlockSize - 1, UINT64_C(9999)}) {
+    uint64_t size = 5 * katana::kBlockSize + 17;
+    std::vector<uint8_t> slice(size);
+    KATANA_CHECKED(queue->Read(path, start, size, slice.data()).get());
+    KATANA_LOG_ASSERT(
+        std::memcmp(slice.data(), data.data() + start, size) == 0);
+  }
+
+  // Empty reads and writes complete too
+  KATANA_CHECKED(queue->Read(path, 0, 0, read.data()).get());
+  KATANA_CHECKED(queue->Write(path + ".empty", data.data(), 0).get());
+  return katana::ResultSuccess();
+}
+
+/// With one worker, requests are serviced in the order they were queued
+katana::Result<void>
+TestOrder(katana::LocalIOQueue* queue, const std::string& path) {
+  std::vector<uint8_t> data = MakeData(8 * katana::kBlockSize, 2);
+  KATANA_CHECKED(queue->Write(path, data.data(), data.size()).get());
+
+  std::vector<std::vector<uint8_t>> reads(
+      32, std::vector<uint8_t>(data.size()));
+  std::vector<std::future<katana::CopyableResult<void>>> futures;
+  for (auto& read : reads) {
+    futures.emplace_back(queue->Read(path, 0, read.size(), read.data()));
+  }
+  KATANA_CHECKED(futures.back().get());
+  for (size_t i = 0; i + 1 < futures.size(); ++i) {
+    KATANA_LOG_VASSERT(IsReady(futures[i]), "read {} is not done", i);
+    KATANA_CHECKED(futures[i].get());
+    KATANA_LOG_ASSERT(reads[i] == data);
+  }
+
+  // Writes of the same size to one file land in order, so the last wins
+  std::vector<std::vector<uint8_t>> writes;
+  for (uint8_t seed = 0; seed < 8; ++seed) {
+    writes.emplace_back(MakeData(data.size(), seed));
+  }
+  std::vector<std::future<katana::CopyableResult<void>>> write_futures;
+  for (const auto& write : writes) {
+    write_futures.emplace_back(queue->Write(path, write.data(), write.size()));
+  }
+  for (auto& future : write_futures) {
+    KATANA_CHECKED(future.get());
+  }
+  std::vector<uint8_t> read(data.size());
+  KATANA_CHECKED(queue->Read(path, 0, read.size(), read.data()).get());
+  KATANA_LOG_ASSERT(read == writes.back());
+  return katana::ResultSuccess();
+}
+
+/// Errors of any piece of a request reach its future
+katana::Result<void>
+TestErrors(katana::LocalIOQueue* queue, const std::string& dir) {
+  std::vector<uint8_t> buf(4 * katana::kBlockSize);
+
+  auto missing = queue->Read(dir + "/missing", 0, buf.size(), buf.data()).get();
+  KATANA_LOG_ASSERT(!missing);
+
+  // Opening a directory succeeds but every pread of it fails
+  auto directory = queue->Read(dir, 0, buf.size(), buf.data()).get();
+  KATANA_LOG_ASSERT(!directory);
+
+  auto no_dir = queue->Write(dir + "/missing/file", buf.data(), buf.size());
+  KATANA_LOG_ASSERT(!no_dir.get());
+
+  // Reading past the end of a file by less than a block is allowed, by more
+  // than a block is an error
+  std::string path = dir + "/short";
+  std::vector<uint8_t> data = MakeData(2 * katana::kBlockSize, 3);
+  KATANA_CHECKED(queue->Write(path, data.data(), data.size()).get());
+  KATANA_CHECKED(queue->Read(path, 100, data.size(), buf.data()).get());
+  auto short_read = queue->Read(path, 0, buf.size(), buf.data()).get();
+  KATANA_LOG_ASSERT(!short_read);
+  KATANA_LOG_ASSERT(
+      short_read.error() == katana::ErrorCode::LocalStorageError);
+
+  // Failed requests leave the queue usable
+  KATANA_CHECKED(queue->Read(path, 0, data.size(), buf.data()).get());
+  KATANA_LOG_ASSERT(std::memcmp(buf.data(), data.data(), data.size()) == 0);
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestQueue(
+    const std::string& dir, const katana::LocalIOQueue::Options& options) {
+  if (boost::system::error_code err; !fs::create_directories(dir, err)) {
+    if (err) {
+      return KATANA_ERROR(
+          std::error_code(err.value(), err.category()),
+          "creating directory {}: {}", dir, err.message());
+    }
+  }
+
+  katana::LocalIOQueue queue;
+  KATANA_CHECKED(queue.Start(options));
+  KATANA_LOG_ASSERT(queue.running() == (options.num_threads > 0));
+  if (queue.running()) {
+    KATANA_LOG_ASSERT(!queue.Start(options));
+  }
+
+  KATANA_CHECKED_CONTEXT(
+      TestReadWrite(&queue, dir + "/data"), "TestReadWrite");
+  if (options.num_threads == 1) {
+    KATANA_CHECKED_CONTEXT(TestOrder(&queue, dir + "/order"), "TestOrder");
+  }
+  KATANA_CHECKED_CONTEXT(TestErrors(&queue, dir), "TestErrors");
+
+  // Requests of many pieces filled the queue, but never beyond its depth
+  KATANA_LOG_VASSERT(
+      queue.max_queued() <= options.queue_depth,
+      "{} requests queued, depth {}", queue.max_queued(), options.queue_depth);
+  if (options.num_threads > 0) {
+    KATANA_LOG_ASSERT(queue.max_queued() > 0);
+  }
+
+  queue.Stop();
+  KATANA_LOG_ASSERT(!queue.running());
+  return katana::ResultSuccess();
+}
+
+katana::Result<void>
+TestAll(const std::string& path) {
+  katana::LocalIOQueue::Options options;
+  options.max_request_size = katana::kBlockSize;
+
+  // Requests run inline
+  options.num_threads = 0;
+  KATANA_CHECKED_CONTEXT(TestQueue(path + "/inline", options), "inline");
+
+  options.num_threads = 1;
+  options.queue_depth = 1;
+  KATANA_CHECKED_CONTEXT(TestQueue(path + "/one", options), "one thread");
+
+  options.num_threads = 4;
+  options.queue_depth = 3;
+  KATANA_CHECKED_CONTEXT(TestQueue(path + "/four", options), "four threads");
+
+  options.direct = true;
+  KATANA_CHECKED_CONTEXT(TestQueue(path + "/direct", options), "direct");
+
+  return katana::ResultSuccess();
+}
+
+}  // namespace
+
+int
+main(int argc, char* argv[]) {
+  if (argc <= 1) {
+    KATANA_LOG_FATAL("{} <empty dir>", argv[0]);
+  }
+
+  auto res = TestAll(argv[1]);
+  if (!res) {
+    KATANA_LOG_FATAL("test failed: {}", res.error());
+  }
+
+  return 0;
+}
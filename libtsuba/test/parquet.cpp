@@ -1,5 +1,7 @@
 #include <arrow/chunked_array.h>
+#include <arrow/io/file.h>
 #include <arrow/type_fwd.h>
+#include <parquet/arrow/writer.h>
 
 #include "katana/ParquetReader.h"
 #include "katana/ParquetWriter.h"
@@ -38,10 +40,56 @@ TestLargeStringRoundTrip(const std::string& dir) {
   return katana::ResultSuccess();
 }
 
+katana::Result<void>
+TestManyRowGroups(const std::string& dir) {
+  auto uri = KATANA_CHECKED(katana::Uri::Make(dir)).Join("row_groups.parquet");
+
+  constexpr int64_t kNumRows = 10000;
+  arrow::Int64Builder int_builder;
+  arrow::LargeStringBuilder string_builder;
+  for (int64_t i = 0; i < kNumRows; ++i) {
+    if (i % 7 == 0) {
+      KATANA_CHECKED(int_builder.AppendNull());
+    } else {
+      KATANA_CHECKED(int_builder.Append(i));
+    }
+    KATANA_CHECKED(string_builder.Append(fmt::format("row-{}", i)));
+  }
+  std::shared_ptr<arrow::Array> ints;
+  std::shared_ptr<arrow::Array> strings;
+  KATANA_CHECKED(int_builder.Finish(&ints));
+  KATANA_CHECKED(string_builder.Finish(&strings));
+
+  auto expected = arrow::Table::Make(
+      arrow::schema(
+          {arrow::field("ints", arrow::int64()),
+           arrow::field("strings", arrow::large_utf8())}),
+      {ints, strings});
+
+  // Write directly with parquet so that the file has many row groups
+  auto out =
+      KATANA_CHECKED(arrow::io::FileOutputStream::Open(uri.path(), false));
+  KATANA_CHECKED(parquet::arrow::WriteTable(
+      *expected, arrow::default_memory_pool(), out, 333));
+  KATANA_CHECKED(out->Close());
+
+  auto reader = KATANA_CHECKED(katana::ParquetReader::Make());
+  auto table = KATANA_CHECKED(reader->ReadTable(uri));
+
+  KATANA_LOG_ASSERT(table->num_rows() == kNumRows);
+  KATANA_LOG_ASSERT(table->column(0)->num_chunks() == 1);
+  KATANA_LOG_VASSERT(
+      table->Equals(*expected), "expected {} found {}", expected->ToString(),
+      table->ToString());
+
+  return katana::ResultSuccess();
+}
+
 katana::Result<void>
 TestAll(const std::string& dir) {
   KATANA_CHECKED_CONTEXT(
       TestLargeStringRoundTrip(dir), "TestLargeStringRoundTrip");
+  KATANA_CHECKED_CONTEXT(TestManyRowGroups(dir), "TestManyRowGroups");
 
   return katana::ResultSuccess();
 }
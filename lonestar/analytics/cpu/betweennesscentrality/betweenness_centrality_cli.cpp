@@ -64,11 +64,30 @@ static cll::opt<BetweennessCentralityPlan::Algorithm> algo(
         // clEnumValN(BetweennessCentralityPlan::kAsynchronous, "Async", "Asynchronous"),
         clEnumValN(
             BetweennessCentralityPlan::kOuter, "Outer",
-            "Outer parallel algorithm")
+            "Outer parallel algorithm"),
+        clEnumValN(
+            BetweennessCentralityPlan::kApproximate, "Approximate",
+            "Approximate algorithm with adaptive source sampling")
         // clEnumValN(BetweennessCentralityPlan::kAutoAlgo, "Auto", "Auto: choose among the algorithms automatically")
         ),
     cll::init(BetweennessCentralityPlan::kLevel));
 
+static cll::opt<double> epsilon(
+    "epsilon",
+    cll::desc("(For Approximate) Maximum error of the normalized centrality "
+              "(default 1e-3)"),
+    cll::init(BetweennessCentralityPlan::kDefaultEpsilon));
+static cll::opt<double> delta(
+    "delta",
+    cll::desc("(For Approximate) Probability of exceeding the maximum error "
+              "(default 0.1)"),
+    cll::init(BetweennessCentralityPlan::kDefaultDelta));
+static cll::opt<uint32_t> sourcesPerBatch(
+    "sourcesPerBatch",
+    cll::desc("(For Approximate) Number of sources explored in one pass, at "
+              "most 64 (default 16)"),
+    cll::init(BetweennessCentralityPlan::kDefaultSourcesPerBatch));
+
 static cll::opt<bool> thread_spin(
     "threadSpin",
     cll::desc("If enabled, threads busy-wait for work rather than use "
@@ -102,6 +121,10 @@ main(int argc, char** argv) {
 
   BetweennessCentralityPlan plan =
       BetweennessCentralityPlan::FromAlgorithm(algo);
+  if (algo == BetweennessCentralityPlan::kApproximate) {
+    plan = BetweennessCentralityPlan::Approximate(
+        epsilon, delta, sourcesPerBatch);
+  }
 
   BetweennessCentralitySources sources = kBetweennessCentralityAllNodes;
   uint32_t num_sources = pg->NumNodes();
@@ -143,8 +166,20 @@ main(int argc, char** argv) {
     sources = num_sources;
   }
 
-  std::cout << "Running betweenness-centrality on " << num_sources
-            << " sources\n";
+  if (algo == BetweennessCentralityPlan::kApproximate) {
+    // Sources are sampled; -numberOfSources only limits their number
+    if (numberOfSources.getNumOccurrences() > 0) {
+      sources = numberOfSources;
+      std::cout << "Running approximate betweenness-centrality on at most "
+                << numberOfSources << " sources\n";
+    } else {
+      sources = kBetweennessCentralityAllNodes;
+      std::cout << "Running approximate betweenness-centrality\n";
+    }
+  } else {
+    std::cout << "Running betweenness-centrality on " << num_sources
+              << " sources\n";
+  }
   katana::TxnContext txn_ctx;
   if (auto r = BetweennessCentrality(
           pg.get(), "betweenness_centrality", &txn_ctx, sources, plan);
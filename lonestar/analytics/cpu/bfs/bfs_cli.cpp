@@ -19,6 +19,7 @@
 
 #include <iostream>
 
+#include <arrow/api.h>
 #include <katana/analytics/bfs/bfs.h>
 
 #include "Lonestar/BoilerPlate.h"
@@ -62,6 +63,13 @@ static cll::opt<bool> persistAllDistances(
         "distances for the last source are persisted (default value false)"),
     cll::init(false));
 
+static cll::opt<bool> multiSource(
+    "multiSource",
+    cll::desc("Search from all start nodes together, 64 at a time, and "
+              "persist their distances as one list property; only SyncDO "
+              "is supported (default value false)"),
+    cll::init(false));
+
 static cll::opt<unsigned int> alpha(
     "alpha", cll::desc("Alpha for direction optimization (default value: 15)"),
     cll::init(15));
@@ -103,6 +111,45 @@ AlgorithmName(BfsPlan::Algorithm algorithm) {
   }
 }
 
+void
+RunMultiSource(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& startNodes,
+    BfsPlan plan) {
+  std::string node_distance_prop = "level";
+  katana::TxnContext txn_ctx;
+  if (auto r =
+          MultiSourceBfs(pg, startNodes, node_distance_prop, &txn_ctx, plan);
+      !r) {
+    KATANA_LOG_FATAL("Failed to run multi-source bfs {}", r.error());
+  }
+
+  auto r = pg->GetNodeProperty(node_distance_prop);
+  if (!r) {
+    KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+  }
+  auto results =
+      std::static_pointer_cast<arrow::LargeListArray>(r.value()->chunk(0));
+  auto distances =
+      std::static_pointer_cast<arrow::UInt32Array>(results->values());
+
+  int64_t offset = results->value_offset(reportNode);
+  for (size_t i = 0; i < startNodes.size(); ++i) {
+    std::cout << "Node " << reportNode << " has distance "
+              << distances->Value(offset + i) << " from " << startNodes[i]
+              << "\n";
+  }
+
+  if (!skipVerify) {
+    if (auto res =
+            MultiSourceBfsAssertValid(pg, startNodes, node_distance_prop);
+        res) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed: {}", res.error());
+    }
+  }
+}
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -160,6 +207,12 @@ main(int argc, char** argv) {
   uint32_t num_sources = startNodes.size();
   std::cout << "Running BFS for " << num_sources << " sources\n";
 
+  if (multiSource) {
+    RunMultiSource(pg.get(), startNodes, plan);
+    totalTime.stop();
+    return 0;
+  }
+
   for (auto start_node : startNodes) {
     if (start_node >= pg->topology().NumNodes()) {
       KATANA_LOG_FATAL("failed to set source: {}", start_node);
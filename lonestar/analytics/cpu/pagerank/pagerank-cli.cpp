@@ -17,6 +17,11 @@
  * Documentation, or loss or inaccuracy of data of any kind.
  */
 
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
 #include "Lonestar/BoilerPlate.h"
 #include "katana/analytics/pagerank/pagerank.h"
 
@@ -50,6 +55,71 @@ static cll::opt<PagerankPlan::Algorithm> algo(
         clEnumValN(PagerankPlan::kPushAsynchronous, "PushAsync", "PushAsync")),
     cll::init(PagerankPlan::kPushAsynchronous));
 
+static cll::opt<std::string> seedSetsFile(
+    "seedSetsFile",
+    cll::desc("File of seed sets, one line of node IDs per set; if given, "
+              "compute the personalized Page Rank of each set instead"),
+    cll::init(""));
+static cll::opt<unsigned int> topK(
+    "topK",
+    cll::desc("Number of nodes to report per seed set (default value 10)"),
+    cll::init(10));
+static cll::opt<PersonalizedPagerankPlan::Algorithm> personalizedAlgo(
+    "personalizedAlgo",
+    cll::desc("Choose a personalized Page Rank algorithm:"),
+    cll::values(
+        clEnumValN(
+            PersonalizedPagerankPlan::kForwardPush, "ForwardPush",
+            "ForwardPush"),
+        clEnumValN(
+            PersonalizedPagerankPlan::kMonteCarlo, "MonteCarlo",
+            "MonteCarlo")),
+    cll::init(PersonalizedPagerankPlan::kForwardPush));
+static cll::opt<float> epsilon(
+    "epsilon",
+    cll::desc("Residual per out-edge at which forward push stops"),
+    cll::init(PersonalizedPagerankPlan::kDefaultEpsilon));
+static cll::opt<unsigned int> numWalks(
+    "numWalks", cll::desc("Number of Monte-Carlo walks per seed set"),
+    cll::init(PersonalizedPagerankPlan::kDefaultNumberOfWalks));
+
+void
+RunPersonalized(katana::PropertyGraph* pg) {
+  std::ifstream file(seedSetsFile);
+  if (!file.good()) {
+    KATANA_LOG_FATAL("failed to open file: {}", seedSetsFile);
+  }
+  std::vector<std::vector<uint32_t>> seed_sets;
+  for (std::string line; std::getline(file, line);) {
+    std::istringstream str(line);
+    std::vector<uint32_t> seeds{
+        std::istream_iterator<uint32_t>{str},
+        std::istream_iterator<uint32_t>{}};
+    if (!seeds.empty()) {
+      seed_sets.emplace_back(std::move(seeds));
+    }
+  }
+  std::cout << "Running personalized Page Rank for " << seed_sets.size()
+            << " seed sets\n";
+
+  PersonalizedPagerankPlan plan =
+      personalizedAlgo == PersonalizedPagerankPlan::kMonteCarlo
+          ? PersonalizedPagerankPlan::MonteCarlo(numWalks, kAlpha)
+          : PersonalizedPagerankPlan::ForwardPush(epsilon, kAlpha);
+  auto res = PersonalizedPagerank(pg, seed_sets, topK, plan);
+  if (!res) {
+    KATANA_LOG_FATAL("Failed to run personalized Pagerank {}", res.error());
+  }
+
+  for (size_t i = 0; i < seed_sets.size(); ++i) {
+    std::cout << "Seed set " << i << ":";
+    for (const auto& [node, rank] : res.value()[i]) {
+      std::cout << " " << node << " (" << rank << ")";
+    }
+    std::cout << "\n";
+  }
+}
+
 int
 main(int argc, char** argv) {
   std::unique_ptr<katana::SharedMemSys> G =
@@ -70,6 +140,12 @@ main(int argc, char** argv) {
   std::cout << "Read " << pg->topology().NumNodes() << " nodes, "
             << pg->topology().NumEdges() << " edges\n";
 
+  if (!seedSetsFile.getValue().empty()) {
+    RunPersonalized(pg.get());
+    totalTime.stop();
+    return 0;
+  }
+
   PagerankPlan plan{kCPU, algo, tolerance, maxIterations, kAlpha};
 
   katana::TxnContext txn_ctx;
@@ -69,6 +69,16 @@ static cll::opt<uint32_t> numberOfEdgeTypes(
     "numberOfEdgeTypes", cll::desc("Number of edge types (only for Edge2Vec)"),
     cll::init(1));
 
+static cll::opt<std::string> edgeWeightProperty(
+    "edgeWeightProperty",
+    cll::desc("Edge property to sample neighbors by (only for Node2Vec; "
+              "default: all edges have weight 1)"),
+    cll::init(""));
+
+static cll::opt<uint64_t> seed(
+    "seed", cll::desc("Random seed (only for Node2Vec)"),
+    cll::init(RandomWalksPlan::kDefaultSeed));
+
 std::string
 AlgorithmName(RandomWalksPlan::Algorithm algorithm) {
   switch (algorithm) {
@@ -83,13 +93,16 @@ AlgorithmName(RandomWalksPlan::Algorithm algorithm) {
 
 void
 PrintWalks(
-    const std::vector<std::vector<uint32_t>>& walks,
-    const std::string& output_file) {
+    const arrow::FixedSizeListArray& walks, const std::string& output_file) {
   std::ofstream f(output_file);
 
-  for (auto walk : walks) {
-    for (auto node : walk) {
-      f << node << " ";
+  const auto& nodes = static_cast<const arrow::UInt32Array&>(*walks.values());
+  for (int64_t i = 0; i < walks.length(); ++i) {
+    int64_t begin = walks.value_offset(i);
+    for (int64_t j = begin; j < begin + walks.value_length(); ++j) {
+      if (nodes.IsValid(j)) {
+        f << nodes.Value(j) << " ";
+      }
     }
     f << std::endl;
   }
@@ -123,7 +136,8 @@ main(int argc, char** argv) {
   switch (algo) {
   case RandomWalksPlan::kNode2Vec:
     plan = RandomWalksPlan::Node2Vec(
-        walkLength, numberOfWalks, backwardProbability, forwardProbability);
+        walkLength, numberOfWalks, backwardProbability, forwardProbability,
+        edgeWeightProperty, seed);
     break;
   case RandomWalksPlan::kEdge2Vec:
     plan = RandomWalksPlan::Edge2Vec(
@@ -134,7 +148,7 @@ main(int argc, char** argv) {
     KATANA_LOG_FATAL("Invalid algorithm");
   }
 
-  auto walks_result = RandomWalks(pg.get(), plan);
+  auto walks_result = RandomWalksFlat(pg.get(), plan);
   if (!walks_result) {
     KATANA_LOG_FATAL("Failed to run RandomWalks: {}", walks_result.error());
   }
@@ -142,7 +156,7 @@ main(int argc, char** argv) {
   if (output) {
     std::string output_file = outputLocation + "/" + outputFile;
     katana::gInfo("Writing random walks to a file: ", output_file);
-    PrintWalks(walks_result.value(), output_file);
+    PrintWalks(*walks_result.value(), output_file);
   }
 
   return 0;
@@ -0,0 +1,87 @@
+#include <iostream>
+
+#include "Lonestar/BoilerPlate.h"
+#include "katana/analytics/similarity/similarity.h"
+
+using namespace katana::analytics;
+
+namespace cll = llvm::cl;
+
+static const char* name = "Top-k Similarity";
+
+static const char* desc =
+    "For each source node, find the k nodes whose neighbor sets are most "
+    "similar to its own.";
+
+static const char* url = "similarity";
+
+static cll::opt<std::string> inputFile(
+    cll::Positional, cll::desc("<input file>"), cll::Required);
+
+static cll::opt<uint32_t> k(
+    "k", cll::desc("Number of similar nodes to find per source (default 10)"),
+    cll::init(10));
+
+static cll::opt<SimilarityMetric> metric(
+    "metric", cll::desc("Choose a similarity metric (default value Jaccard):"),
+    cll::values(
+        clEnumValN(SimilarityMetric::kJaccard, "Jaccard", "Jaccard"),
+        clEnumValN(SimilarityMetric::kCosine, "Cosine", "Cosine")),
+    cll::init(SimilarityMetric::kJaccard));
+
+static cll::list<uint32_t> sourceNodes(
+    "sourceNodes",
+    cll::desc("Nodes to find similar nodes for (default: all nodes)"),
+    cll::CommaSeparated);
+
+int
+main(int argc, char** argv) {
+  std::unique_ptr<katana::SharedMemSys> G =
+      LonestarStart(argc, argv, name, desc, url, &inputFile);
+
+  katana::StatTimer totalTime("TimerTotal");
+  totalTime.start();
+
+  std::cout << "Reading from file: " << inputFile << "\n";
+  std::unique_ptr<katana::PropertyGraph> pg =
+      MakeFileGraph(inputFile, edge_property_name);
+
+  std::cout << "Read " << pg->topology().NumNodes() << " nodes, "
+            << pg->topology().NumEdges() << " edges\n";
+
+  std::string nodes_property_name = "similar_nodes";
+  std::string similarities_property_name = "similarities";
+
+  std::vector<uint32_t> sources(sourceNodes.begin(), sourceNodes.end());
+
+  katana::TxnContext txn_ctx;
+  if (auto r = TopKSimilarity(
+          pg.get(), sources, k, metric, nodes_property_name,
+          similarities_property_name, &txn_ctx);
+      !r) {
+    KATANA_LOG_FATAL("TopKSimilarity failed: {}", r.error());
+  }
+
+  auto stats_result = TopKSimilarityStatistics::Compute(
+      pg.get(), nodes_property_name, similarities_property_name);
+  if (!stats_result) {
+    KATANA_LOG_FATAL("could not compute statistics: {}", stats_result.error());
+  }
+
+  stats_result.value().Print();
+
+  if (!skipVerify) {
+    if (TopKSimilarityAssertValid(
+            pg.get(), k, nodes_property_name, similarities_property_name)) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL(
+          "verification failed (this algorithm does not support graphs "
+          "with duplicate edges)");
+    }
+  }
+
+  totalTime.stop();
+
+  return 0;
+}
@@ -18,6 +18,9 @@
  */
 
 #include <iostream>
+#include <limits>
+
+#include <arrow/api.h>
 
 #include "Lonestar/BoilerPlate.h"
 #include "katana/analytics/sssp/sssp.h"
@@ -57,6 +60,22 @@ static cll::opt<bool> persistAllDistances(
 static cll::opt<unsigned int> reportNode(
     "reportNode", cll::desc("Node to report distance to(default value 1)"),
     cll::init(1));
+static cll::opt<bool> multiSource(
+    "multiSource",
+    cll::desc("Compute the distances from all start nodes together, 64 at a "
+              "time, and persist them as one list property; -algo and "
+              "-delta are ignored (default value false)"),
+    cll::init(false));
+static cll::opt<uint32_t> maxHops(
+    "maxHops",
+    cll::desc("With -multiSource, only follow paths of at most this many "
+              "edges (default value unbounded)"),
+    cll::init(std::numeric_limits<uint32_t>::max()));
+static cll::opt<double> maxDistance(
+    "maxDistance",
+    cll::desc("With -multiSource, only follow paths of at most this length "
+              "(default value unbounded)"),
+    cll::init(std::numeric_limits<double>::infinity()));
 static cll::opt<unsigned int> stepShift(
     "delta", cll::desc("Shift value for the deltastep (default value 13)"),
     cll::init(13));
@@ -146,6 +165,44 @@ OutputResults(
       output_filename);
 }
 
+void
+RunMultiSource(
+    katana::PropertyGraph* pg, const std::vector<uint32_t>& startNodes) {
+  std::string node_distance_prop = "distance";
+  MultiSourceSsspBounds bounds;
+  bounds.max_hops = maxHops;
+  bounds.max_distance = maxDistance;
+
+  katana::TxnContext txn_ctx;
+  if (auto r = MultiSourceSssp(
+          pg, startNodes, edge_property_name, node_distance_prop, &txn_ctx,
+          bounds);
+      !r) {
+    KATANA_LOG_FATAL("Failed to run multi-source SSSP: {}", r.error());
+  }
+
+  auto r = pg->GetNodeProperty(node_distance_prop);
+  if (!r) {
+    KATANA_LOG_FATAL("Failed to get node property {}", r.error());
+  }
+  auto results =
+      std::static_pointer_cast<arrow::LargeListArray>(r.value()->chunk(0));
+  std::cout << "Node " << reportNode << " has distances "
+            << results->value_slice(reportNode)->ToString() << "\n";
+
+  bool bounded = maxHops != std::numeric_limits<uint32_t>::max() ||
+                 maxDistance != std::numeric_limits<double>::infinity();
+  if (!skipVerify && !bounded) {
+    if (auto res = MultiSourceSsspAssertValid(
+            pg, startNodes, edge_property_name, node_distance_prop);
+        res) {
+      std::cout << "Verification successful.\n";
+    } else {
+      KATANA_LOG_FATAL("verification failed: {}", res.error());
+    }
+  }
+}
+
 }  // namespace
 
 int
@@ -189,6 +246,12 @@ main(int argc, char** argv) {
   uint32_t num_sources = startNodes.size();
   std::cout << "Running SSSP for " << num_sources << " sources\n";
 
+  if (multiSource) {
+    RunMultiSource(pg.get(), startNodes);
+    totalTime.stop();
+    return 0;
+  }
+
   if (algo == SsspPlan::kDeltaStep || algo == SsspPlan::kDeltaTile ||
       algo == SsspPlan::kSerialDelta || algo == SsspPlan::kSerialDeltaTile) {
     std::cout
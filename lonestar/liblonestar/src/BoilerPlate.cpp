@@ -34,6 +34,18 @@ llvm::cl::opt<std::string> statFile(
     "statFile",
     llvm::cl::desc("ouput file to print stats to (default value empty)"),
     llvm::cl::init(""));
+llvm::cl::opt<std::string> statJSONFile(
+    "statJSONFile",
+    llvm::cl::desc(
+        "output file to print stats to as JSON, including per-thread values "
+        "(default value empty)"),
+    llvm::cl::init(""));
+llvm::cl::opt<std::string> traceFile(
+    "traceFile",
+    llvm::cl::desc(
+        "output file to write timers, loop statistics and tracer spans to in "
+        "Chrome trace event format (default value empty)"),
+    llvm::cl::init(""));
 
 //! Flag that forces user to be aware that they should be passing in a
 //! symmetric graph.
@@ -82,6 +94,12 @@ LonestarStart(
   numThreads = katana::setActiveThreads(numThreads);
 
   katana::SetStatFile(statFile);
+  if (!statJSONFile.empty()) {
+    katana::SetStatJSONFile(statJSONFile);
+  }
+  if (!traceFile.empty()) {
+    katana::SetTraceFile(traceFile);
+  }
 
   LonestarPrintVersion(llvm::outs());
   llvm::outs() << "Copyright (C) " << katana::getCopyrightYear()
@@ -14,7 +14,7 @@ Betweenness Centrality
 
 """
 
-from libc.stdint cimport uint32_t
+from libc.stdint cimport uint32_t, uint64_t
 from libcpp.string cimport string
 from libcpp.vector cimport vector
 
@@ -36,8 +36,13 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         enum Algorithm:
             kOuter "katana::analytics::BetweennessCentralityPlan::kOuter"
             kLevel "katana::analytics::BetweennessCentralityPlan::kLevel"
+            kApproximate "katana::analytics::BetweennessCentralityPlan::kApproximate"
 
         _BetweennessCentralityPlan.Algorithm algorithm() const
+        double epsilon() const
+        double delta() const
+        uint32_t sources_per_batch() const
+        uint64_t seed() const
 
         BetweennessCentralityPlan()
 
@@ -46,6 +51,8 @@ cdef extern from "katana/analytics/betweenness_centrality/betweenness_centrality
         @staticmethod
         _BetweennessCentralityPlan Outer()
         @staticmethod
+        _BetweennessCentralityPlan Approximate(double epsilon, double delta, uint32_t sources_per_batch, uint64_t seed)
+        @staticmethod
         _BetweennessCentralityPlan FromAlgorithm(_BetweennessCentralityPlan.Algorithm algo)
 
     BetweennessCentralitySources kBetweennessCentralityAllNodes;
@@ -84,6 +91,7 @@ class _BetweennessCentralityAlgorithm(Enum):
     """
     Outer = _BetweennessCentralityPlan.Algorithm.kOuter
     Level = _BetweennessCentralityPlan.Algorithm.kLevel
+    Approximate = _BetweennessCentralityPlan.Algorithm.kApproximate
 
 
 cdef class BetweennessCentralityPlan(Plan):
@@ -110,6 +118,22 @@ cdef class BetweennessCentralityPlan(Plan):
     def algorithm(self) -> _BetweennessCentralityAlgorithm:
         return _BetweennessCentralityAlgorithm(self.underlying_.algorithm())
 
+    @property
+    def epsilon(self) -> float:
+        return self.underlying_.epsilon()
+
+    @property
+    def delta(self) -> float:
+        return self.underlying_.delta()
+
+    @property
+    def sources_per_batch(self) -> int:
+        return self.underlying_.sources_per_batch()
+
+    @property
+    def seed(self) -> int:
+        return self.underlying_.seed()
+
     @staticmethod
     def outer():
         """
@@ -124,6 +148,18 @@ cdef class BetweennessCentralityPlan(Plan):
         """
         return BetweennessCentralityPlan.make(_BetweennessCentralityPlan.Level())
 
+    @staticmethod
+    def approximate(double epsilon = 1.0e-3, double delta = 0.1, uint32_t sources_per_batch = 16,
+                    uint64_t seed = 0):
+        """
+        Sample sources at random, several per level-synchronous pass, until the centrality of every node divided by
+        n * (n - 2) is within epsilon of the exact value with probability at least 1 - delta.
+
+        With this plan, sources must be None or an int limiting the number of sampled sources.
+        """
+        return BetweennessCentralityPlan.make(
+            _BetweennessCentralityPlan.Approximate(epsilon, delta, sources_per_batch, seed))
+
 
 def betweenness_centrality(Graph pg, str output_property_name, sources = None,
              BetweennessCentralityPlan plan = BetweennessCentralityPlan(),
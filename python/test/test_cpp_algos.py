@@ -54,6 +54,7 @@ from katana.local.analytics import (
     subgraph_extraction,
     triangle_count,
 )
+from katana.local.import_data import from_csr
 
 NODES_TO_SAMPLE = 10
 
@@ -247,6 +248,35 @@ def test_betweenness_centrality_level(graph: Graph):
     assert stats.average_centrality == approx(0.000534295046236366)
 
 
+def test_betweenness_centrality_approximate():
+    # A random directed graph with 3 out-edges per node and no self loops
+    num_nodes = 50
+    rng = np.random.default_rng(0)
+    dests = np.concatenate(
+        [rng.choice([m for m in range(num_nodes) if m != n], size=3, replace=False) for n in range(num_nodes)]
+    )
+    graph = from_csr(np.arange(3, 3 * num_nodes + 1, 3, dtype=np.uint64), dests.astype(np.uint32))
+
+    betweenness_centrality(graph, "exact", None, BetweennessCentralityPlan.level())
+    exact = graph.get_node_property("exact").to_numpy()
+
+    epsilon = 0.02
+    betweenness_centrality(graph, "approximate", None, BetweennessCentralityPlan.approximate(epsilon, 0.01, seed=3))
+    approximate = graph.get_node_property("approximate").to_numpy()
+    # The bound is on the centrality divided by n * (n - 2)
+    assert approximate == approx(exact, abs=epsilon * num_nodes * (num_nodes - 2))
+
+    # The sampled sources only depend on the seed
+    betweenness_centrality(graph, "same_seed", None, BetweennessCentralityPlan.approximate(epsilon, 0.01, seed=3))
+    assert np.array_equal(graph.get_node_property("same_seed").to_numpy(), approximate)
+    betweenness_centrality(graph, "other_seed", None, BetweennessCentralityPlan.approximate(epsilon, 0.01, seed=4))
+    assert not np.array_equal(graph.get_node_property("other_seed").to_numpy(), approximate)
+
+    # The approximate algorithm picks its own sources
+    with raises(GaloisError):
+        betweenness_centrality(graph, "given_sources", [0, 1], BetweennessCentralityPlan.approximate())
+
+
 def test_triangle_count():
     graph = Graph(get_rdg_dataset("rmat15_cleaned_symmetric"))
     original_first_edge_list = [graph.get_edge_dest(e) for e in graph.edge_ids(0)]
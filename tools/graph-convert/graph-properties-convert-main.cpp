@@ -57,6 +57,11 @@ cll::opt<int> chunk_size(
               "it can be decreased to improve memory usage when "
               "converting large inputs"),
     cll::init(25000));
+cll::opt<std::string> spill_directory(
+    "spill-dir",
+    cll::desc("Convert GraphML input without holding its properties in "
+              "memory by spilling them to this local directory"),
+    cll::init(""));
 cll::opt<std::string> mapping(
     "mapping",
     cll::desc("File in graphml format with a schema mapping for the database"),
@@ -140,6 +145,15 @@ void
 ParseWild(katana::TxnContext* txn_ctx) {
   switch (type) {
   case katana::SourceType::kGraphml: {
+    if (!spill_directory.empty()) {
+      if (auto r = katana::ConvertGraphMLStreaming(
+              input_filename, output_directory, spill_directory, txn_ctx,
+              chunk_size, true);
+          !r) {
+        KATANA_LOG_FATAL("Failed to convert property graph: {}", r.error());
+      }
+      return;
+    }
     auto components_result =
         katana::ConvertGraphML(input_filename, chunk_size, true);
     if (!components_result) {
@@ -168,6 +182,15 @@ void
 ParseNeo4j(katana::TxnContext* txn_ctx) {
   switch (type) {
   case katana::SourceType::kGraphml: {
+    if (!spill_directory.empty()) {
+      if (auto r = katana::ConvertGraphMLStreaming(
+              input_filename, output_directory, spill_directory, txn_ctx,
+              chunk_size, true);
+          !r) {
+        KATANA_LOG_FATAL("Failed to convert property graph: {}", r.error());
+      }
+      return;
+    }
     auto components_result =
         katana::ConvertGraphML(input_filename, chunk_size, true);
     if (!components_result) {
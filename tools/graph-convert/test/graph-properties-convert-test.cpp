@@ -1,11 +1,14 @@
 #include <iostream>
 #include <memory>
 
+#include <boost/filesystem.hpp>
 #include <llvm/Support/CommandLine.h>
 
 #include "katana/GraphML.h"
 #include "katana/Logging.h"
 #include "katana/SharedMemSys.h"
+#include "katana/TxnContext.h"
+#include "katana/URI.h"
 #include "katana/config.h"
 
 #if defined(KATANA_MONGOC_FOUND)
@@ -13,10 +16,11 @@
 #endif
 
 namespace {
-enum ConvertTest { kMovies, kTypes, kChunks, kMongodb };
+enum ConvertTest { kMovies, kTypes, kChunks, kStreaming, kMongodb };
 }
 
 namespace cll = llvm::cl;
+namespace fs = boost::filesystem;
 
 static cll::opt<std::string> input_filename(
     cll::Positional, cll::desc("<input file/directory>"), cll::Required);
@@ -37,6 +41,9 @@ static cll::opt<ConvertTest> test_type(
             ConvertTest::kMovies, "movies",
             "source file is a test for generic conversion"),
         clEnumValN(ConvertTest::kChunks, "chunks", "this is a test for chunks"),
+        clEnumValN(
+            ConvertTest::kStreaming, "streaming",
+            "this is a test for streaming conversion"),
         clEnumValN(
             ConvertTest::kMongodb, "mongo", "this is a test for mongodb")),
     cll::Required);
@@ -1146,6 +1153,49 @@ VerifyChunksSet(const katana::GraphComponents& graph) {
   CheckTopology(graph, indices_expected, dests_expected);
 }
 
+/// Whether converting the input while streaming makes the same graph as
+/// writing graph, which was converted in memory
+katana::Result<bool>
+StreamedEqualsExpected(
+    katana::GraphComponents&& graph, const std::string& expected_dir,
+    const std::string& streamed_dir, const std::string& spill_dir) {
+  katana::TxnContext txn_ctx;
+  KATANA_CHECKED_CONTEXT(
+      katana::WritePropertyGraph(std::move(graph), expected_dir, &txn_ctx),
+      "writing");
+  auto expected = KATANA_CHECKED_CONTEXT(
+      katana::PropertyGraph::Make(expected_dir, &txn_ctx), "loading");
+
+  KATANA_CHECKED_CONTEXT(
+      katana::ConvertGraphMLStreaming(
+          input_filename, streamed_dir, spill_dir, &txn_ctx, chunk_size, true),
+      "streaming conversion");
+  auto streamed = KATANA_CHECKED_CONTEXT(
+      katana::PropertyGraph::Make(streamed_dir, &txn_ctx), "loading");
+
+  return streamed->Equals(expected.get());
+}
+
+void
+VerifyStreamingSet(katana::GraphComponents&& graph) {
+  auto make_dir = [](const std::string& name) {
+    auto uri = katana::Uri::MakeRand("/tmp/graphml-" + name);
+    KATANA_LOG_ASSERT(uri);
+    return uri.value().path();
+  };
+  std::string expected_dir = make_dir("expected");
+  std::string streamed_dir = make_dir("streamed");
+  std::string spill_dir = make_dir("spill");
+
+  auto equal = StreamedEqualsExpected(
+      std::move(graph), expected_dir, streamed_dir, spill_dir);
+  for (const auto& dir : {expected_dir, streamed_dir, spill_dir}) {
+    fs::remove_all(dir);
+  }
+  KATANA_LOG_VASSERT(equal, "{}", equal.error());
+  KATANA_LOG_ASSERT(equal.value());
+}
+
 #if defined(KATANA_MONGOC_FOUND)
 katana::GraphComponents
 GenerateAndConvertBson(size_t chunk_size) {
@@ -1297,6 +1347,9 @@ main(int argc, char** argv) {
   case ConvertTest::kChunks:
     VerifyChunksSet(graph);
     break;
+  case ConvertTest::kStreaming:
+    VerifyStreamingSet(std::move(graph));
+    break;
 #if defined(KATANA_MONGOC_FOUND)
   case ConvertTest::kMongodb:
     VerifyMongodbSet(graph);